@@ -0,0 +1,69 @@
+//=====================================================================================================//
+// ALERT MESSAGE FORMATTER
+// Subject and body of an alert are rendered into fixed buffers from layouts declared here, so the
+// alert path never touches the heap: no String concatenation, and no printf("%f") either, since
+// newlib's float conversion allocates its big-number scratch space on first use. Numbers are
+// written with integer arithmetic instead.
+//
+// A layout is a constexpr list of literal pieces and fields. alertLayoutMax() adds up the worst
+// case of each piece at compile time, and the static_asserts in alert_format.cpp check every
+// layout against the buffer it is rendered into.
+//=====================================================================================================//
+
+#ifndef ALERT_FORMAT_H
+#define ALERT_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "alert_sink.h"
+
+#define ALERT_SUBJECT_MAX 80
+#define ALERT_BODY_MAX    256
+#define ALERT_TANK_MAX    24      // tank names are cut to this many characters
+#define ALERT_NUMBER_MAX  14      // "-1999999.999"; larger magnitudes print as "nan"
+#define ALERT_STAMP_MAX   32      // TimeService::format()
+
+enum AlertField : uint8_t {
+  ALERT_FIELD_NONE = 0,         // literal piece
+  ALERT_FIELD_TANK,
+  ALERT_FIELD_TEMPERATURE,      // event temperature, 2 decimals
+  ALERT_FIELD_VALUE,            // event value, 2 decimals
+  ALERT_FIELD_THRESHOLD_LOW,
+  ALERT_FIELD_THRESHOLD_HIGH,
+  ALERT_FIELD_STAMP             // reading time
+};
+
+struct AlertPiece {
+  const char *literal;          // null for a field
+  AlertField  field;
+};
+
+#define ALERT_TEXT(s)  {s, ALERT_FIELD_NONE}
+#define ALERT_FIELD(f) {nullptr, f}
+
+/* Worst-case rendered length, usable in static_assert */
+constexpr size_t alertLiteralLength(const char *s) { return *s ? 1 + alertLiteralLength(s + 1) : 0; }
+
+constexpr size_t alertFieldMax(AlertField f) {
+  return f == ALERT_FIELD_TANK ? ALERT_TANK_MAX : f == ALERT_FIELD_STAMP ? ALERT_STAMP_MAX - 1 : ALERT_NUMBER_MAX - 1;
+}
+
+constexpr size_t alertPieceMax(const AlertPiece &p) {
+  return p.literal ? alertLiteralLength(p.literal) : alertFieldMax(p.field);
+}
+
+template <size_t N>
+constexpr size_t alertLayoutMax(const AlertPiece (&layout)[N], size_t i = 0) {
+  return i == N ? 0 : alertPieceMax(layout[i]) + alertLayoutMax(layout, i + 1);
+}
+
+/* "12.34", "-0.50", "nan"; `decimals` up to 3. Returns the length written. */
+size_t formatFixed(char *out, size_t len, float value, uint8_t decimals);
+
+/* The human-readable alert line used by the email body, serial and log sinks */
+size_t formatAlertText(char *out, size_t len, const AlertEvent &e, const TimeService &time, const char *tankName);
+
+/* Email subject for the event's sensor */
+size_t formatAlertSubject(char *out, size_t len, const AlertEvent &e, const TimeService &time, const char *tankName);
+
+#endif // ALERT_FORMAT_H
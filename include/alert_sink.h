@@ -0,0 +1,137 @@
+//=====================================================================================================//
+// ALERT SINKS
+// An alert is an AlertEvent (which sensor, its value and threshold, severity) handed to the
+// AlertDispatcher, which fans it out to every registered AlertSink: SMTP, MQTT, an HTTP webhook,
+// the serial port, a log file on flash (alert_sinks.h). Each sink has its own queue and worker
+// task, so a slow SMTP handshake never holds up the MQTT publish or loop(), and its own retry
+// policy: failed deliveries are retried with a doubling back-off before they count as failed.
+// Per-sink delivery counts and dispatch-to-delivery latency go to /metrics.
+//=====================================================================================================//
+
+#ifndef ALERT_SINK_H
+#define ALERT_SINK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "metrics.h"
+#include "sensor_snapshot.h"
+#include "time_service.h"
+
+#define ALERT_MAX_SINKS   6
+#define ALERT_QUEUE_DEPTH 8     // events waiting per sink; newer ones are dropped beyond this
+
+enum AlertSensor : uint8_t {
+  ALERT_SENSOR_LIQUID_LEVEL = 0,
+  ALERT_SENSOR_TEMPERATURE,
+  ALERT_SENSOR_HEAP,            // the board itself: heap fragmentation (heap_telemetry.h)
+  ALERT_SENSORS
+};
+
+enum AlertSeverity : uint8_t {
+  ALERT_SEVERITY_CLEAR = 0,   // back within limits
+  ALERT_SEVERITY_WARNING,
+  ALERT_SEVERITY_CRITICAL
+};
+
+struct AlertEvent {
+  uint64_t      sampleUs;        // TimeService::monoUs() of the reading that raised it
+  AlertSensor   sensor;
+  AlertSeverity severity;
+  float         value;           // the sensor's reading (liquid level: 1 = low)
+  float         thresholdLow;    // limits the value was checked against, NAN if unused
+  float         thresholdHigh;
+  float         temperature;     // shown with every alert for context
+};
+
+const char *alertSensorName(AlertSensor sensor);
+const char *alertSeverityName(AlertSeverity severity);
+
+class AlertSink {
+public:
+  virtual ~AlertSink() {}
+  virtual const char *name() const = 0;
+
+  /* Runs on the sink's worker task; may block. True once the alert has been handed over. */
+  virtual bool deliver(const AlertEvent &e) = 0;
+
+  /* The worker waits while this is false (e.g. Wi-Fi not up yet) instead of burning retries */
+  virtual bool ready() const { return true; }
+
+  /* Whether ALERT_SEVERITY_CLEAR events are sent to this sink */
+  virtual bool wantsClear() const { return true; }
+};
+
+/* Receives the new AlertDispatcher::status() each time it changes */
+typedef void (*AlertStatusFn)(AlertStatus status);
+
+struct AlertRetryPolicy {
+  uint8_t  attempts;         // including the first one
+  uint32_t firstBackoffMs;   // doubles after every failed attempt
+  uint32_t maxBackoffMs;
+};
+
+struct AlertSinkStats {
+  MetricCounter delivered;
+  MetricCounter failed;      // every attempt failed
+  MetricCounter retries;
+  MetricCounter dropped;     // queue full
+  Log2Histogram<14, 4> latencyMs;   // dispatch to delivery, 16 ms ... >= 2 min
+};
+
+class AlertDispatcher {
+public:
+  AlertDispatcher();
+
+  /* Before begin(); `stackSize` is the worker's stack (TLS needs a lot more than a serial print) */
+  bool addSink(AlertSink &sink, const AlertRetryPolicy &policy, uint32_t stackSize);
+
+  /* Before begin(). Runs on whichever task changed the status (dispatch() or a sink worker), one
+   * call at a time and in order, so the last call always carries the current status. */
+  void onStatusChange(AlertStatusFn fn) { _onStatus = fn; }
+
+  /* Starts one worker per sink */
+  bool begin();
+
+  /* Any task; queues the event for every sink that takes it and returns at once */
+  void dispatch(const AlertEvent &e);
+
+  /* Summary for the display/live feed: SENDING while any sink is still working on an alert, then
+   * SENT, or FAILED if a sink gave up on the last round */
+  AlertStatus status() const;
+
+  void writeMetrics(PromWriter &out) const;
+  void printStats(Print &out) const;
+
+private:
+  struct Job {
+    AlertEvent event;
+    uint64_t   queuedUs;
+  };
+
+  struct Worker {
+    AlertDispatcher *owner;
+    AlertSink *sink;
+    AlertRetryPolicy policy;
+    uint32_t stackSize;
+    QueueHandle_t queue;
+    AlertSinkStats stats;
+  };
+
+  static void workerMain(void *arg);
+  void run(Worker &w);
+  void statusChanged();
+
+  Worker _workers[ALERT_MAX_SINKS];
+  uint8_t _count;
+  std::atomic<uint8_t> _pending;     // alert (not clear) jobs queued or in progress
+  std::atomic<bool> _lastFailed;
+  std::atomic<bool> _raised;         // any alert dispatched yet
+  AlertStatusFn _onStatus;
+  SemaphoreHandle_t _statusLock;     // serializes _onStatus calls
+  AlertStatus _reported;             // last status passed to _onStatus
+};
+
+#endif // ALERT_SINK_H
@@ -0,0 +1,151 @@
+//=====================================================================================================//
+// ALERT SINK IMPLEMENTATIONS
+// The transports behind AlertDispatcher (alert_sink.h):
+//  - SmtpAlertSink:    email through ESP Mail Client, one message per alert (clears are not mailed),
+//                      optionally with the recent history from the sample log attached as CSV
+//  - MqttAlertSink:    retained alert state through MqttSink
+//  - WebhookAlertSink: JSON POST to an HTTP endpoint
+//  - SerialAlertSink:  the alert line on the serial console
+//  - FileAlertSink:    the alert line appended to a log file on LittleFS
+//=====================================================================================================//
+
+#ifndef ALERT_SINKS_H
+#define ALERT_SINKS_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <ESP_Mail_Client.h>
+#include "alert_format.h"
+#include "alert_sink.h"
+#include "heap_telemetry.h"
+#include "mqtt_sink.h"
+#include "sample_log.h"
+#include "tls_profile.h"
+
+#define ALERT_LOG_PATH     "/alerts.log"
+#define ALERT_LOG_OLD_PATH "/alerts.old"
+#define ALERT_LOG_MAX      (32 * 1024)   // rotated to ALERT_LOG_OLD_PATH beyond this
+#define WEBHOOK_TIMEOUT_MS 5000
+#define SMTP_CHUNK_SIZE    1024          // BDAT chunk for messages with an attachment
+
+class SmtpAlertSink : public AlertSink {
+public:
+  SmtpAlertSink(SMTPSession &smtp, ESP_Mail_Session &session, const char *sender, const char *recipient,
+                const TimeService &time, const char *tankName, const volatile bool &ready);
+
+  const char *name() const override { return "smtp"; }
+  bool deliver(const AlertEvent &e) override;
+  bool ready() const override { return _ready; }
+  bool wantsClear() const override { return false; }
+
+  /* Attach the last `windowS` of the sample log, in `resolutionS` buckets, to every alert. The
+   * attachment is streamed from flash into the SMTP session (smtp_stream.h); alerts sent before
+   * the clock is set go out without it. */
+  void attachHistory(SampleLog *log, uint32_t windowS, uint32_t resolutionS);
+
+  /* TLS record buffers for the session, resolved (AUTO: probed) before the first connect. A failed
+   * connect on fragment-sized buffers switches to full ones for the retries. */
+  void setTlsBuffers(TlsBufferPolicy policy, const char *host, uint16_t port, uint16_t fragment);
+  const TlsBuffers &tlsBuffers() const { return _buffers; }
+  bool tlsBuffersResolved() const { return _buffersResolved; }
+
+  /* Heap samples before the connect, after the handshake and after the send */
+  void attachHeapTelemetry(HeapTelemetry *heap);
+
+  /* Carve the mail client's strings for each send (connect to close) from `arena` instead of the heap */
+  void useArena(MB_StringArena *arena) { _arena = arena; }
+
+  /* Free heap taken by an open session (TLS context, record buffers, validator), last and largest */
+  uint32_t sessionHeapLast() const { return _sessionHeapLast; }
+  uint32_t sessionHeapMax() const { return _sessionHeapMax; }
+
+  MetricCounter connectErrors;
+  MetricCounter sendErrors;
+  Log2Histogram<10, 6> connectMs;   // 64 ms ... >= 16 s
+  Log2Histogram<10, 6> sendMs;
+
+private:
+  SMTPSession &_smtp;
+  ESP_Mail_Session &_session;
+  const char *_sender;
+  const char *_recipient;
+  const TimeService &_time;
+  const char *_tankName;
+  const volatile bool &_ready;
+  bool deliverWithHistory(const AlertEvent &e, uint32_t now);
+  void prepareConnect();
+  void connected(uint32_t heapBefore);
+  void connectFailed();
+
+  char _subject[ALERT_SUBJECT_MAX];   // rendered in place for every alert (alert_format.h)
+  char _body[ALERT_BODY_MAX];
+  SampleLog *_history;
+  uint32_t _historyWindowS;
+  uint32_t _historyResolutionS;
+  char _chunk[SMTP_CHUNK_SIZE];
+  TlsBufferPolicy _bufferPolicy;
+  const char *_tlsHost;
+  uint16_t _tlsPort;
+  uint16_t _tlsFragment;
+  TlsBuffers _buffers;
+  bool _buffersResolved;
+  uint32_t _sessionHeapLast;
+  uint32_t _sessionHeapMax;
+  MB_StringArena *_arena;
+  HeapTelemetry *_heap;
+};
+
+class MqttAlertSink : public AlertSink {
+public:
+  explicit MqttAlertSink(MqttSink &mqtt) : _mqtt(mqtt) {}
+
+  const char *name() const override { return "mqtt"; }
+  bool deliver(const AlertEvent &e) override;
+
+private:
+  MqttSink &_mqtt;
+};
+
+class WebhookAlertSink : public AlertSink {
+public:
+  WebhookAlertSink(const char *url, const TimeService &time, const char *tankName)
+      : _url(url), _time(time), _tankName(tankName) {}
+
+  const char *name() const override { return "webhook"; }
+  bool deliver(const AlertEvent &e) override;
+  bool ready() const override;
+
+private:
+  const char *_url;
+  const TimeService &_time;
+  const char *_tankName;
+};
+
+class SerialAlertSink : public AlertSink {
+public:
+  SerialAlertSink(Print &out, const TimeService &time, const char *tankName)
+      : _out(out), _time(time), _tankName(tankName) {}
+
+  const char *name() const override { return "serial"; }
+  bool deliver(const AlertEvent &e) override;
+
+private:
+  Print &_out;
+  const TimeService &_time;
+  const char *_tankName;
+};
+
+class FileAlertSink : public AlertSink {
+public:
+  FileAlertSink(fs::FS &fs, const TimeService &time, const char *tankName) : _fs(fs), _time(time), _tankName(tankName) {}
+
+  const char *name() const override { return "file"; }
+  bool deliver(const AlertEvent &e) override;
+
+private:
+  fs::FS &_fs;
+  const TimeService &_time;
+  const char *_tankName;
+};
+
+#endif // ALERT_SINKS_H
@@ -0,0 +1,100 @@
+//=====================================================================================================//
+// ASYNC LOG
+// Serial output without the wait. A print on the UART returns only once its bytes fit in the
+// FIFO, so a burst of status lines (the stats block, an SMTP status callback) held up whichever
+// task printed them. Here a message is formatted on the caller's stack and copied into a ring in
+// RAM; a low-priority task drains the ring to Serial. Producers never wait: reserving space is a
+// compare-and-swap on the ring head, and a full ring drops the message and counts it. The drain
+// reports drops in the log itself.
+//
+// LOG_E/W/I/D(fmt, ...) write one leveled line, shown as "I (12345) text" with the uptime in ms.
+// AsyncLog is also a Print, so printStats(Print &) style dumps go through the ring unchanged;
+// each write() call becomes one record. Levels above LOG_LEVEL_COMPILED are compiled out.
+//=====================================================================================================//
+
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <stdarg.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "metrics.h"
+
+#define LOG_RING_SIZE     4096    // bytes; a power of two
+#define LOG_LINE_MAX      160     // longest leveled message, longer ones are cut
+#define LOG_TASK_STACK    3072
+#define LOG_TASK_PRIORITY 1       // just above idle: output waits for everything else
+
+enum LogLevel : uint8_t {
+  LOG_LEVEL_ERROR = 0,
+  LOG_LEVEL_WARN,
+  LOG_LEVEL_INFO,
+  LOG_LEVEL_DEBUG,
+  LOG_LEVEL_RAW                   // Print::write() text, passed through as it is
+};
+
+#ifndef LOG_LEVEL_COMPILED
+#define LOG_LEVEL_COMPILED LOG_LEVEL_INFO
+#endif
+
+struct LogStats {
+  MetricCounter records;
+  MetricCounter dropped;          // ring full
+  MetricCounter truncated;        // cut at LOG_LINE_MAX
+  MetricCounter bytes;            // written to the UART
+};
+
+class AsyncLog : public Print {
+public:
+  AsyncLog();
+
+  /* Starts Serial at `baud` and the drain task; until then every message is discarded */
+  bool begin(uint32_t baud);
+
+  void setLevel(LogLevel level) { _level = level; }
+  bool enabled(LogLevel level) const { return level <= _level && _task; }
+
+  void log(LogLevel level, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+  void vlog(LogLevel level, const char *fmt, va_list args);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t len) override;
+  using Print::write;
+
+  /* Waits up to `timeoutMs` for the drain to empty the ring, then for the UART; before deep sleep */
+  void flush() override;
+  bool flush(uint32_t timeoutMs);
+
+  const LogStats &stats() const { return _stats; }
+  uint32_t highWater() const { return _highWater.load(std::memory_order_relaxed); }
+
+private:
+  bool push(LogLevel level, const char *text, size_t len);
+  bool drainOne();
+  static void taskMain(void *arg);
+
+  alignas(4) uint8_t _ring[LOG_RING_SIZE];
+  std::atomic<uint32_t> _head;    // free-running byte counts; reserved up to head
+  std::atomic<uint32_t> _tail;    // drained up to tail
+  std::atomic<uint32_t> _highWater;
+  volatile LogLevel _level;
+  TaskHandle_t _task;
+  uint32_t _droppedReported;      // drain task only
+  LogStats _stats;
+};
+
+extern AsyncLog asyncLog;
+
+#define LOG_AT(level, ...)                                                                                  \
+  do {                                                                                                      \
+    if ((level) <= LOG_LEVEL_COMPILED && asyncLog.enabled(level)) asyncLog.log((level), __VA_ARGS__);      \
+  } while (0)
+
+#define LOG_E(...) LOG_AT(LOG_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_W(...) LOG_AT(LOG_LEVEL_WARN, __VA_ARGS__)
+#define LOG_I(...) LOG_AT(LOG_LEVEL_INFO, __VA_ARGS__)
+#define LOG_D(...) LOG_AT(LOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#endif // ASYNC_LOG_H
@@ -0,0 +1,59 @@
+//=====================================================================================================//
+// STREAMING BASE64 ENCODER
+// MIME base64 (RFC 2045: 76 characters per line, CRLF line breaks) written through a fixed
+// buffer to a sink, e.g. the TLS client of an SMTP session, so an attachment of any size is
+// encoded with a few hundred bytes of RAM instead of a heap copy 4/3 the size of the input.
+//
+// Input is cut into 57-byte lines (76 characters). Each line is encoded 12 bytes at a time: three
+// big-endian 32-bit words give sixteen 6-bit indexes, so the inner loop does three loads and
+// sixteen table lookups instead of a load, shift and mask per byte. A partial line is kept until
+// more input or finish() arrives.
+//=====================================================================================================//
+
+#ifndef BASE64_STREAM_H
+#define BASE64_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BASE64_LINE_INPUT  57                       // bytes per 76-character line
+#define BASE64_LINE_OUTPUT 78                       // 76 characters + CRLF
+#define BASE64_BUFFER_MIN  BASE64_LINE_OUTPUT
+
+typedef bool (*Base64Sink)(void *arg, const char *data, size_t len);
+
+class Base64Stream {
+public:
+  /* `buf` collects whole lines for the sink, at least BASE64_BUFFER_MIN bytes */
+  Base64Stream(char *buf, size_t len, Base64Sink sink, void *arg);
+
+  /* False once the sink has failed; later calls do nothing */
+  bool write(const uint8_t *data, size_t len);
+
+  /* Encodes the partial line with padding, ends it with CRLF and sends the rest of the buffer */
+  bool finish();
+
+  size_t encodedBytes() const { return _encoded; }
+
+  /* Encoded size of `len` input bytes, line breaks included */
+  static size_t encodedLength(size_t len);
+
+  /* Producer-side callback (e.g. a SampleLogSink) that feeds the Base64Stream passed as `arg` */
+  static bool input(void *arg, const char *data, size_t len);
+
+private:
+  void encodeLine(const uint8_t *in, size_t len);
+  bool flush();
+
+  char *_buf;
+  size_t _len;
+  size_t _used;
+  Base64Sink _sink;
+  void *_arg;
+  bool _ok;
+  size_t _encoded;
+  uint8_t _carry[BASE64_LINE_INPUT];   // partial line waiting for more input
+  uint8_t _carryLen;
+};
+
+#endif // BASE64_STREAM_H
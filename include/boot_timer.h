@@ -0,0 +1,65 @@
+//=====================================================================================================//
+// BOOT TIMER
+// Records how long each boot phase took so the startup path can be checked from the serial log.
+// mark() may be called from setup(), loop() and the background network task.
+//=====================================================================================================//
+
+#ifndef BOOT_TIMER_H
+#define BOOT_TIMER_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define BOOT_TIMER_PHASES 12
+
+class BootTimer {
+public:
+  BootTimer() : _count(0) {}
+
+  /* Records the end of a phase; `name` must be a string literal */
+  void mark(const char *name) {
+    uint32_t now = micros();
+    uint8_t i = _count.load(std::memory_order_relaxed);
+    do {
+      if (i >= BOOT_TIMER_PHASES) return;
+    } while (!_count.compare_exchange_weak(i, i + 1, std::memory_order_relaxed));
+    _phases[i].name = name;
+    _phases[i].us = now;
+    _phases[i].ready.store(true, std::memory_order_release);
+  }
+
+  bool has(const char *name) const {
+    uint8_t n = _count.load(std::memory_order_acquire);
+    for (uint8_t i = 0; i < n; i++) {
+      if (_phases[i].ready.load(std::memory_order_acquire) && strcmp(_phases[i].name, name) == 0) return true;
+    }
+    return false;
+  }
+
+  /* Phases in the order they finished; "+" is the time since the previous entry */
+  void print(Print &out) const {
+    uint8_t n = _count.load(std::memory_order_acquire);
+    uint32_t previous = 0;
+    out.println(F("---- boot timing ----"));
+    for (uint8_t i = 0; i < n; i++) {
+      if (!_phases[i].ready.load(std::memory_order_acquire)) continue;
+      uint32_t at = _phases[i].us;
+      out.printf("%-14s at %6lu ms  +%6lu ms\n", _phases[i].name, (unsigned long)(at / 1000),
+                 (unsigned long)((at - previous) / 1000));
+      previous = at;
+    }
+    out.println(F("---------------------"));
+  }
+
+private:
+  struct Phase {
+    const char *name;
+    uint32_t us;                 // micros() since the application started
+    std::atomic<bool> ready{false};
+  };
+
+  Phase _phases[BOOT_TIMER_PHASES];
+  std::atomic<uint8_t> _count;
+};
+
+#endif // BOOT_TIMER_H
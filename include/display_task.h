@@ -0,0 +1,54 @@
+//=====================================================================================================//
+// DISPLAY TASK
+// Renders the LCD (and the TFT dashboard on the S3 build) from its own low-priority FreeRTOS task.
+// loop() only publishes SensorSnapshots into the mailbox; this task picks up the latest one at a
+// capped frame rate, so slow I2C/SPI writes never stretch the sample cadence.
+//=====================================================================================================//
+
+#ifndef DISPLAY_TASK_H
+#define DISPLAY_TASK_H
+
+#include <Arduino.h>
+#include "i2c_lcd.h"
+#include "sensor_snapshot.h"
+#if defined(TFT_DASHBOARD)
+#include "tft_dashboard.h"
+#endif
+
+#define DISPLAY_FPS           4     // frame cap for the display task
+#define DISPLAY_PAGE_MS       2000  // how long each reading stays on the first LCD line
+#define DISPLAY_TASK_PRIORITY 1     // lowest application priority, below the Wi-Fi/lwIP tasks on core 0
+#define DISPLAY_TASK_CORE     0     // loop() runs on core 1
+#define DISPLAY_TASK_STACK    4096
+
+class DisplayTask {
+public:
+  DisplayTask(I2cLcd &lcd, const SensorMailbox &mailbox, const char *tankName);
+
+#if defined(TFT_DASHBOARD)
+  void attachDashboard(TftDashboard *dashboard) { _dashboard = dashboard; }
+#endif
+
+  bool begin();
+
+  uint32_t frames() const { return _frames; }
+  uint32_t lcdWrites() const { return _lcdWrites; }
+
+private:
+  static void taskMain(void *arg);
+  void renderLcd(const SensorSnapshot &snap, bool hasSample, uint32_t now);
+  void writeLine(uint8_t row, const char *text);
+
+  I2cLcd &_lcd;
+  const SensorMailbox &_mailbox;
+  const char *_tankName;
+#if defined(TFT_DASHBOARD)
+  TftDashboard *_dashboard;
+#endif
+
+  char _shown[2][17];   // what is on the LCD now, to skip redundant bus writes
+  uint32_t _frames;
+  uint32_t _lcdWrites;
+};
+
+#endif // DISPLAY_TASK_H
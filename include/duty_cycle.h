@@ -0,0 +1,195 @@
+//=====================================================================================================//
+// DEEP-SLEEP DUTY CYCLE
+// Low-power mode (LowPowerMode in main.cpp): every wake takes one sample, appends it to a ring
+// buffer kept in RTC slow memory and goes back to deep sleep. The on-flash log is only written
+// when the buffer is nearly full, and Wi-Fi only comes up to send an alert. The liquid level pin
+// is armed as an ext0 wake source (or watched by the ULP, see ulp_level_watch.h) so a low level
+// is answered right away instead of at the next timer wake.
+//
+// This header is the state machine only (no Arduino or ESP-IDF calls) so it can be stepped
+// through off-target; the sleep/wake glue is in duty_cycle.cpp and main.cpp.
+//=====================================================================================================//
+
+#ifndef DUTY_CYCLE_H
+#define DUTY_CYCLE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define DUTY_SAMPLE_INTERVAL_S 300   // timer wake period
+#define DUTY_BUFFER_SIZE       96    // samples retained in RTC slow memory (8 hours at 5 min)
+#define DUTY_FLUSH_AT          80    // write to flash once this many are buffered
+
+/* Rough current draw for the energy estimate, NodeMCU-32S at 3.3 V */
+#define DUTY_SUPPLY_V          3.3f
+#define DUTY_ACTIVE_MA         40.0f    // CPU awake, radio off
+#define DUTY_RADIO_MA          120.0f   // Wi-Fi associated / sending
+#define DUTY_SLEEP_MA          0.15f    // deep sleep incl. LDO and sensor quiescent current
+
+enum WakeReason : uint8_t {
+  WAKE_POWER_ON = 0,
+  WAKE_TIMER,
+  WAKE_LEVEL_PIN,
+  WAKE_BUTTON,
+  WAKE_ULP,              // ULP level watch, before the caller knows which pin it was
+  WAKE_OTHER
+};
+
+enum DutyAction : uint8_t {
+  DUTY_NONE  = 0,
+  DUTY_FLUSH = 1 << 0,   // write buffered samples to the on-flash log
+  DUTY_ALERT = 1 << 1    // bring Wi-Fi up and send an alert
+};
+
+struct PackedSample {
+  uint32_t time;         // seconds (UTC once the clock was synced, else since first boot)
+  int16_t  tempCenti;    // deg C x100, INT16_MIN when the read failed
+  uint16_t humCenti;     // %RH x100, UINT16_MAX when the read failed
+  uint8_t  liquidLow;
+  uint8_t  tempAlert;
+} __attribute__((packed));
+
+struct DutyCycleState {
+  uint32_t magic;
+  uint32_t wakes;
+  uint16_t head;                   // next write position
+  uint16_t count;                  // buffered samples
+  uint8_t  liquidLowLast;
+  uint8_t  tempAlertLast;
+  uint32_t levelWakes;
+  uint32_t alertsSent;
+  uint32_t flushes;
+  uint32_t dropped;                // overwritten before they could be flushed
+
+  /* Energy / latency accounting since power-on */
+  uint64_t awakeUs;
+  uint64_t radioUs;
+  uint64_t sleepUs;
+  uint64_t sleepStartUs;           // RTC clock when the last sleep began, 0 if none
+  uint32_t samples;
+  uint32_t lastWakeLatencyUs;      // app start to sample taken, last wake
+  uint32_t maxWakeLatencyUs;
+  uint32_t lastLevelLatencyUs;     // same, for the last level-pin wake
+
+  PackedSample buffer[DUTY_BUFFER_SIZE];
+};
+
+class DutyCycle {
+public:
+  static const uint32_t MAGIC = 0x44555459; // "DUTY"
+
+  explicit DutyCycle(DutyCycleState &state) : _s(state), _reason(WAKE_OTHER) {}
+
+  /* Called first on every wake with the RTC clock (keeps running in deep sleep).
+   * A cold boot (or corrupted RTC memory) starts from scratch. */
+  void begin(WakeReason reason, uint64_t rtcNowUs) {
+    _reason = reason;
+    if (reason == WAKE_POWER_ON || _s.magic != MAGIC) {
+      memset(&_s, 0, sizeof(_s));
+      _s.magic = MAGIC;
+    }
+    if (_s.sleepStartUs && rtcNowUs > _s.sleepStartUs) _s.sleepUs += rtcNowUs - _s.sleepStartUs;
+    _s.sleepStartUs = 0;
+    _s.wakes++;
+    if (reason == WAKE_LEVEL_PIN) _s.levelWakes++;
+  }
+
+  /* Stores the sample and decides what else this wake has to do */
+  uint8_t record(const PackedSample &sample, uint32_t wakeLatencyUs) {
+    if (_s.count == DUTY_BUFFER_SIZE) _s.dropped++;
+    else _s.count++;
+    _s.buffer[_s.head] = sample;
+    _s.head = (_s.head + 1) % DUTY_BUFFER_SIZE;
+    _s.samples++;
+
+    _s.lastWakeLatencyUs = wakeLatencyUs;
+    if (wakeLatencyUs > _s.maxWakeLatencyUs) _s.maxWakeLatencyUs = wakeLatencyUs;
+    if (_reason == WAKE_LEVEL_PIN) _s.lastLevelLatencyUs = wakeLatencyUs;
+
+    /* Alerts fire on the transition into an alarm state, not on every wake while it lasts */
+    uint8_t actions = DUTY_NONE;
+    if ((sample.liquidLow && !_s.liquidLowLast) || (sample.tempAlert && !_s.tempAlertLast)) actions |= DUTY_ALERT;
+    _s.liquidLowLast = sample.liquidLow;
+    _s.tempAlertLast = sample.tempAlert;
+
+    if (_s.count >= DUTY_FLUSH_AT) actions |= DUTY_FLUSH;
+    return actions;
+  }
+
+  /* Oldest-first view of the buffer for flushing: up to two contiguous runs */
+  uint16_t pending(const PackedSample **first, uint16_t *firstLen, const PackedSample **second,
+                   uint16_t *secondLen) const {
+    uint16_t start = (_s.head + DUTY_BUFFER_SIZE - _s.count) % DUTY_BUFFER_SIZE;
+    uint16_t run = DUTY_BUFFER_SIZE - start;
+    if (run > _s.count) run = _s.count;
+    *first = &_s.buffer[start];
+    *firstLen = run;
+    *second = &_s.buffer[0];
+    *secondLen = _s.count - run;
+    return _s.count;
+  }
+
+  /* Drops the `n` oldest samples after they were written out */
+  void flushed(uint16_t n) {
+    if (n > _s.count) n = _s.count;
+    _s.count -= n;
+    _s.flushes++;
+  }
+
+  void alertSent() { _s.alertsSent++; }
+
+  /* Moves samples stamped before the clock was ever set (time below `validAfter`) by `stepS`,
+   * the amount the first time sync moved the wall clock */
+  uint16_t backfill(int64_t stepS, uint32_t validAfter) {
+    uint16_t fixed = 0;
+    for (uint16_t i = 0; i < _s.count; i++) {
+      PackedSample &s = _s.buffer[(_s.head + DUTY_BUFFER_SIZE - 1 - i) % DUTY_BUFFER_SIZE];
+      if (s.time >= validAfter) continue;
+      s.time = (uint32_t)((int64_t)s.time + stepS);
+      fixed++;
+    }
+    return fixed;
+  }
+
+  /* Closes the wake: `awakeUs` is the whole time since app start, `radioUs` the part with Wi-Fi on.
+   * Sleep time is accounted on the next begin(), so early level-pin wakes are counted correctly. */
+  void finish(uint32_t awakeUs, uint32_t radioUs, uint64_t rtcNowUs) {
+    _s.awakeUs += awakeUs;
+    _s.radioUs += radioUs;
+    _s.sleepStartUs = rtcNowUs;
+  }
+
+  uint64_t sleepUs() const { return (uint64_t)DUTY_SAMPLE_INTERVAL_S * 1000000ULL; }
+
+  /* ext0 wakes on a high level; arming it while the level is already low would wake at once */
+  bool armLevelWake() const { return !_s.liquidLowLast; }
+
+  /* Average energy per sample in millijoules, from the current model above */
+  float energyPerSampleMj() const {
+    if (!_s.samples) return 0.0f;
+    float activeS = (float)(_s.awakeUs - _s.radioUs) / 1e6f;
+    float radioS = (float)_s.radioUs / 1e6f;
+    float sleepS = (float)_s.sleepUs / 1e6f;
+    float mAs = DUTY_ACTIVE_MA * activeS + DUTY_RADIO_MA * radioS + DUTY_SLEEP_MA * sleepS;
+    return DUTY_SUPPLY_V * mAs / _s.samples;
+  }
+
+  WakeReason reason() const { return _reason; }
+  const DutyCycleState &state() const { return _s; }
+
+private:
+  DutyCycleState &_s;
+  WakeReason _reason;
+};
+
+#if defined(ARDUINO)
+/* ESP32 glue (duty_cycle.cpp) */
+#define DUTY_LOG_PATH "/duty_log.csv"
+
+WakeReason readWakeReason();
+uint64_t rtcClockUs();
+size_t flushDutyBuffer(DutyCycle &cycle);
+void enterDeepSleep(uint64_t sleepUs, bool armLevelWake, uint8_t levelPin);
+#endif
+
+#endif // DUTY_CYCLE_H
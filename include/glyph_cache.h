@@ -0,0 +1,74 @@
+//=====================================================================================================//
+// GLYPH CACHE
+// Adafruit_GFX::drawChar() plots every glyph pixel by pixel. For the few characters that make up
+// the live readouts (digits, sign, decimal point, units) this cache rasterizes each glyph once into
+// horizontal runs. Into a GFXcanvas16 the runs are written straight into its buffer; on any other
+// target they go through writeFastHLine()/writeFillRect(), one call per run instead of one per
+// pixel. Works with the built-in 5x7 font (font = nullptr) and with any GFXfont from Fonts/.
+//=====================================================================================================//
+
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+#define GLYPH_CACHE_CHARSET    "0123456789.-+%C "  // characters used by the numeric readouts
+#define GLYPH_CACHE_MAX_GLYPHS 20
+#define GLYPH_CACHE_MAX_RUNS   640                 // 3 bytes each; enough for the digit set up to ~18pt
+
+class GlyphCache {
+public:
+  GlyphCache();
+
+  /* Rasterizes `charset` in `font` (nullptr = built-in font). Glyphs that do not fit in the run
+   * pool are left out and drawn through Adafruit_GFX::drawChar() instead. */
+  bool begin(const GFXfont *font = nullptr, const char *charset = GLYPH_CACHE_CHARSET);
+
+  /* Draws `text` with a transparent background and returns the x position after the last glyph.
+   * Same origin as GFX: top-left of the cell for the built-in font, baseline for GFXfonts.
+   * Characters outside the cache are rasterized from the cache's font on the spot; the font set
+   * on `g` is left alone. */
+  int16_t drawString(Adafruit_GFX &g, int16_t x, int16_t y, const char *text, uint16_t color,
+                     uint8_t size = 1) const;
+
+  /* Same, writing the runs straight into the canvas buffer (clipped to the canvas) */
+  int16_t drawString(GFXcanvas16 &canvas, int16_t x, int16_t y, const char *text, uint16_t color,
+                     uint8_t size = 1) const;
+
+  uint8_t glyphCount() const { return _glyphCount; }
+  uint16_t runCount() const { return _runCount; }
+
+private:
+  struct Run {
+    int8_t  x;    // relative to the GFX origin of the glyph
+    int8_t  y;
+    uint8_t len;
+  };
+
+  struct Glyph {
+    char     c;
+    uint8_t  advance;
+    uint16_t firstRun;
+    uint16_t runs;
+  };
+
+  /* Bitmap size and offset from the GFX origin, as drawChar() places the glyph */
+  struct Box {
+    int16_t w, h, ox, oy;
+    uint8_t advance;
+  };
+
+  bool glyphBox(char c, Box &box) const;
+  bool rasterize(char c);
+  const Glyph *find(char c) const;
+  int16_t drawUncached(Adafruit_GFX &g, int16_t x, int16_t y, char c, uint16_t color, uint8_t size) const;
+
+  const GFXfont *_font;
+  Glyph _glyphs[GLYPH_CACHE_MAX_GLYPHS];
+  uint8_t _glyphCount;
+  Run _runs[GLYPH_CACHE_MAX_RUNS];
+  uint16_t _runCount;
+};
+
+#endif // GLYPH_CACHE_H
@@ -0,0 +1,85 @@
+//=====================================================================================================//
+// HEAP AND STACK TELEMETRY
+// Free heap, the lowest free heap since boot, the largest free block and stack high-water marks,
+// sampled at the points where the alert path changes the heap the most: before the SMTP connect,
+// after the TLS handshake and after the send, plus once per loop() cycle as the steady-state
+// reference. Each phase keeps the mail client's HeapStat (current, min, max, drift) and the last
+// HEAP_HISTORY samples of all phases stay in a ring for the serial stats.
+//
+// Fragmentation is 1 - largest block / free heap, both of internal RAM. Free heap alone hides the
+// failure we actually hit: plenty free, but no block big enough for the TLS record buffers, so
+// smtp.connect() fails weeks after boot. Once the loop samples reach warnPct the heap sensor raises
+// a warning alert (ALERT_SENSOR_HEAP), cleared again below clearPct. The SMTP phases are
+// mid-session and do not count towards the alert.
+//=====================================================================================================//
+
+#ifndef HEAP_TELEMETRY_H
+#define HEAP_TELEMETRY_H
+
+#include <Arduino.h>
+#include <HeapStat.h>
+#include <atomic>
+#include <freertos/FreeRTOS.h>
+#include "metrics.h"
+
+#define HEAP_HISTORY     48     // samples kept, all phases together
+#define HEAP_WATCH_TASKS 12
+
+enum HeapPhase : uint8_t {
+  HEAP_PHASE_LOOP = 0,          // once per loop() cycle
+  HEAP_PHASE_PRE_CONNECT,       // SMTP worker, before the connect and the MFLN probe
+  HEAP_PHASE_POST_HANDSHAKE,    // SMTP worker, TLS up and logged in
+  HEAP_PHASE_POST_SEND,         // SMTP worker, message sent or given up
+  HEAP_PHASES
+};
+
+struct HeapSample {
+  uint32_t  uptimeS;
+  uint32_t  freeBytes;
+  uint32_t  largestBlock;
+  uint32_t  stackFree;          // high-water mark of the task that took the sample
+  HeapPhase phase;
+};
+
+class HeapTelemetry {
+public:
+  HeapTelemetry(uint8_t warnPct, uint8_t clearPct);
+
+  /* A few heap_caps calls and a ring write. Each phase is sampled by one task only. */
+  void sample(HeapPhase phase);
+
+  /* Stack marks are looked up by name when read, so a task that has exited just drops out */
+  bool watchTask(const char *name);
+
+  bool fragmented() const { return _fragmented.load(std::memory_order_relaxed); }
+  uint8_t fragmentationPct() const { return _fragPct.load(std::memory_order_relaxed); }
+  uint8_t warnPct() const { return _warnPct; }
+
+  HeapStat &phase(HeapPhase p) { return _stats[p]; }
+
+  /* The sample with the least free heap among the last HEAP_HISTORY; false while there are none */
+  bool lowest(HeapSample &out, size_t &window) const;
+
+  void writeMetrics(PromWriter &out);
+  void printStats(Print &out);
+
+  static const char *phaseName(HeapPhase p);
+
+private:
+  uint8_t _warnPct;
+  uint8_t _clearPct;
+  HeapStat _stats[HEAP_PHASES];
+  std::atomic<uint32_t> _largest[HEAP_PHASES];
+  std::atomic<uint8_t> _fragPct;
+  std::atomic<bool> _fragmented;
+
+  const char *_tasks[HEAP_WATCH_TASKS];
+  uint8_t _taskCount;
+
+  mutable portMUX_TYPE _lock;
+  HeapSample _ring[HEAP_HISTORY];
+  uint16_t _head;               // next slot to write
+  uint16_t _filled;
+};
+
+#endif // HEAP_TELEMETRY_H
@@ -0,0 +1,68 @@
+//=====================================================================================================//
+// LOG2 HISTOGRAM
+// Fixed-bucket power-of-two histogram for latencies. Bucket 0 counts values below 2^FIRST_SHIFT,
+// each next bucket doubles the bound, and the last bucket collects everything above.
+//
+// Counts are relaxed atomics, so another task (the /metrics scrape, a serial report) can read them
+// while the owner records. One writer per histogram: the 64-bit sum goes through a seqlock so a
+// reader never sees it torn. PromWriter::histogram() exports it in the Prometheus format.
+//=====================================================================================================//
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "seqlock_mailbox.h"
+
+template <uint8_t BUCKETS, uint8_t FIRST_SHIFT>
+class Log2Histogram {
+public:
+  Log2Histogram() : _localSum(0) {
+    for (uint8_t b = 0; b < BUCKETS; b++) _counts[b].store(0, std::memory_order_relaxed);
+  }
+
+  void observe(uint32_t value) {
+    uint8_t bucket = 0;
+    if (value >> FIRST_SHIFT) {
+      bucket = (32 - __builtin_clz(value)) - FIRST_SHIFT;
+      if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+    }
+    _counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    _localSum += value;
+    _sum.publish(_localSum);
+  }
+
+  static uint8_t buckets() { return BUCKETS; }
+  static uint32_t upperBound(uint8_t bucket) { return 1UL << (FIRST_SHIFT + bucket); }
+  uint32_t count(uint8_t bucket) const { return _counts[bucket].load(std::memory_order_relaxed); }
+
+  uint32_t total() const {
+    uint32_t n = 0;
+    for (uint8_t b = 0; b < BUCKETS; b++) n += count(b);
+    return n;
+  }
+
+  uint64_t sum() const {
+    uint64_t s = 0;
+    _sum.read(s);
+    return s;
+  }
+
+  /* Only populated buckets are printed: "  <64ms: 3  <128ms: 1" */
+  void print(Print &out, const char *unit) const {
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+      uint32_t n = count(b);
+      if (!n) continue;
+      if (b == BUCKETS - 1) out.printf("  >=%lu%s: %lu", (unsigned long)upperBound(b - 1), unit, (unsigned long)n);
+      else out.printf("  <%lu%s: %lu", (unsigned long)upperBound(b), unit, (unsigned long)n);
+    }
+  }
+
+private:
+  std::atomic<uint32_t> _counts[BUCKETS];
+  uint64_t _localSum;               // writer's copy
+  SeqlockMailbox<uint64_t> _sum;
+};
+
+#endif // HISTOGRAM_H
@@ -0,0 +1,69 @@
+//=====================================================================================================//
+// HTTP SERVER
+// Read-only HTTP API on the ESP-IDF httpd, which runs in its own task so requests never hold up
+// sampling:
+//   GET /now                          latest sample as JSON
+//   GET /history?from=&to=&res=       per-minute log as CSV, chunked; from/to are UTC seconds
+//                                     (negative = seconds before now), res is the bucket length
+//   GET /events                       Server-Sent Events feed of samples and alerts (live_feed.h)
+//   GET /metrics                      Prometheus metrics (metrics.h)
+// History is streamed straight from the LittleFS log through one fixed buffer, so a month of
+// data costs no more heap than a minute of it.
+//=====================================================================================================//
+
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include "metrics.h"
+#include "sample_log.h"
+#include "sensor_snapshot.h"
+#include "time_service.h"
+
+#define HTTP_PORT          80
+#define HTTP_TASK_STACK    6144
+#define HTTP_TASK_PRIORITY 2
+#define HTTP_CHUNK_SIZE    1024   // history is sent in chunks of at most this size
+#define HTTP_JSON_MAX      320    // one snapshot as JSON
+
+class LiveFeed;
+
+/* Writes the /metrics body; runs on the httpd task */
+typedef void (*MetricsFn)(PromWriter &out);
+
+/* The /now JSON body; also the payload of the live feed's events */
+size_t formatSnapshotJson(char *out, size_t len, const SensorSnapshot &snap, const TimeService &time,
+                          const char *tankName);
+
+class HttpServer {
+public:
+  HttpServer(const SensorMailbox &mailbox, SampleLog &log, const TimeService &time, const char *tankName);
+
+  /* Serves /events from `feed`; call before begin() */
+  void attachFeed(LiveFeed *feed) { _feed = feed; }
+  void attachMetrics(MetricsFn fn) { _metrics = fn; }
+
+  /* Needs the network up; later calls do nothing */
+  bool begin(uint16_t port = HTTP_PORT);
+  bool running() const { return _server != nullptr; }
+
+private:
+  static esp_err_t handleNow(httpd_req_t *req);
+  static esp_err_t handleHistory(httpd_req_t *req);
+  static esp_err_t handleEvents(httpd_req_t *req);
+  static esp_err_t handleMetrics(httpd_req_t *req);
+  static void onClose(httpd_handle_t server, int fd);
+  static bool sendChunk(void *arg, const char *data, size_t len);
+  void registerGet(const char *uri, esp_err_t (*handler)(httpd_req_t *));
+
+  const SensorMailbox &_mailbox;
+  SampleLog &_log;
+  const TimeService &_time;
+  const char *_tankName;
+  LiveFeed *_feed;
+  MetricsFn _metrics;
+  httpd_handle_t _server;
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,116 @@
+//=====================================================================================================//
+// I2C BUS MANAGER
+// All traffic on the shared Wire bus (LCD backpack at 0x27, and later AHT20, SSD1306/SH1106 and
+// seesaw boards) goes through one worker task that owns the bus. Callers from any task queue
+// transactions; the worker applies each device's clock speed before talking to it, merges queued
+// writes to the same device into one bus transaction, and keeps per-device counters and a latency
+// histogram (time from queueing to completion).
+//
+// Drivers that insist on calling Wire themselves (LiquidCrystal_I2C, Adafruit_I2CDevice in BusIO)
+// can still be serialized with run(), which executes a callback on the worker task.
+//=====================================================================================================//
+
+#ifndef I2C_BUS_H
+#define I2C_BUS_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include "histogram.h"
+
+#define I2C_MAX_DEVICES      6
+#define I2C_HIST_BUCKETS     12    // log2 buckets: <32us, <64us, ... , >=32ms
+#define I2C_QUEUE_LENGTH     16
+#define I2C_POST_SLOTS       8     // fire-and-forget writes in flight
+#define I2C_POST_MAX         96    // largest single posted write
+#define I2C_BATCH_MAX        256   // Wire's transmit buffer, raised from the ESP32's 128 in begin()
+#define I2C_TASK_PRIORITY    3     // above the display task so queued writes drain promptly
+#define I2C_TASK_STACK       3072
+
+struct I2cDeviceStats {
+  I2cDeviceStats() : transactions(0), requests(0), bytes(0), errors(0) {}
+
+  uint32_t transactions;   // bus transactions actually issued
+  uint32_t requests;       // requests queued (> transactions when writes were batched)
+  uint32_t bytes;
+  uint32_t errors;
+  Log2Histogram<I2C_HIST_BUCKETS, 5> latencyUs;
+};
+
+typedef void (*I2cBusFn)(TwoWire &wire, void *arg);
+
+class I2cBus {
+public:
+  explicit I2cBus(TwoWire &wire);
+
+  /* Starts Wire (default pins unless sda/scl are given) and the worker task */
+  bool begin(int sda = -1, int scl = -1);
+
+  /* Returns the device handle, or -1 when the table is full */
+  int8_t addDevice(const char *name, uint8_t address, uint32_t clockHz);
+
+  /* Blocking calls: return once the worker has finished the transaction */
+  bool write(int8_t dev, const uint8_t *data, size_t len);
+  bool read(int8_t dev, uint8_t *data, size_t len);
+  bool writeRead(int8_t dev, const uint8_t *out, size_t outLen, uint8_t *in, size_t inLen);
+  bool run(int8_t dev, I2cBusFn fn, void *arg, size_t bytesHint = 0);
+
+  /* Non-blocking write; data is copied. Adjacent posts to the same device are batched.
+   * Returns false if no slot is free within `waitMs`. */
+  bool post(int8_t dev, const uint8_t *data, size_t len, uint32_t waitMs = 20);
+
+  const I2cDeviceStats *stats(int8_t dev) const;
+  void printStats(Print &out) const;
+  UBaseType_t queueDepth() const;
+
+private:
+  enum Op : uint8_t { OP_WRITE, OP_READ, OP_WRITE_READ, OP_RUN, OP_POST };
+
+  struct Txn {
+    Op            op;
+    int8_t        dev;
+    bool          ok;
+    const uint8_t *out;
+    size_t        outLen;
+    uint8_t       *in;
+    size_t        inLen;
+    I2cBusFn      fn;
+    void          *arg;
+    uint32_t      queuedUs;
+    TaskHandle_t  waiter;
+    bool          done;     // set by the worker, with release order, before it notifies `waiter`
+  };
+
+  struct PostSlot {
+    Txn     txn;
+    uint8_t data[I2C_POST_MAX];
+  };
+
+  struct Device {
+    const char     *name;
+    uint8_t        address;
+    uint32_t       clockHz;
+    I2cDeviceStats stats;
+  };
+
+  static void taskMain(void *arg);
+  bool submit(Txn &txn);
+  void execute(Txn *txn);
+  void executeBatch(Txn *first);
+  void applyClock(const Device &d);
+  void record(Device &d, uint32_t queuedUs, size_t bytes, bool ok, bool newTransaction);
+  void release(Txn *txn);
+
+  TwoWire &_wire;
+  QueueHandle_t _queue;
+  QueueHandle_t _freeSlots;
+  PostSlot _slots[I2C_POST_SLOTS];
+  Device _devices[I2C_MAX_DEVICES];
+  uint8_t _deviceCount;
+  uint32_t _clockHz;
+  size_t _batchMax;
+};
+
+#endif // I2C_BUS_H
@@ -0,0 +1,38 @@
+//=====================================================================================================//
+// I2C LCD WRITER
+// Writes whole 16x2 LCD lines through the I2C bus manager. LiquidCrystal_I2C issues one I2C
+// transaction per PCF8574 byte (6 per character); here the setCursor command and the characters
+// of a line are encoded into one byte stream and posted as a single batched write.
+// begin() runs the HD44780 4-bit init sequence without LiquidCrystal_I2C's one-second delay.
+//=====================================================================================================//
+
+#ifndef I2C_LCD_H
+#define I2C_LCD_H
+
+#include <Arduino.h>
+#include "i2c_bus.h"
+
+#define I2C_LCD_ADDRESS 0x27
+#define I2C_LCD_CLOCK   100000   // PCF8574 backpacks are standard-mode only
+#define I2C_LCD_COLS    16
+
+class I2cLcd {
+public:
+  I2cLcd(I2cBus &bus, int8_t device);
+
+  /* Initialises the display (about 15 ms); the bus manager must be running */
+  bool begin();
+
+  /* Writes `text` (at most 16 characters) at the start of `row`; returns false if the bus was busy */
+  bool writeLine(uint8_t row, const char *text);
+
+private:
+  size_t encode(uint8_t *out, uint8_t value, bool data) const;
+  bool command(uint8_t value, uint32_t settleUs);
+  bool nibble(uint8_t value, uint32_t settleUs);
+
+  I2cBus &_bus;
+  int8_t _device;
+};
+
+#endif // I2C_LCD_H
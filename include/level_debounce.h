@@ -0,0 +1,58 @@
+//=====================================================================================================//
+// LEVEL / BUTTON DEBOUNCE
+// Integrating debounce for the liquid level and button pins. A pin is polled every
+// DEBOUNCE_PERIOD_MS; its stable level only flips after `limit` consecutive samples at the new
+// level, and each flip counts as one transition. A flip can ask for a wake-up, selected per pin
+// by the new level.
+//
+// This is the reference model of the ULP program in ulp_level_watch.cpp: the ULP keeps one
+// DebounceChannel per pin in RTC slow memory (one 32-bit word per field, value in the low 16 bits)
+// and runs the same steps as debounceStep(). It has no Arduino dependencies so it can be checked
+// off-target against recorded pin traces.
+//=====================================================================================================//
+
+#ifndef LEVEL_DEBOUNCE_H
+#define LEVEL_DEBOUNCE_H
+
+#include <stdint.h>
+
+#define DEBOUNCE_PERIOD_MS      20   // ULP timer period
+#define LEVEL_DEBOUNCE_SAMPLES  10   // level must hold 200 ms (sloshing when the tank is topped up)
+#define BUTTON_DEBOUNCE_SAMPLES 3    // 60 ms for the push button
+
+/* Wake masks: which new stable level wakes the main CPU */
+#define DEBOUNCE_WAKE_LOW  (1 << 0)
+#define DEBOUNCE_WAKE_HIGH (1 << 1)
+
+/* Field order is the ULP's word layout; do not reorder */
+struct DebounceChannel {
+  uint16_t stable;        // debounced level, 0 or 1
+  uint16_t run;           // consecutive samples that differed from `stable`
+  uint16_t transitions;   // stable flips, wraps at 65536
+};
+
+#define DEBOUNCE_WORDS 3   // words per channel in RTC slow memory
+
+inline void debounceReset(DebounceChannel &c, uint8_t level) {
+  c.stable = level ? 1 : 0;
+  c.run = 0;
+  c.transitions = 0;
+}
+
+/* One poll of one pin. Returns true when the stable level flipped to a level in `wakeMask`. */
+inline bool debounceStep(DebounceChannel &c, uint8_t sample, uint16_t limit, uint8_t wakeMask) {
+  sample = sample ? 1 : 0;
+  if (sample == c.stable) {
+    c.run = 0;
+    return false;
+  }
+  c.run++;
+  if (c.run < limit) return false;
+
+  c.stable = sample;
+  c.run = 0;
+  c.transitions++;
+  return (wakeMask >> sample) & 1;
+}
+
+#endif // LEVEL_DEBOUNCE_H
@@ -0,0 +1,88 @@
+//=====================================================================================================//
+// LIVE FEED
+// Server-Sent Events on /events: every new sample ("event: sample") and every alert status change
+// ("event: alert") is pushed to all subscribed browsers, so nobody needs to poll /now.
+//
+// Each update is formatted once, already framed as an HTTP chunk, into a small ring of shared
+// messages; the httpd task then writes the same bytes to every subscriber with non-blocking
+// sends. A subscriber whose socket is full keeps its place and resumes on the next update; one
+// that has fallen behind by whole messages skips straight to the latest (every event carries the
+// full snapshot), and those skipped messages are counted as drops. A subscriber still stuck
+// halfway through a message that has been overwritten is disconnected.
+//=====================================================================================================//
+
+#ifndef LIVE_FEED_H
+#define LIVE_FEED_H
+
+#include <Arduino.h>
+#include <esp_http_server.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "http_server.h"
+#include "sensor_snapshot.h"
+#include "time_service.h"
+
+#define SSE_MAX_CLIENTS 4     // leaves the other httpd sockets for /now and /history
+#define SSE_RING        4     // shared messages kept for subscribers that are mid-send
+#define SSE_MSG_MAX     (HTTP_JSON_MAX + 48)
+
+struct LiveFeedStats {
+  uint32_t published;      // messages formatted
+  uint32_t delivered;      // message copies fully sent
+  uint32_t bytes;
+  uint32_t subscribes;
+  uint32_t rejected;       // subscribers turned away, all slots taken
+  uint32_t wouldBlock;     // sends that found the socket buffer full (backpressure)
+  uint32_t partial;        // sends that only got part of a message out
+  uint32_t dropped;        // message copies skipped for slow subscribers
+  uint32_t slowCloses;     // subscribers dropped for falling a whole ring behind
+};
+
+class LiveFeed {
+public:
+  LiveFeed(const TimeService &time, const char *tankName);
+
+  /* Any task: formats the update once and hands delivery to the httpd task */
+  void publish(const SensorSnapshot &snap);
+
+  /* Used by HttpServer, on the httpd task */
+  void attach(httpd_handle_t server);
+  esp_err_t subscribe(httpd_req_t *req);
+  void onClose(int fd);
+
+  uint8_t clients() const { return _clientCount; }
+  const LiveFeedStats &stats() const { return _stats; }
+  void printStats(Print &out) const;
+
+private:
+  struct Message {
+    uint32_t seq;
+    uint16_t len;
+    char     data[SSE_MSG_MAX];
+  };
+
+  struct Client {
+    int      fd;           // -1 when the slot is free
+    uint32_t nextSeq;      // next message to send
+    uint16_t offset;       // bytes of nextSeq already sent
+    bool     closing;
+  };
+
+  static void pumpWork(void *arg);
+  void pump();
+  void deliver(Client &c);
+
+  const TimeService &_time;
+  const char *_tankName;
+  httpd_handle_t _server;
+  SemaphoreHandle_t _lock;         // ring and client table
+  Message _ring[SSE_RING];
+  uint32_t _latest;                // seq of the newest message, 0 before the first
+  uint64_t _lastSampleUs;
+  AlertStatus _lastAlert;
+  Client _clients[SSE_MAX_CLIENTS];
+  uint8_t _clientCount;
+  LiveFeedStats _stats;
+};
+
+#endif // LIVE_FEED_H
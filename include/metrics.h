@@ -0,0 +1,177 @@
+//=====================================================================================================//
+// METRICS
+// Counters and latency histograms for the Prometheus /metrics endpoint. The hot path only does
+// relaxed atomic increments in place; nothing is formatted or locked until a scrape, which reads
+// the same atomics from the httpd task. Gauges (heap, RSSI, queue depths, sensor values) are not
+// stored at all: the scrape callback reads them from their owners.
+//=====================================================================================================//
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "histogram.h"
+#include "seqlock_mailbox.h"
+
+#define METRICS_CHUNK_SIZE 1024
+
+class MetricCounter {
+public:
+  MetricCounter() : _value(0) {}
+  void inc(uint32_t n = 1) { _value.fetch_add(n, std::memory_order_relaxed); }
+  uint32_t value() const { return _value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<uint32_t> _value;
+};
+
+/* Log-linear buckets for durations that span several orders of magnitude: values below 2^SUB_BITS
+ * get a bucket each, every power of two above is split into 2^SUB_BITS equal steps, and the last
+ * bucket collects everything above. With SUB_BITS 2 a bucket is at most 25% of its lower bound
+ * wide. Same single-writer rule as Log2Histogram; the bucket is a clz and two shifts. */
+template <uint8_t SUB_BITS, uint8_t BUCKETS>
+class LogLinearHistogram {
+public:
+  LogLinearHistogram() : _max(0), _localSum(0) {
+    for (uint8_t b = 0; b < BUCKETS; b++) _counts[b].store(0, std::memory_order_relaxed);
+  }
+
+  void observe(uint32_t value) {
+    uint32_t bucket = value;
+    if (value >> SUB_BITS) {
+      uint8_t exp = 31 - __builtin_clz(value);
+      bucket = ((exp - SUB_BITS + 1) << SUB_BITS) | ((value >> (exp - SUB_BITS)) & (SUB - 1));
+    }
+    if (bucket >= BUCKETS) bucket = BUCKETS - 1;
+    /* One writer: a load and a store, no read-modify-write */
+    _counts[bucket].store(_counts[bucket].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (value > _max.load(std::memory_order_relaxed)) _max.store(value, std::memory_order_relaxed);
+    _localSum += value;
+    _sum.publish(_localSum);
+  }
+
+  static uint8_t buckets() { return BUCKETS; }
+  static uint32_t lowerBound(uint8_t bucket) {
+    if (bucket < SUB) return bucket;
+    uint8_t shift = (bucket >> SUB_BITS) - 1;
+    return (uint32_t)(SUB | (bucket & (SUB - 1))) << shift;
+  }
+  static uint32_t upperBound(uint8_t bucket) {
+    if (bucket < SUB) return bucket + 1;
+    return lowerBound(bucket) + (1UL << ((bucket >> SUB_BITS) - 1));
+  }
+  uint32_t count(uint8_t bucket) const { return _counts[bucket].load(std::memory_order_relaxed); }
+  uint32_t max() const { return _max.load(std::memory_order_relaxed); }
+
+  uint32_t total() const {
+    uint32_t n = 0;
+    for (uint8_t b = 0; b < BUCKETS; b++) n += count(b);
+    return n;
+  }
+
+  /* Upper bound of the bucket holding the q-th quantile (0..1), capped at max(); 0 while empty */
+  uint32_t quantile(float q) const {
+    uint32_t n = total();
+    if (!n) return 0;
+    uint32_t rank = (uint32_t)(q * n + 0.5f), seen = 0;
+    if (rank < 1) rank = 1;
+    for (uint8_t b = 0; b < BUCKETS; b++) {
+      seen += count(b);
+      if (seen < rank) continue;
+      uint32_t top = upperBound(b) - 1;
+      return b + 1 < BUCKETS && top < max() ? top : max();
+    }
+    return max();
+  }
+
+  uint64_t sum() const {
+    uint64_t s = 0;
+    _sum.read(s);
+    return s;
+  }
+
+private:
+  static const uint32_t SUB = 1UL << SUB_BITS;
+
+  std::atomic<uint32_t> _counts[BUCKETS];
+  std::atomic<uint32_t> _max;
+  uint64_t _localSum;               // writer's copy
+  SeqlockMailbox<uint64_t> _sum;
+};
+
+typedef bool (*MetricsSink)(void *arg, const char *data, size_t len);
+
+/* Prometheus text format (version 0.0.4), written through a fixed buffer in chunks */
+class PromWriter {
+public:
+  PromWriter(char *buf, size_t len, MetricsSink sink, void *arg);
+
+  /* "# HELP" and "# TYPE" lines; follow with one or more sample() calls */
+  void family(const char *name, const char *type, const char *help);
+  void sample(const char *name, const char *labels, double value);
+  void sample(const char *name, const char *labels, uint64_t value);
+
+  void counter(const char *name, const char *help, uint64_t value);
+  void gauge(const char *name, const char *help, double value);
+
+  /* `unitSeconds` converts the histogram's unit to seconds for the bounds and the sum */
+  template <uint8_t B, uint8_t S>
+  void histogram(const char *name, const char *help, const Log2Histogram<B, S> &h, double unitSeconds) {
+    family(name, "histogram", help);
+    histogramSeries(name, nullptr, h, unitSeconds);
+  }
+
+  /* One labelled series of a histogram family, e.g. labels "sink=\"smtp\"" */
+  template <uint8_t B, uint8_t S>
+  void histogramSeries(const char *name, const char *labels, const Log2Histogram<B, S> &h, double unitSeconds) {
+    uint64_t cumulative = 0;
+    if (!labels) labels = "";
+    for (uint8_t b = 0; b + 1 < B; b++) {
+      cumulative += h.count(b);
+      bucketLine(name, labels, h.upperBound(b) * unitSeconds, cumulative);
+    }
+    cumulative += h.count(B - 1);
+    bucketLine(name, labels, INFINITY, cumulative);
+    suffixed(name, "_sum", labels, h.sum() * unitSeconds);
+    suffixed(name, "_count", labels, cumulative);
+  }
+
+  /* Log-linear series list the populated buckets only, as each one is "le" its largest value: a
+   * hundred buckets per series would swamp the scrape. Counts never go back to zero, so a bucket
+   * line, once it appears, stays. */
+  template <uint8_t SUB_BITS, uint8_t B>
+  void histogramSeries(const char *name, const char *labels, const LogLinearHistogram<SUB_BITS, B> &h,
+                       double unitSeconds) {
+    uint64_t cumulative = 0;
+    if (!labels) labels = "";
+    for (uint8_t b = 0; b + 1 < B; b++) {
+      uint32_t n = h.count(b);
+      if (!n) continue;
+      cumulative += n;
+      bucketLine(name, labels, (h.upperBound(b) - 1) * unitSeconds, cumulative);
+    }
+    cumulative += h.count(B - 1);
+    bucketLine(name, labels, INFINITY, cumulative);
+    suffixed(name, "_sum", labels, h.sum() * unitSeconds);
+    suffixed(name, "_count", labels, cumulative);
+  }
+
+  /* Sends what is left; false if the sink gave up at any point */
+  bool finish();
+
+private:
+  void append(const char *format, ...) __attribute__((format(printf, 2, 3)));
+  void bucketLine(const char *name, const char *labels, double le, uint64_t value);
+  void suffixed(const char *name, const char *suffix, const char *labels, double value);
+  void suffixed(const char *name, const char *suffix, const char *labels, uint64_t value);
+
+  char *_buf;
+  size_t _len;
+  size_t _used;
+  MetricsSink _sink;
+  void *_arg;
+  bool _ok;
+};
+
+#endif // METRICS_H
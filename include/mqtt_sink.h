@@ -0,0 +1,111 @@
+//=====================================================================================================//
+// MQTT SINK
+// Telemetry and alert state over MQTT, next to the SMTP alerts. Every sample is published as a
+// compact JSON message on <base>/telemetry; the liquid level, temperature and heap alerts are retained
+// {"active":1|0} messages on <base>/alert/<kind>, published on each change, so a dashboard that
+// subscribes later still sees the current state. <base> is "crystaltronics/<tank>", with the tank name lower-cased.
+//
+// Uses the ESP-IDF MQTT client that ships with the Arduino core (its own task, reconnects by
+// itself). Everything goes out with QoS 1 on a persistent session (fixed client id, clean session
+// off), so messages queued while the broker was unreachable are delivered after the reconnect.
+// At most MQTT_INFLIGHT_MAX telemetry messages wait for their PUBACK; telemetry beyond that is
+// dropped rather than queued up, alerts always go out. The broker's last will marks <base>/status
+// "offline" when the board disappears.
+//=====================================================================================================//
+
+#ifndef MQTT_SINK_H
+#define MQTT_SINK_H
+
+#include <Arduino.h>
+#include <mqtt_client.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "metrics.h"
+#include "sensor_snapshot.h"
+#include "time_service.h"
+
+#define MQTT_INFLIGHT_MAX     8       // QoS 1 messages waiting for a PUBACK
+#define MQTT_INFLIGHT_TIMEOUT 30000   // ms; matches the client's outbox expiry
+#define MQTT_ALERT_TIMEOUT_MS 5000    // sendAlert() wait for the PUBACK
+#define MQTT_KEEPALIVE_S      60
+#define MQTT_TOPIC_MAX        64
+#define MQTT_PAYLOAD_MAX      112
+
+enum MqttAlert : uint8_t {
+  MQTT_ALERT_LIQUID_LOW = 0,
+  MQTT_ALERT_TEMPERATURE,
+  MQTT_ALERT_HEAP,
+  MQTT_ALERT_KINDS
+};
+
+struct MqttStats {
+  uint32_t connects;
+  uint32_t disconnects;
+  uint32_t telemetry;      // telemetry messages queued
+  uint32_t alerts;         // alert state changes queued
+  uint32_t acked;          // PUBACKs received
+  uint32_t dropped;        // telemetry skipped, in-flight window full
+  uint32_t expired;        // given up on by the client before a PUBACK came
+  uint32_t alertTimeouts;  // sendAlert() returned before the PUBACK
+  uint32_t bytes;          // payload bytes queued
+};
+
+class MqttSink {
+public:
+  MqttSink(const TimeService &time, const char *tankName);
+
+  /* Once Wi-Fi is up; e.g. "mqtt://192.168.1.10:1883". Credentials may be null. */
+  bool begin(const char *brokerUri, const char *username = nullptr, const char *password = nullptr);
+  bool connected() const { return _connected; }
+
+  /* Every sample; never blocks (the MQTT task does the sending) */
+  void publishSample(const SensorSnapshot &snap);
+
+  /* Same role as sendEmail(): publishes the alert state if it changed and waits for the broker's
+   * PUBACK. Returns true once the broker has acknowledged the current state; until then every
+   * call waits for the same queued message again rather than reporting it delivered. */
+  bool sendAlert(MqttAlert kind, bool active, uint64_t sampleUs);
+
+  uint8_t inflight() const { return _inflightCount; }
+  const MqttStats &stats() const { return _stats; }
+  const Log2Histogram<12, 10> &ackUs() const { return _ackUs; }
+  void printStats(Print &out) const;
+
+private:
+  struct Inflight {
+    int      msgId;        // 0 when the slot is free
+    uint64_t queuedUs;
+  };
+
+  struct AlertState {
+    int8_t   acked;        // state the broker acknowledged, -1 until the first PUBACK
+    int8_t   queued;       // state of the message below
+    int      msgId;        // retained publish waiting for its PUBACK, 0 when none
+    uint64_t queuedUs;
+  };
+
+  static void eventHandler(void *arg, esp_event_base_t base, int32_t eventId, void *eventData);
+  void onEvent(esp_mqtt_event_handle_t event);
+  int enqueue(const char *topic, const char *payload, int len);
+  int enqueueAlert(MqttAlert kind, int8_t state, const char *topic, const char *payload, int len, bool waitAck);
+  void acked(int msgId, bool delivered);
+  int formatStamp(char *buf, size_t len, uint64_t sampleUs) const;
+
+  const TimeService &_time;
+  esp_mqtt_client_handle_t _client;
+  SemaphoreHandle_t _lock;         // in-flight table and alert states
+  SemaphoreHandle_t _ackSignal;    // given when _waitMsgId is acked
+  volatile int _waitMsgId;
+  volatile bool _connected;
+  uint64_t _startUs;
+  char _base[MQTT_TOPIC_MAX - 24];
+  char _statusTopic[MQTT_TOPIC_MAX];
+  char _clientId[24];
+  AlertState _alerts[MQTT_ALERT_KINDS];   // under _lock
+  Inflight _inflight[MQTT_INFLIGHT_MAX];
+  uint8_t _inflightCount;
+  MqttStats _stats;
+  Log2Histogram<12, 10> _ackUs;        // queued to PUBACK, 1 ms ... >= 2 s
+};
+
+#endif // MQTT_SINK_H
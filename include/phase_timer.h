@@ -0,0 +1,110 @@
+//=====================================================================================================//
+// PHASE TIMERS
+// Durations of the phases of a sample, an email and a display frame, in microseconds from
+// esp_timer_get_time(), each kept in a log-linear histogram (1 us steps up to 4 us, then four
+// steps per power of two, up to about a minute). The cycle counter would be cheaper to read, but
+// it is per core and only the display task is pinned, so a probe on any other task could start on
+// one core and end on the other.
+//
+//   PHASE_TIME(PHASE_LCD);                  // from here to the end of the scope
+//   PHASE_TIMER(connect, PHASE_SMTP_CONNECT);
+//   ...
+//   PHASE_STOP(connect);                    // records now instead of at the end of the scope
+//
+// A probe is two clock reads, a clz and a few stores into the phase's histogram. Each phase is
+// timed from one task only (the histograms have a single writer). calibrate() times a run of
+// probes at boot and the per-probe cost is shown in the stats and on /metrics. Build with
+// -DPHASE_TIMING=0 to compile every probe, the histograms and the stats out.
+//=====================================================================================================//
+
+#ifndef PHASE_TIMER_H
+#define PHASE_TIMER_H
+
+#ifndef PHASE_TIMING
+#define PHASE_TIMING 1
+#endif
+
+#if (PHASE_TIMING)
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "metrics.h"
+
+#define PHASE_HIST_BUCKETS     100   // the last one takes everything from 58.7 s up
+#define PHASE_CALIBRATE_PROBES 256
+
+enum TimedPhase : uint8_t {
+  PHASE_LOOP = 0,                 // loop(), after the wait for the next sample
+  PHASE_DHT_TEMPERATURE,
+  PHASE_DHT_HUMIDITY,
+  PHASE_ALERTS,                   // raiseAlerts(): evaluate and queue for the sinks
+  PHASE_PUBLISH,                  // mailbox, live feed and MQTT
+  PHASE_SAMPLE_LOG,
+  PHASE_STATS_DUMP,               // the periodic stats block
+  PHASE_EMAIL,                    // SmtpAlertSink::deliver(), start to finish
+  PHASE_SMTP_CONNECT,             // TCP, TLS handshake and login
+  PHASE_SMTP_SEND,
+  PHASE_LCD,                      // one LCD frame, I2C writes included
+  PHASE_TFT,                      // one TFT dashboard frame
+  TIMED_PHASES
+};
+
+typedef LogLinearHistogram<2, PHASE_HIST_BUCKETS> PhaseHistogram;
+
+class PhaseTimers {
+public:
+  PhaseTimers() : _probeNs(0) {}
+
+  void record(TimedPhase phase, uint32_t us) { _hist[phase].observe(us); }
+  static uint32_t now() { return (uint32_t)esp_timer_get_time(); }
+
+  /* Times PHASE_CALIBRATE_PROBES empty probes into a scratch histogram */
+  void calibrate();
+  uint32_t probeNs() const { return _probeNs; }
+
+  const PhaseHistogram &histogram(TimedPhase phase) const { return _hist[phase]; }
+
+  void writeMetrics(PromWriter &out);
+  void printStats(Print &out);
+
+  static const char *phaseName(TimedPhase phase);
+
+private:
+  PhaseHistogram _hist[TIMED_PHASES];
+  uint32_t _probeNs;
+};
+
+extern PhaseTimers phaseTimers;
+
+class ScopedPhaseTimer {
+public:
+  explicit ScopedPhaseTimer(TimedPhase phase) : _phase(phase), _start(PhaseTimers::now()), _running(true) {}
+  ~ScopedPhaseTimer() { stop(); }
+
+  void stop() {
+    if (!_running) return;
+    _running = false;
+    phaseTimers.record(_phase, PhaseTimers::now() - _start);
+  }
+
+private:
+  TimedPhase _phase;
+  uint32_t _start;
+  bool _running;
+};
+
+#define PHASE_TIMER_CONCAT2(a, b) a##b
+#define PHASE_TIMER_CONCAT(a, b)  PHASE_TIMER_CONCAT2(a, b)
+#define PHASE_TIME(phase)         ScopedPhaseTimer PHASE_TIMER_CONCAT(phaseTimer, __LINE__)(phase)
+#define PHASE_TIMER(name, phase)  ScopedPhaseTimer name(phase)
+#define PHASE_STOP(name)          name.stop()
+
+#else
+
+#define PHASE_TIME(phase)        (void)0
+#define PHASE_TIMER(name, phase) (void)0
+#define PHASE_STOP(name)         (void)0
+
+#endif // PHASE_TIMING
+
+#endif // PHASE_TIMER_H
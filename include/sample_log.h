@@ -0,0 +1,110 @@
+//=====================================================================================================//
+// SAMPLE LOG
+// Per-minute rollups of the sensor samples (average/min/max temperature, average humidity, how
+// many samples saw a low liquid level) appended to LittleFS as fixed 16-byte records, so a time
+// range can be found by binary search and streamed out in small blocks. Two files are kept:
+// when the current one reaches SAMPLE_LOG_FILE_MAX it replaces the old one, which keeps 20 to 40
+// days of history.
+//
+// Records are only written once UTC is known (TimeService). Until then closed rollups wait in a
+// small RAM queue with their monotonic timestamp and are converted when the clock syncs, so the
+// minutes after boot are not lost or mis-dated.
+//=====================================================================================================//
+
+#ifndef SAMPLE_LOG_H
+#define SAMPLE_LOG_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include "sensor_snapshot.h"
+#include "time_service.h"
+
+#define SAMPLE_LOG_PATH       "/history.bin"
+#define SAMPLE_LOG_OLD_PATH   "/history.old"
+#define SAMPLE_LOG_INTERVAL_S 60            // rollup length
+#define SAMPLE_LOG_FILE_MAX   (448 * 1024)  // 28672 records, ~20 days per file
+#define SAMPLE_LOG_PENDING    64            // rollups held in RAM before the clock is set
+#define SAMPLE_LOG_READ_BLOCK 32            // records read per file access while streaming
+
+#define LOG_TEMP_NONE INT16_MIN
+#define LOG_HUM_NONE  UINT16_MAX
+
+struct LogRecord {
+  uint32_t time;        // UTC seconds at the start of the interval
+  int16_t  tempAvg;     // deg C x100, LOG_TEMP_NONE if no valid reading
+  int16_t  tempMin;
+  int16_t  tempMax;
+  uint16_t humAvg;      // %RH x100, LOG_HUM_NONE if no valid reading
+  uint8_t  samples;
+  uint8_t  liquidLow;   // samples that saw a low level
+  uint16_t reserved;
+};
+
+struct SampleLogStats {
+  uint32_t written;
+  uint32_t dropped;     // pending queue overflowed before the clock was set
+  uint32_t writeErrors;
+  uint32_t deferred;    // writes postponed because a reader held the files
+  uint32_t rotations;
+};
+
+/* Receives formatted output while streaming; returns false to stop (e.g. the client went away) */
+typedef bool (*SampleLogSink)(void *arg, const char *data, size_t len);
+
+class SampleLog {
+public:
+  SampleLog(fs::FS &fs, const TimeService &time);
+
+  bool begin();
+
+  /* loop() calls this with every sample; closes and writes rollups as they complete */
+  void add(const SensorSnapshot &snap);
+
+  /* Streams the records in [from, to] (UTC seconds) as CSV through `sink`, merged into buckets
+   * of `res` seconds (at least SAMPLE_LOG_INTERVAL_S). Output goes out in pieces of at most
+   * `bufLen` bytes formatted in `buf`; nothing is held on the heap. Returns false if the sink
+   * gave up. */
+  bool stream(uint32_t from, uint32_t to, uint32_t res, SampleLogSink sink, void *arg, char *buf, size_t bufLen);
+
+  uint8_t pending() const { return _pendingCount; }
+  const SampleLogStats &stats() const { return _stats; }
+  void printStats(Print &out) const;
+
+private:
+  struct Accumulator {
+    uint64_t startUs;
+    int32_t  tempSum;
+    uint32_t humSum;
+    int16_t  tempMin;
+    int16_t  tempMax;
+    uint8_t  tempCount;
+    uint8_t  humCount;
+    uint8_t  samples;
+    uint8_t  liquidLow;
+  };
+
+  struct Pending {
+    LogRecord record;
+    uint64_t  startUs;   // monotonic; record.time is filled in once UTC is known
+  };
+
+  void close();
+  void flushPending();
+  bool append(const LogRecord &record);
+  static size_t lowerBound(File &file, size_t count, uint32_t from);
+
+  fs::FS &_fs;
+  const TimeService &_time;
+  SemaphoreHandle_t _lock;    // file access: loop() appends and rotates, the HTTP task streams
+  bool _ready;
+  size_t _fileBytes;
+  Accumulator _acc;
+  Pending _pending[SAMPLE_LOG_PENDING];
+  uint8_t _pendingHead;
+  uint8_t _pendingCount;
+  SampleLogStats _stats;
+};
+
+#endif // SAMPLE_LOG_H
@@ -0,0 +1,34 @@
+//=====================================================================================================//
+// SENSOR SNAPSHOT
+// One complete sample as published by loop() and read by the display task and the HTTP server.
+//=====================================================================================================//
+
+#ifndef SENSOR_SNAPSHOT_H
+#define SENSOR_SNAPSHOT_H
+
+#include <stdint.h>
+#include "seqlock_mailbox.h"
+
+/* Temperature threshold (deg C); outside of it an alert is sent */
+#define TEMP_LOW_THRESHOLD  20
+#define TEMP_HIGH_THRESHOLD 40
+
+enum AlertStatus : uint8_t {
+  ALERT_NONE = 0,
+  ALERT_SENDING,   // email is being sent
+  ALERT_SENT,
+  ALERT_FAILED
+};
+
+struct SensorSnapshot {
+  uint64_t    sampleUs;     // TimeService::monoUs() when the sample was taken
+  float       temperature;  // deg C, NAN when the read failed
+  float       humidity;     // %RH, NAN when the read failed
+  bool        liquidLow;
+  bool        tempAlert;    // temperature outside the threshold
+  AlertStatus alert;
+};
+
+typedef SeqlockMailbox<SensorSnapshot> SensorMailbox;
+
+#endif // SENSOR_SNAPSHOT_H
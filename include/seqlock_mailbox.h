@@ -0,0 +1,72 @@
+//=====================================================================================================//
+// SEQLOCK MAILBOX
+// Single-writer, multi-reader "latest value" slot. The writer never blocks: it bumps the sequence
+// to odd, copies the value in, and bumps it back to even. A reader copies the value out and retries
+// if the sequence was odd or changed under it (a torn read). The payload is stored as relaxed
+// atomic words so the concurrent copy is well defined; T must be trivially copyable.
+//=====================================================================================================//
+
+#ifndef SEQLOCK_MAILBOX_H
+#define SEQLOCK_MAILBOX_H
+
+#include <atomic>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+template <typename T>
+class SeqlockMailbox {
+  static_assert(std::is_trivially_copyable<T>::value, "SeqlockMailbox needs a trivially copyable type");
+
+public:
+  SeqlockMailbox() : _seq(0), _retries(0) {
+    for (size_t i = 0; i < WORDS; i++) _words[i].store(0, std::memory_order_relaxed);
+  }
+
+  /* Writer side, one task only */
+  void publish(const T &value) {
+    uint32_t buf[WORDS] = {};
+    memcpy(buf, &value, sizeof(T));
+
+    uint32_t seq = _seq.load(std::memory_order_relaxed);
+    _seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; i++) _words[i].store(buf[i], std::memory_order_relaxed);
+    _seq.store(seq + 2, std::memory_order_release);
+  }
+
+  /* Copies the latest value into `out`. Returns false if nothing has been published yet.
+   * `version` (optional) receives a counter that changes with every publish. */
+  bool read(T &out, uint32_t *version = nullptr) const {
+    uint32_t buf[WORDS];
+    uint32_t before, after;
+
+    for (;;) {
+      before = _seq.load(std::memory_order_acquire);
+      if (!(before & 1)) {
+        for (size_t i = 0; i < WORDS; i++) buf[i] = _words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = _seq.load(std::memory_order_relaxed);
+        if (before == after) break;
+      }
+      _retries.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (version) *version = before >> 1;
+    if (before == 0) return false;
+    memcpy(&out, buf, sizeof(T));
+    return true;
+  }
+
+  uint32_t version() const { return _seq.load(std::memory_order_acquire) >> 1; }
+  uint32_t tornReads() const { return _retries.load(std::memory_order_relaxed); }
+
+private:
+  static const size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+  std::atomic<uint32_t> _seq;
+  std::atomic<uint32_t> _words[WORDS];
+  mutable std::atomic<uint32_t> _retries;
+};
+
+#endif // SEQLOCK_MAILBOX_H
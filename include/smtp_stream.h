@@ -0,0 +1,65 @@
+//=====================================================================================================//
+// SMTP MESSAGE STREAM
+// Sends a message that is generated while it goes out, e.g. an alert with the sample history
+// attached, without building it in RAM or in a temp file first. It runs on ESP Mail Client's
+// session (connection, TLS and the custom command interface) but writes the message itself:
+// EHLO, AUTH PLAIN, MAIL FROM, RCPT TO, then the message through a fixed chunk buffer.
+//
+// When the server offers CHUNKING (RFC 3030) each full buffer goes out as one BDAT chunk, so
+// nothing has to be dot-stuffed or scanned; otherwise it falls back to DATA. Callers write whole
+// CRLF-terminated lines: a chunk is only ever cut at a write boundary, and the last two bytes of
+// each BDAT chunk go out with the command that collects the server's reply.
+//=====================================================================================================//
+
+#ifndef SMTP_STREAM_H
+#define SMTP_STREAM_H
+
+#include <Arduino.h>
+#include <ESP_Mail_Client.h>
+
+#define SMTP_STREAM_CHUNK_MIN 128
+
+class SmtpStream {
+public:
+  /* `buf` is the chunk buffer; 1 KB or more keeps the number of BDAT round trips low */
+  SmtpStream(SMTPSession &smtp, char *buf, size_t len);
+
+  /* Connects and logs in with `session`'s credentials, then opens a message for `recipient` */
+  bool begin(ESP_Mail_Session &session, const char *sender, const char *recipient, bool allowChunking = true);
+
+  /* Message text, headers included; whole CRLF-terminated lines only */
+  bool write(const char *data, size_t len);
+  bool print(const char *text) { return write(text, strlen(text)); }
+  bool printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+  /* Last chunk (or the terminating "."), then QUIT. False if the server did not accept the message. */
+  bool end();
+
+  /* Drops the session after a failure on the caller's side */
+  void abort();
+
+  bool chunking() const { return _chunking; }
+  size_t bytes() const { return _bytes; }
+  int lastStatus() const { return _status; }
+
+  /* For SampleLogSink / Base64Sink callers, `arg` is the SmtpStream */
+  static bool sink(void *arg, const char *data, size_t len);
+
+private:
+  bool open(ESP_Mail_Session &session, const char *sender, const char *recipient, bool allowChunking);
+  int command(const char *cmd);
+  bool sendChunk(const char *data, size_t len, bool last);
+  bool flush(bool last);
+  static void onResponse(SMTP_Response res);
+
+  SMTPSession &_smtp;
+  char *_buf;
+  size_t _len;
+  size_t _used;
+  bool _ok;
+  bool _chunking;
+  size_t _bytes;
+  int _status;
+};
+
+#endif // SMTP_STREAM_H
@@ -0,0 +1,91 @@
+//=====================================================================================================//
+// TFT DASHBOARD (ESP32-S3 build only)
+// Draws live values, a temperature trend chart and an alert banner on an ST7789 TFT.
+//
+// The frame is rendered in horizontal bands into two GFXcanvas16 line buffers. While one band
+// is pushed to the panel with Adafruit_SPITFT::writePixels() by a flush task on the other core,
+// the next band is drawn into the second buffer, so drawing and the SPI transfer overlap.
+//=====================================================================================================//
+
+#ifndef TFT_DASHBOARD_H
+#define TFT_DASHBOARD_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/semphr.h>
+#include "glyph_cache.h"
+#include "sensor_snapshot.h"
+
+/* TFT wiring, override with build_flags if the panel is wired differently */
+#ifndef TFT_CS
+#define TFT_CS   10
+#endif
+#ifndef TFT_DC
+#define TFT_DC   7
+#endif
+#ifndef TFT_RST
+#define TFT_RST  6
+#endif
+
+#define TFT_WIDTH        320  // landscape (rotation 1) of a 240x320 ST7789
+#define TFT_HEIGHT       240
+#define TFT_BAND_HEIGHT  20   // rows per line buffer; TFT_HEIGHT must be a multiple of this
+#define TFT_TREND_POINTS 150  // samples kept for the trend chart
+
+struct DashboardFrameStats {
+  uint32_t frames;
+  uint32_t lastUs;     // full frame, first band drawn to last band on the panel
+  uint32_t minUs;
+  uint32_t maxUs;
+  uint64_t totalUs;
+  uint32_t drawUs;     // time spent drawing into the line buffers in the last frame
+};
+
+class TftDashboard {
+public:
+  TftDashboard(Adafruit_ST7789 &tft, const char *title);
+
+  bool begin(uint32_t spiFreq = 40000000);
+  void pushSample(const SensorSnapshot &sample);
+  void render();
+
+  /* Renders `frames` frames back to back and prints the frame-time statistics,
+   * followed by the numeric readout redraw time with and without the glyph cache */
+  void runBenchmark(Print &out, uint16_t frames = 50);
+  void printStats(Print &out) const;
+  const DashboardFrameStats &stats() const { return _stats; }
+
+  /* Draws the rows from y0 down into a canvas of any height (used for the line buffers) */
+  void drawBand(GFXcanvas16 &canvas, int16_t y0) const;
+
+private:
+  struct BandJob {
+    uint8_t  buffer;
+    uint16_t y0;
+  };
+
+  static void flushTask(void *arg);
+  void drawBanner(Adafruit_GFX &g, int16_t y0) const;
+  void drawValues(GFXcanvas16 &g, int16_t y0) const;
+  void drawTrend(Adafruit_GFX &g, int16_t y0) const;
+
+  Adafruit_ST7789 &_tft;
+  const char *_title;
+  GlyphCache _digits;
+  GFXcanvas16 *_band[2];
+  QueueHandle_t _jobs;
+  SemaphoreHandle_t _free[2];
+
+  SensorSnapshot _latest;
+  bool _hasSample;
+  float _trend[TFT_TREND_POINTS];
+  uint16_t _trendHead;
+  uint16_t _trendCount;
+
+  DashboardFrameStats _stats;
+};
+
+#endif // TFT_DASHBOARD_H
@@ -0,0 +1,66 @@
+//=====================================================================================================//
+// TIME SERVICE
+// One clock for samples, logs and alerts. Every timestamp is taken from the 64-bit monotonic
+// microsecond timer (esp_timer, no 49-day wrap like millis()) and mapped to UTC on output.
+// SNTP runs in the background; when a sync arrives the UTC offset is published through a seqlock,
+// so reading or converting a timestamp never blocks. Timestamps taken before the first sync are
+// converted with the same offset, i.e. they are backfilled automatically.
+//
+// Records stamped with the wall clock instead (the RTC-retained duty-cycle samples, where the
+// monotonic timer restarts on every wake) can be corrected with firstStepUs(): the amount the
+// first sync moved the wall clock.
+//=====================================================================================================//
+
+#ifndef TIME_SERVICE_H
+#define TIME_SERVICE_H
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "seqlock_mailbox.h"
+
+#define TIME_NTP_SERVER     "pool.ntp.org"
+#define TIME_VALID_AFTER_S  1600000000UL  // wall clock below this (Sep 2020) has never been set
+
+struct TimeSync {
+  int64_t  offsetUs;        // UTC = monotonic + offsetUs
+  int64_t  firstStepUs;     // wall clock change at the first sync, 0 if it was already set
+  uint64_t lastSyncMonoUs;
+  uint32_t syncs;
+};
+
+class TimeService {
+public:
+  TimeService();
+
+  /* Starts SNTP without waiting for it. Needs the network stack up (call after Wi-Fi connects);
+   * later calls do nothing. */
+  void begin(const char *server = TIME_NTP_SERVER);
+
+  static uint64_t monoUs() { return (uint64_t)esp_timer_get_time(); }
+  static bool wallClockValid();
+
+  /* True once SNTP synced during this boot */
+  bool synced() const;
+
+  /* UTC in microseconds for a monoUs() timestamp, 0 while the time is unknown */
+  int64_t utcUs(uint64_t mono) const;
+  int64_t nowUtcUs() const { return utcUs(monoUs()); }
+  int64_t firstStepUs() const;
+
+  /* "2025-08-01 12:00:00.123Z", or "T+1234.567s" (since boot) while the time is unknown */
+  size_t format(char *buf, size_t len, uint64_t mono) const;
+
+  void printStatus(Print &out) const;
+
+private:
+  static void onSync(struct timeval *tv);
+
+  SeqlockMailbox<TimeSync> _sync;
+  int64_t _wallAnchorUs;     // wall clock and monotonic timer read together in begin(),
+  uint64_t _monoAnchorUs;    // to tell how far the first sync moved the wall clock
+  bool _started;
+
+  static TimeService *_instance;
+};
+
+#endif // TIME_SERVICE_H
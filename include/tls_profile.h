@@ -0,0 +1,57 @@
+//=====================================================================================================//
+// TLS HANDSHAKE PROFILES AND RECORD BUFFERS
+// Cipher suites and BearSSL engines for the SMTP connection, passed to the mail client through
+// Session_Config::secure.profile. The library default offers every suite BearSSL has, so a server
+// with both kinds of certificate (as the large mail providers have) may answer with an ECDSA chain
+// up to a P-384 root: the slowest thing a handshake can make this CPU verify, and more peak stack
+// than an RSA chain.
+//  - TLS_PROFILE_RSA:    ECDHE authenticated with RSA only, ChaCha20-Poly1305 before AES-128-GCM,
+//                        and only the X25519 and P-256 curves, which have engines of their own;
+//                        the rest are the defaults BearSSL already picks for a 32-bit CPU
+//  - TLS_PROFILE_COMPAT: the library defaults, for servers that only have an ECDSA certificate
+//                        or no ECDHE-RSA suite; the default, since it works with any server
+// On an RSA-only server both cost the same CPU, and the RSA profile needs about 500 B less peak stack.
+// On a server with both chains, the RSA profile takes half the CPU. No choice of engines saves heap:
+// that is the SSL context and the record buffers. The 15-bit engines (m15/i15) and aes_small were
+// measured too, and none of them is smaller or faster on a CPU that has a 32x32 bit multiply.
+// The RSA profile fails the handshake rather than fall back, so it is opt-in. The native_mail test
+// test_tls_handshake measures both profiles against local servers, with BearSSL built as for Xtensa.
+//
+// The receive buffer has to hold a whole record: 16 KB plus overhead unless the server agrees to
+// the max_fragment_length extension (MFLN). TLS_BUFFERS_AUTO asks the server once with a probe
+// ClientHello and only shrinks the receive buffer to the fragment size when it accepts; servers
+// without MFLN (most large mail providers) keep the full buffer instead of failing the handshake. The
+// transmit side is ours to choose and stays at the fragment size either way.
+//=====================================================================================================//
+
+#ifndef TLS_PROFILE_H
+#define TLS_PROFILE_H
+
+#include <ESP_Mail_Client.h>
+
+#define TLS_RECORD_MAX 16384
+
+enum TlsProfile { TLS_PROFILE_COMPAT, TLS_PROFILE_RSA, TLS_PROFILES };
+
+enum TlsBufferPolicy {
+  TLS_BUFFERS_AUTO,   // probe for MFLN once, full receive buffer if the server refuses
+  TLS_BUFFERS_MFLN,   // assume MFLN: fragment-sized buffers without probing
+  TLS_BUFFERS_FULL,   // full 16 KB receive buffer, for servers known to lack MFLN
+};
+
+struct TlsBuffers {
+  uint16_t rx;
+  uint16_t tx;
+  bool     mfln;      // rx relies on the negotiated fragment length
+};
+
+/* nullptr for TLS_PROFILE_COMPAT, which leaves the library defaults alone */
+const SSLProfile *tlsProfile(TlsProfile profile);
+const char *tlsProfileName(TlsProfile profile);
+
+/* Record buffer sizes for `policy`; AUTO opens a TCP connection to host:port (implicit TLS) */
+TlsBuffers tlsBuffers(TlsBufferPolicy policy, const char *host, uint16_t port, uint16_t fragment);
+TlsBuffers tlsFullBuffers(uint16_t fragment);
+const char *tlsBufferPolicyName(TlsBufferPolicy policy);
+
+#endif // TLS_PROFILE_H
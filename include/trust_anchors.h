@@ -0,0 +1,117 @@
+//=====================================================================================================//
+// SMTP TRUST ANCHORS
+// Generated by tools/trust_anchors.py; do not edit, change the certificates in certs/ instead.
+// Sources: globalsign_root_ca.pem, gts_root_r1.pem, gts_root_r4.pem
+// The anchors live in flash and are handed to the SSL client as they are, so verification costs
+// no PEM parsing and no heap at connect time.
+//=====================================================================================================//
+
+#ifndef TRUST_ANCHORS_H
+#define TRUST_ANCHORS_H
+
+#include <ESP_Mail_Client.h>  // BearSSL types from the mail client's SSL engine
+
+/* globalsign_root_ca */
+static const unsigned char TA0_DN[] = {
+  0x30, 0x57, 0x31, 0x0B, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x42, 0x45, 0x31,
+  0x19, 0x30, 0x17, 0x06, 0x03, 0x55, 0x04, 0x0A, 0x13, 0x10, 0x47, 0x6C, 0x6F, 0x62, 0x61, 0x6C,
+  0x53, 0x69, 0x67, 0x6E, 0x20, 0x6E, 0x76, 0x2D, 0x73, 0x61, 0x31, 0x10, 0x30, 0x0E, 0x06, 0x03,
+  0x55, 0x04, 0x0B, 0x13, 0x07, 0x52, 0x6F, 0x6F, 0x74, 0x20, 0x43, 0x41, 0x31, 0x1B, 0x30, 0x19,
+  0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x12, 0x47, 0x6C, 0x6F, 0x62, 0x61, 0x6C, 0x53, 0x69, 0x67,
+  0x6E, 0x20, 0x52, 0x6F, 0x6F, 0x74, 0x20, 0x43, 0x41,
+};
+static const unsigned char TA0_RSA_N[] = {
+  0xDA, 0x0E, 0xE6, 0x99, 0x8D, 0xCE, 0xA3, 0xE3, 0x4F, 0x8A, 0x7E, 0xFB, 0xF1, 0x8B, 0x83, 0x25,
+  0x6B, 0xEA, 0x48, 0x1F, 0xF1, 0x2A, 0xB0, 0xB9, 0x95, 0x11, 0x04, 0xBD, 0xF0, 0x63, 0xD1, 0xE2,
+  0x67, 0x66, 0xCF, 0x1C, 0xDD, 0xCF, 0x1B, 0x48, 0x2B, 0xEE, 0x8D, 0x89, 0x8E, 0x9A, 0xAF, 0x29,
+  0x80, 0x65, 0xAB, 0xE9, 0xC7, 0x2D, 0x12, 0xCB, 0xAB, 0x1C, 0x4C, 0x70, 0x07, 0xA1, 0x3D, 0x0A,
+  0x30, 0xCD, 0x15, 0x8D, 0x4F, 0xF8, 0xDD, 0xD4, 0x8C, 0x50, 0x15, 0x1C, 0xEF, 0x50, 0xEE, 0xC4,
+  0x2E, 0xF7, 0xFC, 0xE9, 0x52, 0xF2, 0x91, 0x7D, 0xE0, 0x6D, 0xD5, 0x35, 0x30, 0x8E, 0x5E, 0x43,
+  0x73, 0xF2, 0x41, 0xE9, 0xD5, 0x6A, 0xE3, 0xB2, 0x89, 0x3A, 0x56, 0x39, 0x38, 0x6F, 0x06, 0x3C,
+  0x88, 0x69, 0x5B, 0x2A, 0x4D, 0xC5, 0xA7, 0x54, 0xB8, 0x6C, 0x89, 0xCC, 0x9B, 0xF9, 0x3C, 0xCA,
+  0xE5, 0xFD, 0x89, 0xF5, 0x12, 0x3C, 0x92, 0x78, 0x96, 0xD6, 0xDC, 0x74, 0x6E, 0x93, 0x44, 0x61,
+  0xD1, 0x8D, 0xC7, 0x46, 0xB2, 0x75, 0x0E, 0x86, 0xE8, 0x19, 0x8A, 0xD5, 0x6D, 0x6C, 0xD5, 0x78,
+  0x16, 0x95, 0xA2, 0xE9, 0xC8, 0x0A, 0x38, 0xEB, 0xF2, 0x24, 0x13, 0x4F, 0x73, 0x54, 0x93, 0x13,
+  0x85, 0x3A, 0x1B, 0xBC, 0x1E, 0x34, 0xB5, 0x8B, 0x05, 0x8C, 0xB9, 0x77, 0x8B, 0xB1, 0xDB, 0x1F,
+  0x20, 0x91, 0xAB, 0x09, 0x53, 0x6E, 0x90, 0xCE, 0x7B, 0x37, 0x74, 0xB9, 0x70, 0x47, 0x91, 0x22,
+  0x51, 0x63, 0x16, 0x79, 0xAE, 0xB1, 0xAE, 0x41, 0x26, 0x08, 0xC8, 0x19, 0x2B, 0xD1, 0x46, 0xAA,
+  0x48, 0xD6, 0x64, 0x2A, 0xD7, 0x83, 0x34, 0xFF, 0x2C, 0x2A, 0xC1, 0x6C, 0x19, 0x43, 0x4A, 0x07,
+  0x85, 0xE7, 0xD3, 0x7C, 0xF6, 0x21, 0x68, 0xEF, 0xEA, 0xF2, 0x52, 0x9F, 0x7F, 0x93, 0x90, 0xCF,
+};
+static const unsigned char TA0_RSA_E[] = {
+  0x01, 0x00, 0x01,
+};
+
+/* gts_root_r1 */
+static const unsigned char TA1_DN[] = {
+  0x30, 0x47, 0x31, 0x0B, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x55, 0x53, 0x31,
+  0x22, 0x30, 0x20, 0x06, 0x03, 0x55, 0x04, 0x0A, 0x13, 0x19, 0x47, 0x6F, 0x6F, 0x67, 0x6C, 0x65,
+  0x20, 0x54, 0x72, 0x75, 0x73, 0x74, 0x20, 0x53, 0x65, 0x72, 0x76, 0x69, 0x63, 0x65, 0x73, 0x20,
+  0x4C, 0x4C, 0x43, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x0B, 0x47, 0x54,
+  0x53, 0x20, 0x52, 0x6F, 0x6F, 0x74, 0x20, 0x52, 0x31,
+};
+static const unsigned char TA1_RSA_N[] = {
+  0xB6, 0x11, 0x02, 0x8B, 0x1E, 0xE3, 0xA1, 0x77, 0x9B, 0x3B, 0xDC, 0xBF, 0x94, 0x3E, 0xB7, 0x95,
+  0xA7, 0x40, 0x3C, 0xA1, 0xFD, 0x82, 0xF9, 0x7D, 0x32, 0x06, 0x82, 0x71, 0xF6, 0xF6, 0x8C, 0x7F,
+  0xFB, 0xE8, 0xDB, 0xBC, 0x6A, 0x2E, 0x97, 0x97, 0xA3, 0x8C, 0x4B, 0xF9, 0x2B, 0xF6, 0xB1, 0xF9,
+  0xCE, 0x84, 0x1D, 0xB1, 0xF9, 0xC5, 0x97, 0xDE, 0xEF, 0xB9, 0xF2, 0xA3, 0xE9, 0xBC, 0x12, 0x89,
+  0x5E, 0xA7, 0xAA, 0x52, 0xAB, 0xF8, 0x23, 0x27, 0xCB, 0xA4, 0xB1, 0x9C, 0x63, 0xDB, 0xD7, 0x99,
+  0x7E, 0xF0, 0x0A, 0x5E, 0xEB, 0x68, 0xA6, 0xF4, 0xC6, 0x5A, 0x47, 0x0D, 0x4D, 0x10, 0x33, 0xE3,
+  0x4E, 0xB1, 0x13, 0xA3, 0xC8, 0x18, 0x6C, 0x4B, 0xEC, 0xFC, 0x09, 0x90, 0xDF, 0x9D, 0x64, 0x29,
+  0x25, 0x23, 0x07, 0xA1, 0xB4, 0xD2, 0x3D, 0x2E, 0x60, 0xE0, 0xCF, 0xD2, 0x09, 0x87, 0xBB, 0xCD,
+  0x48, 0xF0, 0x4D, 0xC2, 0xC2, 0x7A, 0x88, 0x8A, 0xBB, 0xBA, 0xCF, 0x59, 0x19, 0xD6, 0xAF, 0x8F,
+  0xB0, 0x07, 0xB0, 0x9E, 0x31, 0xF1, 0x82, 0xC1, 0xC0, 0xDF, 0x2E, 0xA6, 0x6D, 0x6C, 0x19, 0x0E,
+  0xB5, 0xD8, 0x7E, 0x26, 0x1A, 0x45, 0x03, 0x3D, 0xB0, 0x79, 0xA4, 0x94, 0x28, 0xAD, 0x0F, 0x7F,
+  0x26, 0xE5, 0xA8, 0x08, 0xFE, 0x96, 0xE8, 0x3C, 0x68, 0x94, 0x53, 0xEE, 0x83, 0x3A, 0x88, 0x2B,
+  0x15, 0x96, 0x09, 0xB2, 0xE0, 0x7A, 0x8C, 0x2E, 0x75, 0xD6, 0x9C, 0xEB, 0xA7, 0x56, 0x64, 0x8F,
+  0x96, 0x4F, 0x68, 0xAE, 0x3D, 0x97, 0xC2, 0x84, 0x8F, 0xC0, 0xBC, 0x40, 0xC0, 0x0B, 0x5C, 0xBD,
+  0xF6, 0x87, 0xB3, 0x35, 0x6C, 0xAC, 0x18, 0x50, 0x7F, 0x84, 0xE0, 0x4C, 0xCD, 0x92, 0xD3, 0x20,
+  0xE9, 0x33, 0xBC, 0x52, 0x99, 0xAF, 0x32, 0xB5, 0x29, 0xB3, 0x25, 0x2A, 0xB4, 0x48, 0xF9, 0x72,
+  0xE1, 0xCA, 0x64, 0xF7, 0xE6, 0x82, 0x10, 0x8D, 0xE8, 0x9D, 0xC2, 0x8A, 0x88, 0xFA, 0x38, 0x66,
+  0x8A, 0xFC, 0x63, 0xF9, 0x01, 0xF9, 0x78, 0xFD, 0x7B, 0x5C, 0x77, 0xFA, 0x76, 0x87, 0xFA, 0xEC,
+  0xDF, 0xB1, 0x0E, 0x79, 0x95, 0x57, 0xB4, 0xBD, 0x26, 0xEF, 0xD6, 0x01, 0xD1, 0xEB, 0x16, 0x0A,
+  0xBB, 0x8E, 0x0B, 0xB5, 0xC5, 0xC5, 0x8A, 0x55, 0xAB, 0xD3, 0xAC, 0xEA, 0x91, 0x4B, 0x29, 0xCC,
+  0x19, 0xA4, 0x32, 0x25, 0x4E, 0x2A, 0xF1, 0x65, 0x44, 0xD0, 0x02, 0xCE, 0xAA, 0xCE, 0x49, 0xB4,
+  0xEA, 0x9F, 0x7C, 0x83, 0xB0, 0x40, 0x7B, 0xE7, 0x43, 0xAB, 0xA7, 0x6C, 0xA3, 0x8F, 0x7D, 0x89,
+  0x81, 0xFA, 0x4C, 0xA5, 0xFF, 0xD5, 0x8E, 0xC3, 0xCE, 0x4B, 0xE0, 0xB5, 0xD8, 0xB3, 0x8E, 0x45,
+  0xCF, 0x76, 0xC0, 0xED, 0x40, 0x2B, 0xFD, 0x53, 0x0F, 0xB0, 0xA7, 0xD5, 0x3B, 0x0D, 0xB1, 0x8A,
+  0xA2, 0x03, 0xDE, 0x31, 0xAD, 0xCC, 0x77, 0xEA, 0x6F, 0x7B, 0x3E, 0xD6, 0xDF, 0x91, 0x22, 0x12,
+  0xE6, 0xBE, 0xFA, 0xD8, 0x32, 0xFC, 0x10, 0x63, 0x14, 0x51, 0x72, 0xDE, 0x5D, 0xD6, 0x16, 0x93,
+  0xBD, 0x29, 0x68, 0x33, 0xEF, 0x3A, 0x66, 0xEC, 0x07, 0x8A, 0x26, 0xDF, 0x13, 0xD7, 0x57, 0x65,
+  0x78, 0x27, 0xDE, 0x5E, 0x49, 0x14, 0x00, 0xA2, 0x00, 0x7F, 0x9A, 0xA8, 0x21, 0xB6, 0xA9, 0xB1,
+  0x95, 0xB0, 0xA5, 0xB9, 0x0D, 0x16, 0x11, 0xDA, 0xC7, 0x6C, 0x48, 0x3C, 0x40, 0xE0, 0x7E, 0x0D,
+  0x5A, 0xCD, 0x56, 0x3C, 0xD1, 0x97, 0x05, 0xB9, 0xCB, 0x4B, 0xED, 0x39, 0x4B, 0x9C, 0xC4, 0x3F,
+  0xD2, 0x55, 0x13, 0x6E, 0x24, 0xB0, 0xD6, 0x71, 0xFA, 0xF4, 0xC1, 0xBA, 0xCC, 0xED, 0x1B, 0xF5,
+  0xFE, 0x81, 0x41, 0xD8, 0x00, 0x98, 0x3D, 0x3A, 0xC8, 0xAE, 0x7A, 0x98, 0x37, 0x18, 0x05, 0x95,
+};
+static const unsigned char TA1_RSA_E[] = {
+  0x01, 0x00, 0x01,
+};
+
+/* gts_root_r4 */
+static const unsigned char TA2_DN[] = {
+  0x30, 0x47, 0x31, 0x0B, 0x30, 0x09, 0x06, 0x03, 0x55, 0x04, 0x06, 0x13, 0x02, 0x55, 0x53, 0x31,
+  0x22, 0x30, 0x20, 0x06, 0x03, 0x55, 0x04, 0x0A, 0x13, 0x19, 0x47, 0x6F, 0x6F, 0x67, 0x6C, 0x65,
+  0x20, 0x54, 0x72, 0x75, 0x73, 0x74, 0x20, 0x53, 0x65, 0x72, 0x76, 0x69, 0x63, 0x65, 0x73, 0x20,
+  0x4C, 0x4C, 0x43, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x13, 0x0B, 0x47, 0x54,
+  0x53, 0x20, 0x52, 0x6F, 0x6F, 0x74, 0x20, 0x52, 0x34,
+};
+static const unsigned char TA2_EC_Q[] = {
+  0x04, 0xF3, 0x74, 0x73, 0xA7, 0x68, 0x8B, 0x60, 0xAE, 0x43, 0xB8, 0x35, 0xC5, 0x81, 0x30, 0x7B,
+  0x4B, 0x49, 0x9D, 0xFB, 0xC1, 0x61, 0xCE, 0xE6, 0xDE, 0x46, 0xBD, 0x6B, 0xD5, 0x61, 0x18, 0x35,
+  0xAE, 0x40, 0xDD, 0x73, 0xF7, 0x89, 0x91, 0x30, 0x5A, 0xEB, 0x3C, 0xEE, 0x85, 0x7C, 0xA2, 0x40,
+  0x76, 0x3B, 0xA9, 0xC6, 0xB8, 0x47, 0xD8, 0x2A, 0xE7, 0x92, 0x91, 0x6A, 0x73, 0xE9, 0xB1, 0x72,
+  0x39, 0x9F, 0x29, 0x9F, 0xA2, 0x98, 0xD3, 0x5F, 0x5E, 0x58, 0x86, 0x65, 0x0F, 0xA1, 0x84, 0x65,
+  0x06, 0xD1, 0xDC, 0x8B, 0xC9, 0xC7, 0x73, 0xC8, 0x8C, 0x6A, 0x2F, 0xE5, 0xC4, 0xAB, 0xD1, 0x1D,
+  0x8A,
+};
+
+static const br_x509_trust_anchor SMTP_TRUST_ANCHORS[] = {
+  {{(unsigned char *)TA0_DN, sizeof TA0_DN}, BR_X509_TA_CA, {BR_KEYTYPE_RSA, {.rsa = {(unsigned char *)TA0_RSA_N, sizeof TA0_RSA_N, (unsigned char *)TA0_RSA_E, sizeof TA0_RSA_E}}}},
+  {{(unsigned char *)TA1_DN, sizeof TA1_DN}, BR_X509_TA_CA, {BR_KEYTYPE_RSA, {.rsa = {(unsigned char *)TA1_RSA_N, sizeof TA1_RSA_N, (unsigned char *)TA1_RSA_E, sizeof TA1_RSA_E}}}},
+  {{(unsigned char *)TA2_DN, sizeof TA2_DN}, BR_X509_TA_CA, {BR_KEYTYPE_EC, {.ec = {BR_EC_secp384r1, (unsigned char *)TA2_EC_Q, sizeof TA2_EC_Q}}}},
+};
+
+#define SMTP_TRUST_ANCHOR_COUNT (sizeof(SMTP_TRUST_ANCHORS) / sizeof(SMTP_TRUST_ANCHORS[0]))
+
+#endif // TRUST_ANCHORS_H
@@ -0,0 +1,58 @@
+//=====================================================================================================//
+// ULP LEVEL WATCH
+// While the main cores are in deep sleep the ESP32's ULP coprocessor polls the liquid level pin
+// and the button pin every DEBOUNCE_PERIOD_MS, debounces them (level_debounce.h is the model),
+// counts transitions and wakes the main CPU only on a sustained change: any level change, or a
+// button press. The firmware can then use a long timer wake for the temperature samples without
+// losing level-response latency.
+//
+// Both pins must be RTC GPIOs (13 and 15 on the NodeMCU-32S). Once started, the pins belong to
+// the RTC IO mux, so read them through channel() rather than digitalRead(). ESP32 only; on other
+// targets begin() returns false and the caller falls back to the ext0 level wake.
+//=====================================================================================================//
+
+#ifndef ULP_LEVEL_WATCH_H
+#define ULP_LEVEL_WATCH_H
+
+#include <Arduino.h>
+#include "level_debounce.h"
+
+/* RTC slow memory layout, in 32-bit words (the ULP uses the low 16 bits) */
+#define ULP_WORD_MAGIC    0    // written by the main CPU once the program is loaded
+#define ULP_WORD_WAKE     1    // bit per channel that asked for a wake-up
+#define ULP_WORD_TICKS    2    // ULP runs, wraps at 65536
+#define ULP_WORD_CHANNELS 4    // DebounceChannel words, DEBOUNCE_WORDS per channel
+#define ULP_PROG_START    16   // program follows the data; must fit the reserved ULP memory
+
+enum UlpChannel : uint8_t {
+  ULP_CH_LEVEL = 0,
+  ULP_CH_BUTTON,
+  ULP_CHANNELS
+};
+
+class UlpLevelWatch {
+public:
+  UlpLevelWatch(uint8_t levelPin, uint8_t buttonPin);
+
+  /* Loads and starts the program, unless it is still running from before deep sleep
+   * (pass force on a cold boot). Returns false when the ULP is not available. */
+  bool begin(bool force = false);
+  bool running() const;
+
+  /* Channels (bit per UlpChannel) that asked for the current wake; clears them */
+  uint8_t takeWakeBits();
+
+  DebounceChannel channel(UlpChannel ch) const;
+  uint16_t ticks() const;
+
+  /* Arms the ULP as a deep-sleep wake source */
+  void enableWakeup();
+
+  void printStats(Print &out) const;
+
+private:
+  uint8_t _levelPin;
+  uint8_t _buttonPin;
+};
+
+#endif // ULP_LEVEL_WATCH_H
@@ -0,0 +1,69 @@
+//=====================================================================================================//
+// WI-FI CONNECTION MANAGER
+// A plain WiFi.begin(ssid, pass) scans every channel and runs DHCP on each connect. After the first
+// successful connect the AP's BSSID and channel plus the DHCP lease (IP, gateway, mask, DNS) are
+// cached in RTC memory (survives deep sleep) and NVS (survives power loss). The next connect goes
+// straight to that AP with the cached address; if it does not associate quickly, the manager falls
+// back to a full scan with DHCP and refreshes the cache.
+//=====================================================================================================//
+
+#ifndef WIFI_MANAGER_H
+#define WIFI_MANAGER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include "histogram.h"
+
+#define WIFI_FAST_TIMEOUT_MS 3000   // directed connect with the cached BSSID/channel/IP
+#define WIFI_HIST_BUCKETS    10     // <64ms ... >=16s
+
+struct WifiCache {
+  uint32_t magic;
+  uint32_t ssidHash;      // cache is dropped when the credentials change
+  uint8_t  bssid[6];
+  uint8_t  channel;
+  uint8_t  reserved;
+  uint32_t ip, gateway, subnet, dns;
+  uint32_t checksum;
+};
+
+struct WifiStats {
+  uint32_t fastAttempts;
+  uint32_t fastSuccesses;
+  uint32_t fullAttempts;
+  uint32_t fullSuccesses;
+  uint32_t reconnects;    // connects after the first one
+  Log2Histogram<WIFI_HIST_BUCKETS, 6> fastMs;
+  Log2Histogram<WIFI_HIST_BUCKETS, 6> fullMs;
+};
+
+class WifiManager {
+public:
+  WifiManager(const char *ssid, const char *password);
+
+  /* Blocks for at most WIFI_FAST_TIMEOUT_MS + timeoutMs; returns true once associated with an IP */
+  bool connect(uint32_t timeoutMs);
+  bool connected() const { return WiFi.status() == WL_CONNECTED; }
+
+  /* Forgets the cached AP and lease, e.g. after the router was replaced */
+  void invalidateCache();
+
+  const WifiStats &stats() const { return _stats; }
+  void printStats(Print &out) const;
+
+private:
+  bool loadCache();
+  void saveCache();
+  bool waitForConnection(uint32_t timeoutMs);
+  uint32_t hashSsid() const;
+  static uint32_t checksum(const WifiCache &c);
+
+  const char *_ssid;
+  const char *_password;
+  WifiCache _cache;
+  bool _cacheValid;
+  bool _everConnected;
+  WifiStats _stats;
+};
+
+#endif // WIFI_MANAGER_H
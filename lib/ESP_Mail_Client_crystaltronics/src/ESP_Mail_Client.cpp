@@ -137,11 +137,11 @@ bool ESP_Mail_Client::sessionExisted(T sessionPtr)
 #if defined(ENABLE_SMTP) || defined(ENABLE_IMAP)
 
   Session_Config *config = sessionPtr->_session_cfg;
-  _vectorImpl<int> *configPtrList = &(sessionPtr->_configPtrList);
+  _vectorImpl<uintptr_t> *configPtrList = &(sessionPtr->_configPtrList);
 
   if (config)
   {
-    int ptr = toAddr(*config);
+    uintptr_t ptr = toAddr(*config);
     for (size_t i = 0; i < configPtrList->size(); i++)
     {
       if ((*configPtrList)[i] == ptr)
@@ -1427,7 +1427,7 @@ bool ESP_Mail_Client::sessionReady(T sessionPtr)
 
 void ESP_Mail_Client::setCert(Session_Config *session_config, const char *ca)
 {
-  int ptr = reinterpret_cast<int>(ca);
+  uintptr_t ptr = reinterpret_cast<uintptr_t>(ca);
   if (ptr != session_config->cert_ptr)
   {
     session_config->cert_updated = true;
@@ -1444,6 +1444,8 @@ void ESP_Mail_Client::setSecure(ESP_Mail_TCPClient &client, Session_Config *sess
 
 #if !defined(ESP_MAIL_DISABLE_SSL)
 
+  client.setProfile(reinterpret_cast<const SSLProfile *>(session_config->secure.profile));
+
   if (client.getCertType() == esp_mail_cert_type_undefined || session_config->cert_updated)
   {
     if (session_config->certificate.cert_file.length() > 0 || session_config->certificate.cert_data != NULL || session_config->cert_ptr > 0)
@@ -1451,7 +1453,13 @@ void ESP_Mail_Client::setSecure(ESP_Mail_TCPClient &client, Session_Config *sess
       client.setClockReady(timeStatus);
     }
 
-    if (session_config->certificate.cert_file.length() == 0)
+    if (session_config->certificate.trust_anchors != NULL)
+    {
+      client.setClockReady(timeStatus);
+      client.setTrustAnchors(reinterpret_cast<const br_x509_trust_anchor *>(session_config->certificate.trust_anchors),
+                             session_config->certificate.trust_anchor_count);
+    }
+    else if (session_config->certificate.cert_file.length() == 0)
     {
       if (session_config->cert_ptr > 0)
         client.setCACert(reinterpret_cast<const char *>(session_config->cert_ptr));
@@ -1475,7 +1475,7 @@ private:
   void saveSendingLogs(SMTPSession *smtp, SMTP_Message *msg, bool result);
 
   // Get imap or smtp report progress var pointer
-  uint32_t altProgressPtr(SMTPSession *smtp);
+  uintptr_t altProgressPtr(SMTPSession *smtp);
 
   // Get SMTP response status (statusCode and text)
   void getResponseStatus(const char *buf, esp_mail_smtp_status_code statusCode, int beginPos, struct esp_mail_smtp_response_status_t &status);
@@ -1493,7 +1493,7 @@ private:
   bool handleSMTPResponse(SMTPSession *smtp, esp_mail_smtp_command cmd, esp_mail_smtp_status_code statusCode, int errCode);
 
   // Print the upload status to the debug port
-  void uploadReport(const char *filename, uint32_t pgAddr, int progress);
+  void uploadReport(const char *filename, uintptr_t pgAddr, int progress);
 
   // Get MB_FS object pointer
   MB_FS *getMBFS();
@@ -1598,7 +1598,7 @@ private:
   int countChar(const char *buf, char find);
 
   // Store the value to string via its the pointer
-  bool storeStringPtr(IMAPSession *imap, uint32_t addr, MB_String &value, const char *buf);
+  bool storeStringPtr(IMAPSession *imap, uintptr_t addr, MB_String &value, const char *buf);
 
   // Get part header properties
   bool getPartHeaderProperties(IMAPSession *imap, const char *buf, PGM_P p, PGM_P e, bool num, MB_String &value, MB_String &old_value, esp_mail_char_decoding_scheme &scheme, bool caseSensitive);
@@ -1645,7 +1645,7 @@ private:
   void addHeaderItem(MB_String &str, esp_mail_message_header_t *header, bool json);
 
   // Get RFC822 header string pointer by index
-  int getRFC822HeaderPtr(int index, esp_mail_imap_rfc822_msg_header_item_t *header);
+  uintptr_t getRFC822HeaderPtr(int index, esp_mail_imap_rfc822_msg_header_item_t *header);
 
   // Add RFC822 headers to string buffer
   void addRFC822Headers(MB_String &s, esp_mail_imap_rfc822_msg_header_item_t *header, bool json);
@@ -2316,7 +2316,7 @@ private:
   bool _auth_capability[esp_mail_auth_capability_maxType];
   bool _feature_capability[esp_mail_imap_read_capability_maxType];
   Session_Config *_session_cfg;
-  _vectorImpl<int> _configPtrList;
+  _vectorImpl<uintptr_t> _configPtrList;
   MB_String _currentFolder;
   bool _mailboxOpened = false;
   unsigned long _lastSameFolderOpenMillis = 0;
@@ -2824,7 +2824,7 @@ private:
   bool _feature_capability[esp_mail_smtp_send_capability_maxType];
 
   Session_Config *_session_cfg = NULL;
-  _vectorImpl<int> _configPtrList;
+  _vectorImpl<uintptr_t> _configPtrList;
 
   bool _debug = false;
   int _debugLevel = 0;
@@ -2185,7 +2185,7 @@ struct esp_mail_message_part_info_t
     int nestedLevel = 0;
 
     // pointer to the MB_String for storing multi-line header field content.
-    uint32_t stringPtr = 0;
+    uintptr_t stringPtr = 0;
     esp_mail_char_decoding_scheme stringEnc = esp_mail_char_decoding_scheme_default;
 
     content_header_field cur_content_hdr = content_header_field_none;
@@ -2656,6 +2656,12 @@ struct esp_mail_sesson_cert_config_t
 
     /* The cerificate verification option */
     bool verify = false;
+
+    /* Prebuilt trust anchors (const br_x509_trust_anchor *), used instead of cert_data and cert_file */
+    const void *trust_anchors = NULL;
+
+    /* The number of trust anchors */
+    size_t trust_anchor_count = 0;
 };
 
 struct esp_mail_smtp_logs_config_t
@@ -2720,6 +2726,9 @@ struct esp_mail_sesson_secure_config_t
 
     /* The secure connection mode preference */
     esp_mail_secure_mode mode = esp_mail_secure_mode_undefined;
+
+    /* Cipher suites and engines for the handshake (const SSLProfile *), NULL for the defaults */
+    const void *profile = NULL;
 };
 
 struct esp_mail_spi_ethernet_module_t
@@ -2781,7 +2790,7 @@ public:
         aremovePtr();
     }
 
-    void addPtr(_vectorImpl<int> *listPtr, int ptr)
+    void addPtr(_vectorImpl<uintptr_t> *listPtr, uintptr_t ptr)
     {
         if (listPtr)
         {
@@ -2803,7 +2812,7 @@ public:
     {
         if (listPtr)
         {
-            int ptr = toAddr(*this);
+            uintptr_t ptr = toAddr(*this);
             for (size_t i = 0; i < listPtr->size(); i++)
             {
                 if ((*listPtr)[i] == ptr)
@@ -2822,6 +2831,7 @@ public:
 
         secure.startTLS = false;
         secure.mode = esp_mail_secure_mode_undefined;
+        secure.profile = NULL;
 
         login.email.clear();
         login.password.clear();
@@ -2837,14 +2847,16 @@ public:
         certificate.cert_file = "";
         certificate.cert_file_storage_type = esp_mail_file_storage_type_none;
         certificate.verify = false;
+        certificate.trust_anchors = NULL;
+        certificate.trust_anchor_count = 0;
 
         clearPorts();
     }
 
 private:
-    int cert_ptr = 0;
+    uintptr_t cert_ptr = 0;
     bool cert_updated = false;
-    _vectorImpl<int> *listPtr = nullptr;
+    _vectorImpl<uintptr_t> *listPtr = nullptr;
 
     // Internal flags use to keep user sercure.startTLS and secure.mode.
     bool int_start_tls = false;
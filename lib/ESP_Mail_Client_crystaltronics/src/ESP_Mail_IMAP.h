@@ -1892,7 +1892,7 @@ void ESP_Mail_Client::collectHeaderField(IMAPSession *imap, char *buf, struct es
 
     if (state < esp_mail_rfc822_header_field_maxType)
     {
-        int ptr = getRFC822HeaderPtr(state, &header.header_fields);
+        uintptr_t ptr = getRFC822HeaderPtr(state, &header.header_fields);
         if (ptr > 0)
         {
             *(addrTo<MB_String *>(ptr)) += &buf[i];
@@ -2220,7 +2220,7 @@ void ESP_Mail_Client::parsePartHeaderResponse(IMAPSession *imap, esp_mail_imap_r
                     field += esp_mail_str_34; /* ":" */
                     ;
 
-                    int ptr = getRFC822HeaderPtr(i, &res.part.rfc822_header);
+                    uintptr_t ptr = getRFC822HeaderPtr(i, &res.part.rfc822_header);
                     if (ptr > 0)
                     {
                         if (getDecodedHeader(imap, res.response, field.c_str(), *(addrTo<MB_String *>(ptr)), caseSensitive))
@@ -2388,7 +2388,7 @@ int ESP_Mail_Client::countChar(const char *buf, char find)
     return count;
 }
 
-bool ESP_Mail_Client::storeStringPtr(IMAPSession *imap, uint32_t addr, MB_String &value, const char *buf)
+bool ESP_Mail_Client::storeStringPtr(IMAPSession *imap, uintptr_t addr, MB_String &value, const char *buf)
 {
     if (addr)
     {
@@ -3376,7 +3376,7 @@ void ESP_Mail_Client::addHeaderItem(MB_String &str, esp_mail_message_header_t *h
     str += s;
 }
 
-int ESP_Mail_Client::getRFC822HeaderPtr(int index, esp_mail_imap_rfc822_msg_header_item_t *header)
+uintptr_t ESP_Mail_Client::getRFC822HeaderPtr(int index, esp_mail_imap_rfc822_msg_header_item_t *header)
 {
     if (index >= esp_mail_rfc822_header_field_from && index < esp_mail_rfc822_header_field_maxType)
         return toAddr(header->header_items[index]);
@@ -3391,7 +3391,7 @@ void ESP_Mail_Client::addRFC822Headers(MB_String &s, esp_mail_imap_rfc822_msg_he
 
 void ESP_Mail_Client::addRFC822HeaderItem(MB_String &s, esp_mail_imap_rfc822_msg_header_item_t *header, int index, bool json)
 {
-    int ptr = getRFC822HeaderPtr(index, header);
+    uintptr_t ptr = getRFC822HeaderPtr(index, header);
     if (ptr > 0)
         addHeader(s, rfc822_headers[index].text, addrTo<MB_String *>(ptr)->c_str(), 0, rfc822_headers[index].trim, json);
 }
@@ -4618,7 +4618,7 @@ bool IMAPSession::connect(Session_Config *session_config, IMAP_Data *imap_data,
 
     this->_customCmdResCallback = NULL;
 
-    int ptr = toAddr(*session_config);
+    uintptr_t ptr = toAddr(*session_config);
     session_config->addPtr(&_configPtrList, ptr);
 
     if (!handleConnection(session_config, imap_data, _sessionSSL))
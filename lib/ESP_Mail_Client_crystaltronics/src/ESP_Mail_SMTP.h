@@ -1137,7 +1137,7 @@ bool ESP_Mail_Client::altIsDebug(SMTPSession *smtp)
 bool ESP_Mail_Client::sendBlobAttachment(SMTPSession *smtp, SMTP_Message *msg, SMTP_Attachment *att)
 {
     bool cb = altIsCB(smtp);
-    uint32_t addr = altProgressPtr(smtp);
+    uintptr_t addr = altProgressPtr(smtp);
 
     if (strcmp(att->descr.transfer_encoding.c_str(), Content_Transfer_Encoding::enc_base64) == 0 && strcmp(att->descr.transfer_encoding.c_str(), att->descr.content_encoding.c_str()) != 0)
     {
@@ -1211,7 +1211,7 @@ bool ESP_Mail_Client::sendBlobAttachment(SMTPSession *smtp, SMTP_Message *msg, S
 bool ESP_Mail_Client::sendFile(SMTPSession *smtp, SMTP_Message *msg, SMTP_Attachment *att)
 {
     bool cb = altIsCB(smtp);
-    uint32_t addr = altProgressPtr(smtp);
+    uintptr_t addr = altProgressPtr(smtp);
 
     if (strcmp(att->descr.transfer_encoding.c_str(), Content_Transfer_Encoding::enc_base64) == 0 && strcmp(att->descr.transfer_encoding.c_str(), att->descr.content_encoding.c_str()) != 0)
     {
@@ -1888,7 +1888,7 @@ bool ESP_Mail_Client::sendBlobBody(SMTPSession *smtp, SMTP_Message *msg, uint8_t
 {
 
     bool cb = altIsCB(smtp);
-    uint32_t addr = altProgressPtr(smtp);
+    uintptr_t addr = altProgressPtr(smtp);
 
     if (msg->text.blob.size == 0 && msg->html.blob.size == 0 && strlen(msg->text.nonCopyContent) == 0 && strlen(msg->html.nonCopyContent) == 0)
         return true;
@@ -1986,7 +1986,7 @@ bool ESP_Mail_Client::sendBlobBody(SMTPSession *smtp, SMTP_Message *msg, uint8_t
 bool ESP_Mail_Client::sendFileBody(SMTPSession *smtp, SMTP_Message *msg, uint8_t type)
 {
     bool cb = altIsCB(smtp);
-    uint32_t addr = altProgressPtr(smtp);
+    uintptr_t addr = altProgressPtr(smtp);
 
     if (msg->text.file.name.length() == 0 && msg->html.file.name.length() == 0)
         return true;
@@ -2564,9 +2564,9 @@ void ESP_Mail_Client::getRFC822PartHeader(SMTPSession *smtp, MB_String &header,
     appendNewline(header);
 }
 
-uint32_t ESP_Mail_Client::altProgressPtr(SMTPSession *smtp)
+uintptr_t ESP_Mail_Client::altProgressPtr(SMTPSession *smtp)
 {
-    uint32_t addr = 0;
+    uintptr_t addr = 0;
     if (smtp)
     {
         smtp->_lastProgress = -1;
@@ -2896,7 +2896,7 @@ void ESP_Mail_Client::getResponseStatus(const char *buf, esp_mail_smtp_status_co
     }
 }
 
-void ESP_Mail_Client::uploadReport(const char *filename, uint32_t pgAddr, int progress)
+void ESP_Mail_Client::uploadReport(const char *filename, uintptr_t pgAddr, int progress)
 {
     if (pgAddr == 0)
         return;
@@ -2997,7 +2997,7 @@ bool ESP_Mail_Client::sendBase64(SMTPSession *smtp, SMTP_Message *msg, esp_mail_
 
     bool ret = false;
 
-    uint32_t addr = altProgressPtr(smtp);
+    uintptr_t addr = altProgressPtr(smtp);
 
     size_t chunkSize = (BASE64_CHUNKED_LEN * UPLOAD_CHUNKS_NUM) + (2 * UPLOAD_CHUNKS_NUM);
     int bufIndex = 0;
@@ -3183,7 +3183,7 @@ bool SMTPSession::connect(Session_Config *session_config, bool login)
 
     this->_customCmdResCallback = NULL;
 
-    int ptr = toAddr(*session_config);
+    uintptr_t ptr = toAddr(*session_config);
     session_config->addPtr(&_configPtrList, ptr);
 
     if (!handleConnection(session_config, _sessionSSL))
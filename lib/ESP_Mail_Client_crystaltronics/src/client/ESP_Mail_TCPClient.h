@@ -156,6 +156,36 @@ public:
 #endif
     }
 
+    /**
+     * Set prebuilt trust anchors to verify.
+     * @param ta The trust anchor array, which must stay valid while the client is used.
+     * @param count The number of trust anchors.
+     */
+    void setTrustAnchors(const br_x509_trust_anchor *ta, size_t count)
+    {
+#if !defined(ESP_MAIL_DISABLE_SSL)
+        if (_x509)
+            delete _x509;
+
+        _x509 = new X509List(ta, count);
+        _tcp_client->setTrustAnchors(_x509);
+
+        setCertType(esp_mail_cert_type_data);
+        setTA(true);
+#endif
+    }
+
+    /**
+     * Set the cipher suites and algorithm implementations for the handshake.
+     * @param profile The profile, or nullptr for the defaults; it must stay valid while the client is used.
+     */
+    void setProfile(const SSLProfile *profile)
+    {
+#if !defined(ESP_MAIL_DISABLE_SSL)
+        _tcp_client->setProfile(profile);
+#endif
+    }
+
     /**
      * Set Root CA certificate to verify.
      * @param certFile The certificate file path.
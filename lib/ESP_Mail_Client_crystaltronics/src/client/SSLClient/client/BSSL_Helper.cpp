@@ -986,8 +986,18 @@ namespace bssl
     }
   }
 
+  X509List::X509List(const br_x509_trust_anchor *ta, size_t count)
+  {
+    _count = count;
+    _cert = nullptr;
+    _ta = const_cast<br_x509_trust_anchor *>(ta);
+    _borrowed = true;
+  }
+
   X509List::~X509List()
   {
+    if (_borrowed)
+      return;
     key_bssl::free_certificates(_cert, _count); // also frees cert
     for (size_t i = 0; i < _count; i++)
     {
@@ -1003,6 +1013,9 @@ namespace bssl
 
   bool X509List::append(const uint8_t *derCert, size_t derLen)
   {
+    if (_borrowed)
+      return false;
+
     size_t numCerts;
     br_x509_certificate *newCerts = key_bssl::read_certificates(reinterpret_cast<const char *>(derCert), derLen, &numCerts);
     if (!newCerts)
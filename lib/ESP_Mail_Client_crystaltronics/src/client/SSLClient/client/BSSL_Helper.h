@@ -228,6 +228,15 @@ namespace bssl
         key_bssl::private_key *_key;
     };
 
+    // Cipher suites and algorithm implementations for the client handshake, applied on top of the
+    // defaults on every connect. The suite list must stay valid while the client is used.
+    struct SSLProfile
+    {
+        const uint16_t *suites; // nullptr keeps the default list
+        size_t suite_count;
+        void (*engines)(br_ssl_client_context *cc); // nullptr keeps the default implementations
+    };
+
     // Holds one or more X.509 certificates and associated trust anchors for
     // use whenever BearSSL needs a cert or TA.  May want to have multiple
     // certs for things like a series of trusted CAs (but check the CertStore class
@@ -242,6 +251,8 @@ namespace bssl
         explicit X509List(const uint8_t *derCert, size_t derLen);
         explicit X509List(Stream &stream, size_t size);
         explicit X509List(Stream &stream) : X509List(stream, stream.available()){};
+        // Wraps prebuilt trust anchors (e.g. const arrays in flash); nothing is copied or freed
+        explicit X509List(const br_x509_trust_anchor *ta, size_t count);
         ~X509List();
 
         bool append(const char *pemCert);
@@ -269,6 +280,7 @@ namespace bssl
         size_t _count;
         br_x509_certificate *_cert;
         br_x509_trust_anchor *_ta;
+        bool _borrowed = false;
     };
 
     extern "C"
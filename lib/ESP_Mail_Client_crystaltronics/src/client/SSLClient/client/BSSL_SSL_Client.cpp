@@ -980,6 +980,11 @@ bool BSSL_SSL_Client::setCiphers(const std::vector<uint16_t> &list)
     return setCiphers(&list[0], list.size());
 }
 
+void BSSL_SSL_Client::setProfile(const SSLProfile *profile)
+{
+    _profile = profile;
+}
+
 bool BSSL_SSL_Client::setCiphersLessSecure()
 {
     return setCiphers(faster_suites_P, sizeof(faster_suites_P) / sizeof(faster_suites_P[0]));
@@ -1513,6 +1518,16 @@ int BSSL_SSL_Client::mConnectSSL(const char *host)
     else
         bssl::br_ssl_client_base_init(_sc.get(), _cipher_list, _cipher_cnt);
 
+    // A profile narrows the suites (unless setCiphers() was used) and swaps the engines; this has
+    // to happen before the x509 validator picks up the engine's RSA and EC implementations
+    if (_profile)
+    {
+        if (_profile->suites && !_cipher_list)
+            br_ssl_engine_set_suites(_eng, _profile->suites, _profile->suite_count);
+        if (_profile->engines)
+            _profile->engines(_sc.get());
+    }
+
     // Only failure possible in the installation is OOM
     if (!mInstallClientX509Validator())
     {
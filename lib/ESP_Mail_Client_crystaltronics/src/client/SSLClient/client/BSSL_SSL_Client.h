@@ -198,6 +198,8 @@ public:
 
     bool setCiphers(const std::vector<uint16_t> &list);
 
+    void setProfile(const SSLProfile *profile);
+
     bool setCiphersLessSecure();
 
     bool setSSLVersion(uint32_t min, uint32_t max);
@@ -354,6 +356,9 @@ private:
     uint16_t *_cipher_list = nullptr;
     uint8_t _cipher_cnt = 0;
 
+    // Suites and engines replacing the defaults, or nullptr
+    const SSLProfile *_profile = nullptr;
+
     // TLS ciphers allowed
     uint32_t _tls_min = BR_TLS10;
     uint32_t _tls_max = BR_TLS12;
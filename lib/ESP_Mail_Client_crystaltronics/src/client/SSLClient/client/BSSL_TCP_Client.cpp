@@ -301,6 +301,11 @@ void BSSL_TCP_Client::setBufferSizes(int recv, int xmit)
     _ssl_client.setBufferSizes(recv, xmit);
 }
 
+void BSSL_TCP_Client::setProfile(const SSLProfile *profile)
+{
+    _ssl_client.setProfile(profile);
+}
+
 int BSSL_TCP_Client::availableForWrite() { return _ssl_client.availableForWrite(); };
 
 void BSSL_TCP_Client::setSession(BearSSL_Session *session) { _ssl_client.setSession(session); };
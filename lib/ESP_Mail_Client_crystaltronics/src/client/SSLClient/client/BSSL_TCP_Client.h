@@ -380,6 +380,8 @@ public:
 
     bool setCiphers(const std::vector<uint16_t> &list);
 
+    void setProfile(const SSLProfile *profile);
+
     bool setCiphersLessSecure();
 
     bool setSSLVersion(uint32_t min = BR_TLS10, uint32_t max = BR_TLS12);
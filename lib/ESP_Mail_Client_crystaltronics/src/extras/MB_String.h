@@ -108,6 +108,11 @@
 
 class MB_String;
 
+// Strings up to MB_STRING_SSO_SIZE - 1 characters are kept inside the object, off the heap
+#if !defined(MB_STRING_SSO_SIZE)
+#define MB_STRING_SSO_SIZE 24
+#endif
+
 #define pgm2Str(p) (MB_String().appendP(p).c_str())
 #define num2Str(v, p) (MB_String().appendNum(v, p).c_str())
 
@@ -149,7 +154,7 @@ namespace mb_string
     {
 
     public:
-        mb_string_ptr_t(uint32_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
+        mb_string_ptr_t(uintptr_t addr = 0, mb_string_sub_type type = mb_string_sub_type_cstring, int precision = -1, const StringSumHelper *s = nullptr)
         {
             _addr = addr;
             _type = type;
@@ -158,13 +163,13 @@ namespace mb_string
         }
         int precision() { return _precision; }
         mb_string_sub_type type() { return _type; }
-        uint32_t address() { return _addr; }
+        uintptr_t address() { return _addr; }
         const StringSumHelper *stringsumhelper() { return _ssh; }
 
     private:
         mb_string_sub_type _type = mb_string_sub_type_none;
         int _precision = -1;
-        uint32_t _addr = 0;
+        uintptr_t _addr = 0;
         const StringSumHelper *_ssh = nullptr;
 
     } MB_StringPtr;
@@ -391,7 +396,7 @@ namespace mb_string
     };
 
     template <typename T>
-    uint32_t toAddr(T &v) { return reinterpret_cast<uint32_t>(&v); }
+    uintptr_t toAddr(T &v) { return reinterpret_cast<uintptr_t>(&v); }
 
 #if defined(__AVR__)
     template <typename T>
@@ -401,7 +406,7 @@ namespace mb_string
     }
 #else
     template <typename T>
-    auto addrTo(int address) -> typename MB_ENABLE_IF<!MB_IS_SAME<T, nullptr_t>::value, T>::type
+    auto addrTo(uintptr_t address) -> typename MB_ENABLE_IF<!MB_IS_SAME<T, nullptr_t>::value, T>::type
     {
         return reinterpret_cast<T>(address);
     }
@@ -459,25 +464,25 @@ namespace mb_string
     template <typename T>
     auto toStringPtr(const T &val) -> typename MB_ENABLE_IF<is_std_string<T>::value || is_arduino_string<T>::value || is_mb_string<T>::value, MB_StringPtr>::type
     {
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val));
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val));
     }
 
     template <typename T>
     auto toStringPtr(const T &val) -> typename MB_ENABLE_IF<MB_IS_SAME<T, StringSumHelper>::value, MB_StringPtr>::type
     {
 #if defined(ESP8266)
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1);
 
 #else
-        return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), -1, &val);
+        return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), -1, &val);
 #endif
     }
 
     template <typename T>
-    auto toStringPtr(T val) -> typename MB_ENABLE_IF<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T val) -> typename MB_ENABLE_IF<is_const_chars<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
     template <typename T>
-    auto toStringPtr(T &val) -> typename MB_ENABLE_IF<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(val), getSubType(val)); }
+    auto toStringPtr(T &val) -> typename MB_ENABLE_IF<is_arduino_flash_string_helper<T>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(val), getSubType(val)); }
 
 #if !defined(__AVR__)
     template <typename T>
@@ -494,11 +499,208 @@ namespace mb_string
     }
 
     template <typename T>
-    auto toStringPtr(T &val, int precision = -1) -> typename MB_ENABLE_IF<is_num_int<T>::value || is_num_float<T>::value || MB_IS_SAME<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uint32_t>(&val), getSubType(val), precision); }
+    auto toStringPtr(T &val, int precision = -1) -> typename MB_ENABLE_IF<is_num_int<T>::value || is_num_float<T>::value || MB_IS_SAME<T, bool>::value, MB_StringPtr>::type { return MB_StringPtr(reinterpret_cast<uintptr_t>(&val), getSubType(val), precision); }
 }
 
 using namespace mb_string;
 
+/**
+ * Bump arena for MB_String buffers, used around one transaction (e.g. connect and sendMail).
+ *
+ * Between begin() and end(), new buffers of the task that called begin() are carved from the
+ * caller's memory instead of the heap; buffers that already exist stay on the heap. Freeing an
+ * arena buffer only marks it. A buffer that outlives the transaction stays where it is and keeps
+ * its contents; begin() merges the free blocks around such survivors and carves the next
+ * transaction from the largest free run, below or above them. When that run is full, buffers
+ * come from the heap as before. One arena at a time.
+ */
+class MB_StringArena
+{
+public:
+    MB_StringArena(void *buf, size_t len)
+    {
+        size_t skew = (4 - ((uintptr_t)buf & 3)) & 3;
+        _buf = (uint8_t *)buf + skew;
+        _len = len > skew ? (len - skew) & ~(size_t)3 : 0;
+        _limit = _len;
+    }
+
+    void begin()
+    {
+        instance() = this;
+#if defined(ESP32)
+        _owner = xTaskGetCurrentTaskHandle();
+#endif
+        rewind();
+        _active = true;
+    }
+
+    void end()
+    {
+        _active = false;
+        rewind();
+    }
+
+    size_t allocations() const { return _allocs; }
+    size_t overflows() const { return _overflows; }
+    size_t highWater() const { return _high; }
+    size_t used() const { return _used; }
+    size_t survivors() const { return _live; }
+
+    // A buffer from the active arena, or NULL when there is none for this task or it is full
+    static void *alloc(size_t len)
+    {
+        MB_StringArena *a = instance();
+        if (!a || !a->_active)
+            return NULL;
+#if defined(ESP32)
+        if (a->_owner != xTaskGetCurrentTaskHandle())
+            return NULL;
+#endif
+        return a->carve(len);
+    }
+
+    static bool owns(const void *p)
+    {
+        MB_StringArena *a = instance();
+        return a && p && (const uint8_t *)p >= a->_buf && (const uint8_t *)p < a->_buf + a->_len;
+    }
+
+    // Frees p if it is an arena buffer; false leaves it to the heap
+    static bool release(void *p)
+    {
+        if (!owns(p))
+            return false;
+        MB_StringArena *a = instance();
+        uint32_t *head = (uint32_t *)p - 1;
+        size_t size = *head & ~(uint32_t)1;
+        *head = size;
+        a->_live--;
+        if ((uint8_t *)head + size == a->_buf + a->_next)
+            a->moveNext(a->_next - size);
+        return true;
+    }
+
+    // realloc() for an arena buffer: grows in place when it is the last one, else moves it
+    static void *resize(void *p, size_t len)
+    {
+        MB_StringArena *a = instance();
+        uint32_t *head = (uint32_t *)p - 1;
+        size_t size = *head & ~(uint32_t)1;
+        size_t need = blockSize(len);
+        if (need <= size)
+            return p;
+        if ((uint8_t *)head + size == a->_buf + a->_next && (uint8_t *)head + need <= a->_buf + a->_limit && a->_active)
+        {
+            *head = need | 1;
+            a->moveNext(a->_next + need - size);
+            return p;
+        }
+        void *n = alloc(len);
+        if (!n)
+            n = malloc(len);
+        if (n)
+            memcpy(n, p, size - 4);
+        release(p);
+        return n;
+    }
+
+private:
+    uint8_t *_buf = NULL;
+    size_t _len = 0;
+    size_t _used = 0;  // end of the block chain
+    size_t _start = 0; // free run the transaction carves from, [_start, _limit)
+    size_t _next = 0;
+    size_t _limit = 0;
+    size_t _high = 0;
+    size_t _live = 0;
+    size_t _allocs = 0;
+    size_t _overflows = 0;
+    bool _active = false;
+#if defined(ESP32)
+    TaskHandle_t _owner = NULL;
+#endif
+
+    static MB_StringArena *&instance()
+    {
+        static MB_StringArena *arena = NULL;
+        return arena;
+    }
+
+    // Header word holding the block size, bit 0 set while in use. The blocks tile [0, _used).
+    static size_t blockSize(size_t len) { return ((len + 3) & ~(size_t)3) + 4; }
+
+    void *carve(size_t len)
+    {
+        size_t need = blockSize(len);
+        if (_next + need > _limit)
+        {
+            _overflows++;
+            return NULL;
+        }
+        uint32_t *head = (uint32_t *)(_buf + _next);
+        *head = need | 1;
+        moveNext(_next + need);
+        _live++;
+        _allocs++;
+        return head + 1;
+    }
+
+    // Moves the carving point; a free block covers the rest of a run that lies inside the chain
+    void moveNext(size_t next)
+    {
+        _next = next;
+        if (_limit == _len)
+            _used = next;
+        else if (next < _limit)
+            *(uint32_t *)(_buf + next) = _limit - next;
+        if (next - _start > _high)
+            _high = next - _start;
+    }
+
+    // Merges the free blocks between survivors and picks the largest free run to carve from
+    void rewind()
+    {
+        size_t end = 0, run = 0, bestStart = 0, bestLen = 0;
+        bool inRun = false;
+        for (size_t pos = 0; _live && pos < _used;)
+        {
+            uint32_t head = *(uint32_t *)(_buf + pos);
+            size_t size = head & ~(uint32_t)1;
+            if (!(head & 1))
+            {
+                if (!inRun)
+                    run = pos;
+                inRun = true;
+            }
+            else if (inRun)
+            {
+                *(uint32_t *)(_buf + run) = pos - run;
+                if (pos - run > bestLen)
+                {
+                    bestStart = run;
+                    bestLen = pos - run;
+                }
+                inRun = false;
+            }
+            if (head & 1)
+                end = pos + size;
+            pos += size;
+        }
+        _used = end;
+        if (_len - end >= bestLen)
+        {
+            _start = _next = end;
+            _limit = _len;
+        }
+        else
+        {
+            _start = _next = bestStart;
+            _limit = bestStart + bestLen;
+        }
+    }
+};
+
 class MB_String
 {
 public:
@@ -613,12 +815,7 @@ public:
         reserve(33);
         if (bufLen > 0)
         {
-            char *v = toFloatStr(value, 0, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
+            toFloatStr(buf, bufLen, value, 0, decimalPlaces);
         }
     }
 
@@ -628,12 +825,7 @@ public:
 
         if (bufLen > 0)
         {
-            char *v = toFloatStr(value, 1, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
+            toFloatStr(buf, bufLen, value, 1, decimalPlaces);
         }
     }
 
@@ -642,12 +834,7 @@ public:
         reserve(65);
         if (bufLen > 0)
         {
-            char *v = toFloatStr(value, 2, decimalPlaces);
-            if (v)
-            {
-                strcpy(buf, v);
-                delP(&v);
-            }
+            toFloatStr(buf, bufLen, value, 2, decimalPlaces);
         }
     }
 
@@ -814,12 +1001,13 @@ public:
         if (clear)
             this->clear();
 
-        char *t = pgmStr(pgms);
-        if (t)
-        {
-            *this += t;
-            delP(&t);
-        }
+        if (!pgms)
+            return (*this);
+
+        size_t slen = length();
+        size_t len = strlen_P(pgms);
+        if (len > 0 && _reserve(slen + len, false))
+            strcpy_P(buf + slen, pgms);
 
         return (*this);
     }
@@ -898,32 +1086,30 @@ public:
     template <typename T = int>
     auto appendNum(T value, int precision = 0) -> typename MB_ENABLE_IF<is_num_int<T>::value || is_bool<T>::value, MB_String &>::type
     {
-        char *s = NULL;
+        char s[24]; // 64-bit value with sign
 
         if (is_bool<T>::value)
-            s = boolStr(value);
+            strcpy(s, value ? (const char *)MBSTRING_FLASH_MCR("true") : (const char *)MBSTRING_FLASH_MCR("false"));
         else if (is_num_neg_int<T>::value)
         {
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
-            s = int32Str(value);
+            sprintf(s, (const char *)MBSTRING_FLASH_MCR("%ld"), (signed long)value);
 #else
-            s = int64Str(value);
+            sprintf(s, (const char *)MBSTRING_FLASH_MCR("%lld"), (signed long long)value);
 #endif
         }
         else if (is_num_pos_int<T>::value)
         {
 #if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
-            s = uint32Str(value);
+            sprintf(s, (const char *)MBSTRING_FLASH_MCR("%lu"), (unsigned long)value);
 #else
-            s = uint64Str(value);
+            sprintf(s, (const char *)MBSTRING_FLASH_MCR("%llu"), (unsigned long long)value);
 #endif
         }
+        else
+            return (*this);
 
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        *this += s;
 
         return (*this);
     }
@@ -933,12 +1119,9 @@ public:
         if (precision < 0)
             precision = 5;
 
-        char *s = toFloatStr(value, 0, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        char s[64];
+        toFloatStr(s, sizeof(s), value, 0, precision);
+        *this += s;
         return (*this);
     }
 
@@ -947,12 +1130,9 @@ public:
         if (precision < 0)
             precision = 9;
 
-        char *s = toFloatStr(value, 1, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        char s[64];
+        toFloatStr(s, sizeof(s), value, 1, precision);
+        *this += s;
         return (*this);
     }
 
@@ -961,12 +1141,9 @@ public:
         if (precision < 0)
             precision = 9;
 
-        char *s = toFloatStr(value, 2, precision);
-        if (s)
-        {
-            *this += s;
-            delP(&s);
-        }
+        char s[64];
+        toFloatStr(s, sizeof(s), value, 2, precision);
+        *this += s;
         return (*this);
     }
 
@@ -1219,7 +1396,7 @@ public:
         if (len == 0)
             len = 4;
         ESP.setExternalHeap();
-        if (buf)
+        if (buf && buf != sso)
             buf = (char *)realloc(buf, len);
         else
             buf = (char *)malloc(len);
@@ -1479,63 +1656,18 @@ public:
     static const size_t npos = -1;
 
 private:
-#if defined(ARDUINO_ARCH_SAMD) || defined(__AVR_ATmega4809__) || defined(ARDUINO_NANO_RP2040_CONNECT) || defined(ARDUINO_UNOWIFIR4)
-
-    char *int32Str(signed long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%ld"), value);
-        return t;
-    }
-
-    char *uint32Str(unsigned long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lu"), value);
-        return t;
-    }
-
-#endif
-
-    char *int64Str(signed long long value)
-    {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%lld"), value);
-        return t;
-    }
-
-    char *uint64Str(unsigned long long value)
+    // Precision goes in as an argument, 0 to 9 places (trim() drops the trailing zeros anyway)
+    void toFloatStr(char *t, size_t size, long double value, int type, int precision)
     {
-        char *t = (char *)newP(64);
-        sprintf(t, (const char *)MBSTRING_FLASH_MCR("%llu"), value);
-        return t;
-    }
-
-    char *boolStr(bool value)
-    {
-        char *t = (char *)newP(8);
-        value ? strcpy(t, (const char *)MBSTRING_FLASH_MCR("true")) : strcpy(t, (const char *)MBSTRING_FLASH_MCR("false"));
-        return t;
-    }
-
-    char *toFloatStr(long double value, int type, int precision)
-    {
-        int width = type == 0 ? 32 : 64;
-
-        char *t = (char *)newP(width);
-
-        if (t)
-        {
-            MB_String fmt = MBSTRING_FLASH_MCR("%.");
-            fmt += precision;
-            if (type == 2)
-                fmt += MBSTRING_FLASH_MCR("L");
-            fmt += MBSTRING_FLASH_MCR("f");
-            sprintf(t, fmt.c_str(), value);
-            trim(t);
-        }
-
-        return t;
+        if (precision < 0)
+            precision = 0;
+        else if (precision > 9)
+            precision = 9;
+        if (type == 2)
+            snprintf(t, size, (const char *)MBSTRING_FLASH_MCR("%.*Lf"), precision, value);
+        else
+            snprintf(t, size, (const char *)MBSTRING_FLASH_MCR("%.*f"), precision, (double)value);
+        trim(t);
     }
 
     char *nullStr()
@@ -1545,13 +1677,6 @@ private:
         return t;
     }
 
-    char *pgmStr(PGM_P p)
-    {
-        char *t = (char *)newP(strlen_P(p));
-        strcpy_P(t, p);
-        return t;
-    }
-
     void trim(char *s)
     {
         if (!s)
@@ -1574,8 +1699,13 @@ private:
 
     void *newP(size_t len)
     {
-        void *p;
         size_t newLen = getReservedLen(len);
+        void *p = MB_StringArena::alloc(newLen);
+        if (p)
+        {
+            memset(p, 0, newLen);
+            return p;
+        }
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
         if (ESP.getPsramSize() > 0)
             p = (void *)ps_malloc(newLen);
@@ -1610,7 +1740,8 @@ private:
         void **p = (void **)ptr;
         if (*p)
         {
-            free(*p);
+            if (!MB_StringArena::release(*p))
+                free(*p);
             *p = 0;
         }
     }
@@ -1685,6 +1816,13 @@ private:
 
     void move(MB_String &rhs)
     {
+        if (rhs.buf == rhs.sso)
+        {
+            copy(rhs.buf, rhs.length());
+            rhs.clear();
+            return;
+        }
+
         if (buf)
         {
             if (bufLen >= rhs.bufLen)
@@ -1694,7 +1832,7 @@ private:
                 rhs.bufLen = 0;
                 return;
             }
-            else
+            else if (buf != sso && !MB_StringArena::release(buf))
             {
                 free(buf);
             }
@@ -1709,15 +1847,42 @@ private:
 
         if (len == 0)
         {
-            if (buf)
+            if (buf && buf != sso && !MB_StringArena::release(buf))
                 free(buf);
             buf = NULL;
             bufLen = 0;
             return;
         }
 
+        if (len <= sizeof(sso) && (!buf || buf == sso || shrink))
+        {
+            if (!buf)
+                sso[0] = '\0';
+            else if (buf != sso)
+            {
+                // shrinking a heap buffer back inline
+                size_t slen = length();
+                if (slen > sizeof(sso) - 1)
+                    slen = sizeof(sso) - 1;
+                memcpy(sso, buf, slen);
+                sso[slen] = '\0';
+                if (!MB_StringArena::release(buf))
+                    free(buf);
+            }
+            buf = sso;
+            bufLen = sizeof(sso);
+            return;
+        }
+
         if (len > bufLen || shrink)
         {
+            // leaving the inline buffer: allocate as for a new string, then copy the text over
+            bool wasInline = buf == sso;
+            if (wasInline)
+            {
+                buf = NULL;
+                bufLen = 0;
+            }
 
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
             ESP.setExternalHeap();
@@ -1727,13 +1892,16 @@ private:
             {
                 int slen = length();
 
+                if (MB_StringArena::owns(buf))
+                    buf = (char *)MB_StringArena::resize(buf, len);
+                else
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
                 if (ESP.getPsramSize() > 0)
                     buf = (char *)ps_realloc(buf, len);
                 else
                     buf = (char *)realloc(buf, len);
 #else
-                buf = (char *)realloc(buf, len);
+                    buf = (char *)realloc(buf, len);
 #endif
                 if (buf)
                 {
@@ -1743,13 +1911,15 @@ private:
             }
             else
             {
+                buf = (char *)MB_StringArena::alloc(len);
+                if (!buf)
 #if defined(BOARD_HAS_PSRAM) && defined(MB_STRING_USE_PSRAM)
                 if (ESP.getPsramSize() > 0)
                     buf = (char *)ps_malloc(len);
                 else
                     buf = (char *)malloc(len);
 #else
-                buf = (char *)malloc(len);
+                    buf = (char *)malloc(len);
 #endif
                 if (buf)
                 {
@@ -1761,6 +1931,17 @@ private:
 #if defined(ESP8266_USE_EXTERNAL_HEAP)
             ESP.resetHeap();
 #endif
+
+            if (wasInline)
+            {
+                if (buf)
+                    strcpy(buf, sso);
+                else
+                {
+                    buf = sso;
+                    bufLen = sizeof(sso);
+                }
+            }
         }
     }
 
@@ -2032,6 +2213,7 @@ private:
 
     char *buf = NULL;
     size_t bufLen = 0;
+    char sso[MB_STRING_SSO_SIZE];
 };
 
 inline MB_String operator+(const MB_String &lhs, const MB_String &rhs)
@@ -2071,7 +2253,8 @@ inline MB_String operator+(char lhs, MB_String &rhs)
 
 inline MB_String operator+(MB_String &&lhs, char rhs)
 {
-    return std::move(lhs.insert(0, rhs));
+    lhs += rhs;
+    return std::move(lhs);
 }
 
 #endif
@@ -0,0 +1,166 @@
+#include "alert_format.h"
+
+#include <math.h>
+#include <string.h>
+
+/* Email layouts, same wording as the original sendEmail()/sendEmailTemp() messages */
+static constexpr AlertPiece LIQUID_SUBJECT[] = {
+  ALERT_TEXT("RE: LIQUID LEVEL. PLEASE CHECK TANK! - Sent from ESP board"),
+};
+
+static constexpr AlertPiece TEMPERATURE_SUBJECT[] = {
+  ALERT_TEXT("RE: TEMPERATURE. PLEASE CHECK TANK! - Sent from ESP board"),
+};
+
+static constexpr AlertPiece HEAP_SUBJECT[] = {
+  ALERT_TEXT("RE: BOARD MEMORY. HEAP IS FRAGMENTED - Sent from ESP board"),
+};
+
+static constexpr AlertPiece LIQUID_LOW_BODY[] = {
+  ALERT_TEXT("Liquid level is LOW! Current temperature is: "), ALERT_FIELD(ALERT_FIELD_TEMPERATURE),
+  ALERT_TEXT("°C. Please check "), ALERT_FIELD(ALERT_FIELD_TANK),
+  ALERT_TEXT(". (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP), ALERT_TEXT(")"),
+};
+
+static constexpr AlertPiece LIQUID_CLEAR_BODY[] = {
+  ALERT_TEXT("Liquid level is OK again. Current temperature is: "), ALERT_FIELD(ALERT_FIELD_TEMPERATURE),
+  ALERT_TEXT("°C. "), ALERT_FIELD(ALERT_FIELD_TANK),
+  ALERT_TEXT(" is back to normal. (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP), ALERT_TEXT(")"),
+};
+
+static constexpr AlertPiece TEMPERATURE_BODY[] = {
+  ALERT_TEXT("Current temperature is not within threshold! Temperature is currently "),
+  ALERT_FIELD(ALERT_FIELD_VALUE), ALERT_TEXT("°C (limits "), ALERT_FIELD(ALERT_FIELD_THRESHOLD_LOW),
+  ALERT_TEXT(" to "), ALERT_FIELD(ALERT_FIELD_THRESHOLD_HIGH), ALERT_TEXT("°C). Please check "),
+  ALERT_FIELD(ALERT_FIELD_TANK), ALERT_TEXT(". (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP), ALERT_TEXT(")"),
+};
+
+static constexpr AlertPiece TEMPERATURE_CLEAR_BODY[] = {
+  ALERT_TEXT("Temperature is back within threshold. Temperature is currently "), ALERT_FIELD(ALERT_FIELD_VALUE),
+  ALERT_TEXT("°C. "), ALERT_FIELD(ALERT_FIELD_TANK),
+  ALERT_TEXT(" is back to normal. (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP), ALERT_TEXT(")"),
+};
+
+static constexpr AlertPiece HEAP_BODY[] = {
+  ALERT_TEXT("Heap fragmentation is "), ALERT_FIELD(ALERT_FIELD_VALUE), ALERT_TEXT("% (warning at "),
+  ALERT_FIELD(ALERT_FIELD_THRESHOLD_HIGH), ALERT_TEXT("%). "), ALERT_FIELD(ALERT_FIELD_TANK),
+  ALERT_TEXT(" may soon be unable to send email; restart the board. (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP),
+  ALERT_TEXT(")"),
+};
+
+static constexpr AlertPiece HEAP_CLEAR_BODY[] = {
+  ALERT_TEXT("Heap fragmentation is down to "), ALERT_FIELD(ALERT_FIELD_VALUE), ALERT_TEXT("%. "),
+  ALERT_FIELD(ALERT_FIELD_TANK), ALERT_TEXT(" is back to normal. (Reading taken "), ALERT_FIELD(ALERT_FIELD_STAMP),
+  ALERT_TEXT(")"),
+};
+
+static_assert(alertLayoutMax(LIQUID_SUBJECT) < ALERT_SUBJECT_MAX, "subject layout exceeds ALERT_SUBJECT_MAX");
+static_assert(alertLayoutMax(TEMPERATURE_SUBJECT) < ALERT_SUBJECT_MAX, "subject layout exceeds ALERT_SUBJECT_MAX");
+static_assert(alertLayoutMax(LIQUID_LOW_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+static_assert(alertLayoutMax(LIQUID_CLEAR_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+static_assert(alertLayoutMax(TEMPERATURE_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+static_assert(alertLayoutMax(TEMPERATURE_CLEAR_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+static_assert(alertLayoutMax(HEAP_SUBJECT) < ALERT_SUBJECT_MAX, "subject layout exceeds ALERT_SUBJECT_MAX");
+static_assert(alertLayoutMax(HEAP_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+static_assert(alertLayoutMax(HEAP_CLEAR_BODY) < ALERT_BODY_MAX, "body layout exceeds ALERT_BODY_MAX");
+
+size_t formatFixed(char *out, size_t len, float value, uint8_t decimals) {
+  if (!len) return 0;
+  char tmp[ALERT_NUMBER_MAX];
+  size_t n = 0;
+  if (isnan(value) || isinf(value) || fabsf(value) >= 2e6f) {
+    memcpy(tmp, "nan", 3);
+    n = 3;
+  } else {
+    if (decimals > 3) decimals = 3;
+    uint32_t scale = decimals == 0 ? 1 : decimals == 1 ? 10 : decimals == 2 ? 100 : 1000;
+    int32_t scaled = (int32_t)lroundf(value * scale);
+    if (scaled < 0) tmp[n++] = '-';
+    uint32_t magnitude = scaled < 0 ? (uint32_t)-scaled : (uint32_t)scaled;
+    uint32_t whole = magnitude / scale, frac = magnitude % scale;
+
+    char digits[10];
+    uint8_t d = 0;
+    do {
+      digits[d++] = '0' + whole % 10;
+      whole /= 10;
+    } while (whole);
+    while (d) tmp[n++] = digits[--d];
+    if (decimals) {
+      tmp[n++] = '.';
+      for (uint32_t div = scale / 10; div; div /= 10) tmp[n++] = '0' + (frac / div) % 10;
+    }
+  }
+  if (n >= len) n = len - 1;
+  memcpy(out, tmp, n);
+  out[n] = '\0';
+  return n;
+}
+
+/* Renders a layout, cutting at the buffer end */
+template <size_t N>
+static size_t render(char *out, size_t len, const AlertPiece (&layout)[N], const AlertEvent &e,
+                     const TimeService &time, const char *tankName) {
+  if (!len) return 0;
+  size_t used = 0;
+  for (size_t i = 0; i < N && used + 1 < len; i++) {
+    char field[ALERT_STAMP_MAX];
+    const char *piece = layout[i].literal;
+    size_t pieceLen = 0;
+    switch (layout[i].field) {
+      case ALERT_FIELD_NONE:
+        pieceLen = strlen(piece);
+        break;
+      case ALERT_FIELD_TANK:
+        piece = tankName;
+        pieceLen = strnlen(tankName, ALERT_TANK_MAX);
+        break;
+      case ALERT_FIELD_TEMPERATURE:
+        pieceLen = formatFixed(field, sizeof(field), e.temperature, 2);
+        piece = field;
+        break;
+      case ALERT_FIELD_VALUE:
+        pieceLen = formatFixed(field, sizeof(field), e.value, 2);
+        piece = field;
+        break;
+      case ALERT_FIELD_THRESHOLD_LOW:
+        pieceLen = formatFixed(field, sizeof(field), e.thresholdLow, 0);
+        piece = field;
+        break;
+      case ALERT_FIELD_THRESHOLD_HIGH:
+        pieceLen = formatFixed(field, sizeof(field), e.thresholdHigh, 0);
+        piece = field;
+        break;
+      case ALERT_FIELD_STAMP:
+        pieceLen = time.format(field, sizeof(field), e.sampleUs);
+        if (pieceLen >= sizeof(field)) pieceLen = sizeof(field) - 1;
+        piece = field;
+        break;
+    }
+    if (used + pieceLen >= len) pieceLen = len - 1 - used;
+    memcpy(out + used, piece, pieceLen);
+    used += pieceLen;
+  }
+  out[used] = '\0';
+  return used;
+}
+
+size_t formatAlertText(char *out, size_t len, const AlertEvent &e, const TimeService &time, const char *tankName) {
+  bool clear = e.severity == ALERT_SEVERITY_CLEAR;
+  if (e.sensor == ALERT_SENSOR_LIQUID_LEVEL) {
+    return clear ? render(out, len, LIQUID_CLEAR_BODY, e, time, tankName)
+                 : render(out, len, LIQUID_LOW_BODY, e, time, tankName);
+  }
+  if (e.sensor == ALERT_SENSOR_HEAP) {
+    return clear ? render(out, len, HEAP_CLEAR_BODY, e, time, tankName)
+                 : render(out, len, HEAP_BODY, e, time, tankName);
+  }
+  return clear ? render(out, len, TEMPERATURE_CLEAR_BODY, e, time, tankName)
+               : render(out, len, TEMPERATURE_BODY, e, time, tankName);
+}
+
+size_t formatAlertSubject(char *out, size_t len, const AlertEvent &e, const TimeService &time, const char *tankName) {
+  if (e.sensor == ALERT_SENSOR_LIQUID_LEVEL) return render(out, len, LIQUID_SUBJECT, e, time, tankName);
+  if (e.sensor == ALERT_SENSOR_HEAP) return render(out, len, HEAP_SUBJECT, e, time, tankName);
+  return render(out, len, TEMPERATURE_SUBJECT, e, time, tankName);
+}
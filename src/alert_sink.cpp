@@ -0,0 +1,164 @@
+#include "alert_sink.h"
+
+#include <freertos/task.h>
+
+const char *alertSensorName(AlertSensor sensor) {
+  switch (sensor) {
+    case ALERT_SENSOR_LIQUID_LEVEL: return "liquid_level";
+    case ALERT_SENSOR_TEMPERATURE:  return "temperature";
+    case ALERT_SENSOR_HEAP:         return "heap";
+    default:                        return "unknown";
+  }
+}
+
+const char *alertSeverityName(AlertSeverity severity) {
+  switch (severity) {
+    case ALERT_SEVERITY_CLEAR:    return "clear";
+    case ALERT_SEVERITY_WARNING:  return "warning";
+    case ALERT_SEVERITY_CRITICAL: return "critical";
+    default:                      return "unknown";
+  }
+}
+
+AlertDispatcher::AlertDispatcher()
+    : _workers{}, _count(0), _pending(0), _lastFailed(false), _raised(false), _onStatus(nullptr), _statusLock(nullptr),
+      _reported(ALERT_NONE) {}
+
+bool AlertDispatcher::addSink(AlertSink &sink, const AlertRetryPolicy &policy, uint32_t stackSize) {
+  if (_count >= ALERT_MAX_SINKS) return false;
+  Worker &w = _workers[_count++];
+  w.owner = this;
+  w.sink = &sink;
+  w.policy = policy;
+  if (w.policy.attempts == 0) w.policy.attempts = 1;
+  w.stackSize = stackSize;
+  w.queue = nullptr;
+  return true;
+}
+
+bool AlertDispatcher::begin() {
+  bool ok = true;
+  if (_onStatus && !_statusLock) {
+    _statusLock = xSemaphoreCreateMutex();
+    if (!_statusLock) ok = false;
+  }
+  for (uint8_t i = 0; i < _count; i++) {
+    Worker &w = _workers[i];
+    if (w.queue) continue;
+    w.queue = xQueueCreate(ALERT_QUEUE_DEPTH, sizeof(Job));
+    if (!w.queue || xTaskCreate(workerMain, w.sink->name(), w.stackSize, &w, 1, nullptr) != pdPASS) ok = false;
+  }
+  return ok;
+}
+
+void AlertDispatcher::dispatch(const AlertEvent &e) {
+  bool clear = e.severity == ALERT_SEVERITY_CLEAR;
+  if (!clear) {
+    _raised = true;
+    _lastFailed = false;
+  }
+
+  Job job = {e, TimeService::monoUs()};
+  for (uint8_t i = 0; i < _count; i++) {
+    Worker &w = _workers[i];
+    if (!w.queue || (clear && !w.sink->wantsClear())) continue;
+    if (!clear) _pending++;
+    if (xQueueSend(w.queue, &job, 0) != pdTRUE) {
+      if (!clear) _pending--;
+      w.stats.dropped.inc();
+    }
+  }
+  if (!clear) statusChanged();
+}
+
+AlertStatus AlertDispatcher::status() const {
+  if (_pending) return ALERT_SENDING;
+  if (!_raised) return ALERT_NONE;
+  return _lastFailed ? ALERT_FAILED : ALERT_SENT;
+}
+
+/* Every change of _pending/_lastFailed is followed by a call here; under the lock status() is read
+ * after the change, so racing callers cannot leave a stale status as the last one reported */
+void AlertDispatcher::statusChanged() {
+  if (!_onStatus || !_statusLock) return;
+  xSemaphoreTake(_statusLock, portMAX_DELAY);
+  AlertStatus now = status();
+  if (now != _reported) {
+    _reported = now;
+    _onStatus(now);
+  }
+  xSemaphoreGive(_statusLock);
+}
+
+void AlertDispatcher::workerMain(void *arg) {
+  Worker *w = static_cast<Worker *>(arg);
+  w->owner->run(*w);
+}
+
+void AlertDispatcher::run(Worker &w) {
+  for (;;) {
+    Job job;
+    if (xQueueReceive(w.queue, &job, portMAX_DELAY) != pdTRUE) continue;
+
+    while (!w.sink->ready()) vTaskDelay(pdMS_TO_TICKS(1000));
+
+    bool ok = false;
+    uint32_t backoffMs = w.policy.firstBackoffMs;
+    for (uint8_t attempt = 0; attempt < w.policy.attempts && !ok; attempt++) {
+      if (attempt) {
+        w.stats.retries.inc();
+        vTaskDelay(pdMS_TO_TICKS(backoffMs));
+        backoffMs = backoffMs * 2 > w.policy.maxBackoffMs ? w.policy.maxBackoffMs : backoffMs * 2;
+      }
+      ok = w.sink->deliver(job.event);
+    }
+
+    if (ok) {
+      w.stats.delivered.inc();
+      w.stats.latencyMs.observe((uint32_t)((TimeService::monoUs() - job.queuedUs) / 1000));
+    } else {
+      w.stats.failed.inc();
+    }
+    if (job.event.severity != ALERT_SEVERITY_CLEAR) {
+      if (!ok) _lastFailed = true;
+      _pending--;
+      statusChanged();
+    }
+  }
+}
+
+void AlertDispatcher::writeMetrics(PromWriter &out) const {
+  char labels[48];
+  out.family("crystal_alerts_total", "counter", "Alert deliveries by sink and result");
+  for (uint8_t i = 0; i < _count; i++) {
+    const Worker &w = _workers[i];
+    snprintf(labels, sizeof(labels), "sink=\"%s\",result=\"sent\"", w.sink->name());
+    out.sample("crystal_alerts_total", labels, (uint64_t)w.stats.delivered.value());
+    snprintf(labels, sizeof(labels), "sink=\"%s\",result=\"failed\"", w.sink->name());
+    out.sample("crystal_alerts_total", labels, (uint64_t)w.stats.failed.value());
+    snprintf(labels, sizeof(labels), "sink=\"%s\",result=\"dropped\"", w.sink->name());
+    out.sample("crystal_alerts_total", labels, (uint64_t)w.stats.dropped.value());
+  }
+  out.family("crystal_alert_retries_total", "counter", "Alert delivery attempts after the first");
+  for (uint8_t i = 0; i < _count; i++) {
+    snprintf(labels, sizeof(labels), "sink=\"%s\"", _workers[i].sink->name());
+    out.sample("crystal_alert_retries_total", labels, (uint64_t)_workers[i].stats.retries.value());
+  }
+  out.family("crystal_alert_delivery_seconds", "histogram", "Alert dispatch to delivery time, retries included");
+  for (uint8_t i = 0; i < _count; i++) {
+    snprintf(labels, sizeof(labels), "sink=\"%s\"", _workers[i].sink->name());
+    out.histogramSeries("crystal_alert_delivery_seconds", labels, _workers[i].stats.latencyMs, 1e-3);
+  }
+}
+
+void AlertDispatcher::printStats(Print &out) const {
+  for (uint8_t i = 0; i < _count; i++) {
+    const Worker &w = _workers[i];
+    uint32_t delivered = w.stats.delivered.value();
+    out.printf("Alerts %-8s %lu sent, %lu failed, %lu retries, %lu dropped, %u queued, mean %.0f ms\n", w.sink->name(),
+               (unsigned long)delivered, (unsigned long)w.stats.failed.value(),
+               (unsigned long)w.stats.retries.value(), (unsigned long)w.stats.dropped.value(),
+               w.queue ? (unsigned)uxQueueMessagesWaiting(w.queue) : 0u,
+               delivered ? (double)w.stats.latencyMs.sum() / delivered : 0.0);
+  }
+}
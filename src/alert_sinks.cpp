@@ -0,0 +1,260 @@
+#include "alert_sinks.h"
+
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <esp_system.h>
+#include <time.h>
+#include "async_log.h"
+#include "base64_stream.h"
+#include "phase_timer.h"
+#include "smtp_stream.h"
+
+SmtpAlertSink::SmtpAlertSink(SMTPSession &smtp, ESP_Mail_Session &session, const char *sender, const char *recipient,
+                             const TimeService &time, const char *tankName, const volatile bool &ready)
+    : _smtp(smtp), _session(session), _sender(sender), _recipient(recipient), _time(time), _tankName(tankName),
+      _ready(ready), _history(nullptr), _historyWindowS(0), _historyResolutionS(0), _bufferPolicy(TLS_BUFFERS_FULL),
+      _tlsHost(nullptr), _tlsPort(0), _tlsFragment(0), _buffers(tlsFullBuffers(1024)), _buffersResolved(false),
+      _sessionHeapLast(0), _sessionHeapMax(0), _arena(nullptr), _heap(nullptr) {}
+
+/* Begins the arena for the calling task; the end rewinds it, leaving strings still alive in place */
+class ArenaScope {
+public:
+  explicit ArenaScope(MB_StringArena *arena) : _arena(arena) {
+    if (_arena) _arena->begin();
+  }
+  ~ArenaScope() {
+    if (_arena) _arena->end();
+  }
+
+private:
+  MB_StringArena *_arena;
+};
+
+void SmtpAlertSink::attachHistory(SampleLog *log, uint32_t windowS, uint32_t resolutionS) {
+  _history = log;
+  _historyWindowS = windowS;
+  _historyResolutionS = resolutionS;
+}
+
+void SmtpAlertSink::attachHeapTelemetry(HeapTelemetry *heap) { _heap = heap; }
+
+void SmtpAlertSink::setTlsBuffers(TlsBufferPolicy policy, const char *host, uint16_t port, uint16_t fragment) {
+  _bufferPolicy = policy;
+  _tlsHost = host;
+  _tlsPort = port;
+  _tlsFragment = fragment;
+  _buffersResolved = false;
+}
+
+/* Sizes are applied on every connect; the library allocates the buffers in the handshake */
+void SmtpAlertSink::prepareConnect() {
+  if (_heap) _heap->sample(HEAP_PHASE_PRE_CONNECT);
+  if (!_tlsHost) return;
+  if (!_buffersResolved) {
+    _buffers = ::tlsBuffers(_bufferPolicy, _tlsHost, _tlsPort, _tlsFragment);
+    _buffersResolved = true;
+  }
+  _smtp.setSSLBufferSize(_buffers.rx, _buffers.tx);
+}
+
+void SmtpAlertSink::connected(uint32_t heapBefore) {
+  uint32_t heapAfter = ESP.getFreeHeap();
+  _sessionHeapLast = heapBefore > heapAfter ? heapBefore - heapAfter : 0;
+  if (_sessionHeapLast > _sessionHeapMax) _sessionHeapMax = _sessionHeapLast;
+  if (_heap) _heap->sample(HEAP_PHASE_POST_HANDSHAKE);
+}
+
+void SmtpAlertSink::connectFailed() {
+  connectErrors.inc();
+  if (_buffers.mfln) {
+    LOG_W("SMTP connect failed on fragment-sized TLS buffers, retrying with full buffers");
+    _buffers = tlsFullBuffers(_tlsFragment);
+  }
+}
+
+/* Connects, sends and closes the session; times both steps for /metrics */
+bool SmtpAlertSink::deliver(const AlertEvent &e) {
+  PHASE_TIME(PHASE_EMAIL);
+  formatAlertSubject(_subject, sizeof(_subject), e, _time, _tankName);
+  formatAlertText(_body, sizeof(_body), e, _time, _tankName);
+
+  uint32_t now = (uint32_t)(_time.nowUtcUs() / 1000000LL);
+  if (_history && _historyWindowS && now) return deliverWithHistory(e, now);
+
+  /* Declared before the message so the message's strings are freed before the arena rewinds */
+  ArenaScope scope(_arena);
+
+  /* Declare the message class */
+  SMTP_Message message;
+
+  /* Set the message headers */
+  message.sender.name = F("ESP");
+  message.sender.email = _sender;
+  message.subject = _subject;
+  message.addRecipient(F("Sam"), _recipient);
+
+  /* The body is sent straight from _body; `content` would take a heap copy */
+  message.text.nonCopyContent = _body;
+  message.text.charSet = "us-ascii";
+  message.text.transfer_encoding = Content_Transfer_Encoding::enc_7bit;
+
+  message.priority = esp_mail_smtp_priority::esp_mail_smtp_priority_low;
+  message.response.notify = esp_mail_smtp_notify_success | esp_mail_smtp_notify_failure | esp_mail_smtp_notify_delay;
+  message.enable.chunking = true; // BDAT when the server offers CHUNKING
+
+  /* Connect to the server */
+  prepareConnect();
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint32_t start = millis();
+  PHASE_TIMER(connectTimer, PHASE_SMTP_CONNECT);
+  if (!_smtp.connect(&_session)) {
+    connectFailed();
+    return false;
+  }
+  PHASE_STOP(connectTimer);
+  connectMs.observe(millis() - start);
+  connected(heapBefore);
+
+  /* Start sending Email and close the session */
+  start = millis();
+  PHASE_TIMER(sendTimer, PHASE_SMTP_SEND);
+  bool sent = MailClient.sendMail(&_smtp, &message);
+  PHASE_STOP(sendTimer);
+  sendMs.observe(millis() - start);
+  if (_heap) _heap->sample(HEAP_PHASE_POST_SEND);
+  if (!sent) {
+    LOG_E("Error sending Email");
+    sendErrors.inc();
+  }
+  return sent;
+}
+
+/* Alert text plus a CSV attachment written straight from the sample log into the session:
+ * log records -> CSV (SampleLog::stream) -> base64 (Base64Stream) -> BDAT chunks (SmtpStream) */
+bool SmtpAlertSink::deliverWithHistory(const AlertEvent &e, uint32_t now) {
+  ArenaScope scope(_arena);
+  SmtpStream out(_smtp, _chunk, sizeof(_chunk));
+
+  prepareConnect();
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint32_t start = millis();
+  PHASE_TIMER(connectTimer, PHASE_SMTP_CONNECT);
+  if (!out.begin(_session, _sender, _recipient)) {
+    LOG_E("SMTP stream open failed, status %d", out.lastStatus());
+    connectFailed();
+    return false;
+  }
+  PHASE_STOP(connectTimer);
+  connectMs.observe(millis() - start);
+  connected(heapBefore);
+
+  start = millis();
+  PHASE_TIMER(sendTimer, PHASE_SMTP_SEND);
+  char date[40];
+  time_t seconds = now;
+  struct tm tm;
+  gmtime_r(&seconds, &tm);
+  strftime(date, sizeof(date), "%a, %d %b %Y %H:%M:%S +0000", &tm);
+  char boundary[32];
+  snprintf(boundary, sizeof(boundary), "crystal-%08lx", (unsigned long)esp_random());
+  char text[ALERT_BODY_MAX + 2];   // the stream takes whole lines only
+  snprintf(text, sizeof(text), "%s\r\n", _body);
+
+  bool ok = out.printf("Date: %s\r\n", date) &&
+            out.printf("From: ESP <%s>\r\n", _sender) &&
+            out.printf("To: Sam <%s>\r\n", _recipient) &&
+            out.printf("Subject: %s\r\n", _subject) &&
+            out.print("MIME-Version: 1.0\r\n") &&
+            out.printf("Content-Type: multipart/mixed; boundary=\"%s\"\r\n\r\n", boundary) &&
+            out.printf("--%s\r\nContent-Type: text/plain; charset=\"us-ascii\"\r\n", boundary) &&
+            out.print("Content-Transfer-Encoding: 7bit\r\n\r\n") &&
+            out.print(text) &&
+            out.printf("\r\nAttached: the last %lu hours in %lu-minute steps (UTC).\r\n",
+                       (unsigned long)(_historyWindowS / 3600), (unsigned long)(_historyResolutionS / 60)) &&
+            out.printf("--%s\r\nContent-Type: text/csv; name=\"history.csv\"\r\n", boundary) &&
+            out.print("Content-Disposition: attachment; filename=\"history.csv\"\r\n") &&
+            out.print("Content-Transfer-Encoding: base64\r\n\r\n");
+
+  if (ok) {
+    char lines[BASE64_LINE_OUTPUT * 6];
+    char csv[256];
+    Base64Stream encoder(lines, sizeof(lines), SmtpStream::sink, &out);
+    ok = _history->stream(now - _historyWindowS, now, _historyResolutionS, Base64Stream::input, &encoder, csv,
+                          sizeof(csv)) &&
+         encoder.finish();
+  }
+  ok = ok && out.printf("--%s--\r\n", boundary);
+
+  bool sent = out.end() && ok;
+  PHASE_STOP(sendTimer);
+  sendMs.observe(millis() - start);
+  if (_heap) _heap->sample(HEAP_PHASE_POST_SEND);
+  if (!sent) {
+    LOG_E("Error sending Email with history, status %d", out.lastStatus());
+    sendErrors.inc();
+  } else {
+    LOG_I("Alert email sent with history, %u bytes%s", (unsigned)out.bytes(), out.chunking() ? " (BDAT)" : "");
+  }
+  return sent;
+}
+
+bool MqttAlertSink::deliver(const AlertEvent &e) {
+  MqttAlert kind = e.sensor == ALERT_SENSOR_LIQUID_LEVEL ? MQTT_ALERT_LIQUID_LOW
+                   : e.sensor == ALERT_SENSOR_HEAP         ? MQTT_ALERT_HEAP
+                                                           : MQTT_ALERT_TEMPERATURE;
+  return _mqtt.sendAlert(kind, e.severity != ALERT_SEVERITY_CLEAR, e.sampleUs);
+}
+
+bool WebhookAlertSink::ready() const { return WiFi.status() == WL_CONNECTED; }
+
+static void jsonNumber(char *out, size_t len, float v) {
+  if (isnan(v)) snprintf(out, len, "null");
+  else formatFixed(out, len, v, 2);
+}
+
+bool WebhookAlertSink::deliver(const AlertEvent &e) {
+  char stamp[ALERT_STAMP_MAX], value[ALERT_NUMBER_MAX], low[ALERT_NUMBER_MAX], high[ALERT_NUMBER_MAX], body[256];
+  _time.format(stamp, sizeof(stamp), e.sampleUs);
+  jsonNumber(value, sizeof(value), e.value);
+  jsonNumber(low, sizeof(low), e.thresholdLow);
+  jsonNumber(high, sizeof(high), e.thresholdHigh);
+  int len = snprintf(body, sizeof(body),
+                     "{\"tank\":\"%s\",\"sensor\":\"%s\",\"severity\":\"%s\",\"value\":%s,\"threshold_low\":%s,"
+                     "\"threshold_high\":%s,\"time\":\"%s\",\"utc\":%lld}",
+                     _tankName, alertSensorName(e.sensor), alertSeverityName(e.severity), value, low, high, stamp,
+                     (long long)(_time.utcUs(e.sampleUs) / 1000000LL));
+  if (len <= 0 || len >= (int)sizeof(body)) return false;
+
+  HTTPClient http;
+  http.setTimeout(WEBHOOK_TIMEOUT_MS);
+  if (!http.begin(_url)) return false;
+  http.addHeader("Content-Type", "application/json");
+  int code = http.POST((uint8_t *)body, len);
+  http.end();
+  return code >= 200 && code < 300;
+}
+
+bool SerialAlertSink::deliver(const AlertEvent &e) {
+  char text[ALERT_BODY_MAX];
+  formatAlertText(text, sizeof(text), e, _time, _tankName);
+  _out.printf("ALERT [%s/%s] %s\n", alertSensorName(e.sensor), alertSeverityName(e.severity), text);
+  return true;
+}
+
+bool FileAlertSink::deliver(const AlertEvent &e) {
+  File file = _fs.open(ALERT_LOG_PATH, "a");
+  if (!file) return false;
+  if (file.size() >= ALERT_LOG_MAX) {
+    file.close();
+    _fs.remove(ALERT_LOG_OLD_PATH);
+    _fs.rename(ALERT_LOG_PATH, ALERT_LOG_OLD_PATH);
+    file = _fs.open(ALERT_LOG_PATH, "a");
+    if (!file) return false;
+  }
+
+  char text[ALERT_BODY_MAX];
+  formatAlertText(text, sizeof(text), e, _time, _tankName);
+  bool ok = file.printf("%s,%s,%s\n", alertSensorName(e.sensor), alertSeverityName(e.severity), text) > 0;
+  file.close();
+  return ok;
+}
@@ -0,0 +1,162 @@
+#include "async_log.h"
+
+/* A record is a header word, the uptime in ms and the text padded to a word:
+ *   header = text length | level << 16 | state << 24
+ * A producer reserves the whole record by moving _head, fills it and stores the header last; the
+ * drain waits on a zero header, so a record still being written holds back the ones behind it.
+ * A record never wraps: the rest of the ring becomes a pad record and it starts again at 0. The
+ * drain zeroes everything it has written out, which keeps every free byte a zero header. */
+#define LOG_RECORD_EMPTY 0
+#define LOG_RECORD_READY 1
+#define LOG_RECORD_PAD   2
+#define LOG_RECORD_HEAD  8
+
+static_assert((LOG_RING_SIZE & (LOG_RING_SIZE - 1)) == 0, "LOG_RING_SIZE must be a power of two");
+static_assert(LOG_RECORD_HEAD + LOG_LINE_MAX <= LOG_RING_SIZE / 4, "LOG_LINE_MAX too long for the ring");
+
+static const char levelLetters[] = "EWID";
+
+AsyncLog asyncLog;
+
+AsyncLog::AsyncLog()
+    : _head(0), _tail(0), _highWater(0), _level(LOG_LEVEL_INFO), _task(nullptr), _droppedReported(0) {
+  memset(_ring, 0, sizeof(_ring));
+}
+
+bool AsyncLog::begin(uint32_t baud) {
+  Serial.begin(baud);
+  if (_task) return true;
+  return xTaskCreate(taskMain, "log", LOG_TASK_STACK, this, LOG_TASK_PRIORITY, &_task) == pdPASS;
+}
+
+void AsyncLog::log(LogLevel level, const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vlog(level, fmt, args);
+  va_end(args);
+}
+
+void AsyncLog::vlog(LogLevel level, const char *fmt, va_list args) {
+  if (!enabled(level)) return;
+  char line[LOG_LINE_MAX];
+  int len = vsnprintf(line, sizeof(line), fmt, args);
+  if (len < 0) return;
+  if (len >= (int)sizeof(line)) {
+    _stats.truncated.inc();
+    len = sizeof(line) - 1;
+  }
+  push(level, line, len);
+}
+
+size_t AsyncLog::write(uint8_t c) { return write(&c, 1); }
+
+/* Long writes go in LOG_LINE_MAX pieces; what does not fit is dropped, but the caller is told it
+ * was written, as Print callers stop at a short write */
+size_t AsyncLog::write(const uint8_t *data, size_t len) {
+  if (!_task) return len;
+  for (size_t done = 0; done < len; done += LOG_LINE_MAX) {
+    size_t n = len - done < LOG_LINE_MAX ? len - done : LOG_LINE_MAX;
+    push(LOG_LEVEL_RAW, (const char *)data + done, n);
+  }
+  return len;
+}
+
+bool AsyncLog::push(LogLevel level, const char *text, size_t len) {
+  uint32_t size = LOG_RECORD_HEAD + ((len + 3) & ~3u);
+  uint32_t head = _head.load(std::memory_order_relaxed);
+  uint32_t pad, next;
+  for (;;) {
+    uint32_t offset = head & (LOG_RING_SIZE - 1);
+    pad = offset + size > LOG_RING_SIZE ? LOG_RING_SIZE - offset : 0;
+    next = head + pad + size;
+    uint32_t tail = _tail.load(std::memory_order_acquire);
+    if (next - tail > LOG_RING_SIZE) {
+      /* A stale head can be behind a tail that has moved on since; only a current one means full */
+      uint32_t now = _head.load(std::memory_order_relaxed);
+      if (now != head) {
+        head = now;
+        continue;
+      }
+      _stats.dropped.inc();
+      return false;
+    }
+    if (_head.compare_exchange_weak(head, next, std::memory_order_relaxed, std::memory_order_relaxed)) break;
+  }
+
+  if (pad) {
+    uint32_t *header = (uint32_t *)&_ring[head & (LOG_RING_SIZE - 1)];
+    __atomic_store_n(header, pad | (uint32_t)LOG_RECORD_PAD << 24, __ATOMIC_RELEASE);
+  }
+  uint8_t *record = &_ring[(head + pad) & (LOG_RING_SIZE - 1)];
+  uint32_t ms = millis();
+  memcpy(record + 4, &ms, sizeof(ms));
+  memcpy(record + LOG_RECORD_HEAD, text, len);
+  __atomic_store_n((uint32_t *)record, len | (uint32_t)level << 16 | (uint32_t)LOG_RECORD_READY << 24,
+                   __ATOMIC_RELEASE);
+
+  _stats.records.inc();
+  uint32_t used = next - _tail.load(std::memory_order_relaxed);   // wraps if the drain is already past it
+  uint32_t high = _highWater.load(std::memory_order_relaxed);
+  while (used <= LOG_RING_SIZE && used > high &&
+         !_highWater.compare_exchange_weak(high, used, std::memory_order_relaxed)) {
+  }
+  xTaskNotifyGive(_task);
+  return true;
+}
+
+/* Writes out the record at the tail; false when the ring is empty or that record is not complete */
+bool AsyncLog::drainOne() {
+  uint32_t tail = _tail.load(std::memory_order_relaxed);
+  if (tail == _head.load(std::memory_order_acquire)) return false;
+  uint8_t *record = &_ring[tail & (LOG_RING_SIZE - 1)];
+  uint32_t header = __atomic_load_n((uint32_t *)record, __ATOMIC_ACQUIRE);
+  uint8_t state = header >> 24;
+  if (state == LOG_RECORD_EMPTY) return false;
+
+  uint32_t len = header & 0xffff, size = len;
+  if (state == LOG_RECORD_READY) {
+    uint8_t level = (header >> 16) & 0xff;
+    size_t written = 0;
+    if (level != LOG_LEVEL_RAW) {
+      uint32_t ms;
+      memcpy(&ms, record + 4, sizeof(ms));
+      written += Serial.printf("%c (%lu) ", levelLetters[level & 3], (unsigned long)ms);
+    }
+    written += Serial.write(record + LOG_RECORD_HEAD, len);
+    if (level != LOG_LEVEL_RAW) written += Serial.write((const uint8_t *)"\r\n", 2);
+    _stats.bytes.inc(written);
+    size = LOG_RECORD_HEAD + ((len + 3) & ~3u);
+  }
+  memset(record, 0, size);
+  _tail.store(tail + size, std::memory_order_release);
+  return true;
+}
+
+void AsyncLog::taskMain(void *arg) {
+  AsyncLog *self = (AsyncLog *)arg;
+  for (;;) {
+    while (self->drainOne()) {
+    }
+    uint32_t dropped = self->_stats.dropped.value();
+    if (dropped != self->_droppedReported) {
+      Serial.printf("W (%lu) log: %lu messages dropped\r\n", (unsigned long)millis(),
+                    (unsigned long)(dropped - self->_droppedReported));
+      self->_droppedReported = dropped;
+    }
+    /* The timeout picks up a record whose producer was preempted before storing its header */
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(100));
+  }
+}
+
+void AsyncLog::flush() { flush(1000); }
+
+bool AsyncLog::flush(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (_task && _tail.load(std::memory_order_acquire) != _head.load(std::memory_order_relaxed)) {
+    if (millis() - start >= timeoutMs) return false;
+    xTaskNotifyGive(_task);
+    vTaskDelay(1);
+  }
+  Serial.flush();
+  return true;
+}
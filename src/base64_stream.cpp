@@ -0,0 +1,113 @@
+#include "base64_stream.h"
+
+#include <string.h>
+
+static const char base64Table[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+/* 32-bit load in network order; memcpy keeps it legal for unaligned input */
+static inline uint32_t loadBe32(const uint8_t *p) {
+  uint32_t w;
+  memcpy(&w, p, 4);
+  return __builtin_bswap32(w);
+}
+
+/* 12 bytes -> 16 characters */
+static inline void encode12(const uint8_t *in, char *out) {
+  uint32_t a = loadBe32(in), b = loadBe32(in + 4), c = loadBe32(in + 8);
+  out[0] = base64Table[a >> 26];
+  out[1] = base64Table[(a >> 20) & 63];
+  out[2] = base64Table[(a >> 14) & 63];
+  out[3] = base64Table[(a >> 8) & 63];
+  out[4] = base64Table[(a >> 2) & 63];
+  out[5] = base64Table[((a << 4) | (b >> 28)) & 63];
+  out[6] = base64Table[(b >> 22) & 63];
+  out[7] = base64Table[(b >> 16) & 63];
+  out[8] = base64Table[(b >> 10) & 63];
+  out[9] = base64Table[(b >> 4) & 63];
+  out[10] = base64Table[((b << 2) | (c >> 30)) & 63];
+  out[11] = base64Table[(c >> 24) & 63];
+  out[12] = base64Table[(c >> 18) & 63];
+  out[13] = base64Table[(c >> 12) & 63];
+  out[14] = base64Table[(c >> 6) & 63];
+  out[15] = base64Table[c & 63];
+}
+
+/* 1 to 3 bytes -> 4 characters, padded with '=' */
+static inline void encodeTail(const uint8_t *in, size_t len, char *out) {
+  uint32_t v = (uint32_t)in[0] << 16;
+  if (len > 1) v |= (uint32_t)in[1] << 8;
+  if (len > 2) v |= in[2];
+  out[0] = base64Table[v >> 18];
+  out[1] = base64Table[(v >> 12) & 63];
+  out[2] = len > 1 ? base64Table[(v >> 6) & 63] : '=';
+  out[3] = len > 2 ? base64Table[v & 63] : '=';
+}
+
+Base64Stream::Base64Stream(char *buf, size_t len, Base64Sink sink, void *arg)
+    : _buf(buf), _len(len), _used(0), _sink(sink), _arg(arg), _ok(len >= BASE64_BUFFER_MIN), _encoded(0),
+      _carryLen(0) {}
+
+size_t Base64Stream::encodedLength(size_t len) {
+  size_t lines = (len + BASE64_LINE_INPUT - 1) / BASE64_LINE_INPUT;
+  return (len + 2) / 3 * 4 + lines * 2;
+}
+
+bool Base64Stream::flush() {
+  if (_ok && _used) _ok = _sink(_arg, _buf, _used);
+  _used = 0;
+  return _ok;
+}
+
+/* One line of up to BASE64_LINE_INPUT bytes; only the last line of a stream is shorter */
+void Base64Stream::encodeLine(const uint8_t *in, size_t len) {
+  if (_len - _used < BASE64_LINE_OUTPUT && !flush()) return;
+
+  char *out = _buf + _used;
+  char *start = out;
+  for (; len >= 12; len -= 12, in += 12, out += 16) encode12(in, out);
+  for (; len >= 3; len -= 3, in += 3, out += 4) encodeTail(in, 3, out);
+  if (len) {
+    encodeTail(in, len, out);
+    out += 4;
+  }
+  *out++ = '\r';
+  *out++ = '\n';
+  _used += out - start;
+  _encoded += out - start;
+}
+
+bool Base64Stream::write(const uint8_t *data, size_t len) {
+  if (!_ok) return false;
+
+  /* Complete a line left over from the last call first */
+  if (_carryLen) {
+    size_t take = BASE64_LINE_INPUT - _carryLen;
+    if (take > len) take = len;
+    memcpy(_carry + _carryLen, data, take);
+    _carryLen += take;
+    data += take;
+    len -= take;
+    if (_carryLen < BASE64_LINE_INPUT) return true;
+    encodeLine(_carry, BASE64_LINE_INPUT);
+    _carryLen = 0;
+  }
+
+  for (; len >= BASE64_LINE_INPUT && _ok; len -= BASE64_LINE_INPUT, data += BASE64_LINE_INPUT) {
+    encodeLine(data, BASE64_LINE_INPUT);
+  }
+  if (!_ok) return false;
+
+  memcpy(_carry, data, len);
+  _carryLen = len;
+  return _ok;
+}
+
+bool Base64Stream::input(void *arg, const char *data, size_t len) {
+  return static_cast<Base64Stream *>(arg)->write(reinterpret_cast<const uint8_t *>(data), len);
+}
+
+bool Base64Stream::finish() {
+  if (_ok && _carryLen) encodeLine(_carry, _carryLen);
+  _carryLen = 0;
+  return flush();
+}
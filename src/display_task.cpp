@@ -0,0 +1,106 @@
+#include "display_task.h"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "phase_timer.h"
+
+DisplayTask::DisplayTask(I2cLcd &lcd, const SensorMailbox &mailbox, const char *tankName)
+    : _lcd(lcd), _mailbox(mailbox), _tankName(tankName),
+#if defined(TFT_DASHBOARD)
+      _dashboard(nullptr),
+#endif
+      _frames(0), _lcdWrites(0) {
+  _shown[0][0] = '\0';
+  _shown[1][0] = '\0';
+}
+
+bool DisplayTask::begin() {
+  return xTaskCreatePinnedToCore(taskMain, "display", DISPLAY_TASK_STACK, this, DISPLAY_TASK_PRIORITY, nullptr,
+                                 DISPLAY_TASK_CORE) == pdPASS;
+}
+
+void DisplayTask::taskMain(void *arg) {
+  DisplayTask *self = static_cast<DisplayTask *>(arg);
+  const TickType_t period = pdMS_TO_TICKS(1000 / DISPLAY_FPS);
+  TickType_t wake = xTaskGetTickCount();
+#if defined(TFT_DASHBOARD)
+  uint64_t trendSampleUs = 0;
+#endif
+
+  for (;;) {
+    SensorSnapshot snap;
+    bool hasSample = self->_mailbox.read(snap);
+
+    PHASE_TIMER(lcdTimer, PHASE_LCD);
+    self->renderLcd(snap, hasSample, millis());
+    PHASE_STOP(lcdTimer);
+
+#if defined(TFT_DASHBOARD)
+    if (self->_dashboard) {
+      PHASE_TIME(PHASE_TFT);
+      /* Alert status updates republish the same sample; only new samples go into the trend */
+      if (hasSample && snap.sampleUs != trendSampleUs) {
+        self->_dashboard->pushSample(snap);
+        trendSampleUs = snap.sampleUs;
+      }
+      self->_dashboard->render();
+    }
+#endif
+    self->_frames++;
+
+    /* Frame cap; if a frame overran, the next one starts right away */
+    vTaskDelayUntil(&wake, period);
+  }
+}
+
+void DisplayTask::renderLcd(const SensorSnapshot &snap, bool hasSample, uint32_t now) {
+  char line[17];
+
+  /* Boot splash until loop() has published the first sample */
+  if (!hasSample) {
+    writeLine(0, " CRYSTALTRONICS ");
+    writeLine(1, "      2025      ");
+    return;
+  }
+
+  /* First line cycles through the readings like the old loop() did */
+  switch ((now / DISPLAY_PAGE_MS) % 3) {
+    case 0:
+      if (isnan(snap.temperature)) snprintf(line, sizeof(line), " ERROR READ TEMP");
+      else snprintf(line, sizeof(line), "TEMP: %.2fdeg C", snap.temperature);
+      break;
+    case 1:
+      if (isnan(snap.humidity)) snprintf(line, sizeof(line), " ERROR READ HUM ");
+      else snprintf(line, sizeof(line), "HUMIDITY: %.2f%%", snap.humidity);
+      break;
+    default:
+      snprintf(line, sizeof(line), snap.liquidLow ? "LIQUID LVL : LOW" : "LIQUID LVL: OK !");
+      break;
+  }
+  writeLine(0, line);
+
+  /* Second line: alert progress first, then the tank name */
+  switch (snap.alert) {
+    case ALERT_SENDING: writeLine(1, "Sending alert..."); return;
+    case ALERT_SENT:    writeLine(1, "EMAIL ALERT SENT"); return;
+    case ALERT_FAILED:  writeLine(1, "EMAIL NOT SENT !"); return;
+    default: break;
+  }
+  if (snap.tempAlert) {
+    writeLine(1, " TEMP IS NOT OK ");
+  } else {
+    snprintf(line, sizeof(line), "=====%s=====", _tankName);
+    writeLine(1, line);
+  }
+}
+
+/* Pads to the full 16 columns and only touches the bus when the text changed */
+void DisplayTask::writeLine(uint8_t row, const char *text) {
+  char padded[17];
+  snprintf(padded, sizeof(padded), "%-16s", text);
+  if (strcmp(padded, _shown[row]) == 0) return;
+
+  if (!_lcd.writeLine(row, padded)) return; // bus busy, retried next frame
+  memcpy(_shown[row], padded, sizeof(padded));
+  _lcdWrites++;
+}
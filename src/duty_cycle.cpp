@@ -0,0 +1,67 @@
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <esp_sleep.h>
+#include <sys/time.h>
+#include "duty_cycle.h"
+
+WakeReason readWakeReason() {
+  switch (esp_sleep_get_wakeup_cause()) {
+    case ESP_SLEEP_WAKEUP_UNDEFINED: return WAKE_POWER_ON;
+    case ESP_SLEEP_WAKEUP_TIMER:     return WAKE_TIMER;
+    case ESP_SLEEP_WAKEUP_EXT0:      return WAKE_LEVEL_PIN;
+    case ESP_SLEEP_WAKEUP_ULP:       return WAKE_ULP;
+    default:                         return WAKE_OTHER;
+  }
+}
+
+/* The RTC keeps time through deep sleep, unlike esp_timer/micros() which restart on every wake */
+uint64_t rtcClockUs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (uint64_t)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+/* Returns how many lines went out whole; a line cut short by a full flash is not counted */
+static uint16_t appendCsv(File &file, const PackedSample *samples, uint16_t n) {
+  char line[48];
+  for (uint16_t i = 0; i < n; i++) {
+    const PackedSample &s = samples[i];
+    int len = snprintf(line, sizeof(line), "%lu,%d,%u,%u,%u\n", (unsigned long)s.time, s.tempCenti, s.humCenti,
+                       s.liquidLow, s.tempAlert);
+    if (file.write((const uint8_t *)line, len) != (size_t)len) return i;
+  }
+  return n;
+}
+
+/* Appends the buffered samples, oldest first, to the CSV log; returns how many were written.
+ * After a failed write the lines already in the file are dropped from the buffer all the same,
+ * so the next flush carries on after them instead of writing them a second time. What is left
+ * of a cut line is ended first, so it does not run into the line written again after it. */
+size_t flushDutyBuffer(DutyCycle &cycle) {
+  const PackedSample *first, *second;
+  uint16_t firstLen, secondLen;
+  if (!cycle.pending(&first, &firstLen, &second, &secondLen)) return 0;
+
+  File file = LittleFS.open(DUTY_LOG_PATH, "a+");
+  if (!file) return 0;
+  size_t size = file.size();
+  if (size && file.seek(size - 1) && file.read() != '\n' && file.write('\n') != 1) {
+    file.close();
+    return 0;
+  }
+  uint16_t written = appendCsv(file, first, firstLen);
+  if (written == firstLen) written += appendCsv(file, second, secondLen);
+  file.close();
+
+  if (written) cycle.flushed(written);
+  return written;
+}
+
+void enterDeepSleep(uint64_t sleepUs, bool armLevelWake, uint8_t levelPin) {
+  esp_sleep_enable_timer_wakeup(sleepUs);
+  if (armLevelWake) {
+    /* LevelSensor reads 1 when the liquid is low */
+    esp_sleep_enable_ext0_wakeup((gpio_num_t)levelPin, 1);
+  }
+  esp_deep_sleep_start();
+}
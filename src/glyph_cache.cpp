@@ -0,0 +1,158 @@
+#include "glyph_cache.h"
+
+GlyphCache::GlyphCache() : _font(nullptr), _glyphCount(0), _runCount(0) {}
+
+bool GlyphCache::begin(const GFXfont *font, const char *charset) {
+  _font = font;
+  _glyphCount = 0;
+  _runCount = 0;
+
+  bool complete = true;
+  for (const char *p = charset; *p; p++) {
+    if (find(*p)) continue;
+    if (_glyphCount >= GLYPH_CACHE_MAX_GLYPHS || !rasterize(*p)) complete = false;
+  }
+  return complete;
+}
+
+bool GlyphCache::glyphBox(char c, Box &box) const {
+  if (!_font) {
+    box = Box{6, 8, 0, 0, 6};
+    return true;
+  }
+
+  uint8_t first = pgm_read_byte(&_font->first);
+  uint8_t last = pgm_read_byte(&_font->last);
+  if ((uint8_t)c < first || (uint8_t)c > last) return false;
+
+  /* Flash is memory mapped, so the glyph table is read in place as GFX does off AVR */
+  const GFXglyph *glyph = &_font->glyph[(uint8_t)c - first];
+  box.w = pgm_read_byte(&glyph->width);
+  box.h = pgm_read_byte(&glyph->height);
+  box.ox = (int8_t)pgm_read_byte(&glyph->xOffset);
+  box.oy = (int8_t)pgm_read_byte(&glyph->yOffset);
+  box.advance = pgm_read_byte(&glyph->xAdvance);
+  return true;
+}
+
+/* Draws the glyph once into a 1-bit canvas with the stock GFX code, then scans it into runs */
+bool GlyphCache::rasterize(char c) {
+  Box box;
+  if (!glyphBox(c, box)) return false;
+
+  Glyph &g = _glyphs[_glyphCount];
+  g.c = c;
+  g.advance = box.advance;
+  g.firstRun = _runCount;
+  g.runs = 0;
+
+  if (box.w > 0 && box.h > 0) {
+    GFXcanvas1 canvas(box.w, box.h);
+    if (!canvas.getBuffer()) return false;
+    canvas.setFont(_font);
+    canvas.drawChar(-box.ox, -box.oy, c, 1, 1, 1);
+
+    for (int16_t y = 0; y < box.h; y++) {
+      int16_t x = 0;
+      while (x < box.w) {
+        if (!canvas.getPixel(x, y)) { x++; continue; }
+        int16_t start = x;
+        while (x < box.w && canvas.getPixel(x, y) && x - start < 255) x++;
+
+        if (_runCount >= GLYPH_CACHE_MAX_RUNS) {
+          _runCount = g.firstRun; // drop the partial glyph
+          return false;
+        }
+        _runs[_runCount++] = Run{(int8_t)(start + box.ox), (int8_t)(y + box.oy), (uint8_t)(x - start)};
+        g.runs++;
+      }
+    }
+  }
+
+  _glyphCount++;
+  return true;
+}
+
+const GlyphCache::Glyph *GlyphCache::find(char c) const {
+  for (uint8_t i = 0; i < _glyphCount; i++) {
+    if (_glyphs[i].c == c) return &_glyphs[i];
+  }
+  return nullptr;
+}
+
+/* Not in the cache: draws the glyph from the cache's font through a scratch canvas, the slow way,
+ * so the font set on `g` stays as the caller left it. Called inside startWrite(); returns the advance. */
+int16_t GlyphCache::drawUncached(Adafruit_GFX &g, int16_t x, int16_t y, char c, uint16_t color,
+                                 uint8_t size) const {
+  Box box;
+  if (!glyphBox(c, box)) return 0;
+  if (box.w > 0 && box.h > 0) {
+    GFXcanvas1 canvas(box.w, box.h);
+    if (!canvas.getBuffer()) return box.advance * size;
+    canvas.setFont(_font);
+    canvas.drawChar(-box.ox, -box.oy, c, 1, 1, 1);
+
+    for (int16_t py = 0; py < box.h; py++) {
+      for (int16_t px = 0; px < box.w; px++) {
+        if (canvas.getPixel(px, py)) {
+          g.writeFillRect(x + (px + box.ox) * size, y + (py + box.oy) * size, size, size, color);
+        }
+      }
+    }
+  }
+  return box.advance * size;
+}
+
+int16_t GlyphCache::drawString(Adafruit_GFX &g, int16_t x, int16_t y, const char *text, uint16_t color,
+                               uint8_t size) const {
+  g.startWrite();
+  for (const char *p = text; *p; p++) {
+    const Glyph *glyph = find(*p);
+    if (!glyph) {
+      x += drawUncached(g, x, y, *p, color, size);
+      continue;
+    }
+
+    const Run *run = &_runs[glyph->firstRun];
+    for (uint16_t i = 0; i < glyph->runs; i++, run++) {
+      if (size == 1) g.writeFastHLine(x + run->x, y + run->y, run->len, color);
+      else g.writeFillRect(x + run->x * size, y + run->y * size, run->len * size, size, color);
+    }
+    x += glyph->advance * size;
+  }
+  g.endWrite();
+  return x;
+}
+
+int16_t GlyphCache::drawString(GFXcanvas16 &canvas, int16_t x, int16_t y, const char *text, uint16_t color,
+                               uint8_t size) const {
+  uint16_t *buffer = canvas.getBuffer();
+  if (!buffer || canvas.getRotation() != 0) {
+    return drawString(static_cast<Adafruit_GFX &>(canvas), x, y, text, color, size);
+  }
+
+  const int16_t w = canvas.width(), h = canvas.height();
+  for (const char *p = text; *p; p++) {
+    const Glyph *glyph = find(*p);
+    if (!glyph) {
+      x += drawUncached(canvas, x, y, *p, color, size);
+      continue;
+    }
+
+    const Run *run = &_runs[glyph->firstRun];
+    for (uint16_t i = 0; i < glyph->runs; i++, run++) {
+      int16_t x0 = x + run->x * size, x1 = x0 + run->len * size;
+      int16_t y0 = y + run->y * size, y1 = y0 + size;
+      if (x0 < 0) x0 = 0;
+      if (x1 > w) x1 = w;
+      if (y0 < 0) y0 = 0;
+      if (y1 > h) y1 = h;
+      for (int16_t row = y0; row < y1; row++) {
+        uint16_t *pixel = buffer + (int32_t)row * w + x0;
+        for (int16_t n = x1 - x0; n > 0; n--) *pixel++ = color;
+      }
+    }
+    x += glyph->advance * size;
+  }
+  return x;
+}
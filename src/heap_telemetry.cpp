@@ -0,0 +1,120 @@
+#include "heap_telemetry.h"
+
+#include <esp_heap_caps.h>
+#include <freertos/task.h>
+
+static const char *const phaseNames[HEAP_PHASES] = {"loop", "pre_connect", "post_handshake", "post_send"};
+
+HeapTelemetry::HeapTelemetry(uint8_t warnPct, uint8_t clearPct)
+    : _warnPct(warnPct), _clearPct(clearPct), _fragPct(0), _fragmented(false), _taskCount(0), _head(0), _filled(0) {
+  for (uint8_t p = 0; p < HEAP_PHASES; p++) _largest[p].store(0, std::memory_order_relaxed);
+  _lock = portMUX_INITIALIZER_UNLOCKED;
+}
+
+const char *HeapTelemetry::phaseName(HeapPhase p) { return p < HEAP_PHASES ? phaseNames[p] : "?"; }
+
+bool HeapTelemetry::watchTask(const char *name) {
+  if (_taskCount >= HEAP_WATCH_TASKS) return false;
+  _tasks[_taskCount++] = name;
+  return true;
+}
+
+void HeapTelemetry::sample(HeapPhase phase) {
+  if (phase >= HEAP_PHASES) return;
+  HeapSample s;
+  s.uptimeS = millis() / 1000;
+  /* Both from internal RAM: MALLOC_CAP_8BIT counts PSRAM too, whose largest block dwarfs the internal
+   * free heap. The two reads are not atomic, so the block is clamped to what was free. */
+  s.freeBytes = heap_caps_get_free_size(MALLOC_CAP_INTERNAL);
+  size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL);
+  s.largestBlock = largest < s.freeBytes ? largest : s.freeBytes;
+  s.stackFree = uxTaskGetStackHighWaterMark(nullptr);
+  s.phase = phase;
+
+  _stats[phase].collect();
+  _largest[phase].store(s.largestBlock, std::memory_order_relaxed);
+
+  portENTER_CRITICAL(&_lock);
+  _ring[_head] = s;
+  _head = (_head + 1) % HEAP_HISTORY;
+  if (_filled < HEAP_HISTORY) _filled++;
+  portEXIT_CRITICAL(&_lock);
+
+  if (phase != HEAP_PHASE_LOOP || !s.freeBytes) return;
+  uint8_t pct = 100 - (uint8_t)((uint64_t)s.largestBlock * 100 / s.freeBytes);
+  _fragPct.store(pct, std::memory_order_relaxed);
+  if (pct >= _warnPct) _fragmented.store(true, std::memory_order_relaxed);
+  else if (pct < _clearPct) _fragmented.store(false, std::memory_order_relaxed);
+}
+
+bool HeapTelemetry::lowest(HeapSample &out, size_t &window) const {
+  portENTER_CRITICAL(&_lock);
+  window = _filled;
+  size_t low = 0;
+  for (size_t i = 1; i < _filled; i++) {
+    if (_ring[i].freeBytes < _ring[low].freeBytes) low = i;
+  }
+  if (_filled) out = _ring[low];
+  portEXIT_CRITICAL(&_lock);
+  return window > 0;
+}
+
+void HeapTelemetry::writeMetrics(PromWriter &out) {
+  char labels[40];
+  out.family("crystal_heap_phase_free_bytes", "gauge", "Free heap at the last sample of each phase");
+  for (uint8_t p = 0; p < HEAP_PHASES; p++) {
+    snprintf(labels, sizeof(labels), "phase=\"%s\"", phaseNames[p]);
+    out.sample("crystal_heap_phase_free_bytes", labels, (uint64_t)_stats[p].current());
+  }
+  out.family("crystal_heap_phase_min_free_bytes", "gauge", "Lowest free heap seen at each phase");
+  for (uint8_t p = 0; p < HEAP_PHASES; p++) {
+    snprintf(labels, sizeof(labels), "phase=\"%s\"", phaseNames[p]);
+    out.sample("crystal_heap_phase_min_free_bytes", labels, (uint64_t)_stats[p].min());
+  }
+  out.family("crystal_heap_phase_largest_block_bytes", "gauge", "Largest free block at the last sample of each phase");
+  for (uint8_t p = 0; p < HEAP_PHASES; p++) {
+    snprintf(labels, sizeof(labels), "phase=\"%s\"", phaseNames[p]);
+    out.sample("crystal_heap_phase_largest_block_bytes", labels,
+               (uint64_t)_largest[p].load(std::memory_order_relaxed));
+  }
+  out.gauge("crystal_heap_fragmentation_ratio", "1 - largest block / free heap, at the last loop() cycle",
+            fragmentationPct() / 100.0);
+  out.gauge("crystal_heap_fragmented", "1 while the heap fragmentation alert is raised", fragmented() ? 1 : 0);
+
+  out.family("crystal_task_stack_free_bytes", "gauge", "Least free stack each task has had");
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    TaskHandle_t task = xTaskGetHandle(_tasks[i]);
+    if (!task) continue;
+    snprintf(labels, sizeof(labels), "task=\"%s\"", _tasks[i]);
+    out.sample("crystal_task_stack_free_bytes", labels, (uint64_t)uxTaskGetStackHighWaterMark(task));
+  }
+}
+
+void HeapTelemetry::printStats(Print &out) {
+  out.printf("Heap %d free (min %d, ever %lu), largest block %lu, %u%% fragmented%s\n",
+             _stats[HEAP_PHASE_LOOP].current(), _stats[HEAP_PHASE_LOOP].min(), (unsigned long)ESP.getMinFreeHeap(),
+             (unsigned long)_largest[HEAP_PHASE_LOOP].load(std::memory_order_relaxed), fragmentationPct(),
+             fragmented() ? " (alert)" : "");
+  if (_stats[HEAP_PHASE_PRE_CONNECT].count()) {
+    out.printf("Heap SMTP  connect %d, handshake %d, send %d free (min %d, %d, %d)\n",
+               _stats[HEAP_PHASE_PRE_CONNECT].current(), _stats[HEAP_PHASE_POST_HANDSHAKE].current(),
+               _stats[HEAP_PHASE_POST_SEND].current(), _stats[HEAP_PHASE_PRE_CONNECT].min(),
+               _stats[HEAP_PHASE_POST_HANDSHAKE].min(), _stats[HEAP_PHASE_POST_SEND].min());
+  }
+
+  /* The low point of the recent history and where it was taken */
+  HeapSample low;
+  size_t window;
+  if (lowest(low, window)) {
+    out.printf("Heap low   %lu free, largest %lu at %s (task stack %lu free), %lus ago, last %u samples\n",
+               (unsigned long)low.freeBytes, (unsigned long)low.largestBlock, phaseName(low.phase),
+               (unsigned long)low.stackFree, (unsigned long)(millis() / 1000 - low.uptimeS), (unsigned)window);
+  }
+
+  out.print("Stack free");
+  for (uint8_t i = 0; i < _taskCount; i++) {
+    TaskHandle_t task = xTaskGetHandle(_tasks[i]);
+    if (task) out.printf(" %s %u", _tasks[i], (unsigned)uxTaskGetStackHighWaterMark(task));
+  }
+  out.println();
+}
@@ -0,0 +1,155 @@
+#include "http_server.h"
+#include "live_feed.h"
+
+#include <unistd.h>
+
+HttpServer::HttpServer(const SensorMailbox &mailbox, SampleLog &log, const TimeService &time, const char *tankName)
+    : _mailbox(mailbox), _log(log), _time(time), _tankName(tankName), _feed(nullptr), _metrics(nullptr),
+      _server(nullptr) {}
+
+bool HttpServer::begin(uint16_t port) {
+  if (_server) return true;
+
+  httpd_config_t config = HTTPD_DEFAULT_CONFIG();
+  config.server_port = port;
+  config.stack_size = HTTP_TASK_STACK;
+  config.task_priority = HTTP_TASK_PRIORITY;
+  config.core_id = 0;              // loop() keeps core 1 to itself
+  config.lru_purge_enable = true;  // a stalled client cannot hold every socket
+  config.global_user_ctx = this;
+  config.global_user_ctx_free_fn = [](void *) {}; // not heap allocated
+  config.close_fn = onClose;
+  if (httpd_start(&_server, &config) != ESP_OK) {
+    _server = nullptr;
+    return false;
+  }
+
+  registerGet("/now", handleNow);
+  registerGet("/history", handleHistory);
+  if (_feed) {
+    _feed->attach(_server);
+    registerGet("/events", handleEvents);
+  }
+  if (_metrics) registerGet("/metrics", handleMetrics);
+  return true;
+}
+
+void HttpServer::registerGet(const char *uri, esp_err_t (*handler)(httpd_req_t *)) {
+  httpd_uri_t route = {};
+  route.uri = uri;
+  route.method = HTTP_GET;
+  route.handler = handler;
+  route.user_ctx = this;
+  httpd_register_uri_handler(_server, &route);
+}
+
+/* Every session close goes through here so the live feed can forget its subscribers */
+void HttpServer::onClose(httpd_handle_t server, int fd) {
+  HttpServer *self = static_cast<HttpServer *>(httpd_get_global_user_ctx(server));
+  if (self && self->_feed) self->_feed->onClose(fd);
+  close(fd);
+}
+
+esp_err_t HttpServer::handleEvents(httpd_req_t *req) {
+  HttpServer *self = static_cast<HttpServer *>(req->user_ctx);
+  return self->_feed->subscribe(req);
+}
+
+esp_err_t HttpServer::handleMetrics(httpd_req_t *req) {
+  HttpServer *self = static_cast<HttpServer *>(req->user_ctx);
+  httpd_resp_set_type(req, "text/plain; version=0.0.4");
+
+  char buf[METRICS_CHUNK_SIZE];
+  PromWriter out(buf, sizeof(buf), sendChunk, req);
+  self->_metrics(out);
+  if (!out.finish()) return ESP_FAIL;
+  return httpd_resp_send_chunk(req, nullptr, 0);
+}
+
+static const char *alertName(AlertStatus a) {
+  switch (a) {
+    case ALERT_SENDING: return "sending";
+    case ALERT_SENT:    return "sent";
+    case ALERT_FAILED:  return "failed";
+    default:            return "none";
+  }
+}
+
+/* JSON number, or null for a failed reading */
+static void jsonFloat(char *out, size_t len, float v) {
+  if (isnan(v)) snprintf(out, len, "null");
+  else snprintf(out, len, "%.2f", v);
+}
+
+size_t formatSnapshotJson(char *out, size_t len, const SensorSnapshot &snap, const TimeService &time,
+                          const char *tankName) {
+  char stamp[32], temp[12], hum[12];
+  time.format(stamp, sizeof(stamp), snap.sampleUs);
+  jsonFloat(temp, sizeof(temp), snap.temperature);
+  jsonFloat(hum, sizeof(hum), snap.humidity);
+  int64_t utc = time.utcUs(snap.sampleUs);
+  int n = snprintf(out, len,
+                   "{\"tank\":\"%s\",\"time\":\"%s\",\"utc\":%lld,\"uptime_s\":%lu,\"temperature\":%s,"
+                   "\"humidity\":%s,\"liquid_low\":%s,\"temp_alert\":%s,\"alert\":\"%s\"}",
+                   tankName, stamp, (long long)(utc / 1000000LL), (unsigned long)(snap.sampleUs / 1000000ULL), temp,
+                   hum, snap.liquidLow ? "true" : "false", snap.tempAlert ? "true" : "false", alertName(snap.alert));
+  return (n < 0) ? 0 : ((size_t)n < len ? (size_t)n : len - 1);
+}
+
+esp_err_t HttpServer::handleNow(httpd_req_t *req) {
+  HttpServer *self = static_cast<HttpServer *>(req->user_ctx);
+  SensorSnapshot snap;
+  if (!self->_mailbox.read(snap)) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_type(req, "application/json");
+    return httpd_resp_sendstr(req, "{\"error\":\"no sample yet\"}");
+  }
+
+  char body[HTTP_JSON_MAX];
+  formatSnapshotJson(body, sizeof(body), snap, self->_time, self->_tankName);
+
+  httpd_resp_set_type(req, "application/json");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+  return httpd_resp_sendstr(req, body);
+}
+
+static long queryLong(const char *query, const char *key, long fallback) {
+  char value[16];
+  if (!query || httpd_query_key_value(query, key, value, sizeof(value)) != ESP_OK) return fallback;
+  char *end;
+  long v = strtol(value, &end, 10);
+  return (end != value && *end == '\0') ? v : fallback;
+}
+
+bool HttpServer::sendChunk(void *arg, const char *data, size_t len) {
+  return httpd_resp_send_chunk(static_cast<httpd_req_t *>(arg), data, len) == ESP_OK;
+}
+
+esp_err_t HttpServer::handleHistory(httpd_req_t *req) {
+  HttpServer *self = static_cast<HttpServer *>(req->user_ctx);
+
+  char query[96];
+  bool hasQuery = httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK;
+  long now = (long)(self->_time.nowUtcUs() / 1000000LL);
+  if (!now) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    return httpd_resp_sendstr(req, "clock not set yet\n");
+  }
+  long from = queryLong(hasQuery ? query : nullptr, "from", -86400); // last day by default
+  long to = queryLong(hasQuery ? query : nullptr, "to", now);
+  long res = queryLong(hasQuery ? query : nullptr, "res", SAMPLE_LOG_INTERVAL_S);
+  if (from < 0) from += now;
+  if (to < 0) to += now;
+  if (from < 0 || to < from || res <= 0) {
+    return httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "from/to/res out of range");
+  }
+
+  httpd_resp_set_type(req, "text/csv");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-store");
+
+  char buf[HTTP_CHUNK_SIZE];
+  if (!self->_log.stream((uint32_t)from, (uint32_t)to, (uint32_t)res, sendChunk, req, buf, sizeof(buf))) {
+    return ESP_FAIL; // client went away mid-stream; httpd closes the socket
+  }
+  return httpd_resp_send_chunk(req, nullptr, 0);
+}
@@ -0,0 +1,239 @@
+#include "i2c_bus.h"
+
+I2cBus::I2cBus(TwoWire &wire)
+    : _wire(wire), _queue(nullptr), _freeSlots(nullptr), _deviceCount(0), _clockHz(0),
+      _batchMax(I2C_BUFFER_LENGTH) {}
+
+bool I2cBus::begin(int sda, int scl) {
+  /* Room for two whole LCD lines per batch; the buffer can only be resized before Wire starts */
+  if (_wire.setBufferSize(I2C_BATCH_MAX) >= I2C_BATCH_MAX) _batchMax = I2C_BATCH_MAX;
+  if (sda >= 0 && scl >= 0) _wire.begin(sda, scl);
+  else _wire.begin();
+
+  _queue = xQueueCreate(I2C_QUEUE_LENGTH, sizeof(Txn *));
+  _freeSlots = xQueueCreate(I2C_POST_SLOTS, sizeof(uint8_t));
+  if (!_queue || !_freeSlots) return false;
+  for (uint8_t i = 0; i < I2C_POST_SLOTS; i++) xQueueSend(_freeSlots, &i, 0);
+
+  return xTaskCreate(taskMain, "i2cBus", I2C_TASK_STACK, this, I2C_TASK_PRIORITY, nullptr) == pdPASS;
+}
+
+int8_t I2cBus::addDevice(const char *name, uint8_t address, uint32_t clockHz) {
+  if (_deviceCount >= I2C_MAX_DEVICES) return -1;
+  Device &d = _devices[_deviceCount];
+  d.name = name;
+  d.address = address;
+  d.clockHz = clockHz;
+  return _deviceCount++;
+}
+
+bool I2cBus::write(int8_t dev, const uint8_t *data, size_t len) {
+  Txn txn = {};
+  txn.op = OP_WRITE;
+  txn.dev = dev;
+  txn.out = data;
+  txn.outLen = len;
+  return submit(txn);
+}
+
+bool I2cBus::read(int8_t dev, uint8_t *data, size_t len) {
+  Txn txn = {};
+  txn.op = OP_READ;
+  txn.dev = dev;
+  txn.in = data;
+  txn.inLen = len;
+  return submit(txn);
+}
+
+bool I2cBus::writeRead(int8_t dev, const uint8_t *out, size_t outLen, uint8_t *in, size_t inLen) {
+  Txn txn = {};
+  txn.op = OP_WRITE_READ;
+  txn.dev = dev;
+  txn.out = out;
+  txn.outLen = outLen;
+  txn.in = in;
+  txn.inLen = inLen;
+  return submit(txn);
+}
+
+bool I2cBus::run(int8_t dev, I2cBusFn fn, void *arg, size_t bytesHint) {
+  Txn txn = {};
+  txn.op = OP_RUN;
+  txn.dev = dev;
+  txn.fn = fn;
+  txn.arg = arg;
+  txn.outLen = bytesHint;
+  return submit(txn);
+}
+
+/* Blocking submit: the caller sleeps on its task notification until the worker marks the transaction
+ * done. Notifications from anyone else wake it too; they are counted and given back afterwards, so
+ * neither side loses a wakeup. */
+bool I2cBus::submit(Txn &txn) {
+  if (txn.dev < 0 || txn.dev >= _deviceCount || !_queue) return false;
+  txn.waiter = xTaskGetCurrentTaskHandle();
+  txn.queuedUs = micros();
+  txn.done = false;
+
+  Txn *ptr = &txn;
+  if (xQueueSend(_queue, &ptr, portMAX_DELAY) != pdTRUE) return false;
+
+  uint32_t foreign = 0;
+  for (;;) {
+    ulTaskNotifyTake(pdFALSE, portMAX_DELAY);
+    if (__atomic_load_n(&txn.done, __ATOMIC_ACQUIRE)) break;
+    foreign++;
+  }
+  while (foreign--) xTaskNotifyGive(txn.waiter);
+  return txn.ok;
+}
+
+bool I2cBus::post(int8_t dev, const uint8_t *data, size_t len, uint32_t waitMs) {
+  if (dev < 0 || dev >= _deviceCount || !_queue || len > I2C_POST_MAX) return false;
+
+  uint8_t index;
+  if (xQueueReceive(_freeSlots, &index, pdMS_TO_TICKS(waitMs)) != pdTRUE) return false;
+
+  PostSlot &slot = _slots[index];
+  memcpy(slot.data, data, len);
+  slot.txn = Txn{};
+  slot.txn.op = OP_POST;
+  slot.txn.dev = dev;
+  slot.txn.out = slot.data;
+  slot.txn.outLen = len;
+  slot.txn.queuedUs = micros();
+
+  Txn *ptr = &slot.txn;
+  if (xQueueSend(_queue, &ptr, pdMS_TO_TICKS(waitMs)) != pdTRUE) {
+    xQueueSend(_freeSlots, &index, 0);
+    return false;
+  }
+  return true;
+}
+
+void I2cBus::taskMain(void *arg) {
+  I2cBus *self = static_cast<I2cBus *>(arg);
+  Txn *txn;
+
+  for (;;) {
+    if (xQueueReceive(self->_queue, &txn, portMAX_DELAY) != pdTRUE) continue;
+    if (txn->op == OP_POST) self->executeBatch(txn);
+    else self->execute(txn);
+  }
+}
+
+void I2cBus::applyClock(const Device &d) {
+  if (d.clockHz && d.clockHz != _clockHz) {
+    _wire.setClock(d.clockHz);
+    _clockHz = d.clockHz;
+  }
+}
+
+void I2cBus::execute(Txn *txn) {
+  Device &d = _devices[txn->dev];
+  applyClock(d);
+
+  bool ok = true;
+  size_t bytes = 0;
+
+  switch (txn->op) {
+    case OP_WRITE:
+      _wire.beginTransmission(d.address);
+      _wire.write(txn->out, txn->outLen);
+      ok = _wire.endTransmission() == 0;
+      bytes = txn->outLen;
+      break;
+    case OP_READ:
+      ok = _wire.requestFrom((uint16_t)d.address, txn->inLen, true) == txn->inLen;
+      for (size_t i = 0; i < txn->inLen; i++) txn->in[i] = _wire.read();
+      bytes = txn->inLen;
+      break;
+    case OP_WRITE_READ:
+      _wire.beginTransmission(d.address);
+      _wire.write(txn->out, txn->outLen);
+      ok = _wire.endTransmission(false) == 0 && _wire.requestFrom((uint16_t)d.address, txn->inLen, true) == txn->inLen;
+      for (size_t i = 0; ok && i < txn->inLen; i++) txn->in[i] = _wire.read();
+      bytes = txn->outLen + txn->inLen;
+      break;
+    case OP_RUN:
+      txn->fn(_wire, txn->arg);
+      bytes = txn->outLen;
+      break;
+    default:
+      ok = false;
+      break;
+  }
+
+  record(d, txn->queuedUs, bytes, ok, true);
+
+  /* The transaction lives on the caller's stack: once `done` is set it may already be gone */
+  TaskHandle_t waiter = txn->waiter;
+  txn->ok = ok;
+  __atomic_store_n(&txn->done, true, __ATOMIC_RELEASE);
+  xTaskNotifyGive(waiter);
+}
+
+/* Posted writes: keep appending while the next queued request is another post to the same device */
+void I2cBus::executeBatch(Txn *first) {
+  Device &d = _devices[first->dev];
+  applyClock(d);
+
+  Txn *batch[I2C_POST_SLOTS];
+  uint8_t count = 0;
+  size_t bytes = 0;
+
+  _wire.beginTransmission(d.address);
+  _wire.write(first->out, first->outLen);
+  bytes += first->outLen;
+  batch[count++] = first;
+
+  Txn *next;
+  while (count < I2C_POST_SLOTS && xQueuePeek(_queue, &next, 0) == pdTRUE && next->op == OP_POST &&
+         next->dev == first->dev && bytes + next->outLen <= _batchMax) {
+    xQueueReceive(_queue, &next, 0);
+    _wire.write(next->out, next->outLen);
+    bytes += next->outLen;
+    batch[count++] = next;
+  }
+
+  bool ok = _wire.endTransmission() == 0;
+  for (uint8_t i = 0; i < count; i++) {
+    record(d, batch[i]->queuedUs, batch[i]->outLen, ok, i == 0);
+    release(batch[i]);
+  }
+}
+
+void I2cBus::release(Txn *txn) {
+  uint8_t index = reinterpret_cast<PostSlot *>(txn) - _slots;
+  xQueueSend(_freeSlots, &index, 0);
+}
+
+void I2cBus::record(Device &d, uint32_t queuedUs, size_t bytes, bool ok, bool newTransaction) {
+  d.stats.requests++;
+  if (newTransaction) d.stats.transactions++;
+  if (!ok && newTransaction) d.stats.errors++;
+  d.stats.bytes += bytes;
+  d.stats.latencyUs.observe(micros() - queuedUs);
+}
+
+const I2cDeviceStats *I2cBus::stats(int8_t dev) const {
+  if (dev < 0 || dev >= _deviceCount) return nullptr;
+  return &_devices[dev].stats;
+}
+
+UBaseType_t I2cBus::queueDepth() const {
+  return _queue ? uxQueueMessagesWaiting(_queue) : 0;
+}
+
+void I2cBus::printStats(Print &out) const {
+  for (uint8_t i = 0; i < _deviceCount; i++) {
+    const Device &d = _devices[i];
+    out.printf("I2C %-8s 0x%02X @%luk  tx: %lu  req: %lu  bytes: %lu  err: %lu\n", d.name, d.address,
+               (unsigned long)(d.clockHz / 1000), (unsigned long)d.stats.transactions,
+               (unsigned long)d.stats.requests, (unsigned long)d.stats.bytes, (unsigned long)d.stats.errors);
+
+    out.print("    latency");
+    d.stats.latencyUs.print(out, "us");
+    out.println();
+  }
+}
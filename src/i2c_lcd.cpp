@@ -0,0 +1,74 @@
+#include "i2c_lcd.h"
+
+/* PCF8574 backpack wiring (same as LiquidCrystal_I2C) */
+#define LCD_PIN_RS        0x01
+#define LCD_PIN_EN        0x04
+#define LCD_PIN_BACKLIGHT 0x08
+#define LCD_CMD_DDRAM     0x80
+#define LCD_CMD_CLEAR     0x01
+#define LCD_CMD_ENTRY     0x06  // left to right, no shift
+#define LCD_CMD_DISPLAY   0x0C  // display on, cursor and blink off
+#define LCD_CMD_FUNCTION  0x28  // 4-bit, 2 lines, 5x8 dots
+
+static const uint8_t rowOffsets[] = {0x00, 0x40, 0x14, 0x54};
+
+I2cLcd::I2cLcd(I2cBus &bus, int8_t device) : _bus(bus), _device(device) {}
+
+/* HD44780 datasheet figure 24: three 8-bit "function set" nibbles, then switch to 4-bit mode.
+ * LiquidCrystal_I2C also waits a full second after resetting the expander; the datasheet only
+ * asks for 40 ms after power-up, which has long passed by the time setup() runs. */
+bool I2cLcd::begin() {
+  while (millis() < 50) delay(1);
+
+  uint8_t backlight = LCD_PIN_BACKLIGHT;
+  if (!_bus.write(_device, &backlight, 1)) return false;
+
+  nibble(0x30, 4500);
+  nibble(0x30, 4500);
+  nibble(0x30, 150);
+  nibble(0x20, 100);
+
+  command(LCD_CMD_FUNCTION, 50);
+  command(LCD_CMD_DISPLAY, 50);
+  command(LCD_CMD_CLEAR, 2000);
+  return command(LCD_CMD_ENTRY, 50);
+}
+
+bool I2cLcd::nibble(uint8_t value, uint32_t settleUs) {
+  uint8_t bytes[2] = {(uint8_t)(value | LCD_PIN_BACKLIGHT | LCD_PIN_EN), (uint8_t)(value | LCD_PIN_BACKLIGHT)};
+  bool ok = _bus.write(_device, bytes, sizeof(bytes));
+  delayMicroseconds(settleUs);
+  return ok;
+}
+
+bool I2cLcd::command(uint8_t value, uint32_t settleUs) {
+  uint8_t bytes[4];
+  size_t len = encode(bytes, value, false);
+  bool ok = _bus.write(_device, bytes, len);
+  delayMicroseconds(settleUs);
+  return ok;
+}
+
+/* Each nibble is latched on the falling edge of EN: two expander bytes per nibble. At 100 kHz one
+ * byte takes ~90 us on the wire, which already covers the 37 us the HD44780 needs per command. */
+size_t I2cLcd::encode(uint8_t *out, uint8_t value, bool data) const {
+  uint8_t mode = LCD_PIN_BACKLIGHT | (data ? LCD_PIN_RS : 0);
+  uint8_t high = (value & 0xF0) | mode;
+  uint8_t low = ((value << 4) & 0xF0) | mode;
+
+  out[0] = high | LCD_PIN_EN;
+  out[1] = high;
+  out[2] = low | LCD_PIN_EN;
+  out[3] = low;
+  return 4;
+}
+
+bool I2cLcd::writeLine(uint8_t row, const char *text) {
+  uint8_t stream[(I2C_LCD_COLS + 1) * 4];
+  size_t len = encode(stream, LCD_CMD_DDRAM | rowOffsets[row & 3], false);
+
+  for (uint8_t col = 0; col < I2C_LCD_COLS && text[col]; col++) {
+    len += encode(stream + len, (uint8_t)text[col], true);
+  }
+  return _bus.post(_device, stream, len);
+}
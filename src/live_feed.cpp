@@ -0,0 +1,151 @@
+#include "live_feed.h"
+
+#include <lwip/sockets.h>
+
+#define SSE_CHUNK_HEADER 6   // "%04x\r\n"; leading zeros are valid in a chunk size
+
+LiveFeed::LiveFeed(const TimeService &time, const char *tankName)
+    : _time(time), _tankName(tankName), _server(nullptr), _lock(nullptr), _latest(0), _lastSampleUs(0),
+      _lastAlert(ALERT_NONE), _clientCount(0), _stats{} {
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) _clients[i].fd = -1;
+}
+
+void LiveFeed::attach(httpd_handle_t server) {
+  if (!_lock) _lock = xSemaphoreCreateMutex();
+  _server = server;
+}
+
+void LiveFeed::publish(const SensorSnapshot &snap) {
+  if (!_server || !_lock) return;
+
+  /* Alert updates republish the same sample; those become "alert" events */
+  const char *event;
+  if (snap.sampleUs != _lastSampleUs) event = "sample";
+  else if (snap.alert != _lastAlert) event = "alert";
+  else return;
+  _lastSampleUs = snap.sampleUs;
+  _lastAlert = snap.alert;
+
+  char json[HTTP_JSON_MAX];
+  formatSnapshotJson(json, sizeof(json), snap, _time, _tankName);
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  Message &m = _ring[(_latest + 1) % SSE_RING];
+  char *body = m.data + SSE_CHUNK_HEADER;
+  int len = snprintf(body, SSE_MSG_MAX - SSE_CHUNK_HEADER - 2, "event: %s\ndata: %s\n\n", event, json);
+  if (len > 0 && len < SSE_MSG_MAX - SSE_CHUNK_HEADER - 2) {
+    char header[SSE_CHUNK_HEADER + 1];
+    snprintf(header, sizeof(header), "%04x\r\n", len);
+    memcpy(m.data, header, SSE_CHUNK_HEADER);
+    memcpy(body + len, "\r\n", 2);
+    m.len = SSE_CHUNK_HEADER + len + 2;
+    m.seq = ++_latest;
+    _stats.published++;
+  }
+  xSemaphoreGive(_lock);
+
+  httpd_queue_work(_server, pumpWork, this);
+}
+
+esp_err_t LiveFeed::subscribe(httpd_req_t *req) {
+  if (!_lock) return ESP_FAIL;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  Client *slot = nullptr;
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS && !slot; i++) {
+    if (_clients[i].fd < 0) slot = &_clients[i];
+  }
+  if (!slot) _stats.rejected++;
+  xSemaphoreGive(_lock);
+
+  if (!slot) {
+    httpd_resp_set_status(req, "503 Service Unavailable");
+    httpd_resp_set_hdr(req, "Retry-After", "30");
+    return httpd_resp_sendstr(req, "too many live feed clients\n");
+  }
+
+  /* Headers and a first chunk through httpd; the response is left open and later chunks are
+   * written to the socket directly */
+  httpd_resp_set_type(req, "text/event-stream");
+  httpd_resp_set_hdr(req, "Cache-Control", "no-cache");
+  if (httpd_resp_send_chunk(req, "retry: 5000\n\n", HTTPD_RESP_USE_STRLEN) != ESP_OK) return ESP_FAIL;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  slot->fd = httpd_req_to_sockfd(req);
+  slot->nextSeq = _latest ? _latest : 1; // start with the current state
+  slot->offset = 0;
+  slot->closing = false;
+  _clientCount++;
+  _stats.subscribes++;
+  deliver(*slot);
+  xSemaphoreGive(_lock);
+  return ESP_OK;
+}
+
+/* httpd task, from the server's close hook */
+void LiveFeed::onClose(int fd) {
+  if (!_lock) return;
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (_clients[i].fd == fd) {
+      _clients[i].fd = -1;
+      _clientCount--;
+    }
+  }
+  xSemaphoreGive(_lock);
+}
+
+void LiveFeed::pumpWork(void *arg) { static_cast<LiveFeed *>(arg)->pump(); }
+
+void LiveFeed::pump() {
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < SSE_MAX_CLIENTS; i++) {
+    if (_clients[i].fd >= 0 && !_clients[i].closing) deliver(_clients[i]);
+  }
+  xSemaphoreGive(_lock);
+}
+
+/* Caller holds _lock. Sends never block; a full socket just leaves the subscriber where it is. */
+void LiveFeed::deliver(Client &c) {
+  while (c.nextSeq <= _latest) {
+    if (c.offset == 0 && c.nextSeq < _latest) {
+      _stats.dropped += _latest - c.nextSeq;
+      c.nextSeq = _latest;
+    }
+    if (_latest - c.nextSeq >= SSE_RING) {
+      _stats.slowCloses++;
+      c.closing = true;
+      httpd_sess_trigger_close(_server, c.fd);
+      return;
+    }
+
+    const Message &m = _ring[c.nextSeq % SSE_RING];
+    int sent = httpd_socket_send(_server, c.fd, m.data + c.offset, m.len - c.offset, MSG_DONTWAIT);
+    if (sent == HTTPD_SOCK_ERR_TIMEOUT) {
+      _stats.wouldBlock++;
+      return;
+    }
+    if (sent < 0) {
+      c.closing = true;
+      httpd_sess_trigger_close(_server, c.fd);
+      return;
+    }
+    _stats.bytes += sent;
+    c.offset += sent;
+    if (c.offset < m.len) {
+      _stats.partial++;
+      return;
+    }
+    c.offset = 0;
+    c.nextSeq++;
+    _stats.delivered++;
+  }
+}
+
+void LiveFeed::printStats(Print &out) const {
+  out.printf("Live feed: %u clients, %lu published, %lu delivered (%lu KB), %lu dropped, %lu would-block, "
+             "%lu partial, %lu slow closes, %lu rejected\n",
+             (unsigned)_clientCount, (unsigned long)_stats.published, (unsigned long)_stats.delivered,
+             (unsigned long)(_stats.bytes / 1024), (unsigned long)_stats.dropped, (unsigned long)_stats.wouldBlock,
+             (unsigned long)_stats.partial, (unsigned long)_stats.slowCloses, (unsigned long)_stats.rejected);
+}
@@ -28,19 +28,46 @@
 //=====================================================================================================//
 
 #include <Arduino.h>
-#include <LiquidCrystal_I2C.h>
 #include <Adafruit_Sensor.h>
 #include <DHT.h>
 #include <DHT_U.h>
 #include <WiFi.h>
 #include <ESP_Mail_Client.h>
 #include <LittleFS.h>
+#include <esp_heap_caps.h>
+#include "async_log.h"
+#include "trust_anchors.h"
+#include "tls_profile.h"
+#include "i2c_bus.h"
+#include "i2c_lcd.h"
+#include "display_task.h"
+#include "boot_timer.h"
+#include "wifi_manager.h"
+#include "duty_cycle.h"
+#include "ulp_level_watch.h"
+#include "time_service.h"
+#include "sample_log.h"
+#include "http_server.h"
+#include "live_feed.h"
+#include "metrics.h"
+#include "mqtt_sink.h"
+#include "alert_sink.h"
+#include "alert_sinks.h"
+#include "heap_telemetry.h"
+#include "phase_timer.h"
+#if defined(TFT_DASHBOARD)
+#include "tft_dashboard.h"
+#endif
 
 #define SPIFFS LittleFS
 
 //REPLACE WITH YOUR WIFI CREDENTIALS
 #define WIFI_SSID "Deirdog"
 #define WIFI_PASSWORD "************"
+#define WIFI_CONNECT_TIMEOUT_MS 20000 // per full-scan attempt; the network task keeps retrying in the background
+
+/* Caches BSSID/channel/lease in RTC memory and NVS for a directed fast connect */
+WifiManager wifiManager(WIFI_SSID, WIFI_PASSWORD);
 
 #define TANK_NAME "TANK 1" //REPLACE WITH TANK NUMBER
 
@@ -51,7 +78,12 @@
 #define DHTTYPE    DHT22     // DHT 22 (AM2302) -- Used in the final work
 //#define DHTTYPE    DHT21     // DHT 21 (AM2301)
 
-#define SerialDebugging true
+#define SerialDebugging true // output goes through asyncLog, drained to the UART by its own task
+
+/* Battery operation: sample, sleep, repeat (see duty_cycle.h). The LCD, display task and
+ * background network task are not used in this mode; Wi-Fi only comes up to send an alert. */
+#define LowPowerMode false
+#define UlpWatch true // LowPowerMode: let the ULP debounce level/button pins instead of the ext0 wake
 
 const uint8_t   LevelSensor = 13; //Liquid Level Sensor Pin
 
@@ -59,10 +91,28 @@ const uint8_t   LevelSensor = 13; //Liquid Level Sensor Pin
 const uint8_t   Button_pin  = 15; //CURRENTLY UNUSED: Button Pin
 volatile bool  isButtonPressed = false; // the interrupt service routine affects this
 
-LiquidCrystal_I2C lcd(0x27, 16, 2);  // set the LCD address to 0x27 for a 16 chars and 2 line display
 DHT_Unified dht(DHTPIN, DHTTYPE);
 int liquidLevel = 0;
 
+/* All I2C traffic (LCD now; AHT20, SSD1306, seesaw later) goes through the bus manager.
+ * The 16x2 LCD sits at I2C_LCD_ADDRESS (0x27). */
+I2cBus i2cBus(Wire);
+int8_t lcdDevice = i2cBus.addDevice("lcd", I2C_LCD_ADDRESS, I2C_LCD_CLOCK);
+I2cLcd busLcd(i2cBus, lcdDevice);
+
+/* loop() publishes every sample here; the display task reads the latest one */
+SensorMailbox sensorMailbox;
+/* The mailbox takes one writer at a time: loop() and the alert workers (onAlertStatus) publish */
+SemaphoreHandle_t publishLock;
+SensorSnapshot lastPublished;
+DisplayTask display(busLcd, sensorMailbox, TANK_NAME);
+
+#if defined(TFT_DASHBOARD)
+/* ESP32-S3 build: ST7789 dashboard next to the LCD (see tft_dashboard.h for wiring) */
+Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+TftDashboard dashboard(tft, "CRYSTAL " TANK_NAME);
+#endif
+
 uint32_t delayMS;
 
 /** The smtp host name e.g. smtp.gmail.com for GMail or smtp.office365.com for Outlook or smtp.mail.yahoo.com */
@@ -75,6 +125,24 @@ uint32_t delayMS;
  */
 #define SMTP_PORT esp_mail_smtp_port_465
 
+/* Verify the SMTP server against the root CAs in certs/, compiled into flash by tools/trust_anchors.py */
+#define SmtpVerifyTls true
+
+/* The mail client's protocol trace; it writes to Serial directly, blocking the SMTP worker on the UART */
+#define SmtpDebug false
+
+/* Suites and curves for the SMTP handshake (tls_profile.h). COMPAT, the library defaults, works with any
+ * server; RSA refuses a server without an ECDHE-RSA suite, so opt in only once yours has one */
+#define SMTP_TLS_PROFILE TLS_PROFILE_COMPAT
+
+/* TLS record buffers: AUTO probes the server for max_fragment_length once and keeps the full 16 KB
+ * receive buffer if it refuses; TLS_BUFFERS_FULL skips the probe for servers known to lack it */
+#define SMTP_TLS_BUFFERS TLS_BUFFERS_AUTO
+#define SMTP_TLS_FRAGMENT 1024
+
+/* Per-send arena (.bss) for the mail client's strings, so a send leaves no holes in the heap; 0 for the heap */
+#define SMTP_ARENA_BYTES 4096
+
 /* The log in credentials */
 #define AUTHOR_EMAIL "proto01crystaltronics@gmail.com"
 #define AUTHOR_PASSWORD "*************"
@@ -88,10 +156,73 @@ SMTPSession smtp;
 /* Declare the Session_Config for user defined session credentials */
 ESP_Mail_Session config;
 
+#if (SMTP_ARENA_BYTES > 0)
+static uint32_t smtpArenaMem[SMTP_ARENA_BYTES / 4];
+MB_StringArena smtpArena(smtpArenaMem, sizeof(smtpArenaMem));
+#endif
+
+/* Set by the network task once Wi-Fi is up and the SMTP session is configured */
+volatile bool networkReady = false;
+BootTimer bootTimer;
+
+/* 64-bit monotonic timestamps for samples and alerts, mapped to UTC once SNTP syncs */
+TimeService timeService;
+
+/* Per-minute history on LittleFS, served with the live reading over HTTP (/now, /history) */
+SampleLog sampleLog(LittleFS, timeService);
+HttpServer httpServer(sensorMailbox, sampleLog, timeService, TANK_NAME);
+LiveFeed liveFeed(timeService, TANK_NAME); // pushes samples and alert changes on /events
+
+/* Hot-path counters and latency histograms for /metrics; updated in place, read by the scrape */
+struct FirmwareMetrics {
+  MetricCounter samples;
+  MetricCounter tempReadErrors;
+  MetricCounter humReadErrors;
+  Log2Histogram<12, 8> loopUs;         // 256 us ... >= 0.5 s
+};
+FirmwareMetrics metrics;
+
+/* Heap and stack marks once per loop() cycle and around every SMTP send; a warning alert goes out
+ * once the largest free block falls this far below the free heap */
+#define HEAP_FRAG_WARN_PCT  60
+#define HEAP_FRAG_CLEAR_PCT 45
+HeapTelemetry heapTelemetry(HEAP_FRAG_WARN_PCT, HEAP_FRAG_CLEAR_PCT);
+static const char *const watchedTasks[] = {"loopTask", "network", "display", "i2cBus", "httpd", "tftFlush",
+                                           "smtp", "mqtt", "webhook", "serial", "file", "log"};
+
+/* Telemetry on every sample and retained alert states on an MQTT broker, next to the SMTP alerts */
+#define MqttTelemetry true
+#define MQTT_BROKER_URI "mqtt://192.168.1.10:1883" //REPLACE WITH YOUR BROKER
+MqttSink mqttSink(timeService, TANK_NAME);
+
+/* Every alert goes to each of these sinks, each on its own worker with its own retries */
+#define AlertWebhook false
+#define ALERT_WEBHOOK_URL "http://192.168.1.10:8080/alert" //REPLACE WITH YOUR ENDPOINT
+#define ALERT_REPEAT_MIN 30 // reminder while an alert lasts; transitions are sent right away
+#define AlertHistoryHours 6 // sample history attached to alert emails as CSV; 0 to send the text only
+#define ALERT_HISTORY_STEP_S 300
+
+AlertDispatcher alerts;
+SmtpAlertSink smtpAlerts(smtp, config, AUTHOR_EMAIL, RECIPIENT_EMAIL, timeService, TANK_NAME, networkReady);
+MqttAlertSink mqttAlerts(mqttSink);
+WebhookAlertSink webhookAlerts(ALERT_WEBHOOK_URL, timeService, TANK_NAME);
+SerialAlertSink serialAlerts(asyncLog, timeService, TANK_NAME);
+FileAlertSink fileAlerts(LittleFS, timeService, TANK_NAME);
+
+/* Survives deep sleep; only used when LowPowerMode is set */
+RTC_DATA_ATTR DutyCycleState dutyState;
+UlpLevelWatch levelWatch(LevelSensor, Button_pin);
+
 /* Callback function to get the Email sending status */
 void smtpCallback(SMTP_Status status);
-void sendEmail();
-void sendEmailTemp();
+void networkTask(void *arg);
+void configureSmtp();
+void dutyCycleWake();
+void publishSnapshot(const SensorSnapshot &snap);
+void onAlertStatus(AlertStatus status);
+void writeMetrics(PromWriter &out);
+void raiseAlerts(const SensorSnapshot &snap);
+AlertEvent alertEvent(AlertSensor sensor, bool active, float temperature, uint64_t sampleUs);
 
 /****** UNUSED BUTTON FUNCTION (kept for future implementation ******/
 void senseButtonPressed() {     // interrupt service routine
@@ -101,81 +232,42 @@ void senseButtonPressed() {     // interrupt service routine
 }
 
 void setup() {
+    bootTimer.mark("reset");
+
     #if (SerialDebugging)
-    Serial.begin(9600); while (!Serial); Serial.println();
+    asyncLog.begin(115200);
     #endif
+    bootTimer.mark("serial");
 
-    lcd.init(); // initialize the lcd 
-    lcd.backlight();
-    lcd.setCursor(1,0);
-    lcd.print("CRYSTALTRONICS");
-    lcd.setCursor(6,1);
-    lcd.print("2025");
-    delay(2000); // wait for 2 seconds
-    lcd.clear(); // clear the screen
+    #if (PHASE_TIMING)
+    phaseTimers.calibrate();
+    #endif
 
-    dht.begin();
-    Serial.println(F("Init DHT11 Sensor"));
+    #if (LowPowerMode)
+    dutyCycleWake(); // does not return
+    #endif
 
-    WiFi.begin(WIFI_SSID, WIFI_PASSWORD);
-    while (WiFi.status() != WL_CONNECTED)
-    {
-        Serial.print(".");
-        delay(200);
+    /* LCD splash comes up through the bus manager; the display task replaces it with the first sample */
+    if (!i2cBus.begin()) {
+      LOG_E("I2C bus manager could not be started");
     }
-
-    Serial.println("");
-    Serial.println("WiFi connected.");
-    Serial.println("IP address: ");
-    Serial.println(WiFi.localIP());
-    Serial.println();
-    lcd.setCursor(0,0);
-    lcd.print("=====");lcd.print(TANK_NAME);lcd.print("=====");
-    lcd.setCursor(0,1);
-    lcd.print("Waiting for WIFI.");
-    delay(2000); // wait for 2 seconds
-    lcd.setCursor(0,1);
-    lcd.print("IP: ");lcd.print(WiFi.localIP());
-
-    if (!LittleFS.begin()) { //littleFS initialize then create file if it does not exist
-    Serial.println("LittleFS Mount Failed");
-    File file = LittleFS.open("/tze.txt", "w");
-    if (file) file.close();
-    return;
+    busLcd.begin();
+    busLcd.writeLine(0, " CRYSTALTRONICS ");
+    busLcd.writeLine(1, "      2025      ");
+    bootTimer.mark("lcd");
+
+    #if defined(TFT_DASHBOARD)
+    if (dashboard.begin()) {
+      #if defined(TFT_BENCHMARK)
+      dashboard.runBenchmark(asyncLog, 20); // frame-time benchmark on an empty dashboard
+      #endif
+    } else {
+      LOG_E("TFT dashboard init failed");
     }
-    
+    bootTimer.mark("tft");
+    #endif
 
-    /*  Set the network reconnection option */
-    MailClient.networkReconnect(true);
-
-    /** Enable the debug via Serial port
-     * 0 for no debugging
-     * 1 for basic level debugging
-     *
-     * Debug port can be changed via ESP_MAIL_DEFAULT_DEBUG_PORT in ESP_Mail_FS.h
-     */
-    smtp.debug(1);
-
-    /* Set the callback function to get the sending results */
-    smtp.callback(smtpCallback);
-
-    /* Set the session config */
-    config.server.host_name = SMTP_HOST;
-    config.server.port = SMTP_PORT;
-    config.login.email = AUTHOR_EMAIL;
-    config.login.password = AUTHOR_PASSWORD;
-    config.login.user_domain = "";
-
-    /*
-    Set the NTP config time
-    For times east of the Prime Meridian use 0-12
-    For times west of the Prime Meridian add 12 to the offset.
-    Ex. American/Denver GMT would be -6. 6 + 12 = 18
-    See https://en.wikipedia.org/wiki/Time_zone for a list of the GMT/UTC timezone offsets
-    */
-    config.time.ntp_server = F("pool.ntp.org");
-    config.time.gmt_offset = 0;
-    config.time.day_light_offset = 0;
+    dht.begin();
 
     // Get temperature sensor details.
     sensor_t sensor;
@@ -193,182 +285,515 @@ void setup() {
     
     isButtonPressed = false;  // ignore any power-on-reboot garbage
     /*******************************************************************/
+    bootTimer.mark("sensors");
+
+    if (!LittleFS.begin()) { //littleFS initialize then create file if it does not exist
+      LOG_E("LittleFS Mount Failed");
+      File file = LittleFS.open("/tze.txt", "w");
+      if (file) file.close();
+    }
+    else if (!sampleLog.begin()) {
+      LOG_E("Sample log could not be started");
+    }
+    bootTimer.mark("littlefs");
+
+    /* From here on only the display task touches the LCD (and the TFT) */
+    #if defined(TFT_DASHBOARD)
+    display.attachDashboard(&dashboard);
+    #endif
+    if (!display.begin()) {
+      LOG_E("Display task could not be started");
+    }
+
+    /* Alert fan-out; the SMTP worker holds its alerts until the network task sets networkReady */
+    alerts.addSink(serialAlerts, {1, 0, 0}, 3072);
+    alerts.addSink(fileAlerts, {2, 500, 500}, 4096);
+    #if (SMTP_ARENA_BYTES > 0)
+    smtpAlerts.useArena(&smtpArena);
+    #endif
+    #if (AlertHistoryHours > 0)
+    smtpAlerts.attachHistory(&sampleLog, AlertHistoryHours * 3600UL, ALERT_HISTORY_STEP_S);
+    #endif
+    smtpAlerts.attachHeapTelemetry(&heapTelemetry);
+    for (const char *task : watchedTasks) heapTelemetry.watchTask(task);
+    alerts.addSink(smtpAlerts, {3, 5000, 60000}, 13312);  // TLS, the history stream and SMTP_Message's strings
+    #if (MqttTelemetry)
+    alerts.addSink(mqttAlerts, {3, 2000, 10000}, 4096);
+    #endif
+    #if (AlertWebhook)
+    alerts.addSink(webhookAlerts, {3, 2000, 30000}, 6144);
+    #endif
+    publishLock = xSemaphoreCreateMutex();
+    alerts.onStatusChange(onAlertStatus);
+    if (!alerts.begin()) {
+      LOG_E("Alert workers could not be started");
+    }
+
+    /* Wi-Fi, NTP and the SMTP session config finish in the background; loop() starts sampling now */
+    if (xTaskCreatePinnedToCore(networkTask, "network", 4096, nullptr, 1, nullptr, 0) != pdPASS) {
+      LOG_E("Network task could not be started");
+    }
+    bootTimer.mark("setup done");
 }
 
-void loop() {
-  /* Delay between measurements. */
-  delay(delayMS);
+/* Brings Wi-Fi up without holding up setup(), then stays around to reconnect. Each attempt is
+ * bounded; alerts are held back until networkReady is set. */
+void networkTask(void *arg) {
+    while (!wifiManager.connect(WIFI_CONNECT_TIMEOUT_MS)) {
+      LOG_W("WiFi connect timed out, retrying");
+    }
+    bootTimer.mark("wifi");
+
+    LOG_I("WiFi connected, IP address %s", WiFi.localIP().toString().c_str());
 
-  /*****IF USING ESPNOW : Display the data from ESP32CAM on the LCD******/
-  //lcd.setCursor(0,1);
-  //lcd.print("Photo No. : ");lcd.println("");
+    configureSmtp();
+    bootTimer.mark("smtp config");
+
+    httpServer.attachFeed(&liveFeed);
+    httpServer.attachMetrics(writeMetrics);
+    if (httpServer.begin()) {
+      LOG_I("HTTP API: http://%s/now", WiFi.localIP().toString().c_str());
+    } else {
+      LOG_E("HTTP server could not be started");
+    }
+
+    #if (MqttTelemetry)
+    if (!mqttSink.begin(MQTT_BROKER_URI)) {
+      LOG_E("MQTT client could not be started");
+    }
+    #endif
+
+    networkReady = true;
+    bootTimer.print(asyncLog);
+
+    for (;;) {
+      vTaskDelay(pdMS_TO_TICKS(1000));
+      if (!wifiManager.connected() && !wifiManager.connect(WIFI_CONNECT_TIMEOUT_MS)) {
+        LOG_W("WiFi reconnect failed, retrying");
+      }
+    }
+}
+
+/* SMTP session config shared by the background network task and the low-power wake */
+void configureSmtp() {
+  /*  Set the network reconnection option
+   *  Off: the network task reconnects through wifiManager's cached fast path instead */
+  MailClient.networkReconnect(false);
+
+  /** Enable the debug via Serial port
+   * 0 for no debugging
+   * 1 for basic level debugging
+   *
+   * Debug port can be changed via ESP_MAIL_DEFAULT_DEBUG_PORT in ESP_Mail_FS.h
+   * The library prints straight to that port and waits on the UART, so it is off unless SmtpDebug is set
+   */
+  #if (SmtpDebug)
+  smtp.debug(1);
+  #endif
+
+  /* Set the callback function to get the sending results */
+  smtp.callback(smtpCallback);
+
+  /* Set the session config */
+  config.server.host_name = SMTP_HOST;
+  config.server.port = SMTP_PORT;
+  config.login.email = AUTHOR_EMAIL;
+  config.login.password = AUTHOR_PASSWORD;
+  config.login.user_domain = "";
+
+  config.secure.profile = tlsProfile(SMTP_TLS_PROFILE);
+  LOG_I("SMTP TLS profile: %s", tlsProfileName(SMTP_TLS_PROFILE));
+  smtpAlerts.setTlsBuffers(SMTP_TLS_BUFFERS, SMTP_HOST, SMTP_PORT, SMTP_TLS_FRAGMENT);
+  LOG_I("SMTP TLS buffers: %s, %u byte fragments", tlsBufferPolicyName(SMTP_TLS_BUFFERS), SMTP_TLS_FRAGMENT);
+
+  #if (SmtpVerifyTls)
+  /* Prebuilt anchors instead of certificate.cert_data: nothing is parsed or allocated on connect */
+  config.certificate.trust_anchors = SMTP_TRUST_ANCHORS;
+  config.certificate.trust_anchor_count = SMTP_TRUST_ANCHOR_COUNT;
+  config.certificate.verify = true;
+  #endif
+
+  /*
+  Set the NTP config time
+  For times east of the Prime Meridian use 0-12
+  For times west of the Prime Meridian add 12 to the offset.
+  Ex. American/Denver GMT would be -6. 6 + 12 = 18
+  See https://en.wikipedia.org/wiki/Time_zone for a list of the GMT/UTC timezone offsets
+  */
+  config.time.ntp_server = F("pool.ntp.org");
+  config.time.gmt_offset = 0;
+  config.time.day_light_offset = 0;
+
+  /* Start SNTP now (without waiting) so the clock is already set by the time the first email goes out */
+  timeService.begin(TIME_NTP_SERVER);
+}
+
+#if (LowPowerMode)
+/* One low-power wake: sample, buffer in RTC memory, flush/alert when needed, back to sleep */
+void dutyCycleWake() {
+  DutyCycle cycle(dutyState);
+  WakeReason reason = readWakeReason();
+  PackedSample sample = {};
+
+  /* The level pin first: on a level-pin wake it is the reading that matters */
+  #if (UlpWatch)
+  bool ulpWatch = levelWatch.begin(reason == WAKE_POWER_ON);
+  if (reason == WAKE_ULP) {
+    reason = (levelWatch.takeWakeBits() & (1 << ULP_CH_LEVEL)) ? WAKE_LEVEL_PIN : WAKE_BUTTON;
+  }
+  #else
+  bool ulpWatch = false;
+  #endif
+  cycle.begin(reason, rtcClockUs());
+
+  if (ulpWatch) {
+    sample.liquidLow = levelWatch.channel(ULP_CH_LEVEL).stable != 0; // the pin now belongs to the RTC IO mux
+  } else {
+    pinMode(LevelSensor, INPUT);
+    sample.liquidLow = digitalRead(LevelSensor) != 0;
+  }
+
+  dht.begin();
+  sensor_t sensor;
+  dht.temperature().getSensor(&sensor);
+  delay(sensor.min_delay / 1000); // the DHT needs its warm-up after power-on
+
+  sensors_event_t event;
+  dht.temperature().getEvent(&event);
+  float temperature = event.temperature;
+  sample.tempCenti = isnan(temperature) ? INT16_MIN : (int16_t)lroundf(temperature * 100);
+  sample.tempAlert = !isnan(temperature) && (temperature < TEMP_LOW_THRESHOLD || temperature > TEMP_HIGH_THRESHOLD);
+  dht.humidity().getEvent(&event);
+  sample.humCenti = isnan(event.relative_humidity) ? UINT16_MAX : (uint16_t)lroundf(event.relative_humidity * 100);
+  sample.time = (uint32_t)(rtcClockUs() / 1000000ULL);
+  uint64_t sampleUs = TimeService::monoUs();
+
+  uint8_t actions = cycle.record(sample, micros());
+
+  uint32_t radioUs = 0;
+  if (actions & DUTY_ALERT) {
+    uint32_t radioStart = micros();
+    if (wifiManager.connect(WIFI_CONNECT_TIMEOUT_MS)) {
+      configureSmtp();
+      /* No dispatcher here: the wake ends right after, so the email goes out inline */
+      float temperature = sample.tempCenti == INT16_MIN ? NAN : sample.tempCenti / 100.0f;
+      bool sent = false;
+      if (sample.tempAlert) sent |= smtpAlerts.deliver(alertEvent(ALERT_SENSOR_TEMPERATURE, true, temperature, sampleUs));
+      if (sample.liquidLow) sent |= smtpAlerts.deliver(alertEvent(ALERT_SENSOR_LIQUID_LEVEL, true, temperature, sampleUs));
+      if (sent) cycle.alertSent();
+    } else {
+      LOG_W("WiFi connect timed out, alert not sent");
+    }
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    radioUs = micros() - radioStart;
+
+    /* The first sync moved the RTC clock; samples buffered before it get the same correction */
+    int64_t stepUs = timeService.firstStepUs();
+    if (stepUs) {
+      uint16_t fixed = cycle.backfill(stepUs / 1000000LL, TIME_VALID_AFTER_S);
+      LOG_I("Duty cycle: backfilled %u sample times by %+lld s", (unsigned)fixed, (long long)(stepUs / 1000000LL));
+    }
+  }
+
+  if (actions & DUTY_FLUSH) {
+    if (LittleFS.begin()) {
+      size_t written = flushDutyBuffer(cycle);
+      LOG_I("Duty cycle: flushed %u samples to %s", (unsigned)written, DUTY_LOG_PATH);
+      LittleFS.end();
+    } else {
+      LOG_E("LittleFS Mount Failed, keeping samples in RTC memory");
+    }
+  }
+
+  const DutyCycleState &st = cycle.state();
+  LOG_I("Duty cycle: wake %lu (%s), latency %lu us (max %lu, level %lu), %u buffered, %lu dropped, %.1f mJ/sample",
+        (unsigned long)st.wakes,
+        cycle.reason() == WAKE_LEVEL_PIN ? "level" : cycle.reason() == WAKE_BUTTON ? "button" : "timer",
+        (unsigned long)st.lastWakeLatencyUs, (unsigned long)st.maxWakeLatencyUs, (unsigned long)st.lastLevelLatencyUs,
+        (unsigned)st.count, (unsigned long)st.dropped, cycle.energyPerSampleMj());
+  if (ulpWatch) levelWatch.printStats(asyncLog);
+  asyncLog.flush(); // the ring is in RAM that deep sleep does not keep
+
+  cycle.finish(micros(), radioUs, rtcClockUs());
+  /* The ULP wakes on any sustained level change, so the ext0 wake is only needed without it */
+  if (ulpWatch) levelWatch.enableWakeup();
+  enterDeepSleep(cycle.sleepUs(), !ulpWatch && cycle.armLevelWake(), LevelSensor);
+}
+#endif
+
+void loop() {
+  /* Fixed sample cadence; the display task renders on its own schedule so LCD/TFT writes never delay a sample */
+  static uint64_t nextSampleUs = TimeService::monoUs();
+  int64_t wait = (int64_t)(nextSampleUs - TimeService::monoUs());
+  if (wait > 0) delay((uint32_t)(wait / 1000));
+  else nextSampleUs = TimeService::monoUs(); // fell behind (e.g. an email was sent); don't burst to catch up
+  nextSampleUs += (uint64_t)delayMS * 1000;
+  PHASE_TIME(PHASE_LOOP);
+
+  SensorSnapshot snap = {};
+  snap.sampleUs = TimeService::monoUs();
+  snap.alert = ALERT_NONE;
+  metrics.samples.inc();
+
+  char stamp[32];
+  timeService.format(stamp, sizeof(stamp), snap.sampleUs);
+  LOG_I("Sample at %s", stamp);
 
   /* Get temperature event and print its value. */
   sensors_event_t event;
+  PHASE_TIMER(temperatureTimer, PHASE_DHT_TEMPERATURE);
   dht.temperature().getEvent(&event);
+  PHASE_STOP(temperatureTimer);
+  snap.temperature = event.temperature;
   if (isnan(event.temperature)) {
-    Serial.println(F("Error reading temperature!"));
-    lcd.setCursor(0,0);
-    lcd.print(" ERROR READ TEMP ");
-    delay(2000); // wait a second before next reading
+    LOG_E("Error reading temperature!");
+    metrics.tempReadErrors.inc();
   }
   else {
-    Serial.print(F("Temperature: "));
-    Serial.print(event.temperature);
-    Serial.println(F("°C"));
-    lcd.setCursor(0,0);
-    lcd.print("TEMP: ");lcd.print(event.temperature);lcd.println("deg C");
-    delay(2000); // wait a second before next reading
+    LOG_I("Temperature: %.2f°C", event.temperature);
 
     /* Check if temperature is within threshold (20°C to 40°C); if not, send email notification. */
-      if(event.temperature < 20 || event.temperature > 40) {
-        Serial.println("Temperature is not within threshold! Sending email...");
-        lcd.setCursor(0,1);
-        lcd.print(" TEMP IS NOT OK ");
-        delay(2000); // wait before displaying next text
-        lcd.setCursor(0,1);
-        lcd.print("Sending alert...");
-
-        sendEmailTemp();
-        lcd.setCursor(0,1);
-        lcd.print("EMAIL ALERT SENT");
-    }
+    snap.tempAlert = event.temperature < TEMP_LOW_THRESHOLD || event.temperature > TEMP_HIGH_THRESHOLD;
   }
+
   /* Get humidity event and print its value. */
+  PHASE_TIMER(humidityTimer, PHASE_DHT_HUMIDITY);
   dht.humidity().getEvent(&event);
+  PHASE_STOP(humidityTimer);
+  snap.humidity = event.relative_humidity;
   if (isnan(event.relative_humidity)) {
-    Serial.println(F("Error reading humidity!"));
-    lcd.setCursor(0,0);
-    lcd.print(" ERROR READ HUM ");
-    delay(2000); // wait before displaying next text
+    LOG_E("Error reading humidity!");
+    metrics.humReadErrors.inc();
   }
   else {
-    Serial.print(F("Humidity: "));
-    Serial.print(event.relative_humidity);
-    Serial.println(F("%"));
-    lcd.setCursor(0,0);
-    lcd.print("HUMIDITY: ");lcd.print(event.relative_humidity);lcd.println("%");
-    delay(2000); // wait before displaying next text
+    LOG_I("Humidity: %.2f%%", event.relative_humidity);
   }
 
   /* if water level is 0 = OK, if water level is 1 = LOW */
   liquidLevel = digitalRead(LevelSensor);
-    if  (liquidLevel == 0) {
-      lcd.setCursor(0,1);
-      lcd.print("=====");lcd.print(TANK_NAME);lcd.print("=====");
-      
-      Serial.print("Liquid Level : OK!");Serial.println();
-      lcd.setCursor(0,0);
-      lcd.print("LIQUID LVL: OK !");
-      delay(2000); // wait before displaying next text
-    } 
-    else {
-      Serial.print("Liquid Level: LOW. ");Serial.println("PLEASE CHECK TANK!");
-      lcd.setCursor(0,0);
-      lcd.print("LIQUID LVL : LOW");
-      lcd.setCursor(0,1);
-      lcd.print("Sending alert...");
-      delay(2000); // wait before displaying next text
-
-      sendEmail();
-      lcd.setCursor(0,1);
-      lcd.print("EMAIL ALERT SENT");
-    }
-}
+  snap.liquidLow = liquidLevel != 0;
+  if (snap.liquidLow) {
+    LOG_W("Liquid Level: LOW. PLEASE CHECK TANK!");
+  } else {
+    LOG_I("Liquid Level : OK!");
+  }
 
-void sendEmail() {
-  String lastTemp, TankName;
+  /* Alerts are sent by the sink workers; the display and live feed show how far they got */
+  PHASE_TIMER(alertsTimer, PHASE_ALERTS);
+  raiseAlerts(snap);
+  if (snap.tempAlert || snap.liquidLow || heapTelemetry.fragmented()) snap.alert = alerts.status();
+  PHASE_STOP(alertsTimer);
+
+  PHASE_TIMER(publishTimer, PHASE_PUBLISH);
+  publishSnapshot(snap);
+  /* MQTT never waits for the network task: the client queues until the broker is reachable */
+  #if (MqttTelemetry)
+  mqttSink.publishSample(snap);
+  #endif
+  PHASE_STOP(publishTimer);
+
+  PHASE_TIMER(sampleLogTimer, PHASE_SAMPLE_LOG);
+  sampleLog.add(snap);
+  PHASE_STOP(sampleLogTimer);
+
+  if (!bootTimer.has("first sample")) {
+    bootTimer.mark("first sample");
+    bootTimer.print(asyncLog);
+  }
 
-  sensors_event_t event;
-  dht.temperature().getEvent(&event);
-  lastTemp = String(event.temperature);
-
-  /* Declare the message class */
-  SMTP_Message message;
-
-  /* Set the message headers */
-  message.sender.name = F("ESP");
-  message.sender.email = AUTHOR_EMAIL;
-  message.subject = F("RE: LIQUID LEVEL. PLEASE CHECK TANK! - Sent from ESP board");
-  message.addRecipient(F("Sam"), RECIPIENT_EMAIL);
-
-  //Send raw text message
-  String textMsg = "Liquid level is LOW! Current temperature is: " + (lastTemp) + "°C. Please check " + TANK_NAME + ".";
-  message.text.content = textMsg.c_str();
-  message.text.charSet = "us-ascii";
-  message.text.transfer_encoding = Content_Transfer_Encoding::enc_7bit;
-  
-  message.priority = esp_mail_smtp_priority::esp_mail_smtp_priority_low;
-  message.response.notify = esp_mail_smtp_notify_success | esp_mail_smtp_notify_failure | esp_mail_smtp_notify_delay;
-
-  /* Connect to the server */
-  if (!smtp.connect(&config)){
-   // ESP_MAIL_PRINTF("Connection error, Status Code: %d, Error Code: %d, Reason: %s", smtp.statusCode(), smtp.errorCode(), smtp.errorReason().c_str());
-    return;
+  /* Per-device I2C counters and Wi-Fi connect times every 30 samples */
+  static uint16_t samplesSinceStats = 0;
+  if (++samplesSinceStats >= 30) {
+    samplesSinceStats = 0;
+    PHASE_TIME(PHASE_STATS_DUMP);
+    i2cBus.printStats(asyncLog);
+    wifiManager.printStats(asyncLog);
+    timeService.printStatus(asyncLog);
+    sampleLog.printStats(asyncLog);
+    liveFeed.printStats(asyncLog);
+    alerts.printStats(asyncLog);
+    heapTelemetry.printStats(asyncLog);
+    #if (PHASE_TIMING)
+    phaseTimers.printStats(asyncLog);
+    #endif
+    #if (MqttTelemetry)
+    mqttSink.printStats(asyncLog);
+    #endif
   }
 
-  /* Start sending Email and close the session */
-  if (!MailClient.sendMail(&smtp, &message)) //"Status Code: %d" smtp.statusCode(),
-    //ESP_MAIL_PRINTF("Error,  Error Code: %d, Reason: %s",  smtp.errorCode(), smtp.errorReason().c_str());
-    Serial.println("Error sending Email");
-    lcd.setCursor(20,2);
-    lcd.print("Error sending e-mail!");
+  heapTelemetry.sample(HEAP_PHASE_LOOP);
+  metrics.loopUs.observe((uint32_t)(TimeService::monoUs() - snap.sampleUs));
+}
+
+/* Display task and HTTP /now read the mailbox; live feed subscribers get the update pushed */
+void publishSnapshot(const SensorSnapshot &snap) {
+  xSemaphoreTake(publishLock, portMAX_DELAY);
+  sensorMailbox.publish(snap);
+  liveFeed.publish(snap);
+  lastPublished = snap;
+  xSemaphoreGive(publishLock);
 }
 
-void sendEmailTemp() {
-  String lastTemp;
+/* From the alert workers: republishes the current sample with the new status, so the display and
+ * the live feed ("alert" event) follow SENDING -> SENT/FAILED between samples. Samples without an
+ * active alert show no status and are left alone. */
+void onAlertStatus(AlertStatus status) {
+  xSemaphoreTake(publishLock, portMAX_DELAY);
+  if (lastPublished.alert != ALERT_NONE && lastPublished.alert != status) {
+    lastPublished.alert = status;
+    sensorMailbox.publish(lastPublished);
+    liveFeed.publish(lastPublished);
+  }
+  xSemaphoreGive(publishLock);
+}
 
-  sensors_event_t event;
-  dht.temperature().getEvent(&event);
-  lastTemp = String(event.temperature);
-
-  /* Declare the message class */
-  SMTP_Message message;
-
-  /* Set the message headers */
-  message.sender.name = F("ESP");
-  message.sender.email = AUTHOR_EMAIL;
-  message.subject = F("RE: TEMPERATURE. PLEASE CHECK TANK! - Sent from ESP board");
-  message.addRecipient(F("Sam"), RECIPIENT_EMAIL);
-
-  //Send raw text message
-  String textMsg = "Current temperature is not within threshold! Temperature is currently " + (lastTemp) + "°C. Please check " + TANK_NAME + ".";
-  message.text.content = textMsg.c_str();
-  message.text.charSet = "us-ascii";
-  message.text.transfer_encoding = Content_Transfer_Encoding::enc_7bit;
-  
-  message.priority = esp_mail_smtp_priority::esp_mail_smtp_priority_low;
-  message.response.notify = esp_mail_smtp_notify_success | esp_mail_smtp_notify_failure | esp_mail_smtp_notify_delay;
-
-  /* Connect to the server */
-  if (!smtp.connect(&config)){
-   // ESP_MAIL_PRINTF("Connection error, Status Code: %d, Error Code: %d, Reason: %s", smtp.statusCode(), smtp.errorCode(), smtp.errorReason().c_str());
-    return;
+/* Dispatches an alert when a sensor goes into or out of its alarm state, and a reminder every
+ * ALERT_REPEAT_MIN while it stays there */
+void raiseAlerts(const SensorSnapshot &snap) {
+  static bool lastActive[ALERT_SENSORS];
+  static uint64_t lastSentUs[ALERT_SENSORS];
+
+  for (uint8_t s = 0; s < ALERT_SENSORS; s++) {
+    if (s == ALERT_SENSOR_TEMPERATURE && isnan(snap.temperature)) continue; // a failed read changes nothing
+    bool active = s == ALERT_SENSOR_LIQUID_LEVEL ? snap.liquidLow
+                  : s == ALERT_SENSOR_HEAP         ? heapTelemetry.fragmented()
+                                                   : snap.tempAlert;
+    bool reminder = active && snap.sampleUs - lastSentUs[s] >= (uint64_t)ALERT_REPEAT_MIN * 60000000ULL;
+    if (active == lastActive[s] && !reminder) continue;
+
+    alerts.dispatch(alertEvent((AlertSensor)s, active, snap.temperature, snap.sampleUs));
+    lastActive[s] = active;
+    lastSentUs[s] = snap.sampleUs;
   }
+}
 
-  /* Start sending Email and close the session */
-  if (!MailClient.sendMail(&smtp, &message)) //"Status Code: %d" smtp.statusCode(),
-    //ESP_MAIL_PRINTF("Error,  Error Code: %d, Reason: %s",  smtp.errorCode(), smtp.errorReason().c_str());
-    Serial.println("Error sending Email");
-    lcd.setCursor(20,2);
-    lcd.print("Error sending e-mail!");
+/* `active` false builds the all-clear for the sensor */
+AlertEvent alertEvent(AlertSensor sensor, bool active, float temperature, uint64_t sampleUs) {
+  AlertEvent e = {};
+  e.sampleUs = sampleUs;
+  e.sensor = sensor;
+  e.temperature = temperature;
+  if (sensor == ALERT_SENSOR_LIQUID_LEVEL) {
+    e.severity = active ? ALERT_SEVERITY_CRITICAL : ALERT_SEVERITY_CLEAR; // the crystals dry out
+    e.value = active ? 1 : 0;
+    e.thresholdLow = NAN;
+    e.thresholdHigh = NAN;
+  } else if (sensor == ALERT_SENSOR_HEAP) {
+    e.severity = active ? ALERT_SEVERITY_WARNING : ALERT_SEVERITY_CLEAR;
+    e.value = heapTelemetry.fragmentationPct();
+    e.thresholdLow = NAN;
+    e.thresholdHigh = HEAP_FRAG_WARN_PCT;
+  } else {
+    e.severity = active ? ALERT_SEVERITY_WARNING : ALERT_SEVERITY_CLEAR;
+    e.value = temperature;
+    e.thresholdLow = TEMP_LOW_THRESHOLD;
+    e.thresholdHigh = TEMP_HIGH_THRESHOLD;
+  }
+  return e;
+}
+
+/* /metrics body, on the httpd task. Gauges are read from their owners at scrape time. */
+void writeMetrics(PromWriter &out) {
+  SensorSnapshot snap;
+  bool hasSample = sensorMailbox.read(snap);
+  out.gauge("crystal_temperature_celsius", "Last temperature reading", hasSample ? snap.temperature : NAN);
+  out.gauge("crystal_humidity_percent", "Last relative humidity reading", hasSample ? snap.humidity : NAN);
+  out.gauge("crystal_liquid_low", "1 while the liquid level is low", hasSample && snap.liquidLow ? 1 : 0);
+  out.gauge("crystal_temperature_alert", "1 while the temperature is outside the threshold",
+            hasSample && snap.tempAlert ? 1 : 0);
+  out.counter("crystal_samples_total", "Samples taken by loop()", metrics.samples.value());
+  out.family("crystal_sensor_read_errors_total", "counter", "Failed DHT reads");
+  out.sample("crystal_sensor_read_errors_total", "sensor=\"temperature\"", (uint64_t)metrics.tempReadErrors.value());
+  out.sample("crystal_sensor_read_errors_total", "sensor=\"humidity\"", (uint64_t)metrics.humReadErrors.value());
+  out.histogram("crystal_loop_cycle_seconds", "Time loop() spends on one sample, excluding the wait", metrics.loopUs,
+                1e-6);
+
+  alerts.writeMetrics(out);
+  out.family("crystal_smtp_errors_total", "counter", "SMTP failures by stage");
+  out.sample("crystal_smtp_errors_total", "stage=\"connect\"", (uint64_t)smtpAlerts.connectErrors.value());
+  out.sample("crystal_smtp_errors_total", "stage=\"send\"", (uint64_t)smtpAlerts.sendErrors.value());
+  out.histogram("crystal_smtp_connect_seconds", "SMTP connect and login time", smtpAlerts.connectMs, 1e-3);
+  out.histogram("crystal_smtp_send_seconds", "SMTP message send time", smtpAlerts.sendMs, 1e-3);
+  out.gauge("crystal_smtp_tls_rx_buffer_bytes", "TLS receive buffer of the SMTP session",
+            smtpAlerts.tlsBuffersResolved() ? smtpAlerts.tlsBuffers().rx : NAN);
+  out.gauge("crystal_smtp_tls_mfln", "1 while the SMTP session relies on max_fragment_length",
+            smtpAlerts.tlsBuffersResolved() && smtpAlerts.tlsBuffers().mfln ? 1 : 0);
+  out.gauge("crystal_smtp_session_heap_bytes", "Heap taken by the last open SMTP session", smtpAlerts.sessionHeapLast());
+  out.gauge("crystal_smtp_session_heap_max_bytes", "Largest heap taken by an SMTP session",
+            smtpAlerts.sessionHeapMax());
+  #if (SMTP_ARENA_BYTES > 0)
+  out.counter("crystal_smtp_arena_allocations_total", "Mail client strings carved from the send arena",
+              smtpArena.allocations());
+  out.counter("crystal_smtp_arena_overflows_total", "Mail client strings that found the arena full and used the heap",
+              smtpArena.overflows());
+  out.gauge("crystal_smtp_arena_high_water_bytes", "Most of the send arena one send has carved", smtpArena.highWater());
+  out.gauge("crystal_smtp_arena_survivors", "Arena strings still alive after the last send", smtpArena.survivors());
+  #endif
+
+  const MqttStats &mqtt = mqttSink.stats();
+  out.gauge("crystal_mqtt_connected", "1 while connected to the MQTT broker", mqttSink.connected() ? 1 : 0);
+  out.family("crystal_mqtt_messages_total", "counter", "MQTT messages queued by kind");
+  out.sample("crystal_mqtt_messages_total", "kind=\"telemetry\"", (uint64_t)mqtt.telemetry);
+  out.sample("crystal_mqtt_messages_total", "kind=\"alert\"", (uint64_t)mqtt.alerts);
+  out.counter("crystal_mqtt_acked_total", "MQTT PUBACKs received", mqtt.acked);
+  out.counter("crystal_mqtt_dropped_total", "Telemetry skipped with the in-flight window full", mqtt.dropped);
+  out.counter("crystal_mqtt_expired_total", "MQTT messages given up before a PUBACK", mqtt.expired);
+  out.counter("crystal_mqtt_bytes_total", "MQTT payload bytes queued", mqtt.bytes);
+  out.gauge("crystal_mqtt_inflight", "MQTT telemetry waiting for a PUBACK", mqttSink.inflight());
+  out.histogram("crystal_mqtt_ack_seconds", "MQTT publish to PUBACK time", mqttSink.ackUs(), 1e-6);
+
+  HeapStat &loopHeap = heapTelemetry.phase(HEAP_PHASE_LOOP);
+  out.gauge("crystal_heap_free_bytes", "Free heap at the last loop() cycle", loopHeap.current());
+  out.gauge("crystal_heap_min_free_bytes", "Lowest free heap seen by loop()", loopHeap.min());
+  out.gauge("crystal_heap_low_watermark_bytes", "Lowest free heap since boot", ESP.getMinFreeHeap());
+  out.gauge("crystal_heap_largest_free_block_bytes", "Largest allocatable block of internal RAM",
+            heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL));
+  heapTelemetry.writeMetrics(out);
+  #if (PHASE_TIMING)
+  phaseTimers.writeMetrics(out);
+  #endif
+
+  out.family("crystal_queue_depth", "gauge", "Items waiting in internal queues");
+  out.sample("crystal_queue_depth", "queue=\"i2c\"", (uint64_t)i2cBus.queueDepth());
+  out.sample("crystal_queue_depth", "queue=\"sample_log\"", (uint64_t)sampleLog.pending());
+  const I2cDeviceStats *lcdStats = i2cBus.stats(lcdDevice);
+  if (lcdStats) {
+    out.counter("crystal_i2c_lcd_transactions_total", "I2C transactions to the LCD", lcdStats->transactions);
+    out.counter("crystal_i2c_lcd_errors_total", "Failed I2C transactions to the LCD", lcdStats->errors);
+  }
+  out.gauge("crystal_sse_clients", "Live feed subscribers", liveFeed.clients());
+  out.counter("crystal_sse_dropped_total", "Live feed messages skipped for slow subscribers", liveFeed.stats().dropped);
+
+  const LogStats &logStats = asyncLog.stats();
+  out.counter("crystal_log_records_total", "Log messages queued for the serial port", logStats.records.value());
+  out.counter("crystal_log_dropped_total", "Log messages dropped with the log ring full", logStats.dropped.value());
+  out.counter("crystal_log_truncated_total", "Log messages cut at LOG_LINE_MAX", logStats.truncated.value());
+  out.counter("crystal_log_bytes_total", "Bytes written to the serial port by the log task", logStats.bytes.value());
+  out.gauge("crystal_log_ring_high_water_bytes", "Most of the log ring in use at once", asyncLog.highWater());
+
+  bool wifiUp = wifiManager.connected();
+  const WifiStats &wifi = wifiManager.stats();
+  out.gauge("crystal_wifi_connected", "1 while associated", wifiUp ? 1 : 0);
+  out.gauge("crystal_wifi_rssi_dbm", "Signal strength of the current AP", wifiUp ? WiFi.RSSI() : NAN);
+  out.counter("crystal_wifi_reconnects_total", "Wi-Fi connects after the first one", wifi.reconnects);
+  out.family("crystal_wifi_connects_total", "counter", "Successful Wi-Fi connects by path");
+  out.sample("crystal_wifi_connects_total", "path=\"fast\"", (uint64_t)wifi.fastSuccesses);
+  out.sample("crystal_wifi_connects_total", "path=\"full\"", (uint64_t)wifi.fullSuccesses);
+
+  out.gauge("crystal_time_synced", "1 once SNTP has set the clock", timeService.synced() ? 1 : 0);
+  out.gauge("crystal_uptime_seconds", "Time since boot", TimeService::monoUs() / 1e6);
+  out.counter("crystal_display_frames_total", "Frames rendered by the display task", display.frames());
 }
 
 /* Callback function to get the Email sending status */
 void smtpCallback(SMTP_Status status) {
   /* Print the current status */
-  Serial.println(status.info());
+  LOG_I("%s", status.info());
 
-  /* Print the sending result */
+  /* Print the sending result; through asyncLog rather than ESP_MAIL_PRINTF so the SMTP worker never waits on Serial */
   if (status.success()){
-    // ESP_MAIL_PRINTF used in the examples is for format printing via debug Serial port
-    // that works for all supported Arduino platform SDKs e.g. AVR, SAMD, ESP32 and ESP8266.
-    // In ESP8266 and ESP32, you can use Serial.printf directly.
-
-    Serial.println("----------------");
-    ESP_MAIL_PRINTF("Message sent success: %d\n", status.completedCount());
-    ESP_MAIL_PRINTF("Message sent failed: %d\n", status.failedCount());
-    Serial.println("----------------\n");
+    LOG_I("Message sent success: %d, failed: %d", (int)status.completedCount(), (int)status.failedCount());
 
     for (size_t i = 0; i < smtp.sendingResult.size(); i++)
     {
@@ -380,13 +805,9 @@ void smtpCallback(SMTP_Status status) {
       // Other devices may show invalid timestamp as the device time was not set i.e. it will show Jan 1, 1970.
       // You can call smtp.setSystemTime(xxx) to set device time manually. Where xxx is timestamp (seconds since Jan 1, 1970)
       
-      ESP_MAIL_PRINTF("Message No: %d\n", i + 1);
-      ESP_MAIL_PRINTF("Status: %s\n", result.completed ? "success" : "failed");
-      //ESP_MAIL_PRINTF("Date/Time: %s\n", MailClient.Time.getDateTimeString(result.timestamp, "%B %d, %Y %H:%M:%S").c_str());
-      ESP_MAIL_PRINTF("Recipient: %s\n", result.recipients.c_str());
-      ESP_MAIL_PRINTF("Subject: %s\n", result.subject.c_str());
+      LOG_I("Message No: %u, status: %s, recipient: %s, subject: %s", (unsigned)(i + 1),
+            result.completed ? "success" : "failed", result.recipients.c_str(), result.subject.c_str());
     }
-    Serial.println("----------------\n");
 
     // You need to clear sending result as the memory usage will grow up.
     smtp.sendingResult.clear();
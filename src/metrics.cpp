@@ -0,0 +1,71 @@
+#include "metrics.h"
+
+#include <stdarg.h>
+
+PromWriter::PromWriter(char *buf, size_t len, MetricsSink sink, void *arg)
+    : _buf(buf), _len(len), _used(0), _sink(sink), _arg(arg), _ok(true) {}
+
+/* Formats one line into the buffer, sending the buffer first if the line does not fit */
+void PromWriter::append(const char *format, ...) {
+  if (!_ok) return;
+  for (uint8_t attempt = 0; attempt < 2; attempt++) {
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(_buf + _used, _len - _used, format, args);
+    va_end(args);
+    if (n < 0) return;
+    if (_used + n < _len) {
+      _used += n;
+      return;
+    }
+    if (_used == 0) return; // a single line larger than the buffer; dropped
+    _ok = _sink(_arg, _buf, _used);
+    _used = 0;
+    if (!_ok) return;
+  }
+}
+
+void PromWriter::family(const char *name, const char *type, const char *help) {
+  append("# HELP %s %s\n# TYPE %s %s\n", name, help, name, type);
+}
+
+void PromWriter::sample(const char *name, const char *labels, double value) {
+  if (isnan(value)) append(labels ? "%s{%s} NaN\n" : "%s%s NaN\n", name, labels ? labels : "");
+  else append(labels ? "%s{%s} %.6g\n" : "%s%s %.6g\n", name, labels ? labels : "", value);
+}
+
+void PromWriter::sample(const char *name, const char *labels, uint64_t value) {
+  append(labels ? "%s{%s} %llu\n" : "%s%s %llu\n", name, labels ? labels : "", (unsigned long long)value);
+}
+
+void PromWriter::counter(const char *name, const char *help, uint64_t value) {
+  family(name, "counter", help);
+  sample(name, nullptr, value);
+}
+
+void PromWriter::gauge(const char *name, const char *help, double value) {
+  family(name, "gauge", help);
+  sample(name, nullptr, value);
+}
+
+/* The series labels and "le" go out in one line, however long the labels; an infinite `le` is +Inf */
+void PromWriter::bucketLine(const char *name, const char *labels, double le, uint64_t value) {
+  const char *sep = *labels ? "," : "";
+  if (isinf(le)) append("%s_bucket{%s%sle=\"+Inf\"} %llu\n", name, labels, sep, (unsigned long long)value);
+  else append("%s_bucket{%s%sle=\"%g\"} %llu\n", name, labels, sep, le, (unsigned long long)value);
+}
+
+/* `labels` may be empty; the braces are left out then */
+void PromWriter::suffixed(const char *name, const char *suffix, const char *labels, double value) {
+  append(*labels ? "%s%s{%s} %.6g\n" : "%s%s%s %.6g\n", name, suffix, labels, value);
+}
+
+void PromWriter::suffixed(const char *name, const char *suffix, const char *labels, uint64_t value) {
+  append(*labels ? "%s%s{%s} %llu\n" : "%s%s%s %llu\n", name, suffix, labels, (unsigned long long)value);
+}
+
+bool PromWriter::finish() {
+  if (_ok && _used) _ok = _sink(_arg, _buf, _used);
+  _used = 0;
+  return _ok;
+}
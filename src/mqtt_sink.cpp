@@ -0,0 +1,233 @@
+#include "mqtt_sink.h"
+
+#include <ctype.h>
+#include <math.h>
+
+static const char *const alertTopics[MQTT_ALERT_KINDS] = {"liquid_low", "temperature", "heap"};
+
+MqttSink::MqttSink(const TimeService &time, const char *tankName)
+    : _time(time), _client(nullptr), _lock(nullptr), _ackSignal(nullptr), _waitMsgId(0), _connected(false),
+      _startUs(0), _inflight{}, _inflightCount(0), _stats{} {
+  /* "TANK 1" -> "crystaltronics/tank_1" */
+  size_t n = snprintf(_base, sizeof(_base), "crystaltronics/");
+  for (const char *p = tankName; *p && n + 1 < sizeof(_base); p++) {
+    _base[n++] = isalnum((unsigned char)*p) ? tolower((unsigned char)*p) : '_';
+  }
+  _base[n] = '\0';
+  snprintf(_statusTopic, sizeof(_statusTopic), "%s/status", _base);
+  for (uint8_t k = 0; k < MQTT_ALERT_KINDS; k++) _alerts[k] = {-1, -1, 0, 0};
+}
+
+bool MqttSink::begin(const char *brokerUri, const char *username, const char *password) {
+  if (_client) return true;
+  _lock = xSemaphoreCreateMutex();
+  _ackSignal = xSemaphoreCreateBinary();
+  if (!_lock || !_ackSignal) return false;
+
+  /* The persistent session is keyed on the client id, so it has to stay the same across reboots */
+  snprintf(_clientId, sizeof(_clientId), "crystal-%06llx", (unsigned long long)(ESP.getEfuseMac() & 0xFFFFFF));
+
+  esp_mqtt_client_config_t cfg = {};
+  cfg.uri = brokerUri;
+  cfg.username = username;
+  cfg.password = password;
+  cfg.client_id = _clientId;
+  cfg.disable_clean_session = true;
+  cfg.keepalive = MQTT_KEEPALIVE_S;
+  cfg.lwt_topic = _statusTopic;
+  cfg.lwt_msg = "offline";
+  cfg.lwt_qos = 1;
+  cfg.lwt_retain = 1;
+  cfg.buffer_size = 512;          // messages are small; the default 1 KB per direction is not needed
+  cfg.task_stack = 4096;
+  _client = esp_mqtt_client_init(&cfg);
+  if (!_client) return false;
+
+  esp_mqtt_client_register_event(_client, (esp_mqtt_event_id_t)ESP_EVENT_ANY_ID, eventHandler, this);
+  if (esp_mqtt_client_start(_client) != ESP_OK) {
+    esp_mqtt_client_destroy(_client);
+    _client = nullptr;
+    return false;
+  }
+  _startUs = TimeService::monoUs();
+  return true;
+}
+
+int MqttSink::formatStamp(char *buf, size_t len, uint64_t sampleUs) const {
+  int64_t utc = _time.utcUs(sampleUs);
+  if (utc) return snprintf(buf, len, "\"utc\":%lld", (long long)(utc / 1000));
+  return snprintf(buf, len, "\"up\":%llu", (unsigned long long)(sampleUs / 1000)); // ms since boot
+}
+
+void MqttSink::publishSample(const SensorSnapshot &snap) {
+  if (!_client) return;
+
+  char payload[MQTT_PAYLOAD_MAX], stamp[32], temp[12], hum[12];
+  if (isnan(snap.temperature)) strcpy(temp, "null");
+  else snprintf(temp, sizeof(temp), "%.2f", snap.temperature);
+  if (isnan(snap.humidity)) strcpy(hum, "null");
+  else snprintf(hum, sizeof(hum), "%.1f", snap.humidity);
+  formatStamp(stamp, sizeof(stamp), snap.sampleUs);
+  int len = snprintf(payload, sizeof(payload), "{\"t\":%s,\"h\":%s,\"low\":%d,\"hot\":%d,%s}", temp, hum,
+                     snap.liquidLow ? 1 : 0, snap.tempAlert ? 1 : 0, stamp);
+  if (len <= 0 || len >= (int)sizeof(payload)) return;
+
+  char topic[MQTT_TOPIC_MAX];
+  snprintf(topic, sizeof(topic), "%s/telemetry", _base);
+  if (enqueue(topic, payload, len) > 0) _stats.telemetry++;
+}
+
+bool MqttSink::sendAlert(MqttAlert kind, bool active, uint64_t sampleUs) {
+  if (!_client || kind >= MQTT_ALERT_KINDS) return false;
+  int8_t state = active ? 1 : 0;
+
+  char topic[MQTT_TOPIC_MAX], payload[48], stamp[32];
+  snprintf(topic, sizeof(topic), "%s/alert/%s", _base, alertTopics[kind]);
+  formatStamp(stamp, sizeof(stamp), sampleUs);
+  int len = snprintf(payload, sizeof(payload), "{\"active\":%d,%s}", state, stamp);
+
+  xSemaphoreTake(_ackSignal, 0); // a late PUBACK from a timed-out wait must not satisfy this one
+  bool wait = _connected;
+  int msgId = enqueueAlert(kind, state, topic, payload, len, wait);
+  if (msgId == 0) return true; // the broker already acknowledged this state
+  if (msgId < 0 || !wait) return false; // in the outbox; the session delivers it after a reconnect
+
+  bool signalled = xSemaphoreTake(_ackSignal, pdMS_TO_TICKS(MQTT_ALERT_TIMEOUT_MS)) == pdTRUE;
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  _waitMsgId = 0;
+  bool ok = _alerts[kind].acked == state; // the outbox giving the message up signals too
+  xSemaphoreGive(_lock);
+  if (!signalled) _stats.alertTimeouts++;
+  return ok;
+}
+
+/* Queues a QoS 1 telemetry message in the client's outbox. It takes an in-flight slot and is
+ * dropped when none is free. Returns the message id. */
+int MqttSink::enqueue(const char *topic, const char *payload, int len) {
+  Inflight *slot = nullptr;
+  uint64_t now = TimeService::monoUs();
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+    Inflight &f = _inflight[i];
+    if (f.msgId && now - f.queuedUs > (uint64_t)MQTT_INFLIGHT_TIMEOUT * 1000) {
+      f.msgId = 0; // missed MQTT_EVENT_DELETED; the client's outbox has expired it by now
+      _inflightCount--;
+    }
+    if (!f.msgId && !slot) slot = &f;
+  }
+  if (!slot) {
+    _stats.dropped++;
+    xSemaphoreGive(_lock);
+    return -1;
+  }
+
+  int msgId = esp_mqtt_client_enqueue(_client, topic, payload, len, 1, 0, true);
+  if (msgId > 0) {
+    _stats.bytes += len;
+    slot->msgId = msgId;
+    slot->queuedUs = now;
+    _inflightCount++;
+  }
+  xSemaphoreGive(_lock);
+  return msgId;
+}
+
+/* Queues the retained `state` of alert `kind`, outside the in-flight window so it always goes.
+ * Nothing is queued when the broker already acknowledged that state, or when a copy of it is
+ * still waiting in the outbox (that copy is waited for instead). `waitAck` arms _ackSignal before
+ * the MQTT task can see the PUBACK. Returns the message id to wait for, 0 for none, -1 on failure. */
+int MqttSink::enqueueAlert(MqttAlert kind, int8_t state, const char *topic, const char *payload, int len,
+                           bool waitAck) {
+  AlertState &a = _alerts[kind];
+  uint64_t now = TimeService::monoUs();
+  int msgId;
+
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  if (a.msgId && now - a.queuedUs > (uint64_t)MQTT_INFLIGHT_TIMEOUT * 1000) a.msgId = 0; // missed DELETED
+  if (a.msgId && a.queued == state) {
+    msgId = a.msgId;
+  } else if (!a.msgId && a.acked == state) {
+    msgId = 0;
+  } else {
+    msgId = esp_mqtt_client_enqueue(_client, topic, payload, len, 1, 1, true);
+    if (msgId > 0) {
+      _stats.bytes += len;
+      _stats.alerts++;
+      a.queued = state;
+      a.msgId = msgId; // a copy of the other state still queued is superseded: the last one retained wins
+      a.queuedUs = now;
+    }
+  }
+  if (msgId > 0 && waitAck) _waitMsgId = msgId;
+  xSemaphoreGive(_lock);
+  return msgId;
+}
+
+/* MQTT task: a PUBACK arrived (or the outbox gave the message up) */
+void MqttSink::acked(int msgId, bool delivered) {
+  uint64_t now = TimeService::monoUs();
+  xSemaphoreTake(_lock, portMAX_DELAY);
+  for (uint8_t i = 0; i < MQTT_INFLIGHT_MAX; i++) {
+    Inflight &f = _inflight[i];
+    if (f.msgId != msgId) continue;
+    if (delivered) _ackUs.observe((uint32_t)(now - f.queuedUs));
+    f.msgId = 0;
+    _inflightCount--;
+    break;
+  }
+  for (uint8_t k = 0; k < MQTT_ALERT_KINDS; k++) {
+    AlertState &a = _alerts[k];
+    if (a.msgId != msgId) continue;
+    if (delivered) {
+      _ackUs.observe((uint32_t)(now - a.queuedUs));
+      a.acked = a.queued; // only now does the broker hold this state
+    }
+    a.msgId = 0;
+  }
+  if (delivered) _stats.acked++;
+  else _stats.expired++;
+  bool waited = msgId == _waitMsgId;
+  xSemaphoreGive(_lock);
+
+  if (waited) xSemaphoreGive(_ackSignal);
+}
+
+void MqttSink::eventHandler(void *arg, esp_event_base_t base, int32_t eventId, void *eventData) {
+  static_cast<MqttSink *>(arg)->onEvent(static_cast<esp_mqtt_event_handle_t>(eventData));
+}
+
+void MqttSink::onEvent(esp_mqtt_event_handle_t event) {
+  switch (event->event_id) {
+    case MQTT_EVENT_CONNECTED:
+      _connected = true;
+      _stats.connects++;
+      /* Clears the last will's "offline"; the session resends anything still in the outbox */
+      esp_mqtt_client_enqueue(_client, _statusTopic, "online", 6, 1, 1, true);
+      break;
+    case MQTT_EVENT_DISCONNECTED:
+      if (_connected) _stats.disconnects++;
+      _connected = false;
+      break;
+    case MQTT_EVENT_PUBLISHED:
+      acked(event->msg_id, true);
+      break;
+    case MQTT_EVENT_DELETED:
+      acked(event->msg_id, false);
+      break;
+    default:
+      break;
+  }
+}
+
+void MqttSink::printStats(Print &out) const {
+  float minutes = _startUs ? (TimeService::monoUs() - _startUs) / 60e6f : 0.0f;
+  uint32_t acks = _ackUs.total();
+  out.printf("MQTT %s: %lu telemetry, %lu alerts, %lu acked (%.1f/min), %lu dropped, %lu expired, %u in flight\n",
+             _connected ? "up" : "down", (unsigned long)_stats.telemetry, (unsigned long)_stats.alerts,
+             (unsigned long)_stats.acked, minutes > 0 ? _stats.acked / minutes : 0.0f,
+             (unsigned long)_stats.dropped, (unsigned long)_stats.expired, (unsigned)_inflightCount);
+  out.printf("    PUBACK mean %.1f ms, %lu bytes, %lu connects, %lu alert timeouts\n",
+             acks ? _ackUs.sum() / 1000.0 / acks : 0.0, (unsigned long)_stats.bytes,
+             (unsigned long)_stats.connects, (unsigned long)_stats.alertTimeouts);
+}
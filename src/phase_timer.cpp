@@ -0,0 +1,52 @@
+#include "phase_timer.h"
+
+#if (PHASE_TIMING)
+
+static const char *const phaseNames[TIMED_PHASES] = {
+    "loop", "dht_temperature", "dht_humidity", "alerts", "publish", "sample_log", "stats_dump",
+    "email", "smtp_connect", "smtp_send", "lcd", "tft"};
+
+PhaseTimers phaseTimers;
+
+const char *PhaseTimers::phaseName(TimedPhase phase) { return phase < TIMED_PHASES ? phaseNames[phase] : "?"; }
+
+/* Empty probes into a histogram nothing else reads; the loop is counted in, so the figure errs high */
+void PhaseTimers::calibrate() {
+  static PhaseHistogram scratch;
+  uint32_t start = now();
+  for (uint16_t i = 0; i < PHASE_CALIBRATE_PROBES; i++) {
+    uint32_t probe = now();
+    scratch.observe(now() - probe);
+  }
+  _probeNs = (uint32_t)((uint64_t)(now() - start) * 1000 / PHASE_CALIBRATE_PROBES);
+}
+
+void PhaseTimers::writeMetrics(PromWriter &out) {
+  char labels[32];
+  out.family("crystal_phase_duration_seconds", "histogram", "Time spent in each timed phase");
+  for (uint8_t p = 0; p < TIMED_PHASES; p++) {
+    snprintf(labels, sizeof(labels), "phase=\"%s\"", phaseNames[p]);
+    out.histogramSeries("crystal_phase_duration_seconds", labels, _hist[p], 1e-6);
+  }
+  out.family("crystal_phase_max_seconds", "gauge", "Longest time spent in each timed phase");
+  for (uint8_t p = 0; p < TIMED_PHASES; p++) {
+    snprintf(labels, sizeof(labels), "phase=\"%s\"", phaseNames[p]);
+    out.sample("crystal_phase_max_seconds", labels, _hist[p].max() * 1e-6);
+  }
+  out.gauge("crystal_phase_probe_cost_seconds", "Cost of one phase timer probe, measured at boot", _probeNs * 1e-9);
+}
+
+/* Phases that have not run yet are left out; quantiles are bucket bounds, within 25% */
+void PhaseTimers::printStats(Print &out) {
+  out.printf("Phase timing in us, probe %lu ns\n", (unsigned long)_probeNs);
+  for (uint8_t p = 0; p < TIMED_PHASES; p++) {
+    const PhaseHistogram &h = _hist[p];
+    uint32_t n = h.total();
+    if (!n) continue;
+    out.printf("  %-16s n %6lu  mean %8lu  p50 %8lu  p90 %8lu  p99 %8lu  max %8lu\n", phaseNames[p],
+               (unsigned long)n, (unsigned long)(h.sum() / n), (unsigned long)h.quantile(0.5f),
+               (unsigned long)h.quantile(0.9f), (unsigned long)h.quantile(0.99f), (unsigned long)h.max());
+  }
+}
+
+#endif // PHASE_TIMING
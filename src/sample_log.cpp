@@ -0,0 +1,248 @@
+#include "sample_log.h"
+
+static_assert(sizeof(LogRecord) == 16, "LogRecord is the on-flash format");
+
+SampleLog::SampleLog(fs::FS &fs, const TimeService &time)
+    : _fs(fs), _time(time), _lock(nullptr), _ready(false), _fileBytes(0), _acc{}, _pendingHead(0),
+      _pendingCount(0), _stats{} {}
+
+bool SampleLog::begin() {
+  if (!_lock) _lock = xSemaphoreCreateMutex();
+  if (!_lock) return false;
+
+  File file = _fs.open(SAMPLE_LOG_PATH, "r");
+  _fileBytes = file ? file.size() : 0;
+  if (file) file.close();
+  _fileBytes -= _fileBytes % sizeof(LogRecord); // a torn last record is overwritten by the next append
+  _ready = true;
+  return true;
+}
+
+static int16_t toCenti(float v) { return (int16_t)lroundf(v * 100); }
+
+void SampleLog::add(const SensorSnapshot &snap) {
+  if (_acc.samples && snap.sampleUs - _acc.startUs >= (uint64_t)SAMPLE_LOG_INTERVAL_S * 1000000ULL) close();
+
+  if (!_acc.samples) {
+    _acc = {};
+    _acc.startUs = snap.sampleUs;
+    _acc.tempMin = INT16_MAX;
+    _acc.tempMax = INT16_MIN;
+  }
+  if (!isnan(snap.temperature)) {
+    int16_t t = toCenti(snap.temperature);
+    _acc.tempSum += t;
+    if (t < _acc.tempMin) _acc.tempMin = t;
+    if (t > _acc.tempMax) _acc.tempMax = t;
+    _acc.tempCount++;
+  }
+  if (!isnan(snap.humidity)) {
+    _acc.humSum += (uint16_t)lroundf(snap.humidity * 100);
+    _acc.humCount++;
+  }
+  if (snap.liquidLow) _acc.liquidLow++;
+  _acc.samples++;
+
+  flushPending();
+}
+
+/* Ends the current interval and queues its record */
+void SampleLog::close() {
+  LogRecord r = {};
+  r.samples = _acc.samples;
+  r.liquidLow = _acc.liquidLow;
+  if (_acc.tempCount) {
+    r.tempAvg = (int16_t)(_acc.tempSum / _acc.tempCount);
+    r.tempMin = _acc.tempMin;
+    r.tempMax = _acc.tempMax;
+  } else {
+    r.tempAvg = r.tempMin = r.tempMax = LOG_TEMP_NONE;
+  }
+  r.humAvg = _acc.humCount ? (uint16_t)(_acc.humSum / _acc.humCount) : LOG_HUM_NONE;
+
+  if (_pendingCount == SAMPLE_LOG_PENDING) {
+    _pendingHead = (_pendingHead + 1) % SAMPLE_LOG_PENDING; // drop the oldest
+    _pendingCount--;
+    _stats.dropped++;
+  }
+  Pending &p = _pending[(_pendingHead + _pendingCount) % SAMPLE_LOG_PENDING];
+  p.record = r;
+  p.startUs = _acc.startUs;
+  _pendingCount++;
+  _acc.samples = 0;
+}
+
+/* Writes queued records once UTC is known. Never waits for the lock: if a download is
+ * streaming, the records stay queued until a later sample. */
+void SampleLog::flushPending() {
+  if (!_ready || !_pendingCount) return;
+  if (_time.utcUs(_pending[_pendingHead].startUs) == 0) return;
+  if (xSemaphoreTake(_lock, 0) != pdTRUE) {
+    _stats.deferred++;
+    return;
+  }
+
+  while (_pendingCount) {
+    Pending &p = _pending[_pendingHead];
+    p.record.time = (uint32_t)(_time.utcUs(p.startUs) / 1000000LL);
+    if (!append(p.record)) {
+      _stats.writeErrors++;
+      break;
+    }
+    _pendingHead = (_pendingHead + 1) % SAMPLE_LOG_PENDING;
+    _pendingCount--;
+    _stats.written++;
+  }
+  xSemaphoreGive(_lock);
+}
+
+/* Caller holds _lock */
+bool SampleLog::append(const LogRecord &record) {
+  if (_fileBytes + sizeof(LogRecord) > SAMPLE_LOG_FILE_MAX) {
+    _fs.remove(SAMPLE_LOG_OLD_PATH);
+    if (!_fs.rename(SAMPLE_LOG_PATH, SAMPLE_LOG_OLD_PATH)) return false;
+    _fileBytes = 0;
+    _stats.rotations++;
+  }
+
+  File file = _fs.open(SAMPLE_LOG_PATH, _fileBytes ? "r+" : "w");
+  if (!file) return false;
+  bool ok = file.seek(_fileBytes) && file.write((const uint8_t *)&record, sizeof(record)) == sizeof(record);
+  file.close();
+  if (ok) _fileBytes += sizeof(LogRecord);
+  return ok;
+}
+
+/* Several rollups merged into one output bucket, weighted by their sample counts */
+struct SampleLogBucket {
+  uint32_t time;
+  int64_t  tempWeighted;
+  uint32_t tempSamples;
+  int16_t  tempMin;
+  int16_t  tempMax;
+  uint64_t humWeighted;
+  uint32_t humSamples;
+  uint32_t samples;
+  uint32_t liquidLow;
+};
+
+static void bucketStart(SampleLogBucket &b, uint32_t time) {
+  b = {};
+  b.time = time;
+  b.tempMin = INT16_MAX;
+  b.tempMax = INT16_MIN;
+}
+
+static void bucketAdd(SampleLogBucket &b, const LogRecord &r) {
+  if (r.tempAvg != LOG_TEMP_NONE) {
+    b.tempWeighted += (int64_t)r.tempAvg * r.samples;
+    b.tempSamples += r.samples;
+    if (r.tempMin < b.tempMin) b.tempMin = r.tempMin;
+    if (r.tempMax > b.tempMax) b.tempMax = r.tempMax;
+  }
+  if (r.humAvg != LOG_HUM_NONE) {
+    b.humWeighted += (uint64_t)r.humAvg * r.samples;
+    b.humSamples += r.samples;
+  }
+  b.samples += r.samples;
+  b.liquidLow += r.liquidLow;
+}
+
+/* First record with time >= from; records are appended in time order */
+size_t SampleLog::lowerBound(File &file, size_t count, uint32_t from) {
+  size_t lo = 0, hi = count;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    uint32_t t = 0;
+    if (!file.seek(mid * sizeof(LogRecord)) || file.read((uint8_t *)&t, sizeof(t)) != sizeof(t)) return count;
+    if (t < from) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo;
+}
+
+static size_t formatBucket(char *out, size_t len, const SampleLogBucket &b) {
+  char temp[24] = ",,", hum[8] = "";
+  if (b.tempSamples) {
+    snprintf(temp, sizeof(temp), "%.2f,%.2f,%.2f", (float)b.tempWeighted / b.tempSamples / 100.0f,
+             b.tempMin / 100.0f, b.tempMax / 100.0f);
+  }
+  if (b.humSamples) snprintf(hum, sizeof(hum), "%.2f", (float)b.humWeighted / b.humSamples / 100.0f);
+  return snprintf(out, len, "%lu,%s,%s,%lu,%lu\n", (unsigned long)b.time, temp, hum, (unsigned long)b.liquidLow,
+                  (unsigned long)b.samples);
+}
+
+bool SampleLog::stream(uint32_t from, uint32_t to, uint32_t res, SampleLogSink sink, void *arg, char *buf,
+                       size_t bufLen) {
+  static const char header[] = "time,temp_avg,temp_min,temp_max,humidity,liquid_low,samples\n";
+  const size_t lineMax = 64;
+  if (bufLen < lineMax) return false;
+  if (res < SAMPLE_LOG_INTERVAL_S) res = SAMPLE_LOG_INTERVAL_S;
+
+  size_t used = snprintf(buf, bufLen, "%s", header);
+  bool ok = true;
+  bool open = false;
+  SampleLogBucket bucket = {};
+  const char *paths[] = {SAMPLE_LOG_OLD_PATH, SAMPLE_LOG_PATH};
+
+  /* Holding the lock for the whole download only delays appends (they queue in RAM) */
+  if (!_lock || xSemaphoreTake(_lock, portMAX_DELAY) != pdTRUE) return false;
+
+  for (uint8_t f = 0; f < 2 && ok; f++) {
+    File file = _fs.open(paths[f], "r");
+    if (!file) continue;
+    size_t count = file.size() / sizeof(LogRecord);
+    size_t i = lowerBound(file, count, from);
+    file.seek(i * sizeof(LogRecord));
+
+    LogRecord block[SAMPLE_LOG_READ_BLOCK];
+    bool done = false;
+    while (ok && !done && i < count) {
+      size_t n = min<size_t>(SAMPLE_LOG_READ_BLOCK, count - i);
+      if (file.read((uint8_t *)block, n * sizeof(LogRecord)) != n * sizeof(LogRecord)) break;
+      i += n;
+
+      for (size_t k = 0; k < n; k++) {
+        const LogRecord &r = block[k];
+        if (r.time > to) {
+          done = true;
+          break;
+        }
+        uint32_t start = r.time - r.time % res;
+        if (open && start != bucket.time) {
+          if (used + lineMax > bufLen) {
+            ok = sink(arg, buf, used);
+            used = 0;
+          }
+          used += formatBucket(buf + used, bufLen - used, bucket);
+          open = false;
+        }
+        if (!open) {
+          bucketStart(bucket, start);
+          open = true;
+        }
+        bucketAdd(bucket, r);
+      }
+    }
+    file.close();
+    if (done) break;
+  }
+  xSemaphoreGive(_lock);
+
+  if (ok && open) {
+    if (used + lineMax > bufLen) {
+      ok = sink(arg, buf, used);
+      used = 0;
+    }
+    used += formatBucket(buf + used, bufLen - used, bucket);
+  }
+  if (ok && used) ok = sink(arg, buf, used);
+  return ok;
+}
+
+void SampleLog::printStats(Print &out) const {
+  out.printf("Sample log: %lu written, %u pending, %lu dropped, %lu deferred, %lu errors, %lu rotations, %u KB\n",
+             (unsigned long)_stats.written, (unsigned)_pendingCount, (unsigned long)_stats.dropped,
+             (unsigned long)_stats.deferred, (unsigned long)_stats.writeErrors, (unsigned long)_stats.rotations,
+             (unsigned)(_fileBytes / 1024));
+}
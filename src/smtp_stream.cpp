@@ -0,0 +1,155 @@
+#include "smtp_stream.h"
+
+#include <stdarg.h>
+#include "base64_stream.h"
+
+/* Set from the EHLO reply; the response callback has no user argument */
+static bool serverChunking = false;
+
+struct AuthBuffer {
+  char   text[160];
+  size_t used;
+};
+
+/* Base64Sink that joins the encoded lines into one token */
+static bool authSink(void *arg, const char *data, size_t len) {
+  AuthBuffer *auth = static_cast<AuthBuffer *>(arg);
+  for (size_t i = 0; i < len; i++) {
+    if (data[i] == '\r' || data[i] == '\n') continue;
+    if (auth->used + 1 >= sizeof(auth->text)) return false;
+    auth->text[auth->used++] = data[i];
+  }
+  auth->text[auth->used] = '\0';
+  return true;
+}
+
+SmtpStream::SmtpStream(SMTPSession &smtp, char *buf, size_t len)
+    : _smtp(smtp), _buf(buf), _len(len), _used(0), _ok(len >= SMTP_STREAM_CHUNK_MIN), _chunking(false), _bytes(0),
+      _status(0) {}
+
+void SmtpStream::onResponse(SMTP_Response res) {
+  if (strstr(res.text.c_str(), "CHUNKING")) serverChunking = true;
+}
+
+int SmtpStream::command(const char *cmd) {
+  _status = _smtp.sendCustomCommand(cmd, onResponse);
+  return _status;
+}
+
+bool SmtpStream::begin(ESP_Mail_Session &session, const char *sender, const char *recipient, bool allowChunking) {
+  if (!_ok) return false;
+  _ok = false;
+  if (open(session, sender, recipient, allowChunking)) {
+    _used = 0;
+    _bytes = 0;
+    _ok = true;
+    return true;
+  }
+  _smtp.closeSession();
+  return false;
+}
+
+bool SmtpStream::open(ESP_Mail_Session &session, const char *sender, const char *recipient, bool allowChunking) {
+  serverChunking = false;
+  if (_smtp.customConnect(&session, onResponse) < 0) return false;
+  if (command("EHLO crystaltronics") != 250) return false;
+
+  /* AUTH PLAIN: base64 of "\0user\0password" */
+  const char *user = session.login.email.c_str();
+  const char *password = session.login.password.c_str();
+  uint8_t plain[128];
+  size_t userLen = strlen(user), passwordLen = strlen(password);
+  if (userLen + passwordLen + 2 > sizeof(plain)) return false;
+  plain[0] = '\0';
+  memcpy(plain + 1, user, userLen);
+  plain[1 + userLen] = '\0';
+  memcpy(plain + 2 + userLen, password, passwordLen);
+
+  char line[BASE64_LINE_OUTPUT];
+  AuthBuffer auth = {};
+  memcpy(auth.text, "AUTH PLAIN ", 11);
+  auth.used = 11;
+  Base64Stream encoder(line, sizeof(line), authSink, &auth);
+  bool encoded = encoder.write(plain, userLen + passwordLen + 2) && encoder.finish();
+  int authStatus = encoded ? command(auth.text) : -1;
+  memset(plain, 0, sizeof(plain));
+  memset(&auth, 0, sizeof(auth));
+  memset(line, 0, sizeof(line));
+  if (authStatus != 235) return false;
+
+  char cmd[96];
+  snprintf(cmd, sizeof(cmd), "MAIL FROM:<%s>", sender);
+  if (command(cmd) != 250) return false;
+  snprintf(cmd, sizeof(cmd), "RCPT TO:<%s>", recipient);
+  int rcpt = command(cmd);
+  if (rcpt != 250 && rcpt != 251) return false;
+
+  _chunking = allowChunking && serverChunking;
+  return _chunking || command("DATA") == 354;
+}
+
+/* One BDAT chunk, or plain data inside DATA. `data` ends with CRLF unless it is empty. */
+bool SmtpStream::sendChunk(const char *data, size_t len, bool last) {
+  if (!_chunking) return len == 0 || _smtp.sendCustomData((uint8_t *)data, len);
+
+  char cmd[32];
+  if (len < 2) {
+    snprintf(cmd, sizeof(cmd), "BDAT 0%s", last ? " LAST" : "");
+    return command(cmd) == 250;
+  }
+  /* The command line and all but the final CRLF go out as raw data; sendCustomCommand("") then
+   * sends that CRLF and reads the chunk's reply */
+  snprintf(cmd, sizeof(cmd), "BDAT %u%s\r\n", (unsigned)len, last ? " LAST" : "");
+  if (!_smtp.sendCustomData((const char *)cmd)) return false;
+  if (!_smtp.sendCustomData((uint8_t *)data, len - 2)) return false;
+  return command("") == 250;
+}
+
+bool SmtpStream::flush(bool last) {
+  if (!_ok) return false;
+  if (_used || last) _ok = sendChunk(_buf, _used, last);
+  _used = 0;
+  return _ok;
+}
+
+bool SmtpStream::write(const char *data, size_t len) {
+  if (!_ok) return false;
+  _bytes += len;
+  if (_used + len > _len && !flush(false)) return false;
+  if (len > _len) return _ok = sendChunk(data, len, false); // already whole lines; no need to copy
+  memcpy(_buf + _used, data, len);
+  _used += len;
+  return true;
+}
+
+bool SmtpStream::printf(const char *format, ...) {
+  char line[160];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (n < 0 || n >= (int)sizeof(line)) return _ok = false;
+  return write(line, n);
+}
+
+bool SmtpStream::sink(void *arg, const char *data, size_t len) {
+  return static_cast<SmtpStream *>(arg)->write(data, len);
+}
+
+bool SmtpStream::end() {
+  bool ok;
+  if (_chunking) {
+    ok = flush(true);
+  } else {
+    ok = flush(false) && command(".") == 250;
+  }
+  if (_smtp.connected()) command("QUIT");
+  _smtp.closeSession();
+  _ok = false;
+  return ok;
+}
+
+void SmtpStream::abort() {
+  _ok = false;
+  _smtp.closeSession();
+}
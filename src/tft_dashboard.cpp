@@ -0,0 +1,231 @@
+#if defined(TFT_DASHBOARD)
+
+#include "tft_dashboard.h"
+
+/* Layout (landscape 320x240) */
+#define BANNER_H    28
+#define VALUES_Y    BANNER_H
+#define VALUES_H    72
+#define TREND_Y     (VALUES_Y + VALUES_H + 4)
+#define TREND_H     (TFT_HEIGHT - TREND_Y - 4)
+#define TREND_X     28
+#define TREND_W     (TFT_WIDTH - TREND_X - 4)
+#define TREND_MIN_C 10.0f   // chart scale in deg C
+#define TREND_MAX_C 50.0f
+#define TEMP_LOW_C  ((float)TEMP_LOW_THRESHOLD)
+#define TEMP_HIGH_C ((float)TEMP_HIGH_THRESHOLD)
+#define VALUE_SIZE  4       // text size of the live readouts
+
+TftDashboard::TftDashboard(Adafruit_ST7789 &tft, const char *title)
+    : _tft(tft), _title(title), _band{nullptr, nullptr}, _jobs(nullptr), _free{nullptr, nullptr},
+      _latest{}, _hasSample(false), _trendHead(0), _trendCount(0), _stats{} {
+  _latest.temperature = NAN;
+  _latest.humidity = NAN;
+  _stats.minUs = UINT32_MAX;
+}
+
+bool TftDashboard::begin(uint32_t spiFreq) {
+  _tft.init(240, 320);
+  _tft.setRotation(1);
+  _tft.setSPISpeed(spiFreq);
+  _tft.fillScreen(ST77XX_BLACK);
+  _digits.begin();
+
+  for (uint8_t i = 0; i < 2; i++) {
+    _band[i] = new GFXcanvas16(TFT_WIDTH, TFT_BAND_HEIGHT);
+    if (!_band[i] || !_band[i]->getBuffer()) return false;
+    _free[i] = xSemaphoreCreateBinary();
+    if (!_free[i]) return false;
+    xSemaphoreGive(_free[i]);
+  }
+
+  _jobs = xQueueCreate(2, sizeof(BandJob));
+  if (!_jobs) return false;
+
+  /* The flush task runs on the core opposite to the caller so SPI pushes overlap with drawing */
+  BaseType_t otherCore = xPortGetCoreID() == 0 ? 1 : 0;
+  return xTaskCreatePinnedToCore(flushTask, "tftFlush", 3072, this, 1, nullptr, otherCore) == pdPASS;
+}
+
+void TftDashboard::pushSample(const SensorSnapshot &sample) {
+  _latest = sample;
+  _hasSample = true;
+  if (isnan(sample.temperature)) return;
+
+  _trend[_trendHead] = sample.temperature;
+  _trendHead = (_trendHead + 1) % TFT_TREND_POINTS;
+  if (_trendCount < TFT_TREND_POINTS) _trendCount++;
+}
+
+void TftDashboard::render() {
+  uint32_t start = micros();
+  uint32_t drawUs = 0;
+  uint8_t buf = 0;
+
+  for (uint16_t y0 = 0; y0 < TFT_HEIGHT; y0 += TFT_BAND_HEIGHT) {
+    /* Wait until the flush task is done with this buffer, then draw the next band into it */
+    xSemaphoreTake(_free[buf], portMAX_DELAY);
+    uint32_t t = micros();
+    drawBand(*_band[buf], y0);
+    drawUs += micros() - t;
+
+    BandJob job = {buf, y0};
+    xQueueSend(_jobs, &job, portMAX_DELAY);
+    buf ^= 1;
+  }
+
+  /* Both buffers free again means the last band is on the panel */
+  for (uint8_t i = 0; i < 2; i++) xSemaphoreTake(_free[i], portMAX_DELAY);
+  for (uint8_t i = 0; i < 2; i++) xSemaphoreGive(_free[i]);
+
+  uint32_t elapsed = micros() - start;
+  _stats.frames++;
+  _stats.lastUs = elapsed;
+  _stats.drawUs = drawUs;
+  _stats.totalUs += elapsed;
+  if (elapsed < _stats.minUs) _stats.minUs = elapsed;
+  if (elapsed > _stats.maxUs) _stats.maxUs = elapsed;
+}
+
+void TftDashboard::flushTask(void *arg) {
+  TftDashboard *self = static_cast<TftDashboard *>(arg);
+  BandJob job;
+
+  for (;;) {
+    if (xQueueReceive(self->_jobs, &job, portMAX_DELAY) != pdTRUE) continue;
+
+    self->_tft.startWrite();
+    self->_tft.setAddrWindow(0, job.y0, TFT_WIDTH, TFT_BAND_HEIGHT);
+    self->_tft.writePixels(self->_band[job.buffer]->getBuffer(), (uint32_t)TFT_WIDTH * TFT_BAND_HEIGHT, false);
+    self->_tft.endWrite();
+
+    xSemaphoreGive(self->_free[job.buffer]);
+  }
+}
+
+void TftDashboard::runBenchmark(Print &out, uint16_t frames) {
+  _stats = DashboardFrameStats{};
+  _stats.minUs = UINT32_MAX;
+  for (uint16_t i = 0; i < frames; i++) render();
+  printStats(out);
+
+  /* Numeric readout redraw: stock GFX text path vs. cached glyph runs, into a line buffer */
+  GFXcanvas16 &canvas = *_band[0];
+  xSemaphoreTake(_free[0], portMAX_DELAY);
+  uint32_t t = micros();
+  for (uint8_t i = 0; i < 50; i++) {
+    canvas.setTextSize(VALUE_SIZE);
+    canvas.setCursor(0, 0);
+    canvas.print("-23.45");
+  }
+  uint32_t gfxUs = micros() - t;
+  t = micros();
+  for (uint8_t i = 0; i < 50; i++) _digits.drawString(canvas, 0, 0, "-23.45", ST77XX_WHITE, VALUE_SIZE);
+  uint32_t cachedUs = micros() - t;
+  xSemaphoreGive(_free[0]);
+
+  out.printf("Readout redraw x50: GFX %u us, glyph cache %u us (%.1fx)\n", (unsigned)gfxUs, (unsigned)cachedUs,
+             cachedUs ? (float)gfxUs / cachedUs : 0.0f);
+}
+
+void TftDashboard::printStats(Print &out) const {
+  if (!_stats.frames) return;
+  out.printf("TFT frames: %u  last: %u us (draw %u us)  min: %u us  avg: %u us  max: %u us\n",
+             (unsigned)_stats.frames, (unsigned)_stats.lastUs, (unsigned)_stats.drawUs, (unsigned)_stats.minUs,
+             (unsigned)(_stats.totalUs / _stats.frames), (unsigned)_stats.maxUs);
+}
+
+/* Everything below draws in panel coordinates shifted up by y0; the canvas clips what falls outside the band */
+void TftDashboard::drawBand(GFXcanvas16 &g, int16_t y0) const {
+  int16_t y1 = y0 + g.height();
+  g.fillScreen(ST77XX_BLACK);
+  if (y0 < BANNER_H) drawBanner(g, y0);
+  if (y0 < VALUES_Y + VALUES_H && y1 > VALUES_Y) drawValues(g, y0);
+  if (y1 > TREND_Y) drawTrend(g, y0);
+}
+
+void TftDashboard::drawBanner(Adafruit_GFX &g, int16_t y0) const {
+  const char *text;
+  uint16_t bg;
+
+  if (_latest.liquidLow) {
+    text = "LIQUID LEVEL LOW";
+    bg = ST77XX_RED;
+  } else if (_latest.tempAlert) {
+    text = "TEMP NOT OK";
+    bg = ST77XX_ORANGE;
+  } else {
+    text = _title;
+    bg = ST77XX_BLUE;
+  }
+
+  g.fillRect(0, -y0, TFT_WIDTH, BANNER_H, bg);
+  g.setTextSize(2);
+  g.setTextColor(ST77XX_WHITE);
+  int16_t x = (TFT_WIDTH - (int16_t)strlen(text) * 12) / 2;
+  g.setCursor(x < 0 ? 0 : x, 7 - y0);
+  g.print(text);
+}
+
+void TftDashboard::drawValues(GFXcanvas16 &g, int16_t y0) const {
+  int16_t y = VALUES_Y + 8 - y0;
+
+  g.setTextSize(1);
+  g.setTextColor(ST77XX_CYAN);
+  g.setCursor(8, y);
+  g.print("TEMP (deg C)");
+  g.setCursor(168, y);
+  g.print("HUMIDITY (%)");
+
+  char value[8];
+  if (!_hasSample || isnan(_latest.temperature)) strcpy(value, "--.-");
+  else snprintf(value, sizeof(value), "%.1f", _latest.temperature);
+  _digits.drawString(g, 8, y + 16, value, _latest.tempAlert ? ST77XX_ORANGE : ST77XX_WHITE, VALUE_SIZE);
+
+  if (!_hasSample || isnan(_latest.humidity)) strcpy(value, "--.-");
+  else snprintf(value, sizeof(value), "%.1f", _latest.humidity);
+  _digits.drawString(g, 168, y + 16, value, ST77XX_WHITE, VALUE_SIZE);
+
+  g.setTextSize(1);
+  g.setTextColor(_latest.liquidLow ? ST77XX_RED : ST77XX_GREEN);
+  g.setCursor(8, y + 52);
+  g.print(_latest.liquidLow ? "LIQUID LVL: LOW" : "LIQUID LVL: OK");
+}
+
+static int16_t trendRow(float celsius) {
+  if (celsius < TREND_MIN_C) celsius = TREND_MIN_C;
+  if (celsius > TREND_MAX_C) celsius = TREND_MAX_C;
+  return TREND_Y + TREND_H - 1 - (int16_t)((celsius - TREND_MIN_C) * (TREND_H - 1) / (TREND_MAX_C - TREND_MIN_C));
+}
+
+void TftDashboard::drawTrend(Adafruit_GFX &g, int16_t y0) const {
+  g.drawRect(TREND_X, TREND_Y - y0, TREND_W, TREND_H, ST77XX_WHITE);
+
+  /* Threshold lines and scale */
+  g.drawFastHLine(TREND_X + 1, trendRow(TEMP_LOW_C) - y0, TREND_W - 2, ST77XX_BLUE);
+  g.drawFastHLine(TREND_X + 1, trendRow(TEMP_HIGH_C) - y0, TREND_W - 2, ST77XX_RED);
+  g.setTextSize(1);
+  g.setTextColor(ST77XX_WHITE);
+  g.setCursor(4, trendRow(TREND_MAX_C) - y0);
+  g.print((int)TREND_MAX_C);
+  g.setCursor(4, trendRow(TREND_MIN_C) - 7 - y0);
+  g.print((int)TREND_MIN_C);
+
+  if (_trendCount < 2) return;
+
+  /* Oldest sample on the left, newest on the right */
+  uint16_t first = (_trendHead + TFT_TREND_POINTS - _trendCount) % TFT_TREND_POINTS;
+  int16_t span = TREND_W - 3;
+  int16_t px = TREND_X + 1;
+  int16_t py = trendRow(_trend[first]);
+
+  for (uint16_t i = 1; i < _trendCount; i++) {
+    int16_t x = TREND_X + 1 + (int32_t)i * span / (TFT_TREND_POINTS - 1);
+    int16_t y = trendRow(_trend[(first + i) % TFT_TREND_POINTS]);
+    g.drawLine(px, py - y0, x, y - y0, ST77XX_YELLOW);
+    px = x;
+    py = y;
+  }
+}
+
+#endif // TFT_DASHBOARD
@@ -0,0 +1,93 @@
+#include "time_service.h"
+
+#include <esp_sntp.h>
+#include <sys/time.h>
+#include <time.h>
+
+TimeService *TimeService::_instance = nullptr;
+
+static int64_t wallClockUs() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return (int64_t)tv.tv_sec * 1000000LL + tv.tv_usec;
+}
+
+TimeService::TimeService() : _wallAnchorUs(0), _monoAnchorUs(0), _started(false) {}
+
+bool TimeService::wallClockValid() { return time(nullptr) > (time_t)TIME_VALID_AFTER_S; }
+
+void TimeService::begin(const char *server) {
+  if (_started) return;
+  _started = true;
+  _instance = this;
+  _monoAnchorUs = monoUs();
+  _wallAnchorUs = wallClockUs();
+
+  sntp_set_time_sync_notification_cb(onSync);
+  configTime(0, 0, server); // UTC; returns at once, the sync arrives on the lwIP task
+}
+
+/* Runs on the lwIP task right after SNTP set the wall clock; the only writer of _sync */
+void TimeService::onSync(struct timeval *tv) {
+  TimeService *self = _instance;
+  if (!self) return;
+
+  uint64_t mono = monoUs();
+  int64_t utc = (int64_t)tv->tv_sec * 1000000LL + tv->tv_usec;
+
+  TimeSync sync = {};
+  self->_sync.read(sync);
+  if (sync.syncs == 0) {
+    int64_t unsynced = self->_wallAnchorUs + (int64_t)(mono - self->_monoAnchorUs);
+    sync.firstStepUs = (self->_wallAnchorUs / 1000000LL > (int64_t)TIME_VALID_AFTER_S) ? 0 : utc - unsynced;
+  }
+  sync.offsetUs = utc - (int64_t)mono;
+  sync.lastSyncMonoUs = mono;
+  sync.syncs++;
+  self->_sync.publish(sync);
+}
+
+bool TimeService::synced() const {
+  TimeSync sync;
+  return _sync.read(sync);
+}
+
+int64_t TimeService::utcUs(uint64_t mono) const {
+  TimeSync sync;
+  if (_sync.read(sync)) return (int64_t)mono + sync.offsetUs;
+
+  /* Not synced this boot, but the RTC may still hold UTC from before a reset or deep sleep */
+  if (wallClockValid()) return (int64_t)mono + (wallClockUs() - (int64_t)monoUs());
+  return 0;
+}
+
+int64_t TimeService::firstStepUs() const {
+  TimeSync sync;
+  return _sync.read(sync) ? sync.firstStepUs : 0;
+}
+
+size_t TimeService::format(char *buf, size_t len, uint64_t mono) const {
+  int64_t utc = utcUs(mono);
+  if (!utc) {
+    return snprintf(buf, len, "T+%lu.%03lus", (unsigned long)(mono / 1000000ULL),
+                    (unsigned long)(mono / 1000ULL % 1000ULL));
+  }
+
+  time_t seconds = (time_t)(utc / 1000000LL);
+  struct tm tm;
+  gmtime_r(&seconds, &tm);
+  size_t n = strftime(buf, len, "%Y-%m-%d %H:%M:%S", &tm);
+  return n + snprintf(buf + n, len - n, ".%03luZ", (unsigned long)(utc / 1000LL % 1000LL));
+}
+
+void TimeService::printStatus(Print &out) const {
+  TimeSync sync = {};
+  char now[32];
+  format(now, sizeof(now), monoUs());
+  if (_sync.read(sync)) {
+    out.printf("Time: %s, %lu syncs, last %lu s ago, first step %+lld ms\n", now, (unsigned long)sync.syncs,
+               (unsigned long)((monoUs() - sync.lastSyncMonoUs) / 1000000ULL), (long long)(sync.firstStepUs / 1000));
+  } else {
+    out.printf("Time: %s, not synced\n", now);
+  }
+}
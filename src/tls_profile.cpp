@@ -0,0 +1,85 @@
+#include "tls_profile.h"
+
+#include <WiFi.h>
+#include "async_log.h"
+
+static const uint16_t rsaSuites[] = {
+  BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+  BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+};
+
+/* X25519 and P-256 only, each on its own 32-bit engine: what br_ec_all_m31 does for these two,
+ * without offering P-384 and P-521, which it can only do with the much slower generic code */
+static const br_ec_impl &rsaCurve(int curve) {
+  return curve == BR_EC_curve25519 ? br_ec_c25519_m31 : br_ec_p256_m31;
+}
+
+static const unsigned char *rsaGenerator(int curve, size_t *len) { return rsaCurve(curve).generator(curve, len); }
+static const unsigned char *rsaOrder(int curve, size_t *len) { return rsaCurve(curve).order(curve, len); }
+static size_t rsaXoff(int curve, size_t *len) { return rsaCurve(curve).xoff(curve, len); }
+
+static uint32_t rsaMul(unsigned char *G, size_t Glen, const unsigned char *x, size_t xlen, int curve) {
+  return rsaCurve(curve).mul(G, Glen, x, xlen, curve);
+}
+
+static size_t rsaMulgen(unsigned char *R, const unsigned char *x, size_t xlen, int curve) {
+  return rsaCurve(curve).mulgen(R, x, xlen, curve);
+}
+
+static uint32_t rsaMuladd(unsigned char *A, const unsigned char *B, size_t len, const unsigned char *x, size_t xlen,
+                          const unsigned char *y, size_t ylen, int curve) {
+  return rsaCurve(curve).muladd(A, B, len, x, xlen, y, ylen, curve);
+}
+
+static const br_ec_impl rsaCurves = {
+  ((uint32_t)1 << BR_EC_curve25519) | ((uint32_t)1 << BR_EC_secp256r1),
+  rsaGenerator, rsaOrder, rsaXoff, rsaMul, rsaMulgen, rsaMuladd,
+};
+
+/* The other engines stay the library's: without a 64x64 bit multiply, which Xtensa lacks, BearSSL
+ * already picks the 32-bit ones (i31 RSA, bitsliced AES, ChaCha20 and Poly1305 in C) */
+static void rsaEngines(br_ssl_client_context *cc) {
+  br_ssl_engine_set_ec(&cc->eng, &rsaCurves);
+}
+
+static const SSLProfile profiles[TLS_PROFILES] = {
+  {nullptr, 0, nullptr},
+  {rsaSuites, sizeof(rsaSuites) / sizeof(rsaSuites[0]), rsaEngines},
+};
+
+static const char *const profileNames[TLS_PROFILES] = {"compat", "rsa"};
+
+const SSLProfile *tlsProfile(TlsProfile profile) {
+  if (profile <= TLS_PROFILE_COMPAT || profile >= TLS_PROFILES) return nullptr;
+  return &profiles[profile];
+}
+
+const char *tlsProfileName(TlsProfile profile) {
+  return profile < TLS_PROFILES ? profileNames[profile] : "?";
+}
+
+TlsBuffers tlsFullBuffers(uint16_t fragment) {
+  TlsBuffers buffers = {TLS_RECORD_MAX, fragment, false};
+  return buffers;
+}
+
+TlsBuffers tlsBuffers(TlsBufferPolicy policy, const char *host, uint16_t port, uint16_t fragment) {
+  TlsBuffers buffers = {fragment, fragment, true};
+  if (policy == TLS_BUFFERS_FULL) return tlsFullBuffers(fragment);
+  if (policy == TLS_BUFFERS_MFLN) return buffers;
+
+  /* A bare ClientHello with the extension; the server's ServerHello tells whether it echoed it */
+  WiFiClient tcp;
+  ESP_SSLClient probe;
+  probe.setClient(&tcp);
+  bool accepted = probe.probeMaxFragmentLength(host, port, fragment);
+  probe.stop();
+  LOG_I("TLS: %s:%u %s max_fragment_length %u", host, port, accepted ? "accepts" : "refuses", fragment);
+  return accepted ? buffers : tlsFullBuffers(fragment);
+}
+
+static const char *const bufferPolicyNames[] = {"auto", "mfln", "full"};
+
+const char *tlsBufferPolicyName(TlsBufferPolicy policy) {
+  return policy <= TLS_BUFFERS_FULL ? bufferPolicyNames[policy] : "?";
+}
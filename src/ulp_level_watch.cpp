@@ -0,0 +1,144 @@
+#include "ulp_level_watch.h"
+
+#if CONFIG_IDF_TARGET_ESP32
+#include <driver/rtc_io.h>
+#include <esp_sleep.h>
+#include <esp32/ulp.h>
+#include <soc/rtc_cntl_reg.h>
+#include <soc/rtc_io_reg.h>
+
+#define ULP_MAGIC 0x554C5057 // "ULPW"
+
+/* The ULP FSM only works on 16-bit values; the upper half of a word holds the PC of the ST */
+static inline uint16_t ulpWord(uint32_t index) { return RTC_SLOW_MEM[index] & 0xFFFF; }
+
+/* debounceStep() for one channel, in ULP instructions. Labels `label` and `label + 1` are used.
+ * R1 points at the channel words, R2 holds the sample. */
+#define ULP_DEBOUNCE_CHANNEL(ch, rtcio, limit, wakeMask, label)                              \
+  I_MOVI(R1, ULP_WORD_CHANNELS + (ch) * DEBOUNCE_WORDS),                                     \
+  I_RD_REG(RTC_GPIO_IN_REG, RTC_GPIO_IN_NEXT_S + (rtcio), RTC_GPIO_IN_NEXT_S + (rtcio)),     \
+  I_MOVR(R2, R0),                                                                            \
+  I_LD(R3, R1, 0),                 /* sample == stable: run = 0 */                           \
+  I_SUBR(R0, R2, R3),                                                                        \
+  M_BXZ(label),                                                                              \
+  I_LD(R0, R1, 1),                 /* run++, still bouncing if run < limit */                \
+  I_ADDI(R0, R0, 1),                                                                         \
+  I_ST(R0, R1, 1),                                                                           \
+  M_BL((label) + 1, (limit)),                                                                \
+  I_ST(R2, R1, 0),                 /* flip: stable = sample, transitions++ */                \
+  I_LD(R0, R1, 2),                                                                           \
+  I_ADDI(R0, R0, 1),                                                                         \
+  I_ST(R0, R1, 2),                                                                           \
+  I_MOVI(R3, (wakeMask)),          /* (wakeMask >> sample) & 1 */                            \
+  I_RSHR(R0, R3, R2),                                                                        \
+  I_ANDI(R0, R0, 1),                                                                         \
+  M_BL(label, 1),                                                                            \
+  I_MOVI(R3, ULP_WORD_WAKE),       /* request a wake for this channel */                     \
+  I_LD(R0, R3, 0),                                                                           \
+  I_ORI(R0, R0, 1 << (ch)),                                                                  \
+  I_ST(R0, R3, 0),                                                                           \
+  M_LABEL(label),                                                                            \
+  I_MOVI(R0, 0),                                                                             \
+  I_ST(R0, R1, 1),                                                                           \
+  M_LABEL((label) + 1)
+
+UlpLevelWatch::UlpLevelWatch(uint8_t levelPin, uint8_t buttonPin) : _levelPin(levelPin), _buttonPin(buttonPin) {}
+
+bool UlpLevelWatch::running() const { return RTC_SLOW_MEM[ULP_WORD_MAGIC] == ULP_MAGIC; }
+
+bool UlpLevelWatch::begin(bool force) {
+  if (running() && !force) return true;
+
+  int levelIo = rtc_io_number_get((gpio_num_t)_levelPin);
+  int buttonIo = rtc_io_number_get((gpio_num_t)_buttonPin);
+  if (levelIo < 0 || buttonIo < 0) return false;
+
+  rtc_gpio_init((gpio_num_t)_levelPin);
+  rtc_gpio_set_direction((gpio_num_t)_levelPin, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_init((gpio_num_t)_buttonPin);
+  rtc_gpio_set_direction((gpio_num_t)_buttonPin, RTC_GPIO_MODE_INPUT_ONLY);
+  rtc_gpio_pulldown_dis((gpio_num_t)_buttonPin);
+  rtc_gpio_pullup_en((gpio_num_t)_buttonPin); // button pulls the pin low
+
+  /* Start from the current levels so power-on does not count as a transition */
+  RTC_SLOW_MEM[ULP_WORD_MAGIC] = 0;
+  RTC_SLOW_MEM[ULP_WORD_WAKE] = 0;
+  RTC_SLOW_MEM[ULP_WORD_TICKS] = 0;
+  DebounceChannel c;
+  for (uint8_t ch = 0; ch < ULP_CHANNELS; ch++) {
+    debounceReset(c, rtc_gpio_get_level((gpio_num_t)(ch == ULP_CH_LEVEL ? _levelPin : _buttonPin)));
+    RTC_SLOW_MEM[ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 0] = c.stable;
+    RTC_SLOW_MEM[ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 1] = c.run;
+    RTC_SLOW_MEM[ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 2] = c.transitions;
+  }
+
+  /* Register fields in the instructions depend on the pins, so the program is built at run time */
+  ulp_insn_t program[] = {
+    I_MOVI(R3, ULP_WORD_TICKS),
+    I_LD(R0, R3, 0),
+    I_ADDI(R0, R0, 1),
+    I_ST(R0, R3, 0),
+
+    ULP_DEBOUNCE_CHANNEL(ULP_CH_LEVEL, levelIo, LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW | DEBOUNCE_WAKE_HIGH, 1),
+    ULP_DEBOUNCE_CHANNEL(ULP_CH_BUTTON, buttonIo, BUTTON_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW, 3),
+
+    /* Wake the SoC once a request is pending and it is ready for it. While the main CPU is
+     * awake the request stays pending, so a change seen then wakes it right after it sleeps. */
+    I_MOVI(R3, ULP_WORD_WAKE),
+    I_LD(R0, R3, 0),
+    M_BL(9, 1),
+    I_RD_REG(RTC_CNTL_LOW_POWER_ST_REG, RTC_CNTL_RDY_FOR_WAKEUP_S, RTC_CNTL_RDY_FOR_WAKEUP_S),
+    M_BL(9, 1),
+    I_WAKE(),
+    M_LABEL(9),
+    I_HALT()
+  };
+
+  size_t size = sizeof(program) / sizeof(ulp_insn_t);
+  if (ulp_process_macros_and_load(ULP_PROG_START, program, &size) != ESP_OK) return false;
+  if (ulp_set_wakeup_period(0, DEBOUNCE_PERIOD_MS * 1000) != ESP_OK) return false;
+  if (ulp_run(ULP_PROG_START) != ESP_OK) return false;
+
+  RTC_SLOW_MEM[ULP_WORD_MAGIC] = ULP_MAGIC;
+  return true;
+}
+
+/* The ULP can set a bit between the read and the clear; that request is lost, but the stable
+ * level and the transition count are not, and the caller samples them on this wake anyway. */
+uint8_t UlpLevelWatch::takeWakeBits() {
+  uint8_t bits = ulpWord(ULP_WORD_WAKE);
+  RTC_SLOW_MEM[ULP_WORD_WAKE] = 0;
+  return bits;
+}
+
+DebounceChannel UlpLevelWatch::channel(UlpChannel ch) const {
+  DebounceChannel c;
+  c.stable = ulpWord(ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 0);
+  c.run = ulpWord(ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 1);
+  c.transitions = ulpWord(ULP_WORD_CHANNELS + ch * DEBOUNCE_WORDS + 2);
+  return c;
+}
+
+uint16_t UlpLevelWatch::ticks() const { return ulpWord(ULP_WORD_TICKS); }
+
+void UlpLevelWatch::enableWakeup() { esp_sleep_enable_ulp_wakeup(); }
+
+#else
+
+UlpLevelWatch::UlpLevelWatch(uint8_t levelPin, uint8_t buttonPin) : _levelPin(levelPin), _buttonPin(buttonPin) {}
+bool UlpLevelWatch::begin(bool) { return false; }
+bool UlpLevelWatch::running() const { return false; }
+uint8_t UlpLevelWatch::takeWakeBits() { return 0; }
+DebounceChannel UlpLevelWatch::channel(UlpChannel) const { return DebounceChannel{}; }
+uint16_t UlpLevelWatch::ticks() const { return 0; }
+void UlpLevelWatch::enableWakeup() {}
+
+#endif
+
+void UlpLevelWatch::printStats(Print &out) const {
+  DebounceChannel level = channel(ULP_CH_LEVEL);
+  DebounceChannel button = channel(ULP_CH_BUTTON);
+  out.printf("ULP watch: %s, %u polls, level %s (%u transitions), button %s (%u transitions)\n",
+             running() ? "running" : "stopped", (unsigned)ticks(), level.stable ? "LOW" : "OK",
+             (unsigned)level.transitions, button.stable ? "up" : "down", (unsigned)button.transitions);
+}
@@ -0,0 +1,154 @@
+#include "wifi_manager.h"
+
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#define WIFI_CACHE_MAGIC 0x57494649  // "WIFI"
+
+/* RTC slow memory keeps the cache across deep sleep without touching flash */
+RTC_DATA_ATTR static WifiCache rtcCache;
+
+WifiManager::WifiManager(const char *ssid, const char *password)
+    : _ssid(ssid), _password(password), _cache{}, _cacheValid(false), _everConnected(false), _stats{} {}
+
+uint32_t WifiManager::hashSsid() const {
+  /* FNV-1a over ssid and password */
+  uint32_t h = 2166136261u;
+  for (const char *p = _ssid; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+  h *= 16777619u; // separator, so "ab"+"c" and "a"+"bc" differ
+  for (const char *p = _password; *p; p++) h = (h ^ (uint8_t)*p) * 16777619u;
+  return h;
+}
+
+uint32_t WifiManager::checksum(const WifiCache &c) {
+  const uint8_t *bytes = reinterpret_cast<const uint8_t *>(&c);
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < offsetof(WifiCache, checksum); i++) h = (h ^ bytes[i]) * 16777619u;
+  return h;
+}
+
+bool WifiManager::loadCache() {
+  WifiCache c = rtcCache;
+  bool ok = c.magic == WIFI_CACHE_MAGIC && c.ssidHash == hashSsid() && c.checksum == checksum(c);
+
+  if (!ok) {
+    Preferences prefs;
+    if (prefs.begin("wifi", true)) {
+      ok = prefs.getBytes("cache", &c, sizeof(c)) == sizeof(c) && c.magic == WIFI_CACHE_MAGIC &&
+           c.ssidHash == hashSsid() && c.checksum == checksum(c);
+      prefs.end();
+    }
+    if (ok) rtcCache = c;
+  }
+
+  if (ok) _cache = c;
+  _cacheValid = ok;
+  return ok;
+}
+
+/* NVS is only written when the AP or the lease changed, to spare the flash */
+void WifiManager::saveCache() {
+  WifiCache c = {};
+  c.magic = WIFI_CACHE_MAGIC;
+  c.ssidHash = hashSsid();
+  memcpy(c.bssid, WiFi.BSSID(), sizeof(c.bssid));
+  c.channel = WiFi.channel();
+  c.ip = WiFi.localIP();
+  c.gateway = WiFi.gatewayIP();
+  c.subnet = WiFi.subnetMask();
+  c.dns = WiFi.dnsIP();
+  c.checksum = checksum(c);
+
+  bool changed = !_cacheValid || memcmp(&c, &_cache, sizeof(c)) != 0;
+  _cache = c;
+  _cacheValid = true;
+  rtcCache = c;
+  if (!changed) return;
+
+  Preferences prefs;
+  if (prefs.begin("wifi", false)) {
+    prefs.putBytes("cache", &c, sizeof(c));
+    prefs.end();
+  }
+}
+
+void WifiManager::invalidateCache() {
+  _cacheValid = false;
+  memset(&_cache, 0, sizeof(_cache));
+  rtcCache = _cache;
+  Preferences prefs;
+  if (prefs.begin("wifi", false)) {
+    prefs.remove("cache");
+    prefs.end();
+  }
+}
+
+bool WifiManager::waitForConnection(uint32_t timeoutMs) {
+  uint32_t start = millis();
+  while (WiFi.status() != WL_CONNECTED) {
+    if (millis() - start >= timeoutMs) return false;
+    vTaskDelay(pdMS_TO_TICKS(20));
+  }
+  return true;
+}
+
+bool WifiManager::connect(uint32_t timeoutMs) {
+  if (connected()) return true;
+
+  WiFi.mode(WIFI_STA);
+  WiFi.persistent(false); // the SDK's own flash copy of the config is not needed
+  if (!_cacheValid) loadCache();
+
+  bool ok = false;
+
+  /* Fast path: straight to the cached AP on its channel, with the cached lease as a static IP */
+  if (_cacheValid) {
+    uint32_t start = millis();
+    _stats.fastAttempts++;
+    WiFi.config(IPAddress(_cache.ip), IPAddress(_cache.gateway), IPAddress(_cache.subnet), IPAddress(_cache.dns));
+    WiFi.begin(_ssid, _password, _cache.channel, _cache.bssid, true);
+    ok = waitForConnection(WIFI_FAST_TIMEOUT_MS);
+    if (ok) {
+      _stats.fastSuccesses++;
+      _stats.fastMs.observe(millis() - start);
+    } else {
+      WiFi.disconnect();
+      _cacheValid = false; // AP moved or lease gone: rebuild the cache from a full connect
+    }
+  }
+
+  /* Slow path: full scan and DHCP */
+  if (!ok) {
+    uint32_t start = millis();
+    _stats.fullAttempts++;
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0)); // back to DHCP
+    WiFi.begin(_ssid, _password);
+    ok = waitForConnection(timeoutMs);
+    if (ok) {
+      _stats.fullSuccesses++;
+      _stats.fullMs.observe(millis() - start);
+    } else {
+      WiFi.disconnect();
+      return false;
+    }
+  }
+
+  saveCache();
+  if (_everConnected) _stats.reconnects++;
+  _everConnected = true;
+  return true;
+}
+
+void WifiManager::printStats(Print &out) const {
+  out.printf("WiFi fast: %lu/%lu  full: %lu/%lu  reconnects: %lu  RSSI: %d dBm\n",
+             (unsigned long)_stats.fastSuccesses, (unsigned long)_stats.fastAttempts,
+             (unsigned long)_stats.fullSuccesses, (unsigned long)_stats.fullAttempts,
+             (unsigned long)_stats.reconnects, connected() ? WiFi.RSSI() : 0);
+  out.print("    fast connect");
+  _stats.fastMs.print(out, "ms");
+  out.println();
+  out.print("    full connect");
+  _stats.fullMs.print(out, "ms");
+  out.println();
+}
@@ -0,0 +1,105 @@
+//=====================================================================================================//
+// HOST SHIM: Adafruit_ST7789
+// A fake panel with the calls TftDashboard makes. The pixels pushed through setAddrWindow() and
+// writePixels() land in a framebuffer in panel (rotated) coordinates, so a test can compare the
+// banded render against a single full-frame canvas. GFX drawing straight onto the panel also
+// goes to the framebuffer. Pushes are counted per frame, and `pixelNs` can add a simulated SPI
+// cost per pixel for the frame-time benchmark, held to the microsecond like the real transfer.
+//=====================================================================================================//
+
+#ifndef NATIVE_ADAFRUIT_ST7789_H
+#define NATIVE_ADAFRUIT_ST7789_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#define ST77XX_BLACK   0x0000
+#define ST77XX_WHITE   0xFFFF
+#define ST77XX_RED     0xF800
+#define ST77XX_GREEN   0x07E0
+#define ST77XX_BLUE    0x001F
+#define ST77XX_CYAN    0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW  0xFFE0
+#define ST77XX_ORANGE  0xFC00
+
+class Adafruit_ST7789 : public Adafruit_GFX {
+public:
+  Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst)
+      : Adafruit_GFX(240, 320), pixelNs(0), pushes(0), pixelsPushed(0), _winX(0), _winY(0), _winW(0), _winH(0),
+        _cursor(0), _inWrite(false) {
+    (void)cs, (void)dc, (void)rst;
+  }
+
+  void init(uint16_t width, uint16_t height, uint8_t spiMode = 0) {
+    (void)spiMode;
+    WIDTH = _width = width;
+    HEIGHT = _height = height;
+    _fb.assign((size_t)width * height, 0);
+  }
+  void setSPISpeed(uint32_t freq) { (void)freq; }
+
+  void startWrite() override { _inWrite = true; }
+  void endWrite() override { _inWrite = false; }
+
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    _winX = x;
+    _winY = y;
+    _winW = w;
+    _winH = h;
+    _cursor = 0;
+  }
+
+  /* Fills the address window left to right, top to bottom, like the controller's RAM pointer */
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false) {
+    (void)block, (void)bigEndian;
+    pushes++;
+    pixelsPushed += len;
+    if (!_winW || !_winH) return;
+    for (uint32_t i = 0; i < len; i++, _cursor++) {
+      int16_t x = _winX + _cursor % _winW, y = _winY + (_cursor / _winW) % _winH;
+      if (x < _width && y < _height) _fb[(size_t)y * _width + x] = colors[i];
+    }
+    if (pixelNs) busyWait(std::chrono::nanoseconds((uint64_t)pixelNs * len));
+  }
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+    _fb[(size_t)y * _width + x] = color;
+  }
+
+  void setRotation(uint8_t r) override {
+    Adafruit_GFX::setRotation(r);
+    _fb.assign((size_t)_width * _height, 0);
+  }
+
+  /* Framebuffer in the current rotation, width() x height() */
+  const uint16_t *framebuffer() const { return _fb.data(); }
+  uint16_t pixel(int16_t x, int16_t y) const { return _fb[(size_t)y * _width + x]; }
+  bool inWrite() const { return _inWrite; }
+
+  uint32_t pixelNs;         // simulated SPI time per pushed pixel, 0 = free
+  uint32_t pushes;
+  uint64_t pixelsPushed;
+
+private:
+  /* Host sleeps overshoot by a good part of a band's push time: sleep for most of the transfer, then
+   * yield until the exact end so other threads still get the CPU like they would beside the SPI */
+  static void busyWait(std::chrono::nanoseconds cost) {
+    typedef std::chrono::steady_clock Clock;
+    const std::chrono::microseconds margin(400);
+    Clock::time_point end = Clock::now() + cost;
+    if (cost > margin) std::this_thread::sleep_for(cost - margin);
+    while (Clock::now() < end) std::this_thread::yield();
+  }
+
+  uint16_t _winX, _winY, _winW, _winH;
+  uint32_t _cursor;
+  bool _inWrite;
+  std::vector<uint16_t> _fb;
+};
+
+#endif // NATIVE_ADAFRUIT_ST7789_H
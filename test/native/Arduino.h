@@ -0,0 +1,115 @@
+//=====================================================================================================//
+// HOST SHIM: Arduino core
+// What the project's host-buildable modules and Adafruit GFX/BusIO need from the Arduino-ESP32
+// core, for the [env:native] unit tests. millis()/micros() run on the host's monotonic clock,
+// GPIOs are an array the tests set through native_hal.h, and Serial writes to stdout.
+//=====================================================================================================//
+
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include "Print.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+using std::max;
+using std::min;
+
+#define PROGMEM
+#define PSTR(s) (s)
+#define FPSTR(p) (reinterpret_cast<const __FlashStringHelper *>(p))
+typedef const char *PGM_P;
+#define strlen_P  strlen
+#define strcpy_P  strcpy
+#define strncpy_P strncpy
+#define strcat_P  strcat
+#define strcmp_P  strcmp
+#define strncmp_P strncmp
+#define strstr_P  strstr
+#define memcpy_P  memcpy
+#define pgm_read_byte(addr)    (*(const uint8_t *)(addr))
+#define pgm_read_word(addr)    (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr)   (*(const uint32_t *)(addr))
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+
+#define LOW          0x0
+#define HIGH         0x1
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define PULLUP       0x04
+#define INPUT_PULLUP 0x05
+#define RISING       0x01
+#define FALLING      0x02
+#define CHANGE       0x03
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+typedef uint8_t BitOrder;
+
+#define NATIVE_GPIO_COUNT 49
+#define digitalPinToInterrupt(p) ((p) < NATIVE_GPIO_COUNT ? (p) : -1)
+
+#ifndef _BV
+#define _BV(bit) (1 << (bit))
+#endif
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+/* [0, howbig) and [howsmall, howbig), next to libc's random() as in the core */
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+/* SNTP never runs on the host, whose wall clock is already set */
+void configTime(long gmtOffsetS, int daylightOffsetS, const char *server1, const char *server2 = nullptr,
+                const char *server3 = nullptr);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  void end() {}
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+  uint32_t getHeapSize() { return heap_caps_get_total_size(MALLOC_CAP_INTERNAL); }
+  uint32_t getFreeHeap() { return heap_caps_get_free_size(MALLOC_CAP_INTERNAL); }
+  uint32_t getMinFreeHeap() { return heap_caps_get_minimum_free_size(MALLOC_CAP_INTERNAL); }
+  uint32_t getMaxAllocHeap() { return heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL); }
+  uint64_t getEfuseMac() { return 0x0000a4cf12345678ULL; }
+  void restart() { abort(); }
+};
+
+extern EspClass ESP;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,32 @@
+//=====================================================================================================//
+// HOST SHIM: Client.h
+// The Arduino core's abstract network client, for the mail client's SSL layer. Without the
+// Arduino-ESP32 connect(..., timeout) overloads, as the mail client expects off the ESP32.
+//=====================================================================================================//
+
+#ifndef NATIVE_CLIENT_H
+#define NATIVE_CLIENT_H
+
+#include "IPAddress.h"
+#include "Print.h"
+
+class Client : public Stream {
+public:
+  virtual int connect(IPAddress ip, uint16_t port) = 0;
+  virtual int connect(const char *host, uint16_t port) = 0;
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t size) = 0;
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int read(uint8_t *buf, size_t size) = 0;
+  virtual int peek() = 0;
+  virtual void flush() = 0;
+  virtual void stop() = 0;
+  virtual uint8_t connected() = 0;
+  virtual operator bool() = 0;
+
+protected:
+  uint8_t *rawIPAddress(IPAddress &addr) { return &addr[0]; }
+};
+
+#endif // NATIVE_CLIENT_H
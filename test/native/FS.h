@@ -0,0 +1,78 @@
+//=====================================================================================================//
+// HOST SHIM: FS.h
+// fs::FS and fs::File over a directory on the host, with the open modes of the ESP32 core ("r",
+// "w", "a", "r+", ...) passed to fopen(). native_hal.h can make writes run out of space after a
+// byte budget, to test what the callers do with a short write.
+//=====================================================================================================//
+
+#ifndef NATIVE_FS_H
+#define NATIVE_FS_H
+
+#include <Arduino.h>
+#include <memory>
+#include <string>
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class FileImpl;
+
+class File : public Stream {
+public:
+  File() {}
+  explicit File(std::shared_ptr<FileImpl> impl) : _impl(impl) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t size) override;
+  using Print::write;
+  size_t read(uint8_t *buf, size_t size);
+  int read() override;
+  int peek() override;
+  int available() override;
+  void flush() override;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const;
+  size_t size() const;
+  void close();
+  operator bool() const;
+  const char *path() const;
+
+private:
+  std::shared_ptr<FileImpl> _impl;
+};
+
+class FS {
+public:
+  explicit FS(const char *mountPoint = "") : _mountPoint(mountPoint) {}
+
+  File open(const char *path, const char *mode = "r", bool create = false);
+  File open(const String &path, const char *mode = "r", bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char *path);
+  bool remove(const char *path);
+  bool rename(const char *from, const char *to);
+  bool mkdir(const char *path);
+  bool rmdir(const char *path);
+
+protected:
+  std::string hostPath(const char *path) const;
+
+  std::string _mountPoint;
+};
+
+} // namespace fs
+
+using fs::File;
+using fs::FS;
+using fs::SeekCur;
+using fs::SeekEnd;
+using fs::SeekMode;
+using fs::SeekSet;
+
+#endif // NATIVE_FS_H
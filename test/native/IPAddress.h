@@ -0,0 +1,40 @@
+//=====================================================================================================//
+// HOST SHIM: IPAddress.h
+// The Arduino core's IPv4 address: four octets, indexable, built from octets or a uint32_t in
+// network order, printable as dotted quad.
+//=====================================================================================================//
+
+#ifndef NATIVE_IPADDRESS_H
+#define NATIVE_IPADDRESS_H
+
+#include <stdint.h>
+#include <string.h>
+#include "Print.h"
+
+class IPAddress {
+public:
+  IPAddress() : _octets{} {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+  IPAddress(uint32_t address) { memcpy(_octets, &address, 4); }
+
+  operator uint32_t() const {
+    uint32_t address;
+    memcpy(&address, _octets, 4);
+    return address;
+  }
+  bool operator==(const IPAddress &o) const { return memcmp(_octets, o._octets, 4) == 0; }
+  bool operator!=(const IPAddress &o) const { return !(*this == o); }
+  uint8_t operator[](int index) const { return _octets[index]; }
+  uint8_t &operator[](int index) { return _octets[index]; }
+
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+    return String(buf);
+  }
+
+private:
+  uint8_t _octets[4];
+};
+
+#endif // NATIVE_IPADDRESS_H
@@ -0,0 +1,27 @@
+//=====================================================================================================//
+// HOST SHIM: LittleFS.h
+// Mounts a fresh temporary directory on the first begin(); it lasts for the test process.
+//=====================================================================================================//
+
+#ifndef NATIVE_LITTLEFS_H
+#define NATIVE_LITTLEFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class LittleFSFS : public FS {
+public:
+  bool begin(bool formatOnFail = false, const char *basePath = "/littlefs", uint8_t maxOpenFiles = 10,
+             const char *partitionLabel = "spiffs");
+  void end() { _mountPoint.clear(); }
+  bool format();
+  size_t totalBytes() { return 1024 * 1024; }
+  size_t usedBytes();
+};
+
+} // namespace fs
+
+extern fs::LittleFSFS LittleFS;
+
+#endif // NATIVE_LITTLEFS_H
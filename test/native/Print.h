@@ -0,0 +1,173 @@
+//=====================================================================================================//
+// HOST SHIM: Print / Stream / String
+// The subset of the Arduino-ESP32 core text classes that the project and Adafruit GFX use, with
+// the same overloads and return values, so printStats() dumps and GFX text run unchanged.
+//=====================================================================================================//
+
+#ifndef NATIVE_PRINT_H
+#define NATIVE_PRINT_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+
+class String {
+public:
+  String(const char *s = "") : _s(s ? s : "") {}
+  String(const std::string &s) : _s(s) {}
+  String(char c) : _s(1, c) {}
+  String(int v, unsigned char base = DEC) : _s(format(base == HEX ? "%x" : "%d", v)) {}
+  String(unsigned v, unsigned char base = DEC) : _s(format(base == HEX ? "%x" : "%u", v)) {}
+  String(long v, unsigned char base = DEC) : _s(format(base == HEX ? "%lx" : "%ld", v)) {}
+  String(unsigned long v, unsigned char base = DEC) : _s(format(base == HEX ? "%lx" : "%lu", v)) {}
+  String(float v, unsigned char decimals = 2) : _s(format("%.*f", decimals, v)) {}
+  String(double v, unsigned char decimals = 2) : _s(format("%.*f", decimals, v)) {}
+
+  const char *c_str() const { return _s.c_str(); }
+  unsigned int length() const { return _s.size(); }
+  char operator[](unsigned int i) const { return _s[i]; }
+  bool operator==(const String &o) const { return _s == o._s; }
+  bool operator!=(const String &o) const { return _s != o._s; }
+  String &operator+=(const String &o) {
+    _s += o._s;
+    return *this;
+  }
+
+private:
+  static std::string format(const char *fmt, ...) {
+    char buf[40];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    return buf;
+  }
+
+  std::string _s;
+};
+
+/* What `String + x` returns in the core */
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String &s) : String(s) {}
+  StringSumHelper(const char *s) : String(s) {}
+};
+
+inline StringSumHelper operator+(const String &a, const String &b) {
+  String sum = a;
+  return sum += b;
+}
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+      if (!write(*buffer++)) break;
+      n++;
+    }
+    return n;
+  }
+  size_t write(const char *str) { return str ? write((const uint8_t *)str, strlen(str)) : 0; }
+  size_t write(const char *buffer, size_t size) { return write((const uint8_t *)buffer, size); }
+  virtual int availableForWrite() { return 0; }
+  virtual void flush() {}
+  int getWriteError() { return _writeError; }
+  void clearWriteError() { _writeError = 0; }
+
+  size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+    if (len < (int)sizeof(buf)) return write((const uint8_t *)buf, len);
+    std::string big(len + 1, '\0');
+    va_start(args, format);
+    vsnprintf(&big[0], big.size(), format, args);
+    va_end(args);
+    return write((const uint8_t *)big.data(), len);
+  }
+
+  size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+  size_t print(const String &s) { return write(s.c_str(), s.length()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(int v, int base = DEC) { return print((long)v, base); }
+  size_t print(unsigned int v, int base = DEC) { return print((unsigned long)v, base); }
+  size_t print(long v, int base = DEC) { return base == DEC ? printf("%ld", v) : print((unsigned long)v, base); }
+  size_t print(unsigned long v, int base = DEC) {
+    if (base == HEX) return printf("%lX", v);
+    if (base == OCT) return printf("%lo", v);
+    if (base == BIN) {
+      char bits[33], *p = bits + sizeof(bits) - 1;
+      *p = '\0';
+      do *--p = '0' + (v & 1); while (v >>= 1);
+      return write(p);
+    }
+    return printf("%lu", v);
+  }
+  size_t print(long long v, int base = DEC) { return base == DEC ? printf("%lld", v) : printf("%llX", v); }
+  size_t print(unsigned long long v, int base = DEC) { return base == DEC ? printf("%llu", v) : printf("%llX", v); }
+  size_t print(double v, int digits = 2) { return printf("%.*f", digits, v); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T &v) {
+    size_t n = print(v);
+    return n + println();
+  }
+  template <typename T>
+  size_t println(const T &v, int format) {
+    size_t n = print(v, format);
+    return n + println();
+  }
+
+protected:
+  void setWriteError(int err = 1) { _writeError = err; }
+
+private:
+  int _writeError = 0;
+};
+
+class Stream : public Print {
+public:
+  virtual int available() { return 0; }
+  virtual int read() { return -1; }
+  virtual int peek() { return -1; }
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+
+  /* Reads until `length` bytes or the timeout, like the core (byte at a time through read()) */
+  size_t readBytes(uint8_t *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+      int c = timedRead();
+      if (c < 0) break;
+      buffer[count++] = (uint8_t)c;
+    }
+    return count;
+  }
+  size_t readBytes(char *buffer, size_t length) { return readBytes((uint8_t *)buffer, length); }
+
+protected:
+  int timedRead();
+
+  unsigned long _timeout = 1000;
+};
+
+#endif // NATIVE_PRINT_H
@@ -0,0 +1,62 @@
+//=====================================================================================================//
+// HOST SHIM: SPI.h
+// A bus with nothing on it: enough for Adafruit BusIO and Adafruit_SPITFT to compile and link.
+// Reads return 0; the fake panel in Adafruit_ST7789.h never goes through it.
+//=====================================================================================================//
+
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+#include <Arduino.h>
+
+#define SPI_MODE0 0
+#define SPI_MODE1 1
+#define SPI_MODE2 2
+#define SPI_MODE3 3
+
+#define SPI_LSBFIRST LSBFIRST
+#define SPI_MSBFIRST MSBFIRST
+
+class SPISettings {
+public:
+  SPISettings() : clock(1000000), bitOrder(MSBFIRST), dataMode(SPI_MODE0) {}
+  SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode)
+      : clock(clock), bitOrder(bitOrder), dataMode(dataMode) {}
+
+  uint32_t clock;
+  uint8_t bitOrder;
+  uint8_t dataMode;
+};
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck, (void)miso, (void)mosi, (void)ss;
+  }
+  void end() {}
+  void beginTransaction(SPISettings settings) { (void)settings; }
+  void endTransaction() {}
+  void setFrequency(uint32_t freq) { (void)freq; }
+  void setDataMode(uint8_t mode) { (void)mode; }
+  void setBitOrder(uint8_t order) { (void)order; }
+
+  uint8_t transfer(uint8_t data) { return (void)data, 0; }
+  uint16_t transfer16(uint16_t data) { return (void)data, 0; }
+  uint32_t transfer32(uint32_t data) { return (void)data, 0; }
+  void transfer(void *data, uint32_t size) { memset(data, 0, size); }
+  void transferBytes(const uint8_t *data, uint8_t *out, uint32_t size) {
+    (void)data;
+    if (out) memset(out, 0, size);
+  }
+
+  void write(uint8_t data) { (void)data; }
+  void write16(uint16_t data) { (void)data; }
+  void write32(uint32_t data) { (void)data; }
+  void writeBytes(const uint8_t *data, uint32_t size) { (void)data, (void)size; }
+  void writePixels(const void *data, uint32_t size) { (void)data, (void)size; }
+  void writePattern(const uint8_t *data, uint8_t size, uint32_t repeat) { (void)data, (void)size, (void)repeat; }
+};
+
+extern SPIClass SPI;
+
+#endif // NATIVE_SPI_H
@@ -0,0 +1,37 @@
+//=====================================================================================================//
+// HOST SHIM: WiFi.h
+// WiFiClient over a host TCP socket, so the TLS code can talk to a server in the test process.
+// read() never blocks. available() waits up to 1 ms for data before it reports none, so the SSL
+// client, which polls it in a loop, sleeps instead of spinning while the peer computes: the thread's
+// CPU time is then its own work.
+//=====================================================================================================//
+
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include "Client.h"
+
+class WiFiClient : public Client {
+public:
+  WiFiClient() : _fd(-1), _peeked(-1) {}
+  ~WiFiClient() { stop(); }
+
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char *host, uint16_t port) override;
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t *buf, size_t size) override;
+  int available() override;
+  int read() override;
+  int read(uint8_t *buf, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+
+private:
+  int _fd;
+  int _peeked;    // byte taken by peek(), -1 for none
+};
+
+#endif // NATIVE_WIFI_H
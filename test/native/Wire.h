@@ -0,0 +1,72 @@
+//=====================================================================================================//
+// HOST SHIM: Wire.h
+// An I2C bus where no device answers: endTransmission() reports a NACK and requestFrom()
+// returns nothing, which is what Adafruit BusIO and the project's bus code see with no
+// hardware attached. Setting `ack` makes every write succeed. Each transmission is counted with
+// its length; as on the ESP32, bytes past the transmit buffer (setBufferSize()) are dropped.
+//=====================================================================================================//
+
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+#define I2C_BUFFER_LENGTH 128
+
+class TwoWire : public Stream {
+public:
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0) {
+    (void)sda, (void)scl, (void)frequency;
+    return true;
+  }
+  bool end() { return true; }
+  bool setClock(uint32_t frequency) {
+    _clock = frequency;
+    return true;
+  }
+  uint32_t getClock() { return _clock; }
+  void setTimeOut(uint16_t ms) { (void)ms; }
+  size_t setBufferSize(size_t size) {
+    _bufferSize = size;
+    return size;
+  }
+
+  void beginTransmission(uint16_t address) {
+    (void)address;
+    _pending = 0;
+  }
+  uint8_t endTransmission(bool sendStop = true) {
+    (void)sendStop;
+    transmissions++;
+    lastLength = _pending;
+    return ack ? 0 : 2;
+  }
+  size_t requestFrom(uint16_t address, size_t size, bool sendStop = true) {
+    return (void)address, (void)size, (void)sendStop, 0;
+  }
+  uint8_t requestFrom(uint8_t address, uint8_t size, uint8_t sendStop = true) {
+    return (void)address, (void)size, (void)sendStop, 0;
+  }
+
+  size_t write(uint8_t data) override { return write(&data, 1); }
+  size_t write(const uint8_t *data, size_t size) override {
+    (void)data;
+    if (size > _bufferSize - _pending) size = _bufferSize - _pending;
+    _pending += size;
+    return size;
+  }
+  using Print::write;
+
+  bool ack = false;
+  uint32_t transmissions = 0;
+  size_t lastLength = 0;     // bytes sent in the last transmission
+
+private:
+  uint32_t _clock = 100000;
+  size_t _bufferSize = I2C_BUFFER_LENGTH;
+  size_t _pending = 0;
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,11 @@
+// HOST SHIM: driver/gpio.h, the pin numbers only
+#ifndef NATIVE_DRIVER_GPIO_H
+#define NATIVE_DRIVER_GPIO_H
+
+typedef enum {
+  GPIO_NUM_NC = -1,
+  GPIO_NUM_0 = 0,
+  GPIO_NUM_MAX = 40
+} gpio_num_t;
+
+#endif // NATIVE_DRIVER_GPIO_H
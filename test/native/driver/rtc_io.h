@@ -0,0 +1,28 @@
+//=====================================================================================================//
+// HOST SHIM: driver/rtc_io.h
+// The ESP32's GPIO to RTC IO numbering; levels come from the same pin array as digitalRead().
+//=====================================================================================================//
+
+#ifndef NATIVE_DRIVER_RTC_IO_H
+#define NATIVE_DRIVER_RTC_IO_H
+
+#include "driver/gpio.h"
+#include "esp_err.h"
+
+typedef enum {
+  RTC_GPIO_MODE_INPUT_ONLY,
+  RTC_GPIO_MODE_OUTPUT_ONLY,
+  RTC_GPIO_MODE_INPUT_OUTPUT,
+  RTC_GPIO_MODE_DISABLED
+} rtc_gpio_mode_t;
+
+/* -1 when the pin has no RTC function */
+int rtc_io_number_get(gpio_num_t gpio);
+
+esp_err_t rtc_gpio_init(gpio_num_t gpio);
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio, rtc_gpio_mode_t mode);
+esp_err_t rtc_gpio_pullup_en(gpio_num_t gpio);
+esp_err_t rtc_gpio_pulldown_dis(gpio_num_t gpio);
+int rtc_gpio_get_level(gpio_num_t gpio);
+
+#endif // NATIVE_DRIVER_RTC_IO_H
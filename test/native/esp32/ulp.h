@@ -0,0 +1,87 @@
+//=====================================================================================================//
+// HOST SHIM: esp32/ulp.h
+// The ULP FSM macros of ESP-IDF, kept symbolic: each I_* / M_* macro records its opcode and
+// operands instead of the binary encoding, so the project's ULP program is built by its own code
+// and then run by the interpreter in native_ulp.cpp, which follows the FSM's documented
+// behaviour: 16-bit registers R0-R3, ALU instructions setting the zero flag, LD/ST on 32-bit
+// words of RTC slow memory (ST stores the value in the low half and the PC in the high half),
+// M_BXZ on the zero flag and M_BL on R0 < imm.
+//
+// ulp_process_macros_and_load() resolves the labels and checks the program against
+// CONFIG_ULP_COPROC_RESERVE_MEM like the real loader. native_hal.h runs it one period at a time.
+//=====================================================================================================//
+
+#ifndef NATIVE_ESP32_ULP_H
+#define NATIVE_ESP32_ULP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+#ifndef CONFIG_ULP_COPROC_RESERVE_MEM
+#define CONFIG_ULP_COPROC_RESERVE_MEM 512   // Arduino-ESP32 2.x sdkconfig
+#endif
+
+#define ESP_ERR_ULP_BASE                 0x1200
+#define ESP_ERR_ULP_SIZE_TOO_BIG         (ESP_ERR_ULP_BASE + 1)
+#define ESP_ERR_ULP_INVALID_LOAD_ADDR    (ESP_ERR_ULP_BASE + 2)
+#define ESP_ERR_ULP_DUPLICATE_LABEL      (ESP_ERR_ULP_BASE + 3)
+#define ESP_ERR_ULP_UNDEFINED_LABEL      (ESP_ERR_ULP_BASE + 4)
+#define ESP_ERR_ULP_BRANCH_OUT_OF_RANGE  (ESP_ERR_ULP_BASE + 5)
+
+#define NATIVE_RTC_SLOW_MEM_WORDS 2048
+extern uint32_t nativeRtcSlowMem[NATIVE_RTC_SLOW_MEM_WORDS];
+#define RTC_SLOW_MEM nativeRtcSlowMem
+
+#define R0 0
+#define R1 1
+#define R2 2
+#define R3 3
+
+enum NativeUlpOp : uint8_t {
+  ULP_OP_LABEL = 0,  // M_LABEL(a)
+  ULP_OP_MOVI,       // a = b
+  ULP_OP_MOVR,       // a = b
+  ULP_OP_LD,         // a = mem[b + c]
+  ULP_OP_ST,         // mem[b + c] = a
+  ULP_OP_ADDI,       // a = b + c
+  ULP_OP_SUBR,       // a = b - c
+  ULP_OP_ANDI,       // a = b & c
+  ULP_OP_ORI,        // a = b | c
+  ULP_OP_RSHR,       // a = b >> c
+  ULP_OP_RD_REG,     // R0 = reg a, bits b..c
+  ULP_OP_BXZ,        // to label a if zero
+  ULP_OP_BL,         // to label a if R0 < b
+  ULP_OP_WAKE,
+  ULP_OP_HALT
+};
+
+typedef struct {
+  uint8_t op;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+} ulp_insn_t;
+
+#define I_MOVI(rd, imm)            {ULP_OP_MOVI, (rd), (uint32_t)(imm), 0}
+#define I_MOVR(rd, rs)             {ULP_OP_MOVR, (rd), (rs), 0}
+#define I_LD(rd, rs, offset)       {ULP_OP_LD, (rd), (rs), (uint32_t)(offset)}
+#define I_ST(rs, rd, offset)       {ULP_OP_ST, (rs), (rd), (uint32_t)(offset)}
+#define I_ADDI(rd, rs, imm)        {ULP_OP_ADDI, (rd), (rs), (uint32_t)(imm)}
+#define I_SUBR(rd, rs1, rs2)       {ULP_OP_SUBR, (rd), (rs1), (rs2)}
+#define I_ANDI(rd, rs, imm)        {ULP_OP_ANDI, (rd), (rs), (uint32_t)(imm)}
+#define I_ORI(rd, rs, imm)         {ULP_OP_ORI, (rd), (rs), (uint32_t)(imm)}
+#define I_RSHR(rd, rs1, rs2)       {ULP_OP_RSHR, (rd), (rs1), (rs2)}
+#define I_RD_REG(reg, low, high)   {ULP_OP_RD_REG, (uint32_t)(reg), (uint32_t)(low), (uint32_t)(high)}
+#define I_WAKE()                   {ULP_OP_WAKE, 0, 0, 0}
+#define I_HALT()                   {ULP_OP_HALT, 0, 0, 0}
+#define M_LABEL(label)             {ULP_OP_LABEL, (label), 0, 0}
+#define M_BXZ(label)               {ULP_OP_BXZ, (label), 0, 0}
+#define M_BL(label, imm)           {ULP_OP_BL, (label), (uint32_t)(imm), 0}
+
+/* `size` is in instructions on the way in, as with ESP-IDF, and is updated to the words loaded */
+esp_err_t ulp_process_macros_and_load(uint32_t loadAddr, const ulp_insn_t *program, size_t *size);
+esp_err_t ulp_set_wakeup_period(size_t index, uint32_t periodUs);
+esp_err_t ulp_run(uint32_t entryPoint);
+
+#endif // NATIVE_ESP32_ULP_H
@@ -0,0 +1,11 @@
+// HOST SHIM: esp_sntp.h -- SNTP never runs on the host; the wall clock is the host's
+#ifndef NATIVE_ESP_SNTP_H
+#define NATIVE_ESP_SNTP_H
+
+#include <sys/time.h>
+
+typedef void (*sntp_sync_time_cb_t)(struct timeval *tv);
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+
+#endif // NATIVE_ESP_SNTP_H
@@ -0,0 +1,13 @@
+//=====================================================================================================//
+// HOST SHIM: esp_timer.h
+// esp_timer_get_time() on the same monotonic clock as micros(), from the start of the process.
+//=====================================================================================================//
+
+#ifndef NATIVE_ESP_TIMER_H
+#define NATIVE_ESP_TIMER_H
+
+#include <stdint.h>
+
+int64_t esp_timer_get_time();
+
+#endif // NATIVE_ESP_TIMER_H
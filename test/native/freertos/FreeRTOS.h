@@ -0,0 +1,85 @@
+//=====================================================================================================//
+// HOST SHIM: FreeRTOS
+// Tasks are std::threads, queues and semaphores a mutex and a condition variable, one tick is
+// one millisecond. Enough of the API for the project's tasks to run on the host with their real
+// blocking behaviour; priorities and core pinning are accepted and ignored. The task, queue and
+// semphr headers all include this one, as the project only uses the calls declared here.
+//=====================================================================================================//
+
+#ifndef NATIVE_FREERTOS_H
+#define NATIVE_FREERTOS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE          0
+#define pdTRUE           1
+#define pdPASS           pdTRUE
+#define pdFAIL           pdFALSE
+#define errQUEUE_FULL    0
+#define portMAX_DELAY    ((TickType_t)0xffffffffUL)
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define pdMS_TO_TICKS(ms)  ((TickType_t)(((TickType_t)(ms) * configTICK_RATE_HZ) / 1000))
+#define tskNO_AFFINITY     0x7fffffff
+
+typedef void (*TaskFunction_t)(void *);
+typedef struct NativeTask *TaskHandle_t;
+typedef struct NativeQueue *QueueHandle_t;
+typedef QueueHandle_t SemaphoreHandle_t;
+
+/* Tasks */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *created);
+void vTaskDelete(TaskHandle_t task);
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period);
+TickType_t xTaskGetTickCount();
+TaskHandle_t xTaskGetCurrentTaskHandle();
+TaskHandle_t xTaskGetHandle(const char *name);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+BaseType_t xPortGetCoreID();
+BaseType_t xTaskNotifyGive(TaskHandle_t task);
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait);
+
+/* Queues */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+void vQueueDelete(QueueHandle_t queue);
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t wait);
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item);
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait);
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait);
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue);
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue);
+#define xQueueSendToBack(q, item, wait) xQueueSend(q, item, wait)
+
+/* Semaphores: a queue of zero-size items. The mutex is not recursive and has no priority
+ * inheritance, neither of which the project relies on. */
+SemaphoreHandle_t xSemaphoreCreateBinary();
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial);
+SemaphoreHandle_t xSemaphoreCreateMutex();
+#define vSemaphoreDelete(s)        vQueueDelete(s)
+#define xSemaphoreTake(s, wait)    xQueueReceive(s, nullptr, wait)
+#define xSemaphoreGive(s)          xQueueSend(s, nullptr, 0)
+#define uxSemaphoreGetCount(s)     uxQueueMessagesWaiting(s)
+
+/* Critical sections: a spinlock, as on the ESP32 */
+typedef struct {
+  volatile int locked;
+} portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED {0}
+void vPortEnterCritical(portMUX_TYPE *mux);
+void vPortExitCritical(portMUX_TYPE *mux);
+#define portENTER_CRITICAL(mux)     vPortEnterCritical(mux)
+#define portEXIT_CRITICAL(mux)      vPortExitCritical(mux)
+#define portENTER_CRITICAL_ISR(mux) vPortEnterCritical(mux)
+#define portEXIT_CRITICAL_ISR(mux)  vPortExitCritical(mux)
+
+#endif // NATIVE_FREERTOS_H
@@ -0,0 +1,5 @@
+// HOST SHIM: everything is declared in FreeRTOS.h
+#ifndef NATIVE_FREERTOS_QUEUE_H
+#define NATIVE_FREERTOS_QUEUE_H
+#include "FreeRTOS.h"
+#endif
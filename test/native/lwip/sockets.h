@@ -0,0 +1,7 @@
+// HOST SHIM: lwip/sockets.h
+#ifndef NATIVE_LWIP_SOCKETS_H
+#define NATIVE_LWIP_SOCKETS_H
+
+#include <sys/socket.h>
+
+#endif // NATIVE_LWIP_SOCKETS_H
@@ -0,0 +1,69 @@
+//=====================================================================================================//
+// HOST SHIM: mqtt_client.h
+// An ESP-IDF MQTT client without a broker: esp_mqtt_client_enqueue() only records the message and
+// hands out the next message id. The test plays the broker and the client's task through
+// native_hal.h, delivering CONNECTED, PUBLISHED (PUBACK), DELETED, ... events to the registered
+// handler on whichever thread it calls from.
+//=====================================================================================================//
+
+#ifndef NATIVE_MQTT_CLIENT_H
+#define NATIVE_MQTT_CLIENT_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *arg, esp_event_base_t base, int32_t eventId, void *eventData);
+#define ESP_EVENT_ANY_ID -1
+
+typedef struct esp_mqtt_client *esp_mqtt_client_handle_t;
+
+typedef enum {
+  MQTT_EVENT_ANY = -1,
+  MQTT_EVENT_ERROR = 0,
+  MQTT_EVENT_CONNECTED,
+  MQTT_EVENT_DISCONNECTED,
+  MQTT_EVENT_SUBSCRIBED,
+  MQTT_EVENT_UNSUBSCRIBED,
+  MQTT_EVENT_PUBLISHED,
+  MQTT_EVENT_DATA,
+  MQTT_EVENT_BEFORE_CONNECT,
+  MQTT_EVENT_DELETED
+} esp_mqtt_event_id_t;
+
+typedef struct {
+  esp_mqtt_event_id_t event_id;
+  esp_mqtt_client_handle_t client;
+  int msg_id;
+} esp_mqtt_event_t;
+
+typedef esp_mqtt_event_t *esp_mqtt_event_handle_t;
+
+typedef struct {
+  const char *uri;
+  const char *client_id;
+  const char *username;
+  const char *password;
+  const char *lwt_topic;
+  const char *lwt_msg;
+  int lwt_qos;
+  int lwt_retain;
+  int lwt_msg_len;
+  int disable_clean_session;
+  int keepalive;
+  int task_prio;
+  int task_stack;
+  int buffer_size;
+  int out_buffer_size;
+  int network_timeout_ms;
+} esp_mqtt_client_config_t;
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config);
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t client, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *arg);
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t client);
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t client);
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t client, const char *topic, const char *data, int len, int qos,
+                            int retain, bool store);
+
+#endif // NATIVE_MQTT_CLIENT_H
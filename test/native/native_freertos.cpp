@@ -0,0 +1,210 @@
+#include <freertos/FreeRTOS.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <string.h>
+
+struct NativeTask {
+  std::string name;
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t notifyValue = 0;
+};
+
+struct NativeQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+/* Tasks are never freed: a handle stays valid for xTaskGetHandle() and notifications after exit */
+static std::mutex registryLock;
+static std::vector<NativeTask *> registry;
+static thread_local NativeTask *currentTask = nullptr;
+
+typedef std::chrono::steady_clock Clock;
+
+static Clock::time_point deadline(TickType_t wait) {
+  return Clock::now() + std::chrono::milliseconds(wait * portTICK_PERIOD_MS);
+}
+
+/* Waits on `cv` until `ready` or the timeout; portMAX_DELAY waits for good */
+template <typename Pred>
+static bool waitFor(std::condition_variable &cv, std::unique_lock<std::mutex> &lock, TickType_t wait, Pred ready) {
+  if (wait == portMAX_DELAY) {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_until(lock, deadline(wait), ready);
+}
+
+static NativeTask *registerTask(const char *name) {
+  NativeTask *task = new NativeTask;
+  task->name = name ? name : "";
+  std::lock_guard<std::mutex> guard(registryLock);
+  registry.push_back(task);
+  return task;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg,
+                                   UBaseType_t priority, TaskHandle_t *created, BaseType_t core) {
+  (void)stackDepth;
+  (void)priority;
+  (void)core;
+  NativeTask *task = registerTask(name);
+  if (created) *created = task;
+  std::thread([fn, arg, task]() {
+    currentTask = task;
+    fn(arg);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stackDepth, void *arg, UBaseType_t priority,
+                       TaskHandle_t *created) {
+  return xTaskCreatePinnedToCore(fn, name, stackDepth, arg, priority, created, tskNO_AFFINITY);
+}
+
+/* Only a task deleting itself is supported: its thread parks for the rest of the process */
+void vTaskDelete(TaskHandle_t task) {
+  if (task && task != xTaskGetCurrentTaskHandle()) return;
+  for (;;) std::this_thread::sleep_for(std::chrono::hours(1));
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+void vTaskDelayUntil(TickType_t *previousWake, TickType_t period) {
+  *previousWake += period;
+  TickType_t now = xTaskGetTickCount();
+  if ((int32_t)(*previousWake - now) > 0) vTaskDelay(*previousWake - now);
+}
+
+TickType_t xTaskGetTickCount() {
+  static const Clock::time_point start = Clock::now();
+  return (TickType_t)(std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count() /
+                      portTICK_PERIOD_MS);
+}
+
+/* The main thread (setup/loop, or the test runner) becomes a task the first time it asks */
+TaskHandle_t xTaskGetCurrentTaskHandle() {
+  if (!currentTask) currentTask = registerTask("main");
+  return currentTask;
+}
+
+TaskHandle_t xTaskGetHandle(const char *name) {
+  std::lock_guard<std::mutex> guard(registryLock);
+  for (NativeTask *task : registry) {
+    if (task->name == name) return task;
+  }
+  return nullptr;
+}
+
+/* Host stacks are not painted; report a comfortable margin */
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return task || currentTask ? 1024 : 0; }
+
+BaseType_t xPortGetCoreID() { return 1; }
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  if (!task) return pdFAIL;
+  std::lock_guard<std::mutex> guard(task->lock);
+  task->notifyValue++;
+  task->notified.notify_all();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clearOnExit, TickType_t wait) {
+  NativeTask *task = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(task->lock);
+  waitFor(task->notified, lock, wait, [task]() { return task->notifyValue != 0; });
+  uint32_t value = task->notifyValue;
+  if (value) task->notifyValue = clearOnExit ? 0 : value - 1;
+  return value;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  if (!length) return nullptr;
+  NativeQueue *queue = new NativeQueue;
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) { delete queue; }
+
+static BaseType_t queuePut(QueueHandle_t queue, const void *item, TickType_t wait, bool front, bool overwrite) {
+  std::unique_lock<std::mutex> lock(queue->lock);
+  if (overwrite) {
+    queue->items.clear();
+  } else if (!waitFor(queue->changed, lock, wait, [queue]() { return queue->items.size() < queue->length; })) {
+    return errQUEUE_FULL;
+  }
+  std::vector<uint8_t> copy(queue->itemSize);
+  if (item && queue->itemSize) memcpy(copy.data(), item, queue->itemSize);
+  if (front) queue->items.push_front(std::move(copy));
+  else queue->items.push_back(std::move(copy));
+  queue->changed.notify_all();
+  return pdPASS;
+}
+
+static BaseType_t queueGet(QueueHandle_t queue, void *item, TickType_t wait, bool remove) {
+  std::unique_lock<std::mutex> lock(queue->lock);
+  if (!waitFor(queue->changed, lock, wait, [queue]() { return !queue->items.empty(); })) return pdFALSE;
+  if (item && queue->itemSize) memcpy(item, queue->items.front().data(), queue->itemSize);
+  if (remove) {
+    queue->items.pop_front();
+    queue->changed.notify_all();
+  }
+  return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t wait) {
+  return queuePut(queue, item, wait, false, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void *item, TickType_t wait) {
+  return queuePut(queue, item, wait, true, false);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void *item) { return queuePut(queue, item, 0, false, true); }
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t wait) { return queueGet(queue, item, wait, true); }
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void *item, TickType_t wait) { return queueGet(queue, item, wait, false); }
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->length - queue->items.size();
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary() { return xQueueCreate(1, 0); }
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial) {
+  SemaphoreHandle_t sem = xQueueCreate(max, 0);
+  while (sem && initial--) xSemaphoreGive(sem);
+  return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+  SemaphoreHandle_t sem = xQueueCreate(1, 0);
+  if (sem) xSemaphoreGive(sem);
+  return sem;
+}
+
+void vPortEnterCritical(portMUX_TYPE *mux) {
+  while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) std::this_thread::yield();
+}
+
+void vPortExitCritical(portMUX_TYPE *mux) { __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE); }
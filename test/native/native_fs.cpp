@@ -0,0 +1,151 @@
+#include <FS.h>
+#include <LittleFS.h>
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "native_hal.h"
+
+fs::LittleFSFS LittleFS;
+
+static long writeBudget = -1;   // bytes left before writes come up short, -1 = unlimited
+
+void nativeFsFailWritesAfter(long bytes) { writeBudget = bytes; }
+
+/* One directory per process, removed at exit (files only, the project makes no directories) */
+const char *nativeFsRoot() {
+  static std::string root;
+  if (root.empty()) {
+    char dir[] = "/tmp/crystal-fs-XXXXXX";
+    if (!mkdtemp(dir)) abort();
+    root = dir;
+    atexit([]() {
+      LittleFS.format();
+      rmdir(root.c_str());
+    });
+  }
+  return root.c_str();
+}
+
+namespace fs {
+
+class FileImpl {
+public:
+  FileImpl(FILE *f, const std::string &path) : file(f), path(path) {}
+  ~FileImpl() {
+    if (file) fclose(file);
+  }
+
+  FILE *file;
+  std::string path;
+};
+
+size_t File::write(const uint8_t *buf, size_t size) {
+  if (!*this) return 0;
+  if (writeBudget >= 0 && (long)size > writeBudget) size = writeBudget;
+  size_t n = fwrite(buf, 1, size, _impl->file);
+  if (writeBudget >= 0) writeBudget -= n;
+  return n;
+}
+
+size_t File::read(uint8_t *buf, size_t size) { return *this ? fread(buf, 1, size, _impl->file) : 0; }
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) ? c : -1;
+}
+
+int File::peek() {
+  if (!*this) return -1;
+  int c = fgetc(_impl->file);
+  if (c != EOF) ungetc(c, _impl->file);
+  return c == EOF ? -1 : c;
+}
+
+int File::available() { return *this ? (int)(size() - position()) : 0; }
+
+void File::flush() {
+  if (*this) fflush(_impl->file);
+}
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+  if (!*this) return false;
+  int whence = mode == SeekCur ? SEEK_CUR : mode == SeekEnd ? SEEK_END : SEEK_SET;
+  return fseek(_impl->file, pos, whence) == 0;
+}
+
+size_t File::position() const { return *this ? ftell(_impl->file) : 0; }
+
+size_t File::size() const {
+  if (!*this) return 0;
+  fflush(_impl->file);
+  struct stat st;
+  return fstat(fileno(_impl->file), &st) == 0 ? st.st_size : 0;
+}
+
+void File::close() { _impl.reset(); }
+
+File::operator bool() const { return _impl && _impl->file; }
+
+const char *File::path() const { return _impl ? _impl->path.c_str() : nullptr; }
+
+std::string FS::hostPath(const char *path) const { return _mountPoint + (path[0] == '/' ? "" : "/") + path; }
+
+File FS::open(const char *path, const char *mode, bool create) {
+  (void)create;
+  if (_mountPoint.empty()) return File();
+  std::string host = hostPath(path);
+  struct stat st;
+  if (stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) return File();
+  FILE *f = fopen(host.c_str(), mode);
+  if (!f) return File();
+  return File(std::make_shared<FileImpl>(f, path));
+}
+
+bool FS::exists(const char *path) {
+  struct stat st;
+  return !_mountPoint.empty() && stat(hostPath(path).c_str(), &st) == 0;
+}
+
+bool FS::remove(const char *path) { return !_mountPoint.empty() && unlink(hostPath(path).c_str()) == 0; }
+
+bool FS::rename(const char *from, const char *to) {
+  return !_mountPoint.empty() && ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0;
+}
+
+bool FS::mkdir(const char *path) { return !_mountPoint.empty() && ::mkdir(hostPath(path).c_str(), 0755) == 0; }
+
+bool FS::rmdir(const char *path) { return !_mountPoint.empty() && ::rmdir(hostPath(path).c_str()) == 0; }
+
+bool LittleFSFS::begin(bool formatOnFail, const char *basePath, uint8_t maxOpenFiles, const char *partitionLabel) {
+  (void)formatOnFail, (void)basePath, (void)maxOpenFiles, (void)partitionLabel;
+  _mountPoint = nativeFsRoot();
+  return true;
+}
+
+bool LittleFSFS::format() {
+  DIR *dir = opendir(nativeFsRoot());
+  if (!dir) return false;
+  while (struct dirent *e = readdir(dir)) {
+    if (e->d_name[0] != '.') unlink((std::string(nativeFsRoot()) + "/" + e->d_name).c_str());
+  }
+  closedir(dir);
+  return true;
+}
+
+size_t LittleFSFS::usedBytes() {
+  size_t used = 0;
+  DIR *dir = opendir(nativeFsRoot());
+  if (!dir) return 0;
+  while (struct dirent *e = readdir(dir)) {
+    struct stat st;
+    if (stat((std::string(nativeFsRoot()) + "/" + e->d_name).c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+      used += st.st_size;
+    }
+  }
+  closedir(dir);
+  return used;
+}
+
+} // namespace fs
@@ -0,0 +1,132 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <Wire.h>
+#include <esp_sleep.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+#include <chrono>
+#include <thread>
+#include "native_hal.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+SPIClass SPI;
+TwoWire Wire;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static volatile uint8_t pinLevels[NATIVE_GPIO_COUNT];
+static uint8_t pinModes[NATIVE_GPIO_COUNT];
+static NativeHeap heap = {327680, 262144, 245760, 114676};
+static bool serialEcho = true;
+static esp_sleep_source_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+static NativeSleep armed = {0, 0, -1, 0, false};
+static NativeSleep slept = armed;
+
+int64_t esp_timer_get_time() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long millis() { return (unsigned long)(esp_timer_get_time() / 1000); }
+unsigned long micros() { return (unsigned long)esp_timer_get_time(); }
+void delay(uint32_t ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+void delayMicroseconds(uint32_t us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+void yield() { std::this_thread::yield(); }
+
+long random(long howbig) { return howbig > 0 ? random() % howbig : 0; }
+long random(long howsmall, long howbig) { return howsmall < howbig ? howsmall + random(howbig - howsmall) : howsmall; }
+void randomSeed(unsigned long seed) { srandom(seed); }
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    yield();
+  } while (millis() - start < _timeout);
+  return -1;
+}
+
+void configTime(long gmtOffsetS, int daylightOffsetS, const char *server1, const char *server2, const char *server3) {
+  (void)gmtOffsetS;
+  (void)daylightOffsetS;
+  (void)server1;
+  (void)server2;
+  (void)server3;
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) { (void)callback; }
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin >= NATIVE_GPIO_COUNT) return;
+  pinModes[pin] = mode;
+  if (mode == INPUT_PULLUP) pinLevels[pin] = HIGH;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < NATIVE_GPIO_COUNT) pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) { return pin < NATIVE_GPIO_COUNT ? pinLevels[pin] : LOW; }
+
+/* Nothing raises GPIO interrupts on the host; tests call the handlers directly */
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+  (void)pin;
+  (void)isr;
+  (void)mode;
+}
+
+void detachInterrupt(uint8_t pin) { (void)pin; }
+
+void nativeSetPin(uint8_t pin, uint8_t level) {
+  if (pin < NATIVE_GPIO_COUNT) pinLevels[pin] = level ? HIGH : LOW;
+}
+
+uint8_t nativePinMode(uint8_t pin) { return pin < NATIVE_GPIO_COUNT ? pinModes[pin] : 0; }
+
+size_t HardwareSerial::write(uint8_t c) { return write(&c, 1); }
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  if (serialEcho) fwrite(buffer, 1, size, stdout);
+  return size;
+}
+
+void HardwareSerial::flush() { fflush(stdout); }
+
+void nativeSerialEcho(bool on) { serialEcho = on; }
+
+void nativeSetHeap(const NativeHeap &h) { heap = h; }
+
+static bool internal(uint32_t caps) { return !(caps & (MALLOC_CAP_SPIRAM | MALLOC_CAP_EXEC)); }
+
+size_t heap_caps_get_total_size(uint32_t caps) { return internal(caps) ? heap.total : 0; }
+size_t heap_caps_get_free_size(uint32_t caps) { return internal(caps) ? heap.free : 0; }
+size_t heap_caps_get_minimum_free_size(uint32_t caps) { return internal(caps) ? heap.minFree : 0; }
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return internal(caps) ? heap.largest : 0; }
+
+void nativeSetWakeCause(esp_sleep_source_t cause) { wakeCause = cause; }
+const NativeSleep &nativeSleep() { return slept; }
+
+esp_sleep_source_t esp_sleep_get_wakeup_cause() { return wakeCause; }
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  armed.timerUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ext0_wakeup(gpio_num_t pin, int level) {
+  armed.ext0Pin = pin;
+  armed.ext0Level = level;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_ulp_wakeup() {
+  armed.ulp = true;
+  return ESP_OK;
+}
+
+/* Waking is a reboot on the chip, so nothing stays armed for the sleep after */
+void esp_deep_sleep_start() {
+  armed.sleeps = slept.sleeps + 1;
+  slept = armed;
+  armed = NativeSleep{0, 0, -1, 0, false};
+}
@@ -0,0 +1,86 @@
+//=====================================================================================================//
+// HOST SHIM: test hooks
+// What the unit tests drive from outside: GPIO input levels, the simulated heap, whether Serial
+// output is shown (benchmarks print their figures, the rest is noise under the runner) and
+// LittleFS running out of space, the deep sleep wake cause, the ULP, the HTTP server's port, the
+// MQTT broker and an SMTP server.
+//=====================================================================================================//
+
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "esp_sleep.h"
+
+/* Level seen by digitalRead() on an input pin; digitalWrite() on an output pin sets it too */
+void nativeSetPin(uint8_t pin, uint8_t level);
+uint8_t nativePinMode(uint8_t pin);
+
+struct NativeHeap {
+  size_t total;
+  size_t free;
+  size_t minFree;
+  size_t largest;        // largest free block
+};
+
+/* Figures returned by heap_caps_* for internal RAM, and by ESP.getFreeHeap() and friends */
+void nativeSetHeap(const NativeHeap &heap);
+
+void nativeSerialEcho(bool on);
+
+/* LittleFS lives in a temporary directory; writes past `bytes` more come up short (-1 = never) */
+const char *nativeFsRoot();
+void nativeFsFailWritesAfter(long bytes);
+
+/* What the last wake reported, and what was armed before the last esp_deep_sleep_start() */
+struct NativeSleep {
+  uint32_t sleeps;
+  uint64_t timerUs;      // 0 when the timer was not armed
+  int      ext0Pin;      // -1 when ext0 was not armed
+  int      ext0Level;
+  bool     ulp;
+};
+
+void nativeSetWakeCause(esp_sleep_source_t cause);
+const NativeSleep &nativeSleep();
+
+/* One ULP timer period of the loaded program (esp32/ulp.h): 1 when it executed I_WAKE, 0 when it
+ * halted without, -1 when it is not running or did not reach I_HALT */
+int nativeUlpRun();
+size_t nativeUlpProgramWords();
+void nativeUlpReadyForWakeup(bool ready);
+
+/* Port the last httpd_start() listens on (127.0.0.1) */
+uint16_t nativeHttpdPort();
+
+/* What the MQTT client was asked to publish, in order; message ids count from 1 */
+struct NativeMqttMessage {
+  int msgId;
+  std::string topic;
+  std::string payload;
+  int qos;
+  bool retain;
+};
+
+size_t nativeMqttQueued();
+NativeMqttMessage nativeMqttMessage(size_t index);
+
+/* Runs the registered handler for an mqtt_client.h event, as the client's task would */
+void nativeMqttEvent(int eventId, int msgId = 0);
+
+/* SMTP server on 127.0.0.1, started by the first call, one session at a time: any login is accepted
+ * and every message, sent with DATA or BDAT, is kept in order */
+struct NativeSmtpMail {
+  std::string from;
+  std::vector<std::string> to;
+  std::string data;      // headers and body as sent, dot-stuffing undone
+};
+
+uint16_t nativeSmtpPort();
+size_t nativeSmtpReceived();
+NativeSmtpMail nativeSmtpMail(size_t index);
+
+#endif // NATIVE_HAL_H
@@ -0,0 +1,373 @@
+#include <esp_http_server.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <functional>
+#include <mutex>
+#include <netinet/in.h>
+#include <string.h>
+#include <string>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "native_hal.h"
+
+#define HTTPD_REQ_MAX 2048   // request line and headers
+
+struct NativeSession {
+  int fd;
+  uint32_t lastUse;   // LRU purge order
+  std::string in;     // received, not yet handled
+};
+
+struct NativeHttpd {
+  httpd_config_t config;
+  int listenFd = -1;
+  int wake[2] = {-1, -1};   // control pipe: httpd_queue_work() and httpd_stop() write a byte
+  std::thread task;
+  std::vector<httpd_uri_t> routes;
+  std::vector<NativeSession> sessions;
+  std::mutex workLock;
+  std::vector<std::function<void()>> work;
+  bool stopping = false;
+  uint32_t uses = 0;
+};
+
+/* httpd_req_t::aux */
+struct NativeResponse {
+  int fd;
+  std::string query;
+  std::string status = "200 OK";
+  std::string type = "text/html";
+  std::string headers;
+  bool chunked = false;   // headers went out with the first chunk
+};
+
+static uint16_t lastPort;
+
+uint16_t nativeHttpdPort() { return lastPort; }
+
+static bool sendAll(int fd, const char *data, size_t len) {
+  while (len) {
+    ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) return false;
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+static void closeSession(NativeHttpd *server, int fd) {
+  for (size_t i = 0; i < server->sessions.size(); i++) {
+    if (server->sessions[i].fd != fd) continue;
+    server->sessions.erase(server->sessions.begin() + i);
+    if (server->config.close_fn) server->config.close_fn(server, fd);
+    else close(fd);
+    return;
+  }
+}
+
+static const httpd_uri_t *findRoute(NativeHttpd *server, const std::string &path, int method) {
+  for (const httpd_uri_t &route : server->routes) {
+    if (path == route.uri && method == route.method) return &route;
+  }
+  return nullptr;
+}
+
+/* One request from the head of the session's buffer. Returns false when the session must close. */
+static bool handleRequest(NativeHttpd *server, int fd, const std::string &head) {
+  size_t sp1 = head.find(' ');
+  size_t sp2 = head.find(' ', sp1 + 1);
+  if (sp1 == std::string::npos || sp2 == std::string::npos) return false;
+  std::string method = head.substr(0, sp1);
+  std::string target = head.substr(sp1 + 1, sp2 - sp1 - 1);
+
+  httpd_req_t req = {};
+  NativeResponse resp;
+  resp.fd = fd;
+  req.handle = server;
+  req.method = method == "GET" ? HTTP_GET : method == "POST" ? HTTP_POST : method == "HEAD" ? HTTP_HEAD : -1;
+  req.aux = &resp;
+  if (target.size() > HTTPD_MAX_URI_LEN) {
+    httpd_resp_send_err(&req, HTTPD_414_URI_TOO_LONG, nullptr);
+    return false;
+  }
+  strcpy((char *)req.uri, target.c_str());
+
+  size_t q = target.find('?');
+  std::string path = target.substr(0, q);
+  if (q != std::string::npos) resp.query = target.substr(q + 1);
+
+  const httpd_uri_t *route = findRoute(server, path, req.method);
+  if (!route) {
+    httpd_resp_send_err(&req, HTTPD_404_NOT_FOUND, "Nothing matches the given URI");
+    return true;
+  }
+  req.user_ctx = route->user_ctx;
+  return route->handler(&req) == ESP_OK;
+}
+
+static void serve(NativeHttpd *server, NativeSession &session) {
+  char buf[512];
+  ssize_t n = recv(session.fd, buf, sizeof(buf), 0);
+  if (n <= 0) {
+    closeSession(server, session.fd);
+    return;
+  }
+  session.in.append(buf, n);
+  session.lastUse = ++server->uses;
+
+  /* Requests are GETs without a body */
+  int fd = session.fd;
+  for (;;) {
+    NativeSession *s = nullptr;
+    for (NativeSession &open : server->sessions) {
+      if (open.fd == fd) s = &open;
+    }
+    if (!s) return;   // a handler closed it
+    size_t end = s->in.find("\r\n\r\n");
+    if (end == std::string::npos) {
+      if (s->in.size() > HTTPD_REQ_MAX) closeSession(server, fd);
+      return;
+    }
+    std::string head = s->in.substr(0, end);
+    s->in.erase(0, end + 4);
+    if (!handleRequest(server, fd, head)) {
+      closeSession(server, fd);
+      return;
+    }
+  }
+}
+
+static void accepted(NativeHttpd *server, int fd) {
+  if (server->sessions.size() >= server->config.max_open_sockets) {
+    if (!server->config.lru_purge_enable) {
+      close(fd);
+      return;
+    }
+    size_t lru = 0;
+    for (size_t i = 1; i < server->sessions.size(); i++) {
+      if (server->sessions[i].lastUse < server->sessions[lru].lastUse) lru = i;
+    }
+    closeSession(server, server->sessions[lru].fd);
+  }
+  struct timeval timeout = {server->config.send_wait_timeout, 0};
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  server->sessions.push_back({fd, ++server->uses, std::string()});
+}
+
+static void run(NativeHttpd *server) {
+  for (;;) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(server->listenFd, &readable);
+    FD_SET(server->wake[0], &readable);
+    int maxFd = server->listenFd > server->wake[0] ? server->listenFd : server->wake[0];
+    for (const NativeSession &s : server->sessions) {
+      FD_SET(s.fd, &readable);
+      if (s.fd > maxFd) maxFd = s.fd;
+    }
+    if (select(maxFd + 1, &readable, nullptr, nullptr, nullptr) < 0) {
+      if (errno == EINTR) continue;
+      return;
+    }
+
+    if (FD_ISSET(server->wake[0], &readable)) {
+      char drain[64];
+      while (read(server->wake[0], drain, sizeof(drain)) > 0) {}
+      std::vector<std::function<void()>> work;
+      {
+        std::lock_guard<std::mutex> guard(server->workLock);
+        work.swap(server->work);
+        if (server->stopping) return;
+      }
+      for (std::function<void()> &fn : work) fn();
+    }
+
+    std::vector<int> ready;
+    for (const NativeSession &s : server->sessions) {
+      if (FD_ISSET(s.fd, &readable)) ready.push_back(s.fd);
+    }
+    for (int fd : ready) {
+      for (NativeSession &s : server->sessions) {
+        if (s.fd == fd) {
+          serve(server, s);
+          break;
+        }
+      }
+    }
+
+    if (FD_ISSET(server->listenFd, &readable)) {
+      int fd = accept(server->listenFd, nullptr, nullptr);
+      if (fd >= 0) accepted(server, fd);
+    }
+  }
+}
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config) {
+  NativeHttpd *server = new NativeHttpd;
+  server->config = *config;
+  server->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  int on = 1;
+  setsockopt(server->listenFd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = htons(config->server_port);
+  socklen_t addrLen = sizeof(addr);
+  if (server->listenFd < 0 || bind(server->listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+      listen(server->listenFd, config->backlog_conn) != 0 || pipe(server->wake) != 0 ||
+      getsockname(server->listenFd, (struct sockaddr *)&addr, &addrLen) != 0) {
+    if (server->listenFd >= 0) close(server->listenFd);
+    delete server;
+    return ESP_ERR_HTTPD_TASK;
+  }
+  fcntl(server->wake[0], F_SETFL, O_NONBLOCK);
+  lastPort = ntohs(addr.sin_port);
+  server->task = std::thread(run, server);
+  *handle = server;
+  return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle) {
+  NativeHttpd *server = static_cast<NativeHttpd *>(handle);
+  if (!server) return ESP_ERR_INVALID_ARG;
+  {
+    std::lock_guard<std::mutex> guard(server->workLock);
+    server->stopping = true;
+  }
+  (void)!write(server->wake[1], "s", 1);
+  server->task.join();
+  while (!server->sessions.empty()) closeSession(server, server->sessions.front().fd);
+  close(server->listenFd);
+  close(server->wake[0]);
+  close(server->wake[1]);
+  if (server->config.global_user_ctx_free_fn) server->config.global_user_ctx_free_fn(server->config.global_user_ctx);
+  delete server;
+  return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler) {
+  NativeHttpd *server = static_cast<NativeHttpd *>(handle);
+  if (!server || !uri_handler) return ESP_ERR_INVALID_ARG;
+  if (findRoute(server, uri_handler->uri, uri_handler->method)) return ESP_ERR_HTTPD_HANDLER_EXISTS;
+  if (server->routes.size() >= server->config.max_uri_handlers) return ESP_ERR_HTTPD_HANDLERS_FULL;
+  server->routes.push_back(*uri_handler);
+  return ESP_OK;
+}
+
+void *httpd_get_global_user_ctx(httpd_handle_t handle) {
+  return handle ? static_cast<NativeHttpd *>(handle)->config.global_user_ctx : nullptr;
+}
+
+static esp_err_t queue(NativeHttpd *server, std::function<void()> fn) {
+  if (!server) return ESP_ERR_INVALID_ARG;
+  {
+    std::lock_guard<std::mutex> guard(server->workLock);
+    server->work.push_back(fn);
+  }
+  return write(server->wake[1], "w", 1) == 1 ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t httpd_queue_work(httpd_handle_t handle, httpd_work_fn_t work, void *arg) {
+  return queue(static_cast<NativeHttpd *>(handle), [work, arg]() { work(arg); });
+}
+
+esp_err_t httpd_sess_trigger_close(httpd_handle_t handle, int sockfd) {
+  NativeHttpd *server = static_cast<NativeHttpd *>(handle);
+  return queue(server, [server, sockfd]() { closeSession(server, sockfd); });
+}
+
+int httpd_socket_send(httpd_handle_t hd, int sockfd, const char *buf, size_t buf_len, int flags) {
+  (void)hd;
+  ssize_t n = send(sockfd, buf, buf_len, flags | MSG_NOSIGNAL);
+  if (n >= 0) return (int)n;
+  return (errno == EAGAIN || errno == EWOULDBLOCK) ? HTTPD_SOCK_ERR_TIMEOUT : HTTPD_SOCK_ERR_FAIL;
+}
+
+int httpd_req_to_sockfd(httpd_req_t *r) { return r ? static_cast<NativeResponse *>(r->aux)->fd : -1; }
+
+static esp_err_t copyOut(const std::string &value, char *buf, size_t len) {
+  if (!len) return ESP_ERR_HTTPD_RESULT_TRUNC;
+  size_t n = value.size() < len - 1 ? value.size() : len - 1;
+  memcpy(buf, value.data(), n);
+  buf[n] = '\0';
+  return n < value.size() ? ESP_ERR_HTTPD_RESULT_TRUNC : ESP_OK;
+}
+
+esp_err_t httpd_req_get_url_query_str(httpd_req_t *r, char *buf, size_t buf_len) {
+  NativeResponse *resp = static_cast<NativeResponse *>(r->aux);
+  if (resp->query.empty()) return ESP_ERR_NOT_FOUND;
+  return copyOut(resp->query, buf, buf_len);
+}
+
+esp_err_t httpd_query_key_value(const char *qry, const char *key, char *val, size_t val_size) {
+  std::string query = qry;
+  size_t start = 0;
+  while (start <= query.size()) {
+    size_t amp = query.find('&', start);
+    if (amp == std::string::npos) amp = query.size();
+    std::string pair = query.substr(start, amp - start);
+    size_t eq = pair.find('=');
+    if (pair.substr(0, eq) == key) return copyOut(eq == std::string::npos ? "" : pair.substr(eq + 1), val, val_size);
+    start = amp + 1;
+  }
+  return ESP_ERR_NOT_FOUND;
+}
+
+esp_err_t httpd_resp_set_status(httpd_req_t *r, const char *status) {
+  static_cast<NativeResponse *>(r->aux)->status = status;
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type) {
+  static_cast<NativeResponse *>(r->aux)->type = type;
+  return ESP_OK;
+}
+
+esp_err_t httpd_resp_set_hdr(httpd_req_t *r, const char *field, const char *value) {
+  NativeResponse *resp = static_cast<NativeResponse *>(r->aux);
+  resp->headers.append(field).append(": ").append(value).append("\r\n");
+  return ESP_OK;
+}
+
+static std::string statusHeaders(const NativeResponse *resp) {
+  return "HTTP/1.1 " + resp->status + "\r\nContent-Type: " + resp->type + "\r\n" + resp->headers;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+  NativeResponse *resp = static_cast<NativeResponse *>(r->aux);
+  if (buf_len == HTTPD_RESP_USE_STRLEN) buf_len = buf ? strlen(buf) : 0;
+  std::string out = statusHeaders(resp) + "Content-Length: " + std::to_string(buf_len) + "\r\n\r\n";
+  if (buf) out.append(buf, buf_len);
+  return sendAll(resp->fd, out.data(), out.size()) ? ESP_OK : ESP_ERR_HTTPD_RESP_SEND;
+}
+
+esp_err_t httpd_resp_send_chunk(httpd_req_t *r, const char *buf, ssize_t buf_len) {
+  NativeResponse *resp = static_cast<NativeResponse *>(r->aux);
+  if (buf_len == HTTPD_RESP_USE_STRLEN) buf_len = buf ? strlen(buf) : 0;
+  std::string out;
+  if (!resp->chunked) {
+    out = statusHeaders(resp) + "Transfer-Encoding: chunked\r\n\r\n";
+    resp->chunked = true;
+  }
+  char size[16];
+  snprintf(size, sizeof(size), "%x\r\n", (unsigned)buf_len);
+  out.append(size);
+  if (buf) out.append(buf, buf_len);
+  out.append("\r\n");
+  return sendAll(resp->fd, out.data(), out.size()) ? ESP_OK : ESP_ERR_HTTPD_RESP_SEND;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg) {
+  static const char *const statuses[] = {
+      "500 Internal Server Error", "501 Method Not Implemented", "505 Version Not Supported", "400 Bad Request",
+      "401 Unauthorized", "403 Forbidden", "404 Not Found", "405 Method Not Allowed", "408 Request Timeout",
+      "411 Length Required", "414 URI Too Long", "431 Request Header Fields Too Large"};
+  httpd_resp_set_status(req, statuses[error]);
+  httpd_resp_set_type(req, "text/html");
+  return httpd_resp_sendstr(req, msg ? msg : statuses[error]);
+}
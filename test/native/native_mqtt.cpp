@@ -0,0 +1,64 @@
+#include <mqtt_client.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "native_hal.h"
+
+struct esp_mqtt_client {
+  esp_event_handler_t handler;
+  void *arg;
+};
+
+static esp_mqtt_client client;
+static std::mutex lock;
+static std::vector<NativeMqttMessage> outbox;
+
+esp_mqtt_client_handle_t esp_mqtt_client_init(const esp_mqtt_client_config_t *config) {
+  (void)config;
+  client = {};
+  return &client;
+}
+
+esp_err_t esp_mqtt_client_register_event(esp_mqtt_client_handle_t c, esp_mqtt_event_id_t event,
+                                         esp_event_handler_t handler, void *arg) {
+  (void)event;
+  c->handler = handler;
+  c->arg = arg;
+  return ESP_OK;
+}
+
+esp_err_t esp_mqtt_client_start(esp_mqtt_client_handle_t c) { return c ? ESP_OK : ESP_FAIL; }
+esp_err_t esp_mqtt_client_destroy(esp_mqtt_client_handle_t c) { return c ? ESP_OK : ESP_FAIL; }
+
+int esp_mqtt_client_enqueue(esp_mqtt_client_handle_t c, const char *topic, const char *data, int len, int qos,
+                            int retain, bool store) {
+  (void)c;
+  (void)store;
+  std::lock_guard<std::mutex> guard(lock);
+  NativeMqttMessage m;
+  m.msgId = (int)outbox.size() + 1;
+  m.topic = topic;
+  m.payload = std::string(data, len);
+  m.qos = qos;
+  m.retain = retain != 0;
+  outbox.push_back(m);
+  return m.msgId;
+}
+
+size_t nativeMqttQueued() {
+  std::lock_guard<std::mutex> guard(lock);
+  return outbox.size();
+}
+
+NativeMqttMessage nativeMqttMessage(size_t index) {
+  std::lock_guard<std::mutex> guard(lock);
+  return outbox.at(index);
+}
+
+void nativeMqttEvent(int eventId, int msgId) {
+  esp_mqtt_event_t event = {};
+  event.event_id = (esp_mqtt_event_id_t)eventId;
+  event.client = &client;
+  event.msg_id = msgId;
+  if (client.handler) client.handler(client.arg, "MQTT_EVENTS", eventId, &event);
+}
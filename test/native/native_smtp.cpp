@@ -0,0 +1,155 @@
+#include <arpa/inet.h>
+#include <mutex>
+#include <netinet/in.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "native_hal.h"
+
+static std::mutex lock;
+static std::vector<NativeSmtpMail> inbox;
+static uint16_t port;
+
+/* One client connection: reads lines and raw BDAT chunks from `in` */
+class SmtpConn {
+public:
+  explicit SmtpConn(int fd) : _fd(fd) {}
+
+  bool line(std::string &out) {
+    for (;;) {
+      size_t end = _in.find("\r\n");
+      if (end != std::string::npos) {
+        out = _in.substr(0, end);
+        _in.erase(0, end + 2);
+        return true;
+      }
+      if (!fill()) return false;
+    }
+  }
+
+  bool bytes(size_t n, std::string &out) {
+    while (_in.size() < n) {
+      if (!fill()) return false;
+    }
+    out.append(_in, 0, n);
+    _in.erase(0, n);
+    return true;
+  }
+
+  void reply(const char *text) { send(_fd, text, strlen(text), MSG_NOSIGNAL); }
+
+private:
+  bool fill() {
+    char buf[1024];
+    ssize_t n = recv(_fd, buf, sizeof(buf), 0);
+    if (n <= 0) return false;
+    _in.append(buf, n);
+    return true;
+  }
+
+  int _fd;
+  std::string _in;
+};
+
+/* SMTP verbs are case-insensitive */
+static bool startsWith(const std::string &s, const char *prefix) {
+  return strncasecmp(s.c_str(), prefix, strlen(prefix)) == 0;
+}
+
+static void session(int fd) {
+  SmtpConn conn(fd);
+  NativeSmtpMail mail;
+  std::string cmd;
+  conn.reply("220 localhost ESMTP\r\n");
+  while (conn.line(cmd)) {
+    if (startsWith(cmd, "EHLO") || startsWith(cmd, "HELO")) {
+      conn.reply("250-localhost\r\n250-AUTH PLAIN LOGIN\r\n250-8BITMIME\r\n250-CHUNKING\r\n250 SMTPUTF8\r\n");
+    } else if (startsWith(cmd, "AUTH LOGIN")) {
+      std::string user, pass;
+      conn.reply("334 VXNlcm5hbWU6\r\n");
+      if (!conn.line(user)) break;
+      conn.reply("334 UGFzc3dvcmQ6\r\n");
+      if (!conn.line(pass)) break;
+      conn.reply("235 2.7.0 Accepted\r\n");
+    } else if (startsWith(cmd, "AUTH PLAIN")) {
+      std::string credentials;
+      if (cmd.size() <= 11) {
+        conn.reply("334 \r\n");
+        if (!conn.line(credentials)) break;
+      }
+      conn.reply("235 2.7.0 Accepted\r\n");
+    } else if (startsWith(cmd, "MAIL FROM:")) {
+      mail = NativeSmtpMail();
+      mail.from = cmd.substr(10);
+      conn.reply("250 2.1.0 OK\r\n");
+    } else if (startsWith(cmd, "RCPT TO:")) {
+      mail.to.push_back(cmd.substr(8));
+      conn.reply("250 2.1.5 OK\r\n");
+    } else if (startsWith(cmd, "DATA")) {
+      conn.reply("354 Go ahead\r\n");
+      std::string text;
+      while (conn.line(text) && text != ".") mail.data += (text[0] == '.' ? text.substr(1) : text) + "\r\n";
+      {
+        std::lock_guard<std::mutex> guard(lock);
+        inbox.push_back(mail);
+      }
+      conn.reply("250 2.0.0 OK queued\r\n");
+    } else if (startsWith(cmd, "BDAT ")) {
+      size_t n = strtoul(cmd.c_str() + 5, nullptr, 10);
+      if (!conn.bytes(n, mail.data)) break;
+      if (cmd.find("LAST") != std::string::npos) {
+        std::lock_guard<std::mutex> guard(lock);
+        inbox.push_back(mail);
+      }
+      conn.reply("250 2.0.0 OK\r\n");
+    } else if (startsWith(cmd, "QUIT")) {
+      conn.reply("221 2.0.0 Bye\r\n");
+      break;
+    } else {
+      conn.reply("250 OK\r\n");   // RSET, NOOP
+    }
+  }
+  close(fd);
+}
+
+static void run(int listenFd) {
+  for (;;) {
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd < 0) return;
+    session(fd);
+  }
+}
+
+uint16_t nativeSmtpPort() {
+  std::lock_guard<std::mutex> guard(lock);
+  if (port) return port;
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  int on = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  struct sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addrLen = sizeof(addr);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(fd, 4) != 0 ||
+      getsockname(fd, (struct sockaddr *)&addr, &addrLen) != 0) {
+    close(fd);
+    return 0;
+  }
+  port = ntohs(addr.sin_port);
+  std::thread(run, fd).detach();
+  return port;
+}
+
+size_t nativeSmtpReceived() {
+  std::lock_guard<std::mutex> guard(lock);
+  return inbox.size();
+}
+
+NativeSmtpMail nativeSmtpMail(size_t index) {
+  std::lock_guard<std::mutex> guard(lock);
+  return inbox.at(index);
+}
@@ -0,0 +1,135 @@
+#include <Arduino.h>
+#include <driver/rtc_io.h>
+#include <esp32/ulp.h>
+#include <soc/rtc_cntl_reg.h>
+#include <soc/rtc_io_reg.h>
+#include <vector>
+#include "native_hal.h"
+
+#define ULP_MAX_STEPS 4096   // a program that runs longer than this is stuck in a loop
+
+uint32_t nativeRtcSlowMem[NATIVE_RTC_SLOW_MEM_WORDS];
+
+/* GPIO number to RTC IO number, ESP32 */
+static const int8_t rtcIoOfGpio[40] = {
+    11, -1, 12, -1, 10, -1, -1, -1, -1, -1, -1, -1, 15, 14, 16, 13, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, 6,  7,  17, -1, -1, -1, -1, 9,  8,  4,  5,  0,  1,  2,  3};
+
+static std::vector<ulp_insn_t> loaded;    // labels resolved: a branch's `a` is an index into this
+static uint32_t loadAddr;
+static bool started;
+static bool readyForWakeup = true;
+
+int rtc_io_number_get(gpio_num_t gpio) { return gpio >= 0 && gpio < 40 ? rtcIoOfGpio[gpio] : -1; }
+esp_err_t rtc_gpio_init(gpio_num_t gpio) { return rtc_io_number_get(gpio) < 0 ? ESP_ERR_INVALID_ARG : ESP_OK; }
+
+esp_err_t rtc_gpio_set_direction(gpio_num_t gpio, rtc_gpio_mode_t mode) {
+  (void)mode;
+  return rtc_gpio_init(gpio);
+}
+
+esp_err_t rtc_gpio_pullup_en(gpio_num_t gpio) { return rtc_gpio_init(gpio); }
+esp_err_t rtc_gpio_pulldown_dis(gpio_num_t gpio) { return rtc_gpio_init(gpio); }
+int rtc_gpio_get_level(gpio_num_t gpio) { return digitalRead(gpio); }
+
+esp_err_t ulp_process_macros_and_load(uint32_t addr, const ulp_insn_t *program, size_t *size) {
+  std::vector<ulp_insn_t> code;
+  std::vector<int> labels;
+  for (size_t i = 0; i < *size; i++) {
+    if (program[i].op != ULP_OP_LABEL) {
+      code.push_back(program[i]);
+      continue;
+    }
+    if (program[i].a >= labels.size()) labels.resize(program[i].a + 1, -1);
+    if (labels[program[i].a] >= 0) return ESP_ERR_ULP_DUPLICATE_LABEL;
+    labels[program[i].a] = code.size();
+  }
+  if ((addr + code.size()) * sizeof(uint32_t) > CONFIG_ULP_COPROC_RESERVE_MEM) return ESP_ERR_ULP_SIZE_TOO_BIG;
+
+  for (size_t pc = 0; pc < code.size(); pc++) {
+    ulp_insn_t &insn = code[pc];
+    if (insn.op != ULP_OP_BXZ && insn.op != ULP_OP_BL) continue;
+    if (insn.a >= labels.size() || labels[insn.a] < 0) return ESP_ERR_ULP_UNDEFINED_LABEL;
+    int offset = labels[insn.a] - (int)pc;
+    if (offset < -127 || offset > 127) return ESP_ERR_ULP_BRANCH_OUT_OF_RANGE;
+    insn.a = labels[insn.a];
+  }
+
+  loaded = code;
+  loadAddr = addr;
+  *size = code.size();
+  return ESP_OK;
+}
+
+esp_err_t ulp_set_wakeup_period(size_t index, uint32_t periodUs) {
+  (void)periodUs;
+  return index < 5 ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t ulp_run(uint32_t entryPoint) {
+  if (loaded.empty() || entryPoint != loadAddr) return ESP_ERR_INVALID_ARG;
+  started = true;
+  return ESP_OK;
+}
+
+size_t nativeUlpProgramWords() { return loaded.size(); }
+void nativeUlpReadyForWakeup(bool ready) { readyForWakeup = ready; }
+
+static uint32_t readReg(uint32_t reg) {
+  uint32_t value = 0;
+  if (reg == RTC_GPIO_IN_REG) {
+    for (uint8_t gpio = 0; gpio < 40; gpio++) {
+      if (rtcIoOfGpio[gpio] >= 0 && digitalRead(gpio)) value |= 1UL << (RTC_GPIO_IN_NEXT_S + rtcIoOfGpio[gpio]);
+    }
+  } else if (reg == RTC_CNTL_LOW_POWER_ST_REG) {
+    if (readyForWakeup) value |= 1UL << RTC_CNTL_RDY_FOR_WAKEUP_S;
+  }
+  return value;
+}
+
+int nativeUlpRun() {
+  if (!started) return -1;
+  uint16_t r[4] = {0, 0, 0, 0};
+  bool zero = false, woke = false;
+
+  for (size_t pc = 0, steps = 0; pc < loaded.size(); steps++) {
+    if (steps >= ULP_MAX_STEPS) return -1;
+    const ulp_insn_t &in = loaded[pc++];
+    uint32_t alu;
+    switch (in.op) {
+      case ULP_OP_MOVI: alu = in.b; break;
+      case ULP_OP_MOVR: alu = r[in.b]; break;
+      case ULP_OP_ADDI: alu = r[in.b] + in.c; break;
+      case ULP_OP_SUBR: alu = r[in.b] - r[in.c]; break;
+      case ULP_OP_ANDI: alu = r[in.b] & in.c; break;
+      case ULP_OP_ORI:  alu = r[in.b] | in.c; break;
+      case ULP_OP_RSHR: alu = r[in.b] >> (r[in.c] & 0xF); break;
+      case ULP_OP_LD:
+        r[in.a] = RTC_SLOW_MEM[(r[in.b] + in.c) & (NATIVE_RTC_SLOW_MEM_WORDS - 1)] & 0xFFFF;
+        continue;
+      case ULP_OP_ST:
+        RTC_SLOW_MEM[(r[in.b] + in.c) & (NATIVE_RTC_SLOW_MEM_WORDS - 1)] =
+            (uint32_t)(loadAddr + pc - 1) << 21 | r[in.a];
+        continue;
+      case ULP_OP_RD_REG:
+        r[0] = (readReg(in.a) >> in.b) & ((1UL << (in.c - in.b + 1)) - 1);
+        continue;
+      case ULP_OP_BXZ:
+        if (zero) pc = in.a;
+        continue;
+      case ULP_OP_BL:
+        if (r[0] < in.b) pc = in.a;
+        continue;
+      case ULP_OP_WAKE:
+        woke = true;
+        continue;
+      case ULP_OP_HALT:
+        return woke;
+      default:
+        return -1;
+    }
+    r[in.a] = alu & 0xFFFF;
+    zero = r[in.a] == 0;
+  }
+  return -1;   // ran off the end without I_HALT
+}
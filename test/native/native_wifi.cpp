@@ -0,0 +1,98 @@
+#include <WiFi.h>
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  stop();
+  _fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (_fd < 0) return 0;
+  int one = 1;
+  setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  if (::connect(_fd, (sockaddr *)&addr, sizeof(addr)) != 0) {
+    stop();
+    return 0;
+  }
+  return 1;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+  addrinfo hints = {}, *found = nullptr;
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_STREAM;
+  if (getaddrinfo(host, nullptr, &hints, &found) != 0 || !found) return 0;
+  IPAddress ip((uint32_t)((sockaddr_in *)found->ai_addr)->sin_addr.s_addr);
+  freeaddrinfo(found);
+  return connect(ip, port);
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size) {
+  size_t sent = 0;
+  while (_fd >= 0 && sent < size) {
+    ssize_t n = send(_fd, buf + sent, size - sent, MSG_NOSIGNAL);
+    if (n <= 0) break;
+    sent += n;
+  }
+  return sent;
+}
+
+int WiFiClient::available() {
+  if (_fd < 0) return 0;
+  if (_peeked < 0) {
+    pollfd p = {_fd, POLLIN, 0};
+    poll(&p, 1, 1);
+  }
+  int n = 0;
+  ioctl(_fd, FIONREAD, &n);
+  return n + (_peeked >= 0);
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size) {
+  if (!size) return 0;
+  size_t got = 0;
+  if (_peeked >= 0) {
+    buf[got++] = (uint8_t)_peeked;
+    _peeked = -1;
+  }
+  if (_fd >= 0 && got < size) {
+    ssize_t n = recv(_fd, buf + got, size - got, MSG_DONTWAIT);
+    if (n > 0) got += n;
+  }
+  return got ? (int)got : -1;
+}
+
+int WiFiClient::peek() {
+  if (_peeked < 0) _peeked = read();
+  return _peeked;
+}
+
+void WiFiClient::stop() {
+  if (_fd >= 0) close(_fd);
+  _fd = -1;
+  _peeked = -1;
+}
+
+/* Open until the peer has closed and everything it sent has been read */
+uint8_t WiFiClient::connected() {
+  if (_fd < 0) return 0;
+  if (_peeked >= 0) return 1;
+  char c;
+  ssize_t n = recv(_fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n > 0 || (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+}
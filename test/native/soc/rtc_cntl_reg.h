@@ -0,0 +1,8 @@
+// HOST SHIM: soc/rtc_cntl_reg.h, the wake-ready flag the ULP checks before I_WAKE
+#ifndef NATIVE_SOC_RTC_CNTL_REG_H
+#define NATIVE_SOC_RTC_CNTL_REG_H
+
+#define RTC_CNTL_LOW_POWER_ST_REG   0x3ff480c0
+#define RTC_CNTL_RDY_FOR_WAKEUP_S   19
+
+#endif // NATIVE_SOC_RTC_CNTL_REG_H
@@ -0,0 +1,8 @@
+// HOST SHIM: soc/rtc_io_reg.h, the register the ULP reads the RTC GPIO levels from
+#ifndef NATIVE_SOC_RTC_IO_REG_H
+#define NATIVE_SOC_RTC_IO_REG_H
+
+#define RTC_GPIO_IN_REG     0x3ff48424
+#define RTC_GPIO_IN_NEXT_S  14
+
+#endif // NATIVE_SOC_RTC_IO_REG_H
@@ -0,0 +1,172 @@
+//=====================================================================================================//
+// ALERT DISPATCHER: status changes
+// AlertDispatcher against sinks whose deliveries the test holds and releases. The status callback
+// must see SENDING when an alert is dispatched and SENT or FAILED once every sink is done, one call
+// at a time, and nothing for a clear or for a status that did not change.
+//
+//   pio test -e native -f test_alert_dispatcher
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <unity.h>
+#include <vector>
+#include "alert_sink.h"
+#include "native_hal.h"
+
+/* Holds every delivery until released, then answers `result` */
+class HeldSink : public AlertSink {
+public:
+  explicit HeldSink(const char *name) : _name(name), release(false), result(true), delivered(0) {}
+  const char *name() const override { return _name; }
+  bool deliver(const AlertEvent &e) override {
+    (void)e;
+    while (!release) delay(1);
+    delivered++;
+    return result;
+  }
+
+private:
+  const char *_name;
+
+public:
+  std::atomic<bool> release;
+  std::atomic<bool> result;
+  std::atomic<uint32_t> delivered;
+};
+
+static std::mutex seenLock;
+static std::vector<AlertStatus> seen;
+static std::atomic<int> inside(0);
+static std::atomic<int> overlapped(0);
+
+static void recordStatus(AlertStatus status) {
+  if (inside++) overlapped++;
+  delay(1);   // widens the window for a second caller
+  {
+    std::lock_guard<std::mutex> guard(seenLock);
+    seen.push_back(status);
+  }
+  inside--;
+}
+
+static std::vector<AlertStatus> seenSoFar() {
+  std::lock_guard<std::mutex> guard(seenLock);
+  return seen;
+}
+
+/* Waits for the callback to have been called `n` times */
+static bool waitSeen(size_t n) {
+  for (uint32_t waited = 0; waited < 2000; waited++) {
+    if (seenSoFar().size() >= n) return true;
+    delay(1);
+  }
+  return false;
+}
+
+static AlertEvent event(AlertSeverity severity) {
+  AlertEvent e = {};
+  e.sampleUs = TimeService::monoUs();
+  e.sensor = ALERT_SENSOR_TEMPERATURE;
+  e.severity = severity;
+  e.value = 31.5f;
+  e.thresholdLow = NAN;
+  e.thresholdHigh = 30.0f;
+  e.temperature = 31.5f;
+  return e;
+}
+
+void setUp() {
+  std::lock_guard<std::mutex> guard(seenLock);
+  seen.clear();
+  overlapped = 0;
+}
+
+void tearDown() {}
+
+static void test_sending_then_sent() {
+  static HeldSink sink("held");   // the workers outlive the test
+  static AlertDispatcher alerts;
+  alerts.addSink(sink, {1, 10, 10}, 4096);
+  alerts.onStatusChange(recordStatus);
+  TEST_ASSERT_TRUE(alerts.begin());
+
+  alerts.dispatch(event(ALERT_SEVERITY_WARNING));
+  TEST_ASSERT_TRUE(waitSeen(1));
+  TEST_ASSERT_EQUAL(ALERT_SENDING, seenSoFar()[0]);
+  TEST_ASSERT_EQUAL(ALERT_SENDING, alerts.status());
+
+  sink.release = true;
+  TEST_ASSERT_TRUE(waitSeen(2));
+  TEST_ASSERT_EQUAL(ALERT_SENT, seenSoFar()[1]);
+  TEST_ASSERT_EQUAL(ALERT_SENT, alerts.status());
+
+  /* A clear changes no status */
+  alerts.dispatch(event(ALERT_SEVERITY_CLEAR));
+  for (uint32_t waited = 0; sink.delivered < 2 && waited < 2000; waited++) delay(1);
+  TEST_ASSERT_EQUAL(2, sink.delivered);
+  delay(20);
+  TEST_ASSERT_EQUAL(2, seenSoFar().size());
+}
+
+/* Two sinks, one fails: one SENDING while either is busy, FAILED once both are done */
+static void test_one_failed_sink_fails_the_alert() {
+  static HeldSink good("good"), bad("bad");
+  bad.result = false;
+  static AlertDispatcher alerts;
+  alerts.addSink(good, {1, 10, 10}, 4096);
+  alerts.addSink(bad, {2, 1, 1}, 4096);
+  alerts.onStatusChange(recordStatus);
+  TEST_ASSERT_TRUE(alerts.begin());
+
+  alerts.dispatch(event(ALERT_SEVERITY_CRITICAL));
+  good.release = true;
+  for (uint32_t waited = 0; good.delivered < 1 && waited < 2000; waited++) delay(1);
+  delay(20);
+  TEST_ASSERT_EQUAL(1, seenSoFar().size());
+  TEST_ASSERT_EQUAL(ALERT_SENDING, alerts.status());
+
+  bad.release = true;
+  TEST_ASSERT_TRUE(waitSeen(2));
+  std::vector<AlertStatus> statuses = seenSoFar();
+  TEST_ASSERT_EQUAL(ALERT_SENDING, statuses[0]);
+  TEST_ASSERT_EQUAL(ALERT_FAILED, statuses[1]);
+  TEST_ASSERT_EQUAL(ALERT_FAILED, alerts.status());
+}
+
+/* Sinks finishing together: the callback never runs twice at once and its last call is the status */
+static void test_racing_workers_report_in_order() {
+  static HeldSink sinks[4] = {HeldSink("a"), HeldSink("b"), HeldSink("c"), HeldSink("d")};
+  static AlertDispatcher alerts;
+  for (HeldSink &s : sinks) alerts.addSink(s, {1, 10, 10}, 4096);
+  alerts.onStatusChange(recordStatus);
+  TEST_ASSERT_TRUE(alerts.begin());
+
+  for (uint8_t round = 0; round < 20; round++) {
+    sinks[round % 4].result = round % 3 != 0;
+    for (HeldSink &s : sinks) s.release = false;
+    alerts.dispatch(event(ALERT_SEVERITY_WARNING));
+    for (HeldSink &s : sinks) s.release = true;
+    for (uint32_t waited = 0; alerts.status() == ALERT_SENDING && waited < 2000; waited++) delay(1);
+    sinks[round % 4].result = true;
+  }
+  delay(20);
+
+  std::vector<AlertStatus> statuses = seenSoFar();
+  TEST_ASSERT_EQUAL(0, overlapped);
+  TEST_ASSERT_GREATER_THAN(0, statuses.size());
+  TEST_ASSERT_EQUAL(alerts.status(), statuses.back());
+  for (size_t i = 1; i < statuses.size(); i++) TEST_ASSERT_NOT_EQUAL(statuses[i - 1], statuses[i]);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_sending_then_sent);
+  RUN_TEST(test_one_failed_sink_fails_the_alert);
+  RUN_TEST(test_racing_workers_report_in_order);
+  return UNITY_END();
+}
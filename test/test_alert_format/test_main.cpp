@@ -0,0 +1,170 @@
+//=====================================================================================================//
+// ALERT FORMAT: rendering without the heap
+// Every subject and body layout of alert_format.cpp is rendered for each sensor and severity, with
+// ordinary, extreme and NaN readings, an over-long tank name and buffers cut short, while global
+// operator new and malloc/calloc/realloc count their calls. The alert path must not allocate, so
+// every count must stay 0. The counters themselves are checked against a known allocation first.
+//
+//   pio test -e native -f test_alert_format
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <math.h>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "alert_format.h"
+#include "native_hal.h"
+
+/* glibc's own entry points, under the malloc family defined below */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+/* Counted on this thread only, between countAllocations(true) and (false) */
+static thread_local bool counting;
+static thread_local uint32_t allocations;
+
+static void countAllocations(bool on) {
+  if (on) allocations = 0;
+  counting = on;
+}
+
+extern "C" void *malloc(size_t size) {
+  if (counting) allocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+  if (counting) allocations++;
+  return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+  if (counting) allocations++;
+  return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p) { __libc_free(p); }
+
+void *operator new(size_t size) {
+  if (counting) allocations++;
+  void *p = __libc_malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { __libc_free(p); }
+void operator delete[](void *p) noexcept { __libc_free(p); }
+void operator delete(void *p, size_t) noexcept { __libc_free(p); }
+void operator delete[](void *p, size_t) noexcept { __libc_free(p); }
+
+static TimeService clock_;
+
+static const char *const TANK = "Tank 1";
+static const char *const LONG_TANK = "Tank with a name much longer than ALERT_TANK_MAX characters";
+
+static AlertEvent event(AlertSensor sensor, AlertSeverity severity, float value) {
+  AlertEvent e = {};
+  e.sampleUs = TimeService::monoUs();
+  e.sensor = sensor;
+  e.severity = severity;
+  e.value = value;
+  e.thresholdLow = sensor == ALERT_SENSOR_TEMPERATURE ? 20.0f : NAN;
+  e.thresholdHigh = sensor == ALERT_SENSOR_LIQUID_LEVEL ? NAN : 30.0f;
+  e.temperature = 24.5f;
+  return e;
+}
+
+void setUp() { countAllocations(false); }
+void tearDown() { countAllocations(false); }
+
+static void test_counters_see_allocations() {
+  countAllocations(true);
+  void *p = malloc(32);
+  char *q = new char[64];
+  countAllocations(false);
+  free(p);
+  delete[] q;
+  TEST_ASSERT_EQUAL(2, allocations);
+}
+
+static void test_layout_text() {
+  char body[ALERT_BODY_MAX], subject[ALERT_SUBJECT_MAX];
+  AlertEvent e = event(ALERT_SENSOR_TEMPERATURE, ALERT_SEVERITY_CRITICAL, 31.456f);
+  formatAlertSubject(subject, sizeof(subject), e, clock_, TANK);
+  formatAlertText(body, sizeof(body), e, clock_, TANK);
+  TEST_ASSERT_EQUAL_STRING("RE: TEMPERATURE. PLEASE CHECK TANK! - Sent from ESP board", subject);
+  const char *expected = "Current temperature is not within threshold! Temperature is currently 31.46°C "
+                         "(limits 20 to 30°C). Please check Tank 1. (Reading taken ";
+  TEST_ASSERT_EQUAL_STRING_LEN(expected, body, strlen(expected));
+  TEST_ASSERT_EQUAL(')', body[strlen(body) - 1]);
+}
+
+static void test_every_layout_renders_without_allocating() {
+  static const AlertSensor sensors[] = {ALERT_SENSOR_LIQUID_LEVEL, ALERT_SENSOR_TEMPERATURE, ALERT_SENSOR_HEAP};
+  static const AlertSeverity severities[] = {ALERT_SEVERITY_CLEAR, ALERT_SEVERITY_WARNING, ALERT_SEVERITY_CRITICAL};
+  static const float values[] = {0.0f, 1.0f, -0.005f, 31.456f, -1999999.0f, 1e9f, NAN, INFINITY};
+  static const size_t cuts[] = {0, 1, 2, 17, 60};
+  char body[ALERT_BODY_MAX], subject[ALERT_SUBJECT_MAX];
+  uint32_t renders = 0;
+
+  /* gmtime_r/strftime set up their state on first use, as they do once per boot on the board */
+  formatAlertText(body, sizeof(body), event(ALERT_SENSOR_HEAP, ALERT_SEVERITY_WARNING, 1.0f), clock_, TANK);
+
+  countAllocations(true);
+  for (AlertSensor sensor : sensors) {
+    for (AlertSeverity severity : severities) {
+      for (float value : values) {
+        for (const char *tank : {TANK, LONG_TANK, ""}) {
+          AlertEvent e = event(sensor, severity, value);
+          e.temperature = value;
+          size_t n = formatAlertSubject(subject, sizeof(subject), e, clock_, tank);
+          size_t m = formatAlertText(body, sizeof(body), e, clock_, tank);
+          TEST_ASSERT_TRUE(n < sizeof(subject) && m < sizeof(body));
+          TEST_ASSERT_EQUAL(strlen(body), m);
+          for (size_t cut : cuts) {
+            formatAlertText(body, cut, e, clock_, tank);
+            formatAlertSubject(subject, cut, e, clock_, tank);
+          }
+          renders += 2 + 2 * sizeof(cuts) / sizeof(cuts[0]);
+        }
+      }
+    }
+  }
+  countAllocations(false);
+  TEST_ASSERT_EQUAL(0, allocations);
+  TEST_ASSERT_GREATER_THAN(1000, renders);
+}
+
+static void test_format_fixed_without_allocating() {
+  char out[ALERT_NUMBER_MAX];
+  countAllocations(true);
+  size_t n = formatFixed(out, sizeof(out), -1999999.999f, 3);
+  countAllocations(false);
+  TEST_ASSERT_EQUAL(0, allocations);
+  TEST_ASSERT_EQUAL(strlen(out), n);
+  TEST_ASSERT_LESS_THAN(sizeof(out), n + 1);
+
+  formatFixed(out, sizeof(out), -0.5f, 2);
+  TEST_ASSERT_EQUAL_STRING("-0.50", out);
+  formatFixed(out, sizeof(out), NAN, 2);
+  TEST_ASSERT_EQUAL_STRING("nan", out);
+  formatFixed(out, 3, 12.345f, 2);
+  TEST_ASSERT_EQUAL_STRING("12", out);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_counters_see_allocations);
+  RUN_TEST(test_layout_text);
+  RUN_TEST(test_every_layout_renders_without_allocating);
+  RUN_TEST(test_format_fixed_without_allocating);
+  return UNITY_END();
+}
@@ -0,0 +1,231 @@
+//=====================================================================================================//
+// BASE64 STREAM: against the mail client's encoder
+// Base64Stream is fuzzed against ESP_Mail_Client::encodeBase64Str(), the whole-buffer encoder it
+// replaces: random inputs, cut into random writes, through random buffer sizes. With the line
+// breaks taken out, the output must match the library's byte for byte; every line but the last must
+// be 76 characters, and no sink call may exceed the buffer. A failing sink must stop the stream.
+// The benchmark encodes the same input with both and prints the throughput.
+//
+//   pio test -e native_mail -f test_base64_stream
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <ESP_Mail_Client.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+#include "base64_stream.h"
+#include "native_hal.h"
+
+/* encodeBase64Str() is private: an explicit instantiation may name it, and hands the pointer out */
+template <typename Tag, typename Tag::type M> struct Expose {
+  friend typename Tag::type get(Tag) { return M; }
+};
+
+struct EncodeBase64Str {
+  typedef MB_String (ESP_Mail_Client::*type)(uint8_t *, size_t);
+  friend type get(EncodeBase64Str);
+};
+
+template struct Expose<EncodeBase64Str, &ESP_Mail_Client::encodeBase64Str>;
+
+static std::string libraryBase64(std::vector<uint8_t> &data) {
+  MB_String s = (MailClient.*get(EncodeBase64Str()))(data.data(), data.size());
+  return std::string(s.c_str(), s.length());
+}
+
+#define FUZZ_ROUNDS  2000
+#define FUZZ_MAX_LEN 4000
+#define BENCH_BYTES  (1024 * 1024)
+#define BENCH_BUFFER 512
+
+/* Collects what the stream sends; fails from call `failAt` on, when set */
+struct Capture {
+  std::string out;
+  size_t largest;
+  uint32_t calls;
+  uint32_t failAt;
+};
+
+static bool captureSink(void *arg, const char *data, size_t len) {
+  Capture *c = static_cast<Capture *>(arg);
+  c->calls++;
+  if (len > c->largest) c->largest = len;
+  if (c->failAt && c->calls >= c->failAt) return false;
+  c->out.append(data, len);
+  return true;
+}
+
+static bool discardSink(void *arg, const char *data, size_t len) {
+  (void)data;
+  *static_cast<size_t *>(arg) += len;
+  return true;
+}
+
+static std::vector<uint8_t> randomBytes(size_t len) {
+  std::vector<uint8_t> data(len);
+  for (uint8_t &b : data) b = (uint8_t)random(256);
+  return data;
+}
+
+/* Lengths around the 3-byte groups, the 12-byte blocks and the 57-byte lines come up often */
+static size_t randomLength() {
+  switch (random(4)) {
+  case 0:
+    return random(BASE64_LINE_INPUT * 3);
+  case 1:
+    return BASE64_LINE_INPUT * random(1, 40) + random(-2, 3);
+  default:
+    return random(FUZZ_MAX_LEN);
+  }
+}
+
+/* Writes `data` in random pieces, empty ones included */
+static bool writeInPieces(Base64Stream &stream, const std::vector<uint8_t> &data) {
+  size_t at = 0;
+  while (at < data.size()) {
+    size_t piece = random(4) == 0 ? random(4) : random(1, 200);
+    if (piece > data.size() - at) piece = data.size() - at;
+    if (!stream.write(data.data() + at, piece)) return false;
+    at += piece;
+  }
+  return true;
+}
+
+/* Checks the line layout and returns the base64 without the line breaks */
+static std::string unwrapLines(const std::string &out, const char *where) {
+  std::string joined;
+  size_t at = 0;
+  while (at < out.size()) {
+    size_t end = out.find("\r\n", at);
+    TEST_ASSERT_TRUE_MESSAGE(end != std::string::npos, where);
+    size_t line = end - at;
+    TEST_ASSERT_TRUE_MESSAGE(line > 0 && line <= 76, where);
+    if (end + 2 < out.size()) TEST_ASSERT_EQUAL_MESSAGE(76, line, where);
+    joined.append(out, at, line);
+    at = end + 2;
+  }
+  return joined;
+}
+
+void setUp() { randomSeed(41); }
+void tearDown() {}
+
+static void test_known_vectors() {
+  static const char *const plain[] = {"", "f", "fo", "foo", "foob", "fooba", "foobar"};
+  static const char *const encoded[] = {"", "Zg==\r\n", "Zm8=\r\n", "Zm9v\r\n", "Zm9vYg==\r\n", "Zm9vYmE=\r\n",
+                                        "Zm9vYmFy\r\n"};
+  for (size_t i = 0; i < sizeof(plain) / sizeof(plain[0]); i++) {
+    char buf[BASE64_BUFFER_MIN];
+    Capture c = {};
+    Base64Stream stream(buf, sizeof(buf), captureSink, &c);
+    TEST_ASSERT_TRUE(stream.write((const uint8_t *)plain[i], strlen(plain[i])));
+    TEST_ASSERT_TRUE(stream.finish());
+    TEST_ASSERT_EQUAL_STRING(encoded[i], c.out.c_str());
+  }
+}
+
+static void test_matches_library_encoder() {
+  std::vector<char> buf(4096);
+  for (uint32_t round = 0; round < FUZZ_ROUNDS; round++) {
+    char where[48];
+    snprintf(where, sizeof(where), "round %u", (unsigned)round);
+    std::vector<uint8_t> data = randomBytes(randomLength());
+    size_t bufLen = random(BASE64_BUFFER_MIN, buf.size() + 1);
+
+    Capture c = {};
+    Base64Stream stream(buf.data(), bufLen, captureSink, &c);
+    TEST_ASSERT_TRUE_MESSAGE(writeInPieces(stream, data), where);
+    TEST_ASSERT_TRUE_MESSAGE(stream.finish(), where);
+
+    TEST_ASSERT_LESS_OR_EQUAL_MESSAGE(bufLen, c.largest, where);
+    TEST_ASSERT_EQUAL_MESSAGE(Base64Stream::encodedLength(data.size()), c.out.size(), where);
+    TEST_ASSERT_EQUAL_MESSAGE(c.out.size(), stream.encodedBytes(), where);
+    std::string expected = libraryBase64(data);
+    std::string actual = unwrapLines(c.out, where);
+    TEST_ASSERT_EQUAL_MESSAGE(expected.size(), actual.size(), where);
+    TEST_ASSERT_TRUE_MESSAGE(expected == actual, where);
+  }
+}
+
+/* Fed as a producer callback, the way an attachment source drives it */
+static void test_input_callback_matches_write() {
+  std::vector<uint8_t> data = randomBytes(1000);
+  char buf[100];
+  Capture c = {};
+  Base64Stream stream(buf, sizeof(buf), captureSink, &c);
+  for (size_t at = 0; at < data.size(); at += 33) {
+    size_t n = data.size() - at < 33 ? data.size() - at : 33;
+    TEST_ASSERT_TRUE(Base64Stream::input(&stream, (const char *)data.data() + at, n));
+  }
+  TEST_ASSERT_TRUE(stream.finish());
+  TEST_ASSERT_TRUE(libraryBase64(data) == unwrapLines(c.out, "input"));
+}
+
+static void test_failed_sink_stops_the_stream() {
+  for (uint32_t failAt = 1; failAt <= 5; failAt++) {
+    std::vector<uint8_t> data = randomBytes(2000);
+    char buf[BASE64_BUFFER_MIN * 2];
+    Capture c = {};
+    c.failAt = failAt;
+    Base64Stream stream(buf, sizeof(buf), captureSink, &c);
+    bool wrote = writeInPieces(stream, data);
+    bool finished = stream.finish();
+    TEST_ASSERT_FALSE(wrote && finished);
+    TEST_ASSERT_EQUAL(failAt, c.calls);
+
+    /* Nothing more reaches the sink */
+    TEST_ASSERT_FALSE(stream.write(data.data(), data.size()));
+    TEST_ASSERT_FALSE(stream.finish());
+    TEST_ASSERT_EQUAL(failAt, c.calls);
+  }
+}
+
+static void test_buffer_below_one_line_is_refused() {
+  char buf[BASE64_BUFFER_MIN - 1];
+  Capture c = {};
+  Base64Stream stream(buf, sizeof(buf), captureSink, &c);
+  TEST_ASSERT_FALSE(stream.write((const uint8_t *)"foo", 3));
+  TEST_ASSERT_FALSE(stream.finish());
+  TEST_ASSERT_EQUAL(0, c.calls);
+}
+
+/* The same megabyte both ways: whole-buffer encodeBase64Str() and the stream through 512 bytes */
+static void test_throughput_benchmark() {
+  std::vector<uint8_t> data = randomBytes(BENCH_BYTES);
+
+  uint32_t start = micros();
+  std::string whole = libraryBase64(data);
+  uint32_t libraryUs = micros() - start;
+
+  char buf[BENCH_BUFFER];
+  size_t sent = 0;
+  start = micros();
+  Base64Stream stream(buf, sizeof(buf), discardSink, &sent);
+  TEST_ASSERT_TRUE(stream.write(data.data(), data.size()));
+  TEST_ASSERT_TRUE(stream.finish());
+  uint32_t streamUs = micros() - start;
+  TEST_ASSERT_EQUAL(Base64Stream::encodedLength(data.size()), sent);
+
+  nativeSerialEcho(true);
+  Serial.printf("Base64 of %u bytes: encodeBase64Str %u us (%.1f MB/s, %u bytes of heap), "
+                "Base64Stream %u us (%.1f MB/s, %u bytes of buffer)\n",
+                (unsigned)data.size(), (unsigned)libraryUs, libraryUs ? (float)data.size() / libraryUs : 0.0f,
+                (unsigned)whole.size(), (unsigned)streamUs, streamUs ? (float)data.size() / streamUs : 0.0f,
+                (unsigned)sizeof(buf));
+  nativeSerialEcho(false);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_known_vectors);
+  RUN_TEST(test_matches_library_encoder);
+  RUN_TEST(test_input_callback_matches_write);
+  RUN_TEST(test_failed_sink_stops_the_stream);
+  RUN_TEST(test_buffer_below_one_line_is_refused);
+  RUN_TEST(test_throughput_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,262 @@
+//=====================================================================================================//
+// DUTY CYCLE: host simulation
+// Runs the deep-sleep state machine through simulated wakes, with DutyCycleState standing in for
+// RTC slow memory and a simulated RTC clock, and flushes through the real flushDutyBuffer() into
+// the LittleFS stand-in. The CSV it leaves must hold every sample exactly once, in order, also
+// when the flash fills up in the middle of a flush.
+//
+//   pio test -e native -f test_duty_cycle
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <unity.h>
+#include <vector>
+#include "duty_cycle.h"
+#include "native_hal.h"
+
+#define AWAKE_US   900000     // per wake, radio off
+#define RADIO_US   2500000    // extra when an alert goes out
+#define FIRST_TIME 1000000000 // sample time of the first wake
+
+static DutyCycleState rtcState;  // RTC slow memory
+static uint64_t rtcUs;
+static uint32_t nextTime;
+
+struct Wake {
+  uint8_t actions;
+  size_t flushed;
+};
+
+/* One wake as main.cpp's low-power path runs it, minus the sensors and the network */
+static Wake wake(WakeReason reason, bool liquidLow = false, bool tempAlert = false, bool canFlush = true) {
+  DutyCycle cycle(rtcState);
+  cycle.begin(reason, rtcUs);
+
+  PackedSample s = {nextTime, 2150, 4800, liquidLow, tempAlert};
+  nextTime += DUTY_SAMPLE_INTERVAL_S;
+  Wake w = {cycle.record(s, 1200), 0};
+
+  uint32_t radioUs = 0;
+  if (w.actions & DUTY_ALERT) {
+    cycle.alertSent();
+    radioUs = RADIO_US;
+  }
+  if ((w.actions & DUTY_FLUSH) && canFlush && LittleFS.begin()) {
+    w.flushed = flushDutyBuffer(cycle);
+    LittleFS.end();
+  }
+
+  rtcUs += AWAKE_US + radioUs;
+  cycle.finish(AWAKE_US + radioUs, radioUs, rtcUs);
+  rtcUs += cycle.sleepUs();
+  return w;
+}
+
+static std::vector<std::string> csvLines() {
+  std::vector<std::string> lines;
+  LittleFS.begin();
+  File file = LittleFS.open(DUTY_LOG_PATH, "r");
+  std::string line;
+  for (int c; file && (c = file.read()) >= 0;) {
+    if (c != '\n') {
+      line += (char)c;
+      continue;
+    }
+    lines.push_back(line);
+    line.clear();
+  }
+  if (!line.empty()) lines.push_back(line);
+  LittleFS.end();
+  return lines;
+}
+
+/* Sample times of the well-formed lines, in file order */
+static std::vector<uint32_t> csvTimes() {
+  std::vector<uint32_t> times;
+  for (const std::string &line : csvLines()) {
+    unsigned long t;
+    int temp;
+    unsigned hum, low, alert;
+    char end;
+    if (sscanf(line.c_str(), "%lu,%d,%u,%u,%u%c", &t, &temp, &hum, &low, &alert, &end) == 5) times.push_back(t);
+  }
+  return times;
+}
+
+static void assertEverySampleOnce(uint32_t samples) {
+  std::vector<uint32_t> times = csvTimes();
+  TEST_ASSERT_EQUAL(samples, times.size());
+  for (uint32_t i = 0; i < samples; i++) {
+    TEST_ASSERT_EQUAL_UINT32(FIRST_TIME + i * DUTY_SAMPLE_INTERVAL_S, times[i]);
+  }
+}
+
+void setUp() {
+  memset(&rtcState, 0xa5, sizeof(rtcState));  // power-on garbage
+  rtcUs = 5000000;
+  nextTime = FIRST_TIME;
+  nativeFsFailWritesAfter(-1);
+  LittleFS.begin();
+  LittleFS.remove(DUTY_LOG_PATH);
+  LittleFS.end();
+  wake(WAKE_POWER_ON);
+}
+
+void tearDown() { nativeFsFailWritesAfter(-1); }
+
+static void test_power_on_starts_from_scratch() {
+  TEST_ASSERT_EQUAL_UINT32(DutyCycle::MAGIC, rtcState.magic);
+  TEST_ASSERT_EQUAL(1, rtcState.wakes);
+  TEST_ASSERT_EQUAL(1, rtcState.count);
+  TEST_ASSERT_EQUAL(0, rtcState.dropped);
+}
+
+static void test_timer_wake_keeps_state_and_bad_magic_resets() {
+  wake(WAKE_TIMER);
+  TEST_ASSERT_EQUAL(2, rtcState.wakes);
+  TEST_ASSERT_EQUAL(2, rtcState.count);
+
+  rtcState.magic ^= 1;
+  wake(WAKE_TIMER);
+  TEST_ASSERT_EQUAL(1, rtcState.wakes);
+  TEST_ASSERT_EQUAL(1, rtcState.count);
+}
+
+static void test_flushes_every_flush_at_samples() {
+  uint32_t flushes = 0;
+  for (uint32_t i = 1; i < 3 * DUTY_FLUSH_AT; i++) {
+    Wake w = wake(WAKE_TIMER);
+    if (w.actions & DUTY_FLUSH) {
+      flushes++;
+      TEST_ASSERT_EQUAL(DUTY_FLUSH_AT, w.flushed);
+    }
+    TEST_ASSERT_LESS_THAN(DUTY_FLUSH_AT, rtcState.count);
+  }
+  TEST_ASSERT_EQUAL(3, flushes);
+  TEST_ASSERT_EQUAL(0, rtcState.dropped);
+  assertEverySampleOnce(3 * DUTY_FLUSH_AT);
+}
+
+static void test_alert_on_transition_only() {
+  uint8_t alerts = 0;
+  bool pattern[] = {false, true, true, true, false, false, true, true};
+  for (bool low : pattern) {
+    Wake w = wake(low ? WAKE_LEVEL_PIN : WAKE_TIMER, low);
+    if (w.actions & DUTY_ALERT) alerts++;
+    TEST_ASSERT_EQUAL(!low, DutyCycle(rtcState).armLevelWake());
+  }
+  TEST_ASSERT_EQUAL(2, alerts);
+  TEST_ASSERT_EQUAL(2, rtcState.alertsSent);
+  TEST_ASSERT_EQUAL(5, rtcState.levelWakes);
+
+  TEST_ASSERT_TRUE(wake(WAKE_TIMER, false, true).actions & DUTY_ALERT);
+  TEST_ASSERT_FALSE(wake(WAKE_TIMER, false, true).actions & DUTY_ALERT);
+}
+
+/* With the flash out of reach the ring keeps the newest DUTY_BUFFER_SIZE samples */
+static void test_overflow_drops_oldest() {
+  for (uint32_t i = 1; i < DUTY_BUFFER_SIZE + 10; i++) wake(WAKE_TIMER, false, false, false);
+  TEST_ASSERT_EQUAL(DUTY_BUFFER_SIZE, rtcState.count);
+  TEST_ASSERT_EQUAL(10, rtcState.dropped);
+
+  const PackedSample *first, *second;
+  uint16_t firstLen, secondLen;
+  TEST_ASSERT_EQUAL(DUTY_BUFFER_SIZE, DutyCycle(rtcState).pending(&first, &firstLen, &second, &secondLen));
+  TEST_ASSERT_EQUAL(DUTY_BUFFER_SIZE, firstLen + secondLen);
+  TEST_ASSERT_EQUAL_UINT32(FIRST_TIME + 10 * DUTY_SAMPLE_INTERVAL_S, first[0].time);
+  TEST_ASSERT_EQUAL_UINT32(first[firstLen - 1].time + DUTY_SAMPLE_INTERVAL_S, second[0].time);
+}
+
+/* The flash fills up in the second run of a wrapped buffer, in the middle of a line. Once there
+ * is room again the next flush must carry on after the last whole line, not start over. */
+static void test_flush_cut_short_writes_nothing_twice() {
+  for (uint32_t i = 1; i < DUTY_FLUSH_AT; i++) wake(WAKE_TIMER);
+  uint32_t samples = DUTY_FLUSH_AT;
+  for (uint32_t i = 1; i < DUTY_FLUSH_AT; i++, samples++) wake(WAKE_TIMER, false, false, false);
+
+  const PackedSample *first, *second;
+  uint16_t firstLen, secondLen;
+  DutyCycle(rtcState).pending(&first, &firstLen, &second, &secondLen);
+  TEST_ASSERT_GREATER_THAN(0, secondLen);
+
+  /* Lines are 25 bytes here: room for the first run, a few lines of the second and half a line */
+  nativeFsFailWritesAfter(25 * (firstLen + 5) + 12);
+  Wake w = wake(WAKE_TIMER);
+  samples++;
+  TEST_ASSERT_TRUE(w.actions & DUTY_FLUSH);
+  TEST_ASSERT_EQUAL(firstLen + 5, w.flushed);
+  TEST_ASSERT_EQUAL(samples - DUTY_FLUSH_AT - w.flushed, rtcState.count);
+
+  nativeFsFailWritesAfter(-1);
+  while (rtcState.count + 1 < DUTY_FLUSH_AT) {
+    wake(WAKE_TIMER);
+    samples++;
+  }
+  w = wake(WAKE_TIMER);
+  samples++;
+  TEST_ASSERT_EQUAL(DUTY_FLUSH_AT, w.flushed);
+  TEST_ASSERT_EQUAL(0, rtcState.count);
+  assertEverySampleOnce(samples);
+}
+
+static void test_backfill_moves_unsynced_samples() {
+  for (uint8_t i = 0; i < 4; i++) wake(WAKE_TIMER);
+  rtcState.buffer[0].time = 600;
+  rtcState.buffer[1].time = 900;
+  TEST_ASSERT_EQUAL(2, DutyCycle(rtcState).backfill(1700000000, 100000000));
+  TEST_ASSERT_EQUAL_UINT32(1700000600, rtcState.buffer[0].time);
+  TEST_ASSERT_EQUAL_UINT32(1700000900, rtcState.buffer[1].time);
+  TEST_ASSERT_EQUAL_UINT32(FIRST_TIME + 2 * DUTY_SAMPLE_INTERVAL_S, rtcState.buffer[2].time);
+}
+
+/* A day of timer wakes: sleep accounted from the RTC, energy per sample from the current model */
+static void test_energy_per_sample() {
+  const uint32_t wakes = 24 * 3600 / DUTY_SAMPLE_INTERVAL_S;
+  for (uint32_t i = 1; i < wakes; i++) wake(WAKE_TIMER);
+  wake(WAKE_TIMER);
+
+  TEST_ASSERT_EQUAL(wakes + 1, rtcState.samples);
+  TEST_ASSERT_EQUAL_UINT64((uint64_t)wakes * DUTY_SAMPLE_INTERVAL_S * 1000000ULL, rtcState.sleepUs);
+  float expected = DUTY_SUPPLY_V * (DUTY_ACTIVE_MA * AWAKE_US / 1e6f + DUTY_SLEEP_MA * DUTY_SAMPLE_INTERVAL_S);
+  float mj = DutyCycle(rtcState).energyPerSampleMj();
+  TEST_ASSERT_FLOAT_WITHIN(expected * 0.01f, expected, mj);
+
+  char msg[96];
+  snprintf(msg, sizeof(msg), "%.1f mJ per sample, %.1f mJ awake the whole interval", mj,
+           DUTY_SUPPLY_V * DUTY_ACTIVE_MA * DUTY_SAMPLE_INTERVAL_S);
+  TEST_MESSAGE(msg);
+}
+
+static void test_sleep_glue() {
+  enterDeepSleep(DutyCycle(rtcState).sleepUs(), true, 27);
+  TEST_ASSERT_EQUAL_UINT64((uint64_t)DUTY_SAMPLE_INTERVAL_S * 1000000ULL, nativeSleep().timerUs);
+  TEST_ASSERT_EQUAL(27, nativeSleep().ext0Pin);
+  TEST_ASSERT_EQUAL(1, nativeSleep().ext0Level);
+
+  enterDeepSleep(DutyCycle(rtcState).sleepUs(), false, 27);
+  TEST_ASSERT_EQUAL(-1, nativeSleep().ext0Pin);
+
+  nativeSetWakeCause(ESP_SLEEP_WAKEUP_EXT0);
+  TEST_ASSERT_EQUAL(WAKE_LEVEL_PIN, readWakeReason());
+  nativeSetWakeCause(ESP_SLEEP_WAKEUP_TIMER);
+  TEST_ASSERT_EQUAL(WAKE_TIMER, readWakeReason());
+  nativeSetWakeCause(ESP_SLEEP_WAKEUP_UNDEFINED);
+  TEST_ASSERT_EQUAL(WAKE_POWER_ON, readWakeReason());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_power_on_starts_from_scratch);
+  RUN_TEST(test_timer_wake_keeps_state_and_bad_magic_resets);
+  RUN_TEST(test_flushes_every_flush_at_samples);
+  RUN_TEST(test_alert_on_transition_only);
+  RUN_TEST(test_overflow_drops_oldest);
+  RUN_TEST(test_flush_cut_short_writes_nothing_twice);
+  RUN_TEST(test_backfill_moves_unsynced_samples);
+  RUN_TEST(test_energy_per_sample);
+  RUN_TEST(test_sleep_glue);
+  return UNITY_END();
+}
@@ -0,0 +1,98 @@
+//=====================================================================================================//
+// HEAP TELEMETRY: fragmentation from internal RAM
+// HeapTelemetry::sample() against the simulated heap. Fragmentation must come from the internal
+// free heap and its largest block; a largest block above the free heap, as two reads that are not
+// atomic can return, counts as no fragmentation instead of wrapping around. The heap alert must
+// rise at warnPct and clear only below clearPct, from the loop samples only.
+//
+//   pio test -e native_mail -f test_heap_telemetry
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <unity.h>
+#include "heap_telemetry.h"
+#include "native_hal.h"
+
+#define WARN_PCT  50
+#define CLEAR_PCT 30
+
+static void setHeap(size_t free, size_t largest) {
+  NativeHeap heap = {320000, free, free, largest};
+  nativeSetHeap(heap);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_fragmentation_from_internal_heap() {
+  HeapTelemetry telemetry(WARN_PCT, CLEAR_PCT);
+  setHeap(100000, 40000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_EQUAL(60, telemetry.fragmentationPct());
+
+  HeapSample low;
+  size_t window;
+  TEST_ASSERT_TRUE(telemetry.lowest(low, window));
+  TEST_ASSERT_EQUAL(100000, low.freeBytes);
+  TEST_ASSERT_EQUAL(40000, low.largestBlock);
+}
+
+static void test_largest_block_above_free_is_clamped() {
+  HeapTelemetry telemetry(WARN_PCT, CLEAR_PCT);
+  setHeap(50000, 80000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_EQUAL(0, telemetry.fragmentationPct());
+  TEST_ASSERT_FALSE(telemetry.fragmented());
+
+  HeapSample low;
+  size_t window;
+  TEST_ASSERT_TRUE(telemetry.lowest(low, window));
+  TEST_ASSERT_EQUAL(50000, low.largestBlock);
+}
+
+static void test_alert_rises_and_clears_with_hysteresis() {
+  HeapTelemetry telemetry(WARN_PCT, CLEAR_PCT);
+  setHeap(100000, 60000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_FALSE(telemetry.fragmented());
+
+  setHeap(100000, 50000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_TRUE(telemetry.fragmented());
+
+  /* Between the thresholds it stays up */
+  setHeap(100000, 65000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_TRUE(telemetry.fragmented());
+
+  setHeap(100000, 75000);
+  telemetry.sample(HEAP_PHASE_LOOP);
+  TEST_ASSERT_FALSE(telemetry.fragmented());
+}
+
+/* Mid-session samples are recorded but leave the alert alone */
+static void test_smtp_phases_do_not_raise_the_alert() {
+  HeapTelemetry telemetry(WARN_PCT, CLEAR_PCT);
+  setHeap(100000, 10000);
+  telemetry.sample(HEAP_PHASE_POST_HANDSHAKE);
+  TEST_ASSERT_FALSE(telemetry.fragmented());
+  TEST_ASSERT_EQUAL(0, telemetry.fragmentationPct());
+
+  HeapSample low;
+  size_t window;
+  TEST_ASSERT_TRUE(telemetry.lowest(low, window));
+  TEST_ASSERT_EQUAL(HEAP_PHASE_POST_HANDSHAKE, low.phase);
+  TEST_ASSERT_EQUAL(10000, low.largestBlock);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_fragmentation_from_internal_heap);
+  RUN_TEST(test_largest_block_above_free_is_clamped);
+  RUN_TEST(test_alert_rises_and_clears_with_hysteresis);
+  RUN_TEST(test_smtp_phases_do_not_raise_the_alert);
+  return UNITY_END();
+}
@@ -0,0 +1,401 @@
+//=====================================================================================================//
+// HTTP SERVER: host test
+// The real HttpServer, SampleLog and LiveFeed on the httpd stand-in in test/native, which serves
+// 127.0.0.1 over POSIX sockets. A small HTTP/1.1 client in this file fetches /now, /history (three
+// days of per-minute records written to the LittleFS stand-in), /events and /metrics, decodes the
+// chunked transfer encoding itself and checks the framing as well as the bodies: /history must be
+// chunked in pieces of at most HTTP_CHUNK_SIZE and equal SampleLog::stream() byte for byte.
+//
+//   pio test -e native -f test_http_server
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+#include "http_server.h"
+#include "live_feed.h"
+#include "native_hal.h"
+
+#define HISTORY_DAYS 3
+#define TANK_NAME    "Tank 1"
+
+static TimeService clock_;
+static SensorMailbox mailbox;
+static SampleLog sampleLog(LittleFS, clock_);
+static LiveFeed feed(clock_, TANK_NAME);
+static HttpServer server(mailbox, sampleLog, clock_, TANK_NAME);
+
+static uint32_t firstRecord;   // UTC seconds of the oldest record, on an hour boundary
+static uint32_t recordCount;
+
+/* One client connection; reads are buffered so responses can follow each other (keep-alive) */
+class Client {
+public:
+  Client() : _fd(socket(AF_INET, SOCK_STREAM, 0)) {
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(nativeHttpdPort());
+    struct timeval timeout = {5, 0};
+    setsockopt(_fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (connect(_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) TEST_FAIL_MESSAGE("connect");
+  }
+  ~Client() { close(_fd); }
+
+  void get(const char *path) {
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\nHost: tank\r\n\r\n";
+    TEST_ASSERT_EQUAL(request.size(), send(_fd, request.data(), request.size(), MSG_NOSIGNAL));
+  }
+
+  std::string line() {
+    std::string out;
+    char c;
+    while (read(&c, 1) && c != '\n') out += c;
+    if (!out.empty() && out.back() == '\r') out.pop_back();
+    return out;
+  }
+
+  std::string bytes(size_t n) {
+    std::string out(n, '\0');
+    if (n && !read(&out[0], n)) out.clear();
+    return out;
+  }
+
+  /* Closes without reading what is left; an RST reaches the server */
+  void reset() {
+    struct linger hard = {1, 0};
+    setsockopt(_fd, SOL_SOCKET, SO_LINGER, &hard, sizeof(hard));
+  }
+
+private:
+  bool read(char *out, size_t n) {
+    while (n) {
+      if (_pos == _len) {
+        ssize_t got = recv(_fd, _buf, sizeof(_buf), 0);
+        if (got <= 0) return false;
+        _pos = 0;
+        _len = got;
+      }
+      size_t take = std::min(n, _len - _pos);
+      memcpy(out, _buf + _pos, take);
+      _pos += take;
+      out += take;
+      n -= take;
+    }
+    return true;
+  }
+
+  int _fd;
+  char _buf[4096];
+  size_t _pos = 0, _len = 0;
+};
+
+struct Response {
+  int status = 0;
+  std::string type, cacheControl, transferEncoding;
+  long contentLength = -1;
+  std::string body;
+  size_t chunks = 0;       // data chunks, the terminating one not counted
+  size_t largestChunk = 0;
+};
+
+static void readHead(Client &client, Response &r) {
+  std::string status = client.line();
+  TEST_ASSERT_EQUAL_STRING("HTTP/1.1", status.substr(0, 8).c_str());
+  r.status = atoi(status.c_str() + 9);
+  for (std::string h = client.line(); !h.empty(); h = client.line()) {
+    size_t colon = h.find(": ");
+    TEST_ASSERT_TRUE(colon != std::string::npos);
+    std::string name = h.substr(0, colon), value = h.substr(colon + 2);
+    if (name == "Content-Type") r.type = value;
+    else if (name == "Cache-Control") r.cacheControl = value;
+    else if (name == "Transfer-Encoding") r.transferEncoding = value;
+    else if (name == "Content-Length") r.contentLength = atol(value.c_str());
+  }
+}
+
+/* One chunk; false on the terminating one */
+static bool readChunk(Client &client, std::string &data) {
+  std::string size = client.line();
+  char *end;
+  unsigned long n = strtoul(size.c_str(), &end, 16);
+  TEST_ASSERT_TRUE_MESSAGE(!size.empty() && *end == '\0', "chunk size line");
+  data = client.bytes(n);
+  TEST_ASSERT_EQUAL(n, data.size());
+  TEST_ASSERT_EQUAL_STRING("", client.line().c_str());
+  return n != 0;
+}
+
+static Response readResponse(Client &client) {
+  Response r;
+  readHead(client, r);
+  if (r.transferEncoding == "chunked") {
+    TEST_ASSERT_EQUAL(-1, r.contentLength);
+    std::string data;
+    while (readChunk(client, data)) {
+      r.body += data;
+      r.chunks++;
+      r.largestChunk = std::max(r.largestChunk, data.size());
+    }
+  } else {
+    TEST_ASSERT_TRUE(r.contentLength >= 0);
+    r.body = client.bytes(r.contentLength);
+  }
+  return r;
+}
+
+static Response fetch(const char *path) {
+  Client client;
+  client.get(path);
+  return readResponse(client);
+}
+
+static size_t countLines(const std::string &s) { return std::count(s.begin(), s.end(), '\n'); }
+
+static bool appendTo(void *arg, const char *data, size_t len) {
+  static_cast<std::string *>(arg)->append(data, len);
+  return true;
+}
+
+/* What /history must send: SampleLog::stream() straight into a string */
+static std::string streamed(uint32_t from, uint32_t to, uint32_t res) {
+  std::string out;
+  char buf[HTTP_CHUNK_SIZE];
+  TEST_ASSERT_TRUE(sampleLog.stream(from, to, res, appendTo, &out, buf, sizeof(buf)));
+  return out;
+}
+
+/* Record i of the test history; the values are easy to recompute from a CSV line */
+static LogRecord record(uint32_t i) {
+  LogRecord r = {};
+  r.time = firstRecord + i * SAMPLE_LOG_INTERVAL_S;
+  r.tempAvg = 2000 + i % 500;
+  r.tempMin = r.tempAvg - 25;
+  r.tempMax = r.tempAvg + 25;
+  r.humAvg = 5000 + i % 100;
+  r.samples = 12;
+  r.liquidLow = i % 7 == 0 ? 12 : 0;
+  return r;
+}
+
+static void writeHistory() {
+  uint32_t now = (uint32_t)time(nullptr);
+  firstRecord = now - now % 3600 - HISTORY_DAYS * 86400;
+  recordCount = (now - firstRecord) / SAMPLE_LOG_INTERVAL_S;
+  File file = LittleFS.open(SAMPLE_LOG_PATH, "w");
+  for (uint32_t i = 0; i < recordCount; i++) {
+    LogRecord r = record(i);
+    file.write((const uint8_t *)&r, sizeof(r));
+  }
+  file.close();
+}
+
+static SensorSnapshot snapshot(float temperature, float humidity, AlertStatus alert) {
+  SensorSnapshot snap = {};
+  snap.sampleUs = TimeService::monoUs();
+  snap.temperature = temperature;
+  snap.humidity = humidity;
+  snap.liquidLow = true;
+  snap.tempAlert = false;
+  snap.alert = alert;
+  return snap;
+}
+
+/* Labels longer than a bucket line's old 64-byte label buffer */
+#define LONG_LABELS "sink=\"smtp-relay.example.org:587\",tank=\"" TANK_NAME "\",pump=\"main\""
+
+static Log2Histogram<4, 4> latencyMs;
+
+static void writeMetrics(PromWriter &out) {
+  out.counter("tank_test_total", "Test counter", 42);
+  out.family("tank_latency_seconds", "histogram", "Test histogram");
+  out.histogramSeries("tank_latency_seconds", LONG_LABELS, latencyMs, 1e-3);
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_now_before_the_first_sample() {
+  Response r = fetch("/now");
+  TEST_ASSERT_EQUAL(503, r.status);
+  TEST_ASSERT_EQUAL_STRING("application/json", r.type.c_str());
+  TEST_ASSERT_EQUAL_STRING("{\"error\":\"no sample yet\"}", r.body.c_str());
+}
+
+static void test_now_returns_the_latest_sample() {
+  mailbox.publish(snapshot(24.5f, 55.25f, ALERT_SENT));
+  Response r = fetch("/now");
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_EQUAL_STRING("application/json", r.type.c_str());
+  TEST_ASSERT_EQUAL_STRING("no-store", r.cacheControl.c_str());
+  TEST_ASSERT_EQUAL((long)r.body.size(), r.contentLength);
+
+  const char *body = r.body.c_str();
+  TEST_ASSERT_NOT_NULL(strstr(body, "\"tank\":\"" TANK_NAME "\""));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\"temperature\":24.50,\"humidity\":55.25"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "\"liquid_low\":true,\"temp_alert\":false,\"alert\":\"sent\"}"));
+  const char *utc = strstr(body, "\"utc\":");
+  TEST_ASSERT_NOT_NULL(utc);
+  TEST_ASSERT_INT_WITHIN(2, (long)time(nullptr), atol(utc + 6));
+
+  /* A failed read is null, not NaN */
+  mailbox.publish(snapshot(NAN, NAN, ALERT_NONE));
+  r = fetch("/now");
+  TEST_ASSERT_NOT_NULL(strstr(r.body.c_str(), "\"temperature\":null,\"humidity\":null"));
+}
+
+static void test_history_is_streamed_in_chunks() {
+  char path[96];
+  uint32_t to = firstRecord + recordCount * SAMPLE_LOG_INTERVAL_S;
+  snprintf(path, sizeof(path), "/history?from=%lu&to=%lu&res=60", (unsigned long)firstRecord, (unsigned long)to);
+  Response r = fetch(path);
+
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_EQUAL_STRING("text/csv", r.type.c_str());
+  TEST_ASSERT_EQUAL_STRING("chunked", r.transferEncoding.c_str());
+  TEST_ASSERT_GREATER_THAN(r.body.size() / HTTP_CHUNK_SIZE, r.chunks);
+  TEST_ASSERT_LESS_OR_EQUAL(HTTP_CHUNK_SIZE, r.largestChunk);
+  TEST_ASSERT_EQUAL(recordCount + 1, countLines(r.body));
+  TEST_ASSERT_TRUE(r.body == streamed(firstRecord, to, 60));
+
+  /* Spot check one line against the record it came from */
+  LogRecord rec = record(1000);
+  char expected[80];
+  snprintf(expected, sizeof(expected), "\n%lu,%.2f,%.2f,%.2f,%.2f,%u,%u\n", (unsigned long)rec.time,
+           rec.tempAvg / 100.0f, rec.tempMin / 100.0f, rec.tempMax / 100.0f, rec.humAvg / 100.0f, rec.liquidLow,
+           rec.samples);
+  TEST_ASSERT_NOT_NULL(strstr(r.body.c_str(), expected));
+}
+
+static void test_history_resolution_and_relative_range() {
+  char path[96];
+  uint32_t to = firstRecord + HISTORY_DAYS * 86400 - 1;
+  snprintf(path, sizeof(path), "/history?from=%lu&to=%lu&res=3600", (unsigned long)firstRecord, (unsigned long)to);
+  Response r = fetch(path);
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_EQUAL(HISTORY_DAYS * 24 + 1, countLines(r.body));
+  TEST_ASSERT_NOT_NULL(strstr(r.body.c_str(), ",720\n"));   // 60 records of 12 samples per hour
+
+  /* Negative from/to count back from now; the default range is the last day */
+  r = fetch("/history?from=-3600");
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_INT_WITHIN(1, 60 + 1, (int)countLines(r.body));
+  r = fetch("/history");
+  TEST_ASSERT_INT_WITHIN(1, 1440 + 1, (int)countLines(r.body));
+}
+
+static void test_history_rejects_a_bad_range() {
+  Response r = fetch("/history?from=200&to=100");
+  TEST_ASSERT_EQUAL(400, r.status);
+  r = fetch("/history?res=0");
+  TEST_ASSERT_EQUAL(400, r.status);
+  TEST_ASSERT_EQUAL(404, fetch("/nope").status);
+}
+
+/* Requests on one connection, a chunked response between two fixed-length ones */
+static void test_keep_alive() {
+  Client client;
+  client.get("/now");
+  client.get("/history?from=-600");
+  client.get("/now");
+  Response first = readResponse(client);
+  Response history = readResponse(client);
+  Response last = readResponse(client);
+  TEST_ASSERT_EQUAL(200, first.status);
+  TEST_ASSERT_EQUAL_STRING("chunked", history.transferEncoding.c_str());
+  std::string header = history.body.substr(0, history.body.find('\n'));
+  TEST_ASSERT_EQUAL_STRING("time,temp_avg,temp_min,temp_max,humidity,liquid_low,samples", header.c_str());
+  TEST_ASSERT_TRUE(first.body == last.body);
+}
+
+/* A client dropping out of a download leaves the server serving the others */
+static void test_client_gone_mid_history() {
+  for (int i = 0; i < 3; i++) {
+    Client client;
+    client.get("/history?from=0&res=60");
+    Response r;
+    readHead(client, r);
+    client.bytes(100);
+    client.reset();
+  }
+  TEST_ASSERT_EQUAL(200, fetch("/now").status);
+}
+
+static void test_events_stream_samples_and_alerts() {
+  SensorSnapshot snap = snapshot(22.0f, 50.0f, ALERT_NONE);
+  feed.publish(snap);
+
+  Client client;
+  client.get("/events");
+  Response r;
+  readHead(client, r);
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_EQUAL_STRING("text/event-stream", r.type.c_str());
+  TEST_ASSERT_EQUAL_STRING("chunked", r.transferEncoding.c_str());
+
+  std::string data;
+  TEST_ASSERT_TRUE(readChunk(client, data));
+  TEST_ASSERT_EQUAL_STRING("retry: 5000\n\n", data.c_str());
+  TEST_ASSERT_TRUE(readChunk(client, data));   // the current state
+  TEST_ASSERT_EQUAL_STRING("event: sample\ndata: {", data.substr(0, 21).c_str());
+
+  snap.alert = ALERT_SENDING;
+  feed.publish(snap);
+  TEST_ASSERT_TRUE(readChunk(client, data));
+  TEST_ASSERT_EQUAL_STRING("event: alert\ndata: {", data.substr(0, 20).c_str());
+  TEST_ASSERT_NOT_NULL(strstr(data.c_str(), "\"alert\":\"sending\""));
+
+  snap.sampleUs++;
+  feed.publish(snap);
+  TEST_ASSERT_TRUE(readChunk(client, data));
+  TEST_ASSERT_EQUAL_STRING("event: sample\ndata: {", data.substr(0, 21).c_str());
+}
+
+static void test_metrics() {
+  Response r = fetch("/metrics");
+  TEST_ASSERT_EQUAL(200, r.status);
+  TEST_ASSERT_EQUAL_STRING("chunked", r.transferEncoding.c_str());
+  TEST_ASSERT_NOT_NULL(strstr(r.body.c_str(), "tank_test_total 42\n"));
+
+  /* 16 ms buckets: 5 below, 40 in the 64 ms one, 200 above */
+  latencyMs.observe(5);
+  latencyMs.observe(40);
+  latencyMs.observe(200);
+  r = fetch("/metrics");
+  const char *body = r.body.c_str();
+  TEST_ASSERT_NOT_NULL(strstr(body, "tank_latency_seconds_bucket{" LONG_LABELS ",le=\"0.016\"} 1\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "tank_latency_seconds_bucket{" LONG_LABELS ",le=\"0.064\"} 2\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "tank_latency_seconds_bucket{" LONG_LABELS ",le=\"+Inf\"} 3\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "tank_latency_seconds_sum{" LONG_LABELS "} 0.245\n"));
+  TEST_ASSERT_NOT_NULL(strstr(body, "tank_latency_seconds_count{" LONG_LABELS "} 3\n"));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  LittleFS.begin(true);
+  writeHistory();
+  sampleLog.begin();
+  server.attachFeed(&feed);
+  server.attachMetrics(writeMetrics);
+  if (!server.begin(0)) return 1;
+
+  UNITY_BEGIN();
+  RUN_TEST(test_now_before_the_first_sample);
+  RUN_TEST(test_now_returns_the_latest_sample);
+  RUN_TEST(test_history_is_streamed_in_chunks);
+  RUN_TEST(test_history_resolution_and_relative_range);
+  RUN_TEST(test_history_rejects_a_bad_range);
+  RUN_TEST(test_keep_alive);
+  RUN_TEST(test_client_gone_mid_history);
+  RUN_TEST(test_events_stream_samples_and_alerts);
+  RUN_TEST(test_metrics);
+  return UNITY_END();
+}
@@ -0,0 +1,114 @@
+//=====================================================================================================//
+// I2C BUS: batching and blocking calls
+// I2cBus on the Wire stand-in in test/native, with every device answering. Two LCD lines posted
+// while the worker is busy must go out as one bus transaction of both lines, and a blocking call
+// must not return before the worker is done, whoever else notifies the calling task meanwhile;
+// those notifications must still be pending afterwards.
+//
+//   pio test -e native -f test_i2c_bus
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <atomic>
+#include <unity.h>
+#include "i2c_bus.h"
+#include "i2c_lcd.h"
+#include "native_hal.h"
+
+#define FOREIGN_NOTIFICATIONS 5
+
+static I2cBus bus(Wire);
+static int8_t lcdDevice = -1;
+static std::atomic<bool> holding(false);
+static std::atomic<bool> release(false);
+
+/* Keeps the worker busy until released, so posts pile up in the queue behind it */
+static void hold(TwoWire &wire, void *arg) {
+  (void)wire, (void)arg;
+  holding = true;
+  while (!release) delay(1);
+}
+
+static void holdTask(void *arg) {
+  (void)arg;
+  bus.run(lcdDevice, hold, nullptr);
+  vTaskDelete(nullptr);
+}
+
+/* Runs on the worker: notifies the waiting caller several times before finishing */
+static void notifyCaller(TwoWire &wire, void *arg) {
+  (void)wire;
+  TaskHandle_t caller = static_cast<TaskHandle_t>(arg);
+  for (uint8_t i = 0; i < FOREIGN_NOTIFICATIONS; i++) {
+    xTaskNotifyGive(caller);
+    delay(2);
+  }
+}
+
+static bool waitRequests(uint32_t n) {
+  for (uint32_t waited = 0; waited < 2000; waited++) {
+    if (bus.stats(lcdDevice)->requests >= n) return true;
+    delay(1);
+  }
+  return false;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_two_lcd_lines_go_out_in_one_transaction() {
+  I2cLcd lcd(bus, lcdDevice);
+  uint32_t transactions = bus.stats(lcdDevice)->transactions;
+  uint32_t requests = bus.stats(lcdDevice)->requests;
+  uint32_t transmissions = Wire.transmissions;
+
+  holding = false;
+  release = false;
+  xTaskCreate(holdTask, "hold", 2048, nullptr, 1, nullptr);
+  while (!holding) delay(1);
+  TEST_ASSERT_TRUE(lcd.writeLine(0, "Tank 1   24.5 C "));
+  TEST_ASSERT_TRUE(lcd.writeLine(1, " TEMP IS NOT OK "));
+  release = true;
+
+  /* The held run() plus the two posts */
+  TEST_ASSERT_TRUE(waitRequests(requests + 3));
+  TEST_ASSERT_EQUAL(transactions + 2, bus.stats(lcdDevice)->transactions);
+  TEST_ASSERT_EQUAL(transmissions + 1, Wire.transmissions);
+  TEST_ASSERT_EQUAL(2 * (I2C_LCD_COLS + 1) * 4, Wire.lastLength);
+  TEST_ASSERT_EQUAL(0, bus.stats(lcdDevice)->errors);
+}
+
+static void test_blocking_call_waits_for_its_transaction() {
+  TaskHandle_t self = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, 0);
+  uint32_t requests = bus.stats(lcdDevice)->requests;
+
+  TEST_ASSERT_TRUE(bus.run(lcdDevice, notifyCaller, self));
+  TEST_ASSERT_EQUAL(requests + 1, bus.stats(lcdDevice)->requests);
+
+  /* The worker's own wakeup may land a moment after its completion flag */
+  delay(10);
+  TEST_ASSERT_EQUAL(FOREIGN_NOTIFICATIONS, ulTaskNotifyTake(pdTRUE, 0));
+
+  /* Blocking writes and reads still answer with the device's result */
+  uint8_t command = 0x08;
+  TEST_ASSERT_TRUE(bus.write(lcdDevice, &command, 1));
+  Wire.ack = false;
+  TEST_ASSERT_FALSE(bus.write(lcdDevice, &command, 1));
+  Wire.ack = true;
+  TEST_ASSERT_EQUAL(0, ulTaskNotifyTake(pdTRUE, 0));
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  Wire.ack = true;
+  if (!bus.begin()) return 1;
+  lcdDevice = bus.addDevice("lcd", I2C_LCD_ADDRESS, I2C_LCD_CLOCK);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_two_lcd_lines_go_out_in_one_transaction);
+  RUN_TEST(test_blocking_call_waits_for_its_transaction);
+  return UNITY_END();
+}
@@ -0,0 +1,212 @@
+//=====================================================================================================//
+// LEVEL DEBOUNCE: debounceStep() and the ULP program
+// debounceStep() is driven through bounce and sustained-change sequences. Then UlpLevelWatch
+// builds and loads its program into the ULP interpreter of test/native, and the program and
+// debounceStep() are stepped side by side over the same pin traces: stable level, run length,
+// transition count and wake requests must agree after every poll.
+//
+//   pio test -e native -f test_level_debounce
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <esp32/ulp.h>
+#include <unity.h>
+#include "level_debounce.h"
+#include "native_hal.h"
+#include "ulp_level_watch.h"
+
+#define LEVEL_PIN  13   // RTC IO 14
+#define BUTTON_PIN 15   // RTC IO 13
+
+static uint32_t rng = 12345;
+
+static uint32_t nextRandom() {
+  rng = rng * 1103515245 + 12345;
+  return rng >> 8;
+}
+
+/* Feeds `samples` and returns how many steps asked for a wake */
+static uint16_t feed(DebounceChannel &c, const char *samples, uint16_t limit, uint8_t wakeMask) {
+  uint16_t wakes = 0;
+  for (const char *p = samples; *p; p++) {
+    if (debounceStep(c, *p == '1', limit, wakeMask)) wakes++;
+  }
+  return wakes;
+}
+
+void setUp() {
+  nativeSetPin(LEVEL_PIN, LOW);
+  nativeSetPin(BUTTON_PIN, HIGH);
+  nativeUlpReadyForWakeup(true);
+}
+
+void tearDown() {}
+
+static void test_bounce_shorter_than_limit_is_ignored() {
+  DebounceChannel c;
+  debounceReset(c, 0);
+  TEST_ASSERT_EQUAL(0, feed(c, "1110111111111011111111101", LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+  TEST_ASSERT_EQUAL(0, c.stable);
+  TEST_ASSERT_EQUAL(0, c.transitions);
+  TEST_ASSERT_EQUAL(1, c.run);
+}
+
+static void test_sustained_change_flips_after_limit() {
+  DebounceChannel c;
+  debounceReset(c, 0);
+  for (uint16_t i = 1; i < LEVEL_DEBOUNCE_SAMPLES; i++) {
+    TEST_ASSERT_FALSE(debounceStep(c, 1, LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+    TEST_ASSERT_EQUAL(i, c.run);
+  }
+  TEST_ASSERT_TRUE(debounceStep(c, 1, LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+  TEST_ASSERT_EQUAL(1, c.stable);
+  TEST_ASSERT_EQUAL(0, c.run);
+  TEST_ASSERT_EQUAL(1, c.transitions);
+
+  /* Holding the new level is not another transition */
+  TEST_ASSERT_EQUAL(0, feed(c, "1111111111111111111111111", LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+  TEST_ASSERT_EQUAL(1, c.transitions);
+}
+
+static void test_wake_mask_selects_the_new_level() {
+  DebounceChannel c;
+  debounceReset(c, 1);
+  /* Button: pressed (low) wakes, released does not */
+  TEST_ASSERT_EQUAL(1, feed(c, "000", BUTTON_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW));
+  TEST_ASSERT_EQUAL(0, feed(c, "111", BUTTON_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW));
+  TEST_ASSERT_EQUAL(2, c.transitions);
+  TEST_ASSERT_EQUAL(2, feed(c, "000111", BUTTON_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW | DEBOUNCE_WAKE_HIGH));
+  TEST_ASSERT_EQUAL(0, feed(c, "000111", BUTTON_DEBOUNCE_SAMPLES, 0));
+  TEST_ASSERT_EQUAL(6, c.transitions);
+}
+
+static void test_transitions_wrap() {
+  DebounceChannel c;
+  debounceReset(c, 0);
+  c.transitions = 0xFFFF;
+  feed(c, "111", BUTTON_DEBOUNCE_SAMPLES, 0);
+  TEST_ASSERT_EQUAL(0, c.transitions);
+}
+
+/* Level sloshing while the tank is topped up: bursts of noise, then a settled level */
+static void test_sloshing_then_settled() {
+  DebounceChannel c;
+  debounceReset(c, 0);
+  uint16_t wakes = 0;
+  for (uint16_t burst = 0; burst < 50; burst++) {
+    for (uint16_t i = 0; i < 30; i++) {
+      uint8_t sample = (i % (1 + nextRandom() % (LEVEL_DEBOUNCE_SAMPLES - 1))) == 0;
+      if (debounceStep(c, sample, LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_LOW | DEBOUNCE_WAKE_HIGH)) wakes++;
+    }
+  }
+  TEST_ASSERT_EQUAL(0, wakes);
+  TEST_ASSERT_EQUAL(0, feed(c, "000000000000", LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+  TEST_ASSERT_EQUAL(1, feed(c, "111111111111", LEVEL_DEBOUNCE_SAMPLES, DEBOUNCE_WAKE_HIGH));
+}
+
+static void test_ulp_program_loads() {
+  UlpLevelWatch watch(LEVEL_PIN, BUTTON_PIN);
+  TEST_ASSERT_TRUE(watch.begin(true));
+  TEST_ASSERT_TRUE(watch.running());
+  TEST_ASSERT_LESS_OR_EQUAL(CONFIG_ULP_COPROC_RESERVE_MEM / 4, ULP_PROG_START + nativeUlpProgramWords());
+
+  /* Started from the pin levels: no transition, no wake */
+  DebounceChannel level = watch.channel(ULP_CH_LEVEL), button = watch.channel(ULP_CH_BUTTON);
+  TEST_ASSERT_EQUAL(0, level.stable);
+  TEST_ASSERT_EQUAL(1, button.stable);
+  TEST_ASSERT_EQUAL(0, nativeUlpRun());
+  TEST_ASSERT_EQUAL(0, watch.takeWakeBits());
+  TEST_ASSERT_EQUAL(1, watch.ticks());
+}
+
+/* Random traces with bounces of every length around both limits, the ULP against the model */
+static void test_ulp_matches_debounce_step() {
+  UlpLevelWatch watch(LEVEL_PIN, BUTTON_PIN);
+  TEST_ASSERT_TRUE(watch.begin(true));
+
+  DebounceChannel model[ULP_CHANNELS];
+  debounceReset(model[ULP_CH_LEVEL], 0);
+  debounceReset(model[ULP_CH_BUTTON], 1);
+  const uint16_t limits[ULP_CHANNELS] = {LEVEL_DEBOUNCE_SAMPLES, BUTTON_DEBOUNCE_SAMPLES};
+  const uint8_t masks[ULP_CHANNELS] = {DEBOUNCE_WAKE_LOW | DEBOUNCE_WAKE_HIGH, DEBOUNCE_WAKE_LOW};
+  const uint8_t pins[ULP_CHANNELS] = {LEVEL_PIN, BUTTON_PIN};
+
+  uint8_t level[ULP_CHANNELS] = {0, 1};
+  uint16_t hold[ULP_CHANNELS] = {0, 0};
+  uint8_t pendingWake = 0;
+  uint32_t wakes = 0, flips = 0;
+
+  for (uint32_t poll = 1; poll <= 20000; poll++) {
+    /* Each pin holds a level for 1 to 2 x its limit polls, then toggles */
+    for (uint8_t ch = 0; ch < ULP_CHANNELS; ch++) {
+      if (hold[ch] == 0) {
+        level[ch] ^= 1;
+        hold[ch] = 1 + nextRandom() % (2 * limits[ch]);
+      }
+      hold[ch]--;
+      nativeSetPin(pins[ch], level[ch]);
+    }
+
+    /* The main CPU is awake (not ready for a wake) now and then */
+    bool ready = nextRandom() % 8 != 0;
+    nativeUlpReadyForWakeup(ready);
+
+    for (uint8_t ch = 0; ch < ULP_CHANNELS; ch++) {
+      uint16_t before = model[ch].transitions;
+      if (debounceStep(model[ch], level[ch], limits[ch], masks[ch])) pendingWake |= 1 << ch;
+      flips += model[ch].transitions - before;
+    }
+    int woke = nativeUlpRun();
+    TEST_ASSERT_NOT_EQUAL(-1, woke);
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)poll, watch.ticks());
+
+    for (uint8_t ch = 0; ch < ULP_CHANNELS; ch++) {
+      DebounceChannel ulp = watch.channel((UlpChannel)ch);
+      char msg[48];
+      snprintf(msg, sizeof(msg), "poll %lu channel %u", (unsigned long)poll, ch);
+      TEST_ASSERT_EQUAL_UINT16_MESSAGE(model[ch].stable, ulp.stable, msg);
+      TEST_ASSERT_EQUAL_UINT16_MESSAGE(model[ch].run, ulp.run, msg);
+      TEST_ASSERT_EQUAL_UINT16_MESSAGE(model[ch].transitions, ulp.transitions, msg);
+    }
+
+    /* A pending request wakes the SoC as soon as it is ready; the woken CPU takes the bits */
+    TEST_ASSERT_EQUAL(pendingWake && ready, woke);
+    if (woke) {
+      TEST_ASSERT_EQUAL(pendingWake, watch.takeWakeBits());
+      pendingWake = 0;
+      wakes++;
+    }
+  }
+
+  TEST_ASSERT_GREATER_THAN(100, flips);
+  TEST_ASSERT_GREATER_THAN(50, wakes);
+}
+
+/* begin() without force keeps a program that survived deep sleep, with its counts */
+static void test_ulp_survives_warm_begin() {
+  UlpLevelWatch watch(LEVEL_PIN, BUTTON_PIN);
+  TEST_ASSERT_TRUE(watch.begin(true));
+  nativeSetPin(BUTTON_PIN, LOW);
+  for (uint8_t i = 0; i < BUTTON_DEBOUNCE_SAMPLES; i++) nativeUlpRun();
+  TEST_ASSERT_EQUAL(1, watch.channel(ULP_CH_BUTTON).transitions);
+
+  TEST_ASSERT_TRUE(watch.begin());
+  TEST_ASSERT_EQUAL(1, watch.channel(ULP_CH_BUTTON).transitions);
+  TEST_ASSERT_EQUAL(1 << ULP_CH_BUTTON, watch.takeWakeBits());
+  TEST_ASSERT_EQUAL(0, watch.takeWakeBits());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_bounce_shorter_than_limit_is_ignored);
+  RUN_TEST(test_sustained_change_flips_after_limit);
+  RUN_TEST(test_wake_mask_selects_the_new_level);
+  RUN_TEST(test_transitions_wrap);
+  RUN_TEST(test_sloshing_then_settled);
+  RUN_TEST(test_ulp_program_loads);
+  RUN_TEST(test_ulp_matches_debounce_step);
+  RUN_TEST(test_ulp_survives_warm_begin);
+  return UNITY_END();
+}
@@ -0,0 +1,307 @@
+//=====================================================================================================//
+// MB_STRING: short strings inline
+// The mail client's MB_String keeps strings shorter than MB_STRING_SSO_SIZE characters inside the
+// object. Growing past the inline buffer, shrinking back into it (erase, shrink_to_fit, resize),
+// copies and moves from an inline string, and inserts and erases across the boundary must all keep
+// the contents, checked against std::string; a string must never point into another object.
+// The micro-benchmarks print the time and malloc calls of the string operations a send makes most.
+// native_mail_heap_strings builds the same suites with MB_STRING_SSO_SIZE=1 (short strings on the
+// heap, as upstream keeps them), so this suite and test_smtp_arena print the before figures there.
+//
+//   pio test -e native_mail -f test_mb_string
+//   pio test -e native_mail_heap_strings
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <ESP_Mail_Client.h>
+#include <new>
+#include <string>
+#include <unity.h>
+#include <vector>
+#include "native_hal.h"
+
+#define FUZZ_ROUNDS 20000
+#define BENCH_OPS   200000
+
+/* glibc's own entry points, under the malloc family defined below */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+
+/* Counted on this thread only, between countAllocations(true) and (false) */
+static thread_local bool counting;
+static thread_local uint32_t allocations;
+
+static void countAllocations(bool on) {
+  if (on) allocations = 0;
+  counting = on;
+}
+
+extern "C" void *malloc(size_t size) {
+  if (counting) allocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+  if (counting) allocations++;
+  return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+  if (counting) allocations++;
+  return __libc_realloc(p, size);
+}
+
+void *operator new(size_t size) {
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+static bool isInline(const MB_String &s) {
+  const char *p = s.c_str(), *self = (const char *)&s;
+  return p >= self && p < self + sizeof(s);
+}
+
+/* Contents and buffer checked together: inline exactly when short, never someone else's memory */
+static void checkString(const MB_String &s, const std::string &expected, const char *where) {
+  TEST_ASSERT_EQUAL_MESSAGE(expected.size(), s.length(), where);
+  TEST_ASSERT_EQUAL_STRING_MESSAGE(expected.c_str(), s.c_str(), where);
+  TEST_ASSERT_TRUE_MESSAGE(s.bufferLength() > s.length() || expected.empty(), where);
+  if (isInline(s)) TEST_ASSERT_LESS_THAN_MESSAGE(MB_STRING_SSO_SIZE, expected.size(), where);
+}
+
+/* `len` letters of the alphabet, from `from` on and round again */
+static std::string letters(size_t len, char from = 'a') {
+  char base = from >= 'a' ? 'a' : 'A';
+  std::string s;
+  for (size_t i = 0; i < len; i++) s += (char)(base + (from - base + i) % 26);
+  return s;
+}
+
+void setUp() { randomSeed(47); }
+void tearDown() {}
+
+static void test_short_strings_never_allocate() {
+#if MB_STRING_SSO_SIZE > 1
+  for (size_t len = 0; len < MB_STRING_SSO_SIZE; len++) {
+    std::string text = letters(len);
+    countAllocations(true);
+    {
+      MB_String s = text.c_str();
+      MB_String copy = s;
+      copy += "";
+      TEST_ASSERT_TRUE(len == 0 || (isInline(s) && isInline(copy)));
+      TEST_ASSERT_EQUAL_STRING(text.c_str(), copy.c_str());
+    }
+    countAllocations(false);
+    TEST_ASSERT_EQUAL(0, allocations);
+  }
+#else
+  TEST_IGNORE_MESSAGE("short strings are on the heap in this env");
+#endif
+}
+
+/* One character at a time from empty to well past the inline buffer */
+static void test_growth_keeps_the_contents() {
+  MB_String s;
+  std::string expected;
+  for (int i = 0; i < 200; i++) {
+    char c[2] = {(char)('a' + i % 26), '\0'};
+    s += c;
+    expected += c;
+    checkString(s, expected, "append");
+  }
+  TEST_ASSERT_FALSE(isInline(s));
+
+  /* And in one step from inline to a large buffer */
+  MB_String t = "short";
+  t.reserve(500);
+  TEST_ASSERT_EQUAL_STRING("short", t.c_str());
+  TEST_ASSERT_GREATER_OR_EQUAL(501, t.bufferLength());
+}
+
+static void test_shrink_back_inline() {
+  std::string expected = letters(100);
+
+  MB_String s = expected.c_str();
+  s.erase(10);
+  expected.erase(10);
+  checkString(s, expected, "erase");
+#if MB_STRING_SSO_SIZE > 1
+  TEST_ASSERT_TRUE(isInline(s));
+#endif
+
+  /* The last length that fits and the first that does not */
+  for (size_t len = MB_STRING_SSO_SIZE - 2; len <= MB_STRING_SSO_SIZE + 1; len++) {
+    MB_String t = letters(100).c_str();
+    t.resize(len);
+    checkString(t, letters(len), "resize");
+    MB_String u = letters(100).c_str();
+    u.erase(len);
+    u.shrink_to_fit();
+    checkString(u, letters(len), "shrink_to_fit");
+  }
+
+  /* Emptied, then short again */
+  MB_String v = letters(100).c_str();
+  v.clear();
+  countAllocations(true);
+  v = "250";
+  countAllocations(false);
+  checkString(v, "250", "reuse");
+#if MB_STRING_SSO_SIZE > 1
+  TEST_ASSERT_EQUAL(0, allocations);
+#endif
+}
+
+/* MB_String has no move constructor: std::move copies, and the library's vectors copy on growth */
+static void test_move_from_inline() {
+  MB_String a = "inline";
+  MB_String b = std::move(a);
+  checkString(b, "inline", "move");
+  TEST_ASSERT_TRUE(b.c_str() != a.c_str());
+  a = "changed";
+  checkString(b, "inline", "move source changed");
+
+  MB_String heap = letters(100).c_str();
+  heap = std::move(b);
+  checkString(heap, "inline", "move into a heap string");
+  b = std::move(heap);
+  checkString(b, "inline", "move back");
+
+  MB_String sum = MB_String("abc") + 'd';
+  checkString(sum, "abcd", "operator+ on a temporary");
+
+  std::vector<MB_String> list;
+  std::vector<std::string> expected;
+  for (int i = 0; i < 100; i++) {
+    expected.push_back(letters(i % 40, 'A'));
+    list.push_back(MB_String(expected.back().c_str()));
+  }
+  const char *first = (const char *)list.data(), *last = (const char *)(list.data() + list.size());
+  for (size_t i = 0; i < list.size(); i++) {
+    checkString(list[i], expected[i], "vector");
+    const char *p = list[i].c_str();
+    TEST_ASSERT_TRUE(isInline(list[i]) || p < first || p >= last);
+  }
+}
+
+/* Random inserts, erases and appends around MB_STRING_SSO_SIZE, against std::string */
+static void test_erase_insert_across_the_boundary() {
+  MB_String s;
+  std::string expected;
+  for (uint32_t round = 0; round < FUZZ_ROUNDS; round++) {
+    char where[40];
+    snprintf(where, sizeof(where), "round %u", (unsigned)round);
+    size_t len = expected.size();
+    std::string piece = letters(random(1, 12), (char)('a' + random(26)));
+    switch (random(5)) {
+    case 0:   // insert() leaves an empty string and positions past the end alone
+      if (len > 0) {
+        size_t pos = random(len + 1);
+        s.insert(pos, piece.c_str());
+        if (pos < len) expected.insert(pos, piece);
+      }
+      break;
+    case 1: {
+      size_t pos = random(len + 1), n = random(1, 8);
+      s.insert(pos, n, '#');
+      expected.insert(pos, n, '#');
+      break;
+    }
+    case 2:
+    case 3:
+      if (len > 0) {
+        size_t index = random(len), count = random(1, len - index + 1);
+        s.erase(index, count);
+        expected.erase(index, count);
+      }
+      break;
+    default:
+      if (len < 2 * MB_STRING_SSO_SIZE) {
+        s += piece.c_str();
+        expected += piece;
+      }
+      break;
+    }
+    checkString(s, expected, where);
+  }
+}
+
+/* Trailing zeros trimmed, precision capped at 9 places */
+static void test_float_to_string() {
+  checkString(MB_String(23.456f, 2), "23.46", "float");
+  checkString(MB_String(-0.5, 3), "-0.5", "double");
+  checkString(MB_String((long double)2.25L, 4), "2.25", "long double");
+  MB_String third;
+  third.appendNum(1.0 / 3, 20);
+  checkString(third, "0.333333333", "appendNum");
+}
+
+static volatile size_t benchSink;
+
+/* The string operations of a send, timed and their malloc calls counted */
+template <typename F> static void bench(const char *name, F op) {
+  size_t sink = 0;
+  countAllocations(true);
+  uint32_t start = micros();
+  for (int i = 0; i < BENCH_OPS; i++) sink += op(i);
+  uint32_t us = micros() - start;
+  countAllocations(false);
+  benchSink = sink;
+  Serial.printf("  %-32s %6.1f ns, %.2f malloc per op\n", name, us * 1000.0f / BENCH_OPS,
+                (float)allocations / BENCH_OPS);
+}
+
+static void test_micro_benchmark() {
+  nativeSerialEcho(true);
+  Serial.printf("MB_String, MB_STRING_SSO_SIZE %u, sizeof %u:\n", (unsigned)MB_STRING_SSO_SIZE,
+                (unsigned)sizeof(MB_String));
+  bench("reply code \"250\"", [](int) {
+    MB_String s = "250";
+    return s.length();
+  });
+  bench("\"MAIL FROM:<\" + address + \">\"", [](int) {
+    MB_String s = "MAIL FROM:<";
+    s += "sam@ex.io";
+    s += ">";
+    return s.length();
+  });
+  bench("copy of \"text/plain\"", [](int i) {
+    static MB_String a = "text/plain";
+    MB_String b = a;
+    return b.length() + i % 2;
+  });
+  bench("number to string", [](int i) {
+    MB_String s = i;
+    return s.length();
+  });
+  bench("40-character header line", [](int) {
+    MB_String s = "Subject: ";
+    s += "Tank 1: temperature high, 31.25 C";
+    return s.length();
+  });
+  nativeSerialEcho(false);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_short_strings_never_allocate);
+  RUN_TEST(test_growth_keeps_the_contents);
+  RUN_TEST(test_shrink_back_inline);
+  RUN_TEST(test_move_from_inline);
+  RUN_TEST(test_erase_insert_across_the_boundary);
+  RUN_TEST(test_float_to_string);
+  RUN_TEST(test_micro_benchmark);
+  return UNITY_END();
+}
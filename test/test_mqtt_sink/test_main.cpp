@@ -0,0 +1,142 @@
+//=====================================================================================================//
+// MQTT SINK: alert delivery
+// sendAlert() against the MQTT client stand-in, with the test playing the broker. An alert state
+// counts as delivered only once its PUBACK came back: retrying before that must neither report
+// success nor queue another copy, an expired message is queued again, and of two states queued
+// while offline only the acknowledgement of the later one counts.
+//
+//   pio test -e native -f test_mqtt_sink
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <mqtt_client.h>
+#include <thread>
+#include <unity.h>
+#include "mqtt_sink.h"
+#include "native_hal.h"
+
+static TimeService clock_;
+
+/* Broker side: PUBACKs message `index` of the outbox once it has been queued */
+static void ackWhenQueued(size_t index) {
+  for (uint32_t waited = 0; nativeMqttQueued() <= index; waited++) {
+    if (waited > MQTT_ALERT_TIMEOUT_MS) return;
+    delay(1);
+  }
+  nativeMqttEvent(MQTT_EVENT_PUBLISHED, nativeMqttMessage(index).msgId);
+}
+
+/* Broker side: PUBACKs a message that is already queued, once sendAlert() is waiting for it */
+static void ackLater(int msgId) {
+  delay(20);
+  nativeMqttEvent(MQTT_EVENT_PUBLISHED, msgId);
+}
+
+static size_t alertMessages(const char *kind) {
+  std::string topic = std::string("crystaltronics/tank_1/alert/") + kind;
+  size_t n = 0;
+  for (size_t i = 0; i < nativeMqttQueued(); i++) {
+    if (nativeMqttMessage(i).topic == topic) n++;
+  }
+  return n;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_alert_is_delivered_on_its_puback() {
+  MqttSink sink(clock_, "Tank 1");
+  TEST_ASSERT_TRUE(sink.begin("mqtt://broker"));
+  nativeMqttEvent(MQTT_EVENT_CONNECTED);
+
+  size_t next = nativeMqttQueued();
+  std::thread broker(ackWhenQueued, next);
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, true, 0));
+  broker.join();
+
+  NativeMqttMessage m = nativeMqttMessage(next);
+  TEST_ASSERT_EQUAL_STRING("crystaltronics/tank_1/alert/liquid_low", m.topic.c_str());
+  TEST_ASSERT_EQUAL(1, m.qos);
+  TEST_ASSERT_TRUE(m.retain);
+  TEST_ASSERT_EQUAL_STRING("{\"active\":1,", m.payload.substr(0, 12).c_str());
+
+  /* The broker has it: nothing more to send */
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, true, 0));
+  TEST_ASSERT_EQUAL(next + 1, nativeMqttQueued());
+  TEST_ASSERT_EQUAL(1, sink.stats().alerts);
+  TEST_ASSERT_EQUAL(1, sink.stats().acked);
+}
+
+/* The retry the old code answered with "delivered" while the message sat unacknowledged */
+static void test_retry_before_the_puback_is_not_delivered() {
+  MqttSink sink(clock_, "Tank 1");
+  TEST_ASSERT_TRUE(sink.begin("mqtt://broker"));
+  size_t before = alertMessages("temperature");
+
+  TEST_ASSERT_FALSE(sink.sendAlert(MQTT_ALERT_TEMPERATURE, true, 0));
+  TEST_ASSERT_FALSE(sink.sendAlert(MQTT_ALERT_TEMPERATURE, true, 0));
+  TEST_ASSERT_EQUAL(before + 1, alertMessages("temperature"));   // one copy in the outbox
+  int msgId = nativeMqttMessage(nativeMqttQueued() - 1).msgId;
+
+  /* Reconnected: the retry waits for the copy already queued */
+  nativeMqttEvent(MQTT_EVENT_CONNECTED);
+  std::thread broker(ackLater, msgId);
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_TEMPERATURE, true, 0));
+  broker.join();
+  TEST_ASSERT_EQUAL(before + 1, alertMessages("temperature"));
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_TEMPERATURE, true, 0));
+}
+
+static void test_expired_alert_is_queued_again() {
+  MqttSink sink(clock_, "Tank 1");
+  TEST_ASSERT_TRUE(sink.begin("mqtt://broker"));
+  size_t before = alertMessages("heap");
+
+  TEST_ASSERT_FALSE(sink.sendAlert(MQTT_ALERT_HEAP, true, 0));
+  nativeMqttEvent(MQTT_EVENT_DELETED, nativeMqttMessage(nativeMqttQueued() - 1).msgId);
+  TEST_ASSERT_EQUAL(1, sink.stats().expired);
+
+  nativeMqttEvent(MQTT_EVENT_CONNECTED);
+  std::thread broker(ackWhenQueued, nativeMqttQueued());
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_HEAP, true, 0));
+  broker.join();
+  TEST_ASSERT_EQUAL(before + 2, alertMessages("heap"));
+}
+
+/* Raised and cleared while offline: both go out, the broker ends up with the later one */
+static void test_later_state_supersedes_a_queued_one() {
+  MqttSink sink(clock_, "Tank 1");
+  TEST_ASSERT_TRUE(sink.begin("mqtt://broker"));
+
+  TEST_ASSERT_FALSE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, true, 0));
+  int raised = nativeMqttMessage(nativeMqttQueued() - 1).msgId;
+  TEST_ASSERT_FALSE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, false, 0));
+  int cleared = nativeMqttMessage(nativeMqttQueued() - 1).msgId;
+  TEST_ASSERT_NOT_EQUAL(raised, cleared);
+
+  nativeMqttEvent(MQTT_EVENT_CONNECTED);
+  nativeMqttEvent(MQTT_EVENT_PUBLISHED, raised);   // not the state the broker ends up with
+  size_t queued = nativeMqttQueued();
+  std::thread broker(ackLater, cleared);
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, false, 0));
+  broker.join();
+  TEST_ASSERT_EQUAL(queued, nativeMqttQueued());
+
+  /* Raising it again is a new message */
+  std::thread again(ackWhenQueued, queued);
+  TEST_ASSERT_TRUE(sink.sendAlert(MQTT_ALERT_LIQUID_LOW, true, 0));
+  again.join();
+  TEST_ASSERT_EQUAL(queued + 1, nativeMqttQueued());
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  UNITY_BEGIN();
+  RUN_TEST(test_alert_is_delivered_on_its_puback);
+  RUN_TEST(test_retry_before_the_puback_is_not_delivered);
+  RUN_TEST(test_expired_alert_is_queued_again);
+  RUN_TEST(test_later_state_supersedes_a_queued_one);
+  return UNITY_END();
+}
@@ -0,0 +1,309 @@
+//=====================================================================================================//
+// SMTP ARENA: allocator calls per send
+// The alert email, built the way SmtpAlertSink::deliver() builds it, goes through the mail client
+// (the fork in lib/) to the SMTP server stand-in on 127.0.0.1. It is sent with and without
+// MB_StringArena while malloc/calloc/realloc/free count their calls on the sending thread. The
+// server must receive the same mail both ways. Strings that outlive a send, like the session's
+// last result, must keep their contents without leaving the arena less room send after send. A
+// send that fills the arena must go on with the heap.
+// The benchmark prints the calls per send both ways and the arena's high water mark.
+//
+//   pio test -e native_mail -f test_smtp_arena
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <ESP_Mail_Client.h>
+#include <WiFi.h>
+#include <new>
+#include <string>
+#include <unity.h>
+#include "native_hal.h"
+
+#define BENCH_SENDS 20
+#define ARENA_BYTES 4096   // SMTP_ARENA_BYTES in main.cpp
+
+/* glibc's own entry points, under the malloc family defined below */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+struct AllocCalls {
+  uint32_t allocs;     // malloc, calloc, operator new
+  uint32_t reallocs;
+  uint32_t frees;
+};
+
+/* Counted on this thread only, between countAllocations(true) and (false) */
+static thread_local bool counting;
+static thread_local AllocCalls calls;
+
+static void countAllocations(bool on) {
+  if (on) calls = AllocCalls();
+  counting = on;
+}
+
+extern "C" void *malloc(size_t size) {
+  if (counting) calls.allocs++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size) {
+  if (counting) calls.allocs++;
+  return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *p, size_t size) {
+  if (counting) calls.reallocs++;
+  return __libc_realloc(p, size);
+}
+
+extern "C" void free(void *p) {
+  if (counting && p) calls.frees++;
+  __libc_free(p);
+}
+
+void *operator new(size_t size) {
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+static WiFiClient tcp;
+static SMTPSession smtp;
+static Session_Config config;
+
+static const char *const SUBJECT = "RE: TEMPERATURE. PLEASE CHECK TANK! - Sent from ESP board";   // sent as RFC 2047
+static const char *const BODY = "Current temperature is not within threshold! Temperature is currently 31.46°C "
+                                "(limits 20 to 30°C). Please check Tank 1. (Reading taken 2026-10-19 10:00:00 UTC)";
+
+/* The mail client asks an external client's owner to bring the network up and report on it */
+static void networkConnection() {}
+static void networkStatus() { smtp.setNetworkStatus(true); }
+
+/* SmtpAlertSink::deliver() without the sink: the same message, connect, send, close */
+static bool sendAlert(MB_StringArena *arena) {
+  if (arena) arena->begin();
+  bool sent = false;
+  {
+    SMTP_Message message;
+    message.sender.name = F("ESP");
+    message.sender.email = "proto01crystaltronics@gmail.com";
+    message.subject = SUBJECT;
+    message.addRecipient(F("Sam"), "sam@example.com");
+    message.text.nonCopyContent = BODY;
+    message.text.charSet = "us-ascii";
+    message.text.transfer_encoding = Content_Transfer_Encoding::enc_7bit;
+    message.priority = esp_mail_smtp_priority::esp_mail_smtp_priority_low;
+    message.response.notify = esp_mail_smtp_notify_success | esp_mail_smtp_notify_failure | esp_mail_smtp_notify_delay;
+    message.enable.chunking = true;
+
+    sent = smtp.connect(&config) && MailClient.sendMail(&smtp, &message);
+  }
+  if (arena) arena->end();
+  return sent;
+}
+
+/* The last mail received, without the lines that differ from send to send */
+static std::string lastMail() {
+  std::string data = nativeSmtpMail(nativeSmtpReceived() - 1).data, kept;
+  size_t at = 0;
+  while (at < data.size()) {
+    size_t end = data.find("\r\n", at);
+    end = end == std::string::npos ? data.size() : end + 2;
+    std::string line = data.substr(at, end - at);
+    if (line.compare(0, 5, "Date:") != 0 && line.compare(0, 11, "Message-ID:") != 0) kept += line;
+    at = end;
+  }
+  return kept;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_alert_reaches_the_server() {
+  size_t before = nativeSmtpReceived();
+  TEST_ASSERT_TRUE(sendAlert(nullptr));
+  TEST_ASSERT_EQUAL(before + 1, nativeSmtpReceived());
+  NativeSmtpMail mail = nativeSmtpMail(before);
+  TEST_ASSERT_EQUAL(1, mail.to.size());
+  TEST_ASSERT_TRUE(mail.data.find("\r\nSubject: =?utf-8?B?UkU6IFRFTVBFUkFUVVJFLi") != std::string::npos);
+  TEST_ASSERT_TRUE(mail.data.find(BODY) != std::string::npos);
+}
+
+static void test_arena_send_matches_heap_send() {
+  static uint32_t mem[ARENA_BYTES / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  TEST_ASSERT_TRUE(sendAlert(nullptr));
+  std::string heapMail = lastMail();
+  TEST_ASSERT_TRUE(sendAlert(&arena));
+  TEST_ASSERT_TRUE(heapMail == lastMail());
+
+  TEST_ASSERT_GREATER_THAN(0, arena.allocations());
+  TEST_ASSERT_EQUAL(0, arena.overflows());
+  TEST_ASSERT_LESS_OR_EQUAL(sizeof(mem), arena.highWater());
+}
+
+/* 256 bytes hold a few strings of a send, the rest must come from the heap */
+static void test_full_arena_falls_back_to_heap() {
+  static uint32_t mem[256 / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  TEST_ASSERT_TRUE(sendAlert(nullptr));
+  std::string heapMail = lastMail();
+  TEST_ASSERT_TRUE(sendAlert(&arena));
+  TEST_ASSERT_TRUE(heapMail == lastMail());
+  TEST_ASSERT_GREATER_THAN(0, arena.allocations());
+  TEST_ASSERT_GREATER_THAN(0, arena.overflows());
+
+  /* A string that outgrows the arena moves to the heap with its contents */
+  arena.begin();
+  MB_String s = "carved from the arena";
+  for (int i = 0; i < 20; i++) s += " and grown past it";
+  TEST_ASSERT_EQUAL(21 + 20 * 18, s.length());
+  TEST_ASSERT_EQUAL_STRING_LEN("carved from the arena and grown past it and", s.c_str(), 43);
+  s.clear();
+  arena.end();
+}
+
+/* A string assigned during a send and freed after it, as a status text kept for later */
+static void test_survivor_keeps_its_contents() {
+  static uint32_t mem[ARENA_BYTES / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  MB_String *kept = new MB_String();
+
+  arena.begin();
+  MB_String temporary = "gone at the end of the send";
+  *kept = "assigned during the send, read after it";
+  temporary.clear();
+  arena.end();
+  TEST_ASSERT_EQUAL(1, arena.survivors());
+  TEST_ASSERT_GREATER_THAN(0, arena.used());
+
+  /* The next sends carve around it */
+  for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(sendAlert(&arena));
+  TEST_ASSERT_EQUAL_STRING("assigned during the send, read after it", kept->c_str());
+  TEST_ASSERT_EQUAL(0, arena.overflows());
+
+  delete kept;
+  smtp.sendingResult.clear();
+  arena.begin();
+  arena.end();
+  TEST_ASSERT_EQUAL(0, arena.used());
+  TEST_ASSERT_EQUAL(0, arena.survivors());
+}
+
+/* Random strings made, grown and freed across transactions, some kept for a few of them */
+static void test_random_strings_keep_their_contents() {
+  static uint32_t mem[1024 / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  randomSeed(46);
+  MB_String strings[16];
+  std::string expected[16];
+  for (int round = 0; round < 2000; round++) {
+    arena.begin();
+    for (int step = 0; step < 6; step++) {
+      int i = random(16);
+      if (random(3) == 0) {
+        strings[i].clear();
+        expected[i].clear();
+      } else {
+        std::string piece(random(8, 80), (char)('a' + random(26)));
+        strings[i] += piece.c_str();
+        expected[i] += piece;
+      }
+    }
+    arena.end();
+    for (int i = 0; i < 16; i++) TEST_ASSERT_EQUAL_STRING(expected[i].c_str(), strings[i].c_str());
+    /* Most strings are temporaries of one transaction */
+    for (int i = 0; i < 16; i++) {
+      if (random(3)) {
+        strings[i].clear();
+        expected[i].clear();
+      }
+    }
+  }
+  for (int i = 0; i < 16; i++) strings[i].clear();
+  arena.begin();
+  arena.end();
+  TEST_ASSERT_EQUAL(0, arena.used());
+  TEST_ASSERT_EQUAL(0, arena.survivors());
+}
+
+/* The session keeps the last send's result, subject included, until the next send replaces it */
+static void test_session_result_never_fills_the_arena() {
+  static uint32_t mem[ARENA_BYTES / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  TEST_ASSERT_TRUE(sendAlert(&arena));
+  size_t kept = arena.survivors();
+  TEST_ASSERT_GREATER_THAN(0, kept);
+  for (int i = 0; i < 5 * BENCH_SENDS; i++) {
+    TEST_ASSERT_TRUE(sendAlert(&arena));
+    TEST_ASSERT_EQUAL(kept, arena.survivors());
+    TEST_ASSERT_EQUAL(1, smtp.sendingResult.size());
+    TEST_ASSERT_EQUAL_STRING(SUBJECT, smtp.sendingResult.getItem(0).subject.c_str());
+  }
+  TEST_ASSERT_EQUAL(0, arena.overflows());
+  smtp.sendingResult.clear();
+}
+
+static void test_allocations_per_send_benchmark() {
+  static uint32_t mem[ARENA_BYTES / 4];
+  static MB_StringArena arena(mem, sizeof(mem));
+  AllocCalls perSend[2];
+  uint32_t us[2];
+
+  for (int pass = 0; pass < 2; pass++) {
+    MB_StringArena *use = pass ? &arena : nullptr;
+    sendAlert(use);   // first use of the session's own buffers
+    countAllocations(true);
+    uint32_t start = micros();
+    for (int i = 0; i < BENCH_SENDS; i++) TEST_ASSERT_TRUE(sendAlert(use));
+    us[pass] = (micros() - start) / BENCH_SENDS;
+    countAllocations(false);
+    perSend[pass] = calls;
+  }
+  TEST_ASSERT_EQUAL(0, arena.overflows());
+  TEST_ASSERT_LESS_THAN(perSend[0].allocs, perSend[1].allocs);
+
+  nativeSerialEcho(true);
+  const char *names[2] = {"heap", "arena"};
+  for (int pass = 0; pass < 2; pass++) {
+    Serial.printf("Alert send, %-5s: %.1f malloc, %.1f realloc, %.1f free per send, %u us\n", names[pass],
+                  (float)perSend[pass].allocs / BENCH_SENDS, (float)perSend[pass].reallocs / BENCH_SENDS,
+                  (float)perSend[pass].frees / BENCH_SENDS, (unsigned)us[pass]);
+  }
+  Serial.printf("Arena: %u strings per send, high water %u of %u bytes, %u overflows, %u survivors\n",
+                (unsigned)(arena.allocations() / (BENCH_SENDS + 1)), (unsigned)arena.highWater(),
+                (unsigned)sizeof(mem), (unsigned)arena.overflows(), (unsigned)arena.survivors());
+  nativeSerialEcho(false);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  config.server.host_name = "127.0.0.1";
+  config.server.port = nativeSmtpPort();
+  config.secure.mode = esp_mail_secure_mode_nonsecure;
+  config.login.email = "proto01crystaltronics@gmail.com";
+  config.login.password = "password";
+  smtp.setClient(&tcp);
+  smtp.networkConnectionRequestCallback(networkConnection);
+  smtp.networkStatusRequestCallback(networkStatus);
+
+  UNITY_BEGIN();
+  RUN_TEST(test_alert_reaches_the_server);
+  RUN_TEST(test_arena_send_matches_heap_send);
+  RUN_TEST(test_full_arena_falls_back_to_heap);
+  RUN_TEST(test_survivor_keeps_its_contents);
+  RUN_TEST(test_random_strings_keep_their_contents);
+  RUN_TEST(test_session_result_never_fills_the_arena);
+  RUN_TEST(test_allocations_per_send_benchmark);
+  return UNITY_END();
+}
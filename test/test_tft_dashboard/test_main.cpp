@@ -0,0 +1,256 @@
+//=====================================================================================================//
+// TFT DASHBOARD: host rendering test and frame-time benchmark
+// render() draws the frame in TFT_BAND_HEIGHT bands and pushes them through the flush task; the
+// fake panel in test/native collects what arrives. Every frame must come out pixel for pixel the
+// same as drawBand() on one full-frame GFXcanvas16, whatever the alert state and trend history.
+//
+//   pio test -e native -f test_tft_dashboard
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <algorithm>
+#include <unity.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+#include <Fonts/FreeSansBold12pt7b.h>
+#include "native_hal.h"
+#include "tft_dashboard.h"
+
+#define BENCH_FRAMES   30
+#define SPI_PIXEL_NS   400   // 16 bits at 40 MHz
+
+static Adafruit_ST7789 tft(TFT_CS, TFT_DC, TFT_RST);
+static TftDashboard dashboard(tft, "CRYSTAL TEST");
+static bool started = false;
+
+static SensorSnapshot sample(float temperature, float humidity, bool liquidLow, bool tempAlert) {
+  SensorSnapshot s = {};
+  s.sampleUs = micros();
+  s.temperature = temperature;
+  s.humidity = humidity;
+  s.liquidLow = liquidLow;
+  s.tempAlert = tempAlert;
+  return s;
+}
+
+/* Renders through the bands and compares with the full-frame reference; fails on the first difference */
+static void assertFrameMatchesCanvas() {
+  static GFXcanvas16 full(TFT_WIDTH, TFT_HEIGHT);
+  dashboard.render();
+  dashboard.drawBand(full, 0);
+
+  const uint16_t *expected = full.getBuffer();
+  const uint16_t *actual = tft.framebuffer();
+  for (int32_t i = 0; i < TFT_WIDTH * TFT_HEIGHT; i++) {
+    if (expected[i] == actual[i]) continue;
+    char msg[80];
+    snprintf(msg, sizeof(msg), "pixel (%ld, %ld): expected %04x, panel %04x", (long)(i % TFT_WIDTH),
+             (long)(i / TFT_WIDTH), expected[i], actual[i]);
+    TEST_FAIL_MESSAGE(msg);
+  }
+}
+
+void setUp() {
+  nativeSerialEcho(false);
+  if (started) return;
+  TEST_ASSERT_TRUE(dashboard.begin());
+  started = true;
+}
+
+void tearDown() {
+  nativeSerialEcho(true);
+  tft.pixelNs = 0;
+}
+
+static void test_panel_is_landscape() {
+  TEST_ASSERT_EQUAL(TFT_WIDTH, tft.width());
+  TEST_ASSERT_EQUAL(TFT_HEIGHT, tft.height());
+}
+
+static void test_empty_dashboard_matches_canvas() { assertFrameMatchesCanvas(); }
+
+static void test_every_band_is_pushed_once() {
+  uint32_t pushes = tft.pushes;
+  uint64_t pixels = tft.pixelsPushed;
+  dashboard.render();
+  TEST_ASSERT_EQUAL(TFT_HEIGHT / TFT_BAND_HEIGHT, tft.pushes - pushes);
+  TEST_ASSERT_EQUAL((uint64_t)TFT_WIDTH * TFT_HEIGHT, tft.pixelsPushed - pixels);
+  TEST_ASSERT_FALSE(tft.inWrite());
+}
+
+static void test_banner_colour_follows_alert_state() {
+  dashboard.pushSample(sample(25.0f, 50.0f, false, false));
+  dashboard.render();
+  TEST_ASSERT_EQUAL_HEX16(ST77XX_BLUE, tft.pixel(1, 1));
+
+  dashboard.pushSample(sample(45.0f, 50.0f, false, true));
+  dashboard.render();
+  TEST_ASSERT_EQUAL_HEX16(ST77XX_ORANGE, tft.pixel(1, 1));
+
+  /* Liquid low wins over the temperature alert */
+  dashboard.pushSample(sample(45.0f, 50.0f, true, true));
+  dashboard.render();
+  TEST_ASSERT_EQUAL_HEX16(ST77XX_RED, tft.pixel(1, 1));
+}
+
+static void test_trend_and_alerts_match_canvas() {
+  for (uint16_t i = 0; i < TFT_TREND_POINTS + 17; i++) {
+    float t = 30.0f + 22.0f * sinf(i * 0.15f);
+    bool tempAlert = t < TEMP_LOW_THRESHOLD || t > TEMP_HIGH_THRESHOLD;
+    dashboard.pushSample(sample(t, 40.0f + i % 30, i % 40 > 30, tempAlert));
+    if (i % 23 == 0) assertFrameMatchesCanvas();
+  }
+  assertFrameMatchesCanvas();
+}
+
+static void test_failed_read_matches_canvas() {
+  dashboard.pushSample(sample(NAN, NAN, false, false));
+  assertFrameMatchesCanvas();
+}
+
+/* The glyph cache must draw the readouts exactly as the GFX text path would */
+static void test_glyph_cache_matches_gfx_text() {
+  GlyphCache cache;
+  TEST_ASSERT_TRUE(cache.begin());
+  GFXcanvas16 expected(160, 40), actual(160, 40);
+  const char *values[] = {"-23.45", "100.0", "7", "--.-", "+0.5%C"};
+  for (const char *text : values) {
+    for (uint8_t size = 1; size <= 4; size++) {
+      expected.fillScreen(ST77XX_BLACK);
+      expected.setTextSize(size);
+      expected.setTextColor(ST77XX_WHITE);
+      expected.setCursor(2, 3);
+      expected.print(text);
+      actual.fillScreen(ST77XX_BLACK);
+      cache.drawString(actual, 2, 3, text, ST77XX_WHITE, size);
+      TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.getBuffer(), actual.getBuffer(), 160 * 40 * 2, text);
+    }
+  }
+}
+
+static void test_glyph_cache_matches_gfxfont_text() {
+  GlyphCache cache;
+  TEST_ASSERT_TRUE(cache.begin(&FreeSansBold12pt7b));
+  GFXcanvas16 expected(160, 40), actual(160, 40);
+  const char *values[] = {"-23.45", "100.0", "+0.5%C"};
+  for (const char *text : values) {
+    expected.fillScreen(ST77XX_BLACK);
+    expected.setFont(&FreeSansBold12pt7b);
+    expected.setTextColor(ST77XX_WHITE);
+    expected.setCursor(2, 30);
+    expected.print(text);
+    actual.fillScreen(ST77XX_BLACK);
+    cache.drawString(actual, 2, 30, text, ST77XX_WHITE);
+    TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.getBuffer(), actual.getBuffer(), 160 * 40 * 2, text);
+  }
+}
+
+/* Text hanging off the canvas edges, through the canvas buffer and through the GFX calls, with
+ * characters missing from the cache; the font set on the target must survive the fallback */
+static void test_glyph_cache_clips_and_keeps_the_font() {
+  GlyphCache cache;
+  TEST_ASSERT_TRUE(cache.begin(&FreeSansBold12pt7b, "0123456789"));
+  GFXcanvas16 expected(160, 40), actual(160, 40);
+  const int16_t origins[][2] = {{2, 30}, {-9, 12}, {120, 50}, {40, 8}};
+  for (uint8_t viaGfx = 0; viaGfx < 2; viaGfx++) {
+    for (const int16_t *origin : origins) {
+      expected.fillScreen(ST77XX_BLACK);
+      expected.setTextWrap(false);
+      expected.setFont(&FreeSansBold12pt7b);
+      expected.setTextColor(ST77XX_WHITE);
+      expected.setCursor(origin[0], origin[1]);
+      expected.print("A-10%");
+      expected.setFont(nullptr);
+      expected.setCursor(0, 0);
+      expected.print("ok");
+
+      actual.fillScreen(ST77XX_BLACK);
+      actual.setTextWrap(false);
+      actual.setFont(nullptr);
+      actual.setTextColor(ST77XX_WHITE);
+      if (viaGfx) cache.drawString(static_cast<Adafruit_GFX &>(actual), origin[0], origin[1], "A-10%", ST77XX_WHITE);
+      else cache.drawString(actual, origin[0], origin[1], "A-10%", ST77XX_WHITE);
+      actual.setCursor(0, 0);
+      actual.print("ok");
+      TEST_ASSERT_EQUAL_MEMORY_MESSAGE(expected.getBuffer(), actual.getBuffer(), 160 * 40 * 2,
+                                       viaGfx ? "through GFX" : "into the buffer");
+    }
+  }
+}
+
+/* Median of BENCH_FRAMES frames, so a few late wakeups on a busy host do not decide the comparison */
+template <typename F> static uint32_t medianFrameUs(F frame) {
+  std::vector<uint32_t> us;
+  for (uint16_t f = 0; f < BENCH_FRAMES; f++) {
+    uint32_t start = micros();
+    frame();
+    us.push_back(micros() - start);
+  }
+  std::sort(us.begin(), us.end());
+  return us[us.size() / 2];
+}
+
+static void pushBand(GFXcanvas16 &band, uint16_t y0) {
+  tft.startWrite();
+  tft.setAddrWindow(0, y0, TFT_WIDTH, TFT_BAND_HEIGHT);
+  tft.writePixels(band.getBuffer(), (uint32_t)TFT_WIDTH * TFT_BAND_HEIGHT, false);
+  tft.endWrite();
+}
+
+/* Frame time with a simulated 40 MHz SPI push, against drawing and pushing one band after the
+ * other on one thread and against the push alone. The banded frame should come close to the push
+ * alone. Drawing a band on the host takes about 10 us, well under 1% of its push and about as long
+ * as handing the buffer between the two threads, so here the banded frame only ties draw-then-push;
+ * the win is the S3's draw time, which is a much larger share of the frame there.
+ * On the S3 the flush task pushes on the other core. A host with one CPU would instead run the
+ * drawing thread as soon as the flush task frees a buffer, ahead of the next push, and the draw
+ * would land between pushes; dropping the drawing thread's priority lets the push start first, as
+ * the second core does. The priority cannot be raised back, so this test runs last */
+static void test_frame_time_benchmark() {
+#ifdef __linux__
+  sched_param idle = {};
+  sched_setscheduler((pid_t)syscall(SYS_gettid), SCHED_IDLE, &idle);
+#endif
+  tft.pixelNs = SPI_PIXEL_NS;
+  for (uint16_t i = 0; i < TFT_TREND_POINTS; i++) dashboard.pushSample(sample(20.0f + i % 25, 55.0f, false, false));
+
+  nativeSerialEcho(true);
+  dashboard.runBenchmark(Serial, BENCH_FRAMES);
+  const DashboardFrameStats &pipelined = dashboard.stats();
+  TEST_ASSERT_EQUAL(BENCH_FRAMES, pipelined.frames);
+
+  uint32_t bandedUs = medianFrameUs([]() { dashboard.render(); });
+  GFXcanvas16 band(TFT_WIDTH, TFT_BAND_HEIGHT);
+  uint32_t serialUs = medianFrameUs([&band]() {
+    for (uint16_t y0 = 0; y0 < TFT_HEIGHT; y0 += TFT_BAND_HEIGHT) {
+      dashboard.drawBand(band, y0);
+      pushBand(band, y0);
+    }
+  });
+  uint32_t pushUs = medianFrameUs([&band]() {
+    for (uint16_t y0 = 0; y0 < TFT_HEIGHT; y0 += TFT_BAND_HEIGHT) pushBand(band, y0);
+  });
+  Serial.printf("Median frame at %u ns/pixel: banded %u us, draw-then-push %u us, push alone %u us, draw %u us\n",
+                SPI_PIXEL_NS, (unsigned)bandedUs, (unsigned)serialUs, (unsigned)pushUs, (unsigned)pipelined.drawUs);
+  nativeSerialEcho(false);
+  TEST_ASSERT_GREATER_OR_EQUAL(pushUs, bandedUs);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  UNITY_BEGIN();
+  RUN_TEST(test_panel_is_landscape);
+  RUN_TEST(test_empty_dashboard_matches_canvas);
+  RUN_TEST(test_every_band_is_pushed_once);
+  RUN_TEST(test_banner_colour_follows_alert_state);
+  RUN_TEST(test_trend_and_alerts_match_canvas);
+  RUN_TEST(test_failed_read_matches_canvas);
+  RUN_TEST(test_glyph_cache_matches_gfx_text);
+  RUN_TEST(test_glyph_cache_matches_gfxfont_text);
+  RUN_TEST(test_glyph_cache_clips_and_keeps_the_font);
+  RUN_TEST(test_frame_time_benchmark);
+  return UNITY_END();
+}
@@ -0,0 +1,273 @@
+//=====================================================================================================//
+// TLS HANDSHAKE: test certificates
+// Two chains for the local server, valid 2026-2126:
+//  - RSA:   "Test RSA CA" (RSA-2048, self-signed) -> "localhost" (RSA-2048, SHA-256)
+//  - ECDSA: "Test ECDSA CA" (P-384, self-signed) -> "localhost" (P-256, SHA-384)
+// Made with openssl req/x509 (-days 36500) and written out in DER. Test keys, not secrets.
+//=====================================================================================================//
+
+#ifndef TEST_CERTS_H
+#define TEST_CERTS_H
+
+#include <stdint.h>
+
+static const uint8_t RSA_CA_DER[] = {
+  0x30, 0x82, 0x03, 0x0c, 0x30, 0x82, 0x01, 0xf4, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x01,
+  0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+  0x16, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0b, 0x54, 0x65, 0x73, 0x74,
+  0x20, 0x52, 0x53, 0x41, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31,
+  0x39, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39,
+  0x32, 0x35, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x30, 0x16, 0x31, 0x14, 0x30, 0x12, 0x06,
+  0x03, 0x55, 0x04, 0x03, 0x0c, 0x0b, 0x54, 0x65, 0x73, 0x74, 0x20, 0x52, 0x53, 0x41, 0x20, 0x43,
+  0x41, 0x30, 0x82, 0x01, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01,
+  0x01, 0x01, 0x05, 0x00, 0x03, 0x82, 0x01, 0x0f, 0x00, 0x30, 0x82, 0x01, 0x0a, 0x02, 0x82, 0x01,
+  0x01, 0x00, 0x8f, 0xb2, 0x17, 0xb4, 0x2a, 0x4d, 0x6b, 0x63, 0x71, 0x61, 0x84, 0x2e, 0x20, 0x58,
+  0x41, 0x16, 0xf3, 0x98, 0xed, 0x0a, 0xfc, 0xd0, 0x39, 0x03, 0xa5, 0xd2, 0x5f, 0x81, 0x3c, 0xe7,
+  0x7d, 0x7b, 0xbe, 0x4d, 0xdc, 0x85, 0x95, 0x24, 0x80, 0xe5, 0x56, 0xef, 0x6c, 0x00, 0x18, 0xb9,
+  0x06, 0xc6, 0x44, 0x7c, 0xe6, 0x93, 0xb3, 0x6b, 0x7c, 0x96, 0x76, 0x1f, 0x95, 0xf7, 0xa4, 0x20,
+  0xc8, 0x9d, 0x6b, 0xbe, 0x90, 0x16, 0x70, 0x7a, 0x3a, 0xc5, 0x6d, 0x77, 0x40, 0x44, 0xec, 0x78,
+  0x42, 0xa6, 0xed, 0x98, 0x90, 0x93, 0x7f, 0x08, 0x98, 0xed, 0xdf, 0x18, 0x5b, 0x35, 0xc6, 0x1a,
+  0x8c, 0x5e, 0xf8, 0x65, 0xbc, 0xf3, 0xf0, 0x80, 0x26, 0xf7, 0x12, 0x81, 0x14, 0x0e, 0x67, 0xf6,
+  0xe0, 0x6b, 0x2c, 0xeb, 0x4f, 0xf0, 0x0d, 0x8a, 0x5d, 0x98, 0x8b, 0xfa, 0x77, 0x4b, 0xc4, 0x7a,
+  0xab, 0x8e, 0x66, 0xc6, 0xcd, 0x0a, 0x7d, 0x98, 0x78, 0x63, 0x45, 0x31, 0x4a, 0x10, 0xf2, 0x8e,
+  0xfe, 0xf8, 0x84, 0xb1, 0x50, 0x69, 0x61, 0x82, 0xe6, 0x66, 0xf0, 0xab, 0xb0, 0xdc, 0xf0, 0x86,
+  0x9b, 0xc6, 0xff, 0x53, 0x21, 0x72, 0x39, 0x9e, 0x7e, 0x08, 0x09, 0x8f, 0x58, 0xcf, 0x6f, 0x81,
+  0x6d, 0x3f, 0xd2, 0x18, 0xd4, 0xc0, 0xc7, 0x62, 0x18, 0xe7, 0xd3, 0x8f, 0xc3, 0x62, 0x0d, 0xa0,
+  0x1d, 0xb4, 0x47, 0x2c, 0x4b, 0x1a, 0x9e, 0x11, 0x9d, 0x2b, 0x4c, 0x95, 0xc3, 0x06, 0x4f, 0x2c,
+  0xf6, 0xfb, 0x38, 0x5c, 0x4d, 0x31, 0xf6, 0xd2, 0x89, 0x78, 0xd5, 0xac, 0xfb, 0xfe, 0x16, 0xc2,
+  0x39, 0x17, 0x29, 0x53, 0x62, 0x73, 0xcf, 0x12, 0x43, 0xa5, 0x62, 0x3c, 0xf3, 0x4c, 0x29, 0xe0,
+  0xa3, 0xa0, 0x25, 0xe8, 0x44, 0x67, 0xe2, 0x10, 0xd5, 0x2b, 0x91, 0x66, 0xd7, 0x11, 0xde, 0xcb,
+  0x4a, 0xa5, 0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x1d, 0x06, 0x03, 0x55,
+  0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x02, 0x82, 0xe0, 0x70, 0x74, 0x84, 0x31, 0xe3, 0xb1, 0x93,
+  0xd8, 0xf7, 0x1b, 0x16, 0x03, 0x34, 0x2d, 0xac, 0x32, 0x54, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d,
+  0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x02, 0x82, 0xe0, 0x70, 0x74, 0x84, 0x31, 0xe3, 0xb1,
+  0x93, 0xd8, 0xf7, 0x1b, 0x16, 0x03, 0x34, 0x2d, 0xac, 0x32, 0x54, 0x30, 0x0f, 0x06, 0x03, 0x55,
+  0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30, 0x0e, 0x06, 0x03,
+  0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x02, 0x04, 0x30, 0x0d, 0x06, 0x09,
+  0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x03, 0x82, 0x01, 0x01, 0x00,
+  0x33, 0x86, 0x40, 0x8c, 0xfc, 0x05, 0x35, 0xfa, 0xc8, 0x26, 0x3c, 0xb5, 0x2b, 0x67, 0x49, 0xd8,
+  0x09, 0x93, 0x1e, 0x19, 0x11, 0x9a, 0x66, 0xe7, 0xa8, 0x2d, 0x4e, 0x81, 0xbf, 0x59, 0x19, 0x50,
+  0x0e, 0x26, 0x17, 0x86, 0x65, 0x52, 0xe1, 0x08, 0xac, 0x93, 0x38, 0xd1, 0x7f, 0x73, 0x78, 0x3d,
+  0x2a, 0x14, 0x3b, 0x19, 0x38, 0xff, 0xa4, 0x5b, 0x1d, 0x56, 0xea, 0x46, 0x65, 0x24, 0x07, 0x2b,
+  0xf7, 0x22, 0x3e, 0xa7, 0xa2, 0x80, 0x5a, 0xda, 0xde, 0x72, 0x96, 0x11, 0xd8, 0xfe, 0x4b, 0xd5,
+  0xfd, 0x1d, 0x4d, 0xcb, 0x33, 0x06, 0x6b, 0x35, 0xfb, 0x85, 0x20, 0x92, 0xb2, 0xe0, 0x66, 0x5c,
+  0xad, 0x64, 0xb2, 0xe0, 0x48, 0x7f, 0xba, 0xbb, 0x56, 0xd4, 0x62, 0xd7, 0x15, 0x98, 0x31, 0xcb,
+  0x97, 0xa7, 0x1f, 0x06, 0xa2, 0x5a, 0xcf, 0x83, 0xa9, 0xde, 0x62, 0x30, 0xb2, 0xfa, 0x04, 0x93,
+  0x96, 0xf1, 0x17, 0x4d, 0xa0, 0xfc, 0x66, 0xa1, 0xe0, 0xec, 0x66, 0xfb, 0x6a, 0xa3, 0x79, 0xff,
+  0xe8, 0x5a, 0x41, 0x3d, 0x17, 0xff, 0x36, 0xda, 0xa8, 0x9c, 0xf2, 0x1a, 0x18, 0x48, 0xd8, 0xae,
+  0x16, 0x2f, 0x92, 0xb9, 0x9a, 0x65, 0x70, 0x2d, 0x50, 0x0e, 0xe9, 0x6e, 0x7e, 0xd6, 0x3c, 0x06,
+  0x99, 0x51, 0x19, 0xaa, 0x76, 0xc9, 0x51, 0x4e, 0x55, 0x8f, 0x98, 0x1b, 0xd1, 0xdb, 0xc7, 0x63,
+  0xf1, 0x1a, 0x57, 0x7f, 0x8c, 0xa9, 0xe7, 0xfb, 0xc8, 0xa9, 0xaa, 0xf7, 0x1a, 0x9d, 0xae, 0xcd,
+  0x33, 0xcd, 0x4a, 0x49, 0xbc, 0x55, 0x18, 0x9b, 0x99, 0x0e, 0xe7, 0x01, 0x9a, 0x6a, 0xce, 0xfc,
+  0x3a, 0x0e, 0x3d, 0x30, 0x97, 0x1f, 0xf2, 0xcd, 0x7d, 0x88, 0x54, 0x6b, 0x0a, 0x24, 0x0b, 0x0a,
+  0x12, 0xa8, 0x04, 0x98, 0x6f, 0x37, 0x95, 0x8c, 0x4d, 0x56, 0x5e, 0xdc, 0x4b, 0xdc, 0x95, 0x73,
+};
+
+static const uint8_t RSA_CERT_DER[] = {
+  0x30, 0x82, 0x03, 0x24, 0x30, 0x82, 0x02, 0x0c, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x02,
+  0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x0b, 0x05, 0x00, 0x30,
+  0x16, 0x31, 0x14, 0x30, 0x12, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0b, 0x54, 0x65, 0x73, 0x74,
+  0x20, 0x52, 0x53, 0x41, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31,
+  0x39, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39,
+  0x32, 0x35, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x30, 0x14, 0x31, 0x12, 0x30, 0x10, 0x06,
+  0x03, 0x55, 0x04, 0x03, 0x0c, 0x09, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68, 0x6f, 0x73, 0x74, 0x30,
+  0x82, 0x01, 0x22, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01, 0x01,
+  0x05, 0x00, 0x03, 0x82, 0x01, 0x0f, 0x00, 0x30, 0x82, 0x01, 0x0a, 0x02, 0x82, 0x01, 0x01, 0x00,
+  0xd1, 0x40, 0x7d, 0x7c, 0x25, 0xde, 0x40, 0xe1, 0x70, 0xd1, 0x95, 0x5e, 0xd9, 0x3d, 0x42, 0x15,
+  0x61, 0xd1, 0x89, 0xbc, 0xef, 0xc6, 0x95, 0x36, 0x2d, 0x00, 0xf6, 0x62, 0xef, 0x49, 0x03, 0x90,
+  0x7a, 0xd5, 0xb9, 0xaf, 0x0f, 0x4f, 0x15, 0x9e, 0x8e, 0xab, 0x0f, 0x30, 0x4a, 0x94, 0x37, 0xae,
+  0x07, 0xa2, 0xc9, 0x71, 0x8b, 0x8f, 0x24, 0x50, 0x62, 0xaf, 0xad, 0x23, 0x66, 0x86, 0xa3, 0x58,
+  0xdf, 0x25, 0x35, 0x51, 0xef, 0x19, 0x7c, 0xd8, 0x73, 0x13, 0xa7, 0x51, 0x51, 0xbe, 0x8c, 0xdf,
+  0x9f, 0x87, 0xe3, 0x97, 0x1f, 0x87, 0x12, 0xd3, 0x07, 0xb3, 0x6d, 0xf3, 0xef, 0x6d, 0xdb, 0x43,
+  0x38, 0x59, 0xc7, 0x0f, 0xd9, 0xbc, 0x22, 0xc8, 0x07, 0xf3, 0xc8, 0xc9, 0x81, 0xa4, 0xc7, 0x7a,
+  0x66, 0x01, 0x07, 0xf1, 0x44, 0x16, 0x60, 0x24, 0x96, 0x97, 0x93, 0xa0, 0xcc, 0xca, 0x79, 0xd2,
+  0x16, 0x43, 0xee, 0x43, 0xad, 0x17, 0xbb, 0xe3, 0x63, 0xfe, 0x2d, 0x12, 0x9f, 0x48, 0xac, 0x1a,
+  0x10, 0x69, 0xe1, 0x2c, 0x61, 0x1d, 0xee, 0x1d, 0xe7, 0x50, 0xcc, 0x78, 0x89, 0xa2, 0x54, 0x4a,
+  0xe8, 0xba, 0xcc, 0xce, 0xe1, 0x5e, 0x25, 0xff, 0xb6, 0xa5, 0x53, 0xd5, 0xc2, 0x7c, 0x65, 0x38,
+  0xea, 0xd1, 0x6f, 0xbc, 0xb4, 0xef, 0x7f, 0xe0, 0x3d, 0xf7, 0xcb, 0xf5, 0x02, 0x49, 0xcf, 0xe8,
+  0xa7, 0x9f, 0x11, 0xb9, 0x85, 0x35, 0xe6, 0xd3, 0xfb, 0xfb, 0xd6, 0x8d, 0x46, 0x84, 0x05, 0xc1,
+  0xd1, 0x51, 0x6f, 0xae, 0xf3, 0xe4, 0x8f, 0xb3, 0x0b, 0xb7, 0x19, 0xd8, 0x41, 0x6c, 0x35, 0xef,
+  0x61, 0x92, 0x58, 0x95, 0x6c, 0xcd, 0x31, 0xc8, 0x5b, 0x4e, 0x77, 0x9b, 0x83, 0x23, 0x81, 0x28,
+  0x47, 0xd3, 0x61, 0xc1, 0xcb, 0xcf, 0xe7, 0xac, 0x37, 0xe3, 0x24, 0x46, 0x0c, 0x0c, 0xd9, 0x83,
+  0x02, 0x03, 0x01, 0x00, 0x01, 0xa3, 0x7d, 0x30, 0x7b, 0x30, 0x14, 0x06, 0x03, 0x55, 0x1d, 0x11,
+  0x04, 0x0d, 0x30, 0x0b, 0x82, 0x09, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68, 0x6f, 0x73, 0x74, 0x30,
+  0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x05, 0xa0, 0x30,
+  0x13, 0x06, 0x03, 0x55, 0x1d, 0x25, 0x04, 0x0c, 0x30, 0x0a, 0x06, 0x08, 0x2b, 0x06, 0x01, 0x05,
+  0x05, 0x07, 0x03, 0x01, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x78,
+  0x57, 0x3a, 0xac, 0x63, 0x8f, 0x37, 0x77, 0x15, 0x4f, 0xb1, 0x95, 0xb7, 0x15, 0x0c, 0x36, 0x6e,
+  0x87, 0x24, 0xb9, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14,
+  0x02, 0x82, 0xe0, 0x70, 0x74, 0x84, 0x31, 0xe3, 0xb1, 0x93, 0xd8, 0xf7, 0x1b, 0x16, 0x03, 0x34,
+  0x2d, 0xac, 0x32, 0x54, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7, 0x0d, 0x01, 0x01,
+  0x0b, 0x05, 0x00, 0x03, 0x82, 0x01, 0x01, 0x00, 0x34, 0x3a, 0x59, 0x50, 0xe8, 0x95, 0x44, 0xa7,
+  0x22, 0xc0, 0x30, 0xb3, 0x0a, 0xac, 0xe7, 0x7d, 0xc2, 0x76, 0xb2, 0x02, 0xc5, 0xb2, 0x23, 0x06,
+  0xaf, 0x95, 0xff, 0xb8, 0x8b, 0x0e, 0xbd, 0xc3, 0x05, 0xc4, 0x39, 0x5b, 0x04, 0x23, 0x3b, 0x61,
+  0xec, 0xde, 0x9b, 0xe3, 0x52, 0x2f, 0x78, 0x03, 0x13, 0x55, 0xe4, 0x31, 0xec, 0xaf, 0x61, 0xab,
+  0xd1, 0xaf, 0xa4, 0x34, 0x67, 0x22, 0xf4, 0xbd, 0x0f, 0xcc, 0x17, 0x4d, 0x07, 0x65, 0x19, 0x51,
+  0xc3, 0xc6, 0x84, 0x87, 0xa5, 0xd7, 0xd1, 0x87, 0xa2, 0xf0, 0x29, 0x14, 0x88, 0xe6, 0x45, 0x6c,
+  0x05, 0xdb, 0xa0, 0x3e, 0x34, 0x43, 0x4c, 0xaa, 0xdf, 0x7d, 0x7d, 0xa7, 0x6a, 0x46, 0x52, 0xaf,
+  0x43, 0x62, 0x85, 0x45, 0x0e, 0x4e, 0x26, 0xb6, 0x06, 0xd4, 0xe7, 0x47, 0xcc, 0x62, 0xfa, 0x7d,
+  0x5a, 0x28, 0xe9, 0x9b, 0xe2, 0xeb, 0x34, 0x18, 0x12, 0xb7, 0x58, 0x68, 0x16, 0x93, 0x70, 0x64,
+  0x71, 0x08, 0xab, 0xa4, 0x1e, 0x59, 0xbc, 0x0b, 0x12, 0x15, 0xbc, 0x10, 0xe8, 0xa1, 0xf9, 0x2e,
+  0xba, 0x44, 0x4a, 0x0c, 0xa0, 0x17, 0x02, 0x2c, 0xe7, 0x86, 0xda, 0x13, 0x2e, 0x36, 0x5f, 0x0e,
+  0xaa, 0xfc, 0x92, 0xe6, 0x09, 0xd8, 0xc1, 0x68, 0x35, 0x23, 0x04, 0xf8, 0x99, 0xd7, 0x71, 0xc0,
+  0x23, 0xed, 0xfc, 0x66, 0x8d, 0x84, 0x84, 0x30, 0x8e, 0xec, 0x3f, 0xf2, 0xa2, 0xe6, 0x8a, 0x47,
+  0x15, 0x50, 0x63, 0x0f, 0x87, 0xc1, 0xec, 0x67, 0xac, 0x88, 0xcf, 0xbb, 0x30, 0x6e, 0x23, 0xf7,
+  0x2e, 0x61, 0x12, 0x00, 0x68, 0x50, 0x98, 0xf8, 0x74, 0xde, 0xf6, 0xbf, 0x2c, 0x90, 0x00, 0x5f,
+  0x5c, 0x95, 0x87, 0x5a, 0xd1, 0x68, 0x72, 0xd0, 0x25, 0x91, 0x8a, 0x5c, 0x7d, 0x71, 0x2a, 0x4b,
+  0x76, 0x05, 0x4e, 0xdf, 0x10, 0x5e, 0x70, 0xf5,
+};
+
+static const uint8_t RSA_KEY_DER[] = {
+  0x30, 0x82, 0x04, 0xbc, 0x02, 0x01, 0x00, 0x30, 0x0d, 0x06, 0x09, 0x2a, 0x86, 0x48, 0x86, 0xf7,
+  0x0d, 0x01, 0x01, 0x01, 0x05, 0x00, 0x04, 0x82, 0x04, 0xa6, 0x30, 0x82, 0x04, 0xa2, 0x02, 0x01,
+  0x00, 0x02, 0x82, 0x01, 0x01, 0x00, 0xd1, 0x40, 0x7d, 0x7c, 0x25, 0xde, 0x40, 0xe1, 0x70, 0xd1,
+  0x95, 0x5e, 0xd9, 0x3d, 0x42, 0x15, 0x61, 0xd1, 0x89, 0xbc, 0xef, 0xc6, 0x95, 0x36, 0x2d, 0x00,
+  0xf6, 0x62, 0xef, 0x49, 0x03, 0x90, 0x7a, 0xd5, 0xb9, 0xaf, 0x0f, 0x4f, 0x15, 0x9e, 0x8e, 0xab,
+  0x0f, 0x30, 0x4a, 0x94, 0x37, 0xae, 0x07, 0xa2, 0xc9, 0x71, 0x8b, 0x8f, 0x24, 0x50, 0x62, 0xaf,
+  0xad, 0x23, 0x66, 0x86, 0xa3, 0x58, 0xdf, 0x25, 0x35, 0x51, 0xef, 0x19, 0x7c, 0xd8, 0x73, 0x13,
+  0xa7, 0x51, 0x51, 0xbe, 0x8c, 0xdf, 0x9f, 0x87, 0xe3, 0x97, 0x1f, 0x87, 0x12, 0xd3, 0x07, 0xb3,
+  0x6d, 0xf3, 0xef, 0x6d, 0xdb, 0x43, 0x38, 0x59, 0xc7, 0x0f, 0xd9, 0xbc, 0x22, 0xc8, 0x07, 0xf3,
+  0xc8, 0xc9, 0x81, 0xa4, 0xc7, 0x7a, 0x66, 0x01, 0x07, 0xf1, 0x44, 0x16, 0x60, 0x24, 0x96, 0x97,
+  0x93, 0xa0, 0xcc, 0xca, 0x79, 0xd2, 0x16, 0x43, 0xee, 0x43, 0xad, 0x17, 0xbb, 0xe3, 0x63, 0xfe,
+  0x2d, 0x12, 0x9f, 0x48, 0xac, 0x1a, 0x10, 0x69, 0xe1, 0x2c, 0x61, 0x1d, 0xee, 0x1d, 0xe7, 0x50,
+  0xcc, 0x78, 0x89, 0xa2, 0x54, 0x4a, 0xe8, 0xba, 0xcc, 0xce, 0xe1, 0x5e, 0x25, 0xff, 0xb6, 0xa5,
+  0x53, 0xd5, 0xc2, 0x7c, 0x65, 0x38, 0xea, 0xd1, 0x6f, 0xbc, 0xb4, 0xef, 0x7f, 0xe0, 0x3d, 0xf7,
+  0xcb, 0xf5, 0x02, 0x49, 0xcf, 0xe8, 0xa7, 0x9f, 0x11, 0xb9, 0x85, 0x35, 0xe6, 0xd3, 0xfb, 0xfb,
+  0xd6, 0x8d, 0x46, 0x84, 0x05, 0xc1, 0xd1, 0x51, 0x6f, 0xae, 0xf3, 0xe4, 0x8f, 0xb3, 0x0b, 0xb7,
+  0x19, 0xd8, 0x41, 0x6c, 0x35, 0xef, 0x61, 0x92, 0x58, 0x95, 0x6c, 0xcd, 0x31, 0xc8, 0x5b, 0x4e,
+  0x77, 0x9b, 0x83, 0x23, 0x81, 0x28, 0x47, 0xd3, 0x61, 0xc1, 0xcb, 0xcf, 0xe7, 0xac, 0x37, 0xe3,
+  0x24, 0x46, 0x0c, 0x0c, 0xd9, 0x83, 0x02, 0x03, 0x01, 0x00, 0x01, 0x02, 0x82, 0x01, 0x00, 0x1d,
+  0x6b, 0x51, 0xb9, 0x28, 0xa1, 0xcc, 0xc1, 0x65, 0x59, 0x32, 0x04, 0xf9, 0xc9, 0xf1, 0x06, 0x8c,
+  0x90, 0x27, 0x2b, 0x57, 0x12, 0xb6, 0x5b, 0xbd, 0x8c, 0x0b, 0x17, 0xf1, 0xc8, 0x74, 0x25, 0xd5,
+  0xff, 0x42, 0x71, 0xe8, 0x57, 0x18, 0x15, 0x08, 0xbd, 0xe8, 0x0e, 0xc4, 0x0d, 0x7e, 0x9e, 0x8b,
+  0x18, 0x49, 0xf6, 0x1a, 0xc6, 0xef, 0x36, 0x16, 0x09, 0xd8, 0xef, 0xc7, 0x34, 0x5a, 0xb6, 0xdd,
+  0xf8, 0x9f, 0x3c, 0x7b, 0xbf, 0x3b, 0x9c, 0x3a, 0xe1, 0xa2, 0x7e, 0x7e, 0x5d, 0xa9, 0xf4, 0xae,
+  0xbb, 0x2e, 0x36, 0x4b, 0x0a, 0x74, 0x8d, 0x12, 0xe2, 0x19, 0x2d, 0x58, 0x96, 0x3b, 0x63, 0x82,
+  0x02, 0xad, 0x47, 0xff, 0x36, 0xc2, 0x35, 0x19, 0x59, 0x1e, 0xfb, 0xa5, 0xac, 0x83, 0x17, 0x24,
+  0x4c, 0x34, 0xcf, 0xa8, 0xe0, 0xf4, 0x77, 0x70, 0x6c, 0xb3, 0x26, 0xc2, 0x64, 0x1d, 0x28, 0x39,
+  0x0f, 0xbc, 0xf3, 0xfc, 0x0e, 0xaf, 0x35, 0xda, 0x91, 0x0c, 0xb9, 0xb2, 0xa6, 0xf4, 0x73, 0x9c,
+  0x96, 0x46, 0xb1, 0xdb, 0xf8, 0x6b, 0xba, 0x0c, 0x96, 0x5b, 0x51, 0x84, 0xf5, 0x7f, 0x60, 0xe7,
+  0xf4, 0xe3, 0x00, 0x3f, 0x25, 0x32, 0x40, 0xc5, 0x7e, 0x45, 0x00, 0x9b, 0x52, 0xe4, 0xc6, 0x11,
+  0xb6, 0x7a, 0x61, 0xd8, 0x31, 0x25, 0xc7, 0x8f, 0x68, 0xf5, 0xed, 0x5e, 0xe1, 0x0d, 0x9c, 0x23,
+  0x66, 0xf9, 0xc4, 0x77, 0x04, 0x81, 0xba, 0xc8, 0xd2, 0xef, 0x6f, 0x14, 0xac, 0xbc, 0xa3, 0x3d,
+  0x84, 0x80, 0x89, 0x11, 0xff, 0xde, 0xe0, 0x35, 0x41, 0x8d, 0x5e, 0x34, 0xd1, 0x0e, 0x32, 0xb6,
+  0xaa, 0x13, 0xc5, 0x13, 0xe9, 0xc5, 0x75, 0xe0, 0xd0, 0x7b, 0xe0, 0x89, 0x47, 0xb9, 0x99, 0x3f,
+  0xa4, 0x0f, 0x8f, 0x36, 0xe0, 0xd0, 0xa0, 0x63, 0x10, 0x35, 0x80, 0x14, 0x4c, 0x27, 0x11, 0x02,
+  0x81, 0x81, 0x00, 0xf9, 0xd7, 0x25, 0xf4, 0xcc, 0xb6, 0x25, 0x11, 0x7c, 0x3c, 0x90, 0x4d, 0x5f,
+  0x55, 0xa4, 0x9b, 0xb8, 0xe8, 0x61, 0xc2, 0x1c, 0x2e, 0x97, 0x82, 0xb3, 0x23, 0xc7, 0x06, 0x9a,
+  0x68, 0x13, 0x12, 0xe3, 0xf8, 0x54, 0xbb, 0x1d, 0xb4, 0x54, 0xb1, 0xc9, 0xd1, 0x28, 0xae, 0xef,
+  0x81, 0x76, 0x61, 0x2d, 0x35, 0x80, 0x0e, 0x10, 0x94, 0x28, 0x09, 0xc2, 0xf9, 0x27, 0xae, 0x72,
+  0xd9, 0x2f, 0x77, 0xbd, 0x94, 0x48, 0x3a, 0x60, 0xcb, 0x68, 0x98, 0xbe, 0x61, 0x01, 0x09, 0xcc,
+  0xba, 0x14, 0xa4, 0x2d, 0xc4, 0x3a, 0xb1, 0xfd, 0x33, 0x25, 0xf3, 0xb0, 0xf7, 0x06, 0xbb, 0xdd,
+  0x3a, 0x30, 0x9e, 0xa5, 0x5a, 0xfc, 0xb4, 0xac, 0x9a, 0x55, 0xf4, 0x8c, 0xcc, 0x8a, 0x3b, 0xb6,
+  0x18, 0x5b, 0xb5, 0xa1, 0xda, 0xd2, 0x8f, 0x8a, 0xb4, 0x2a, 0x1e, 0x81, 0xa5, 0x82, 0x1d, 0x07,
+  0xbc, 0x44, 0x57, 0x02, 0x81, 0x81, 0x00, 0xd6, 0x69, 0x2b, 0x8f, 0x40, 0x53, 0xf0, 0x9a, 0x2d,
+  0x5b, 0x7f, 0xb0, 0x18, 0x88, 0xa4, 0x66, 0x95, 0xe9, 0x51, 0x66, 0xc0, 0x02, 0x68, 0x0a, 0x9b,
+  0xaf, 0xe2, 0xb7, 0xff, 0x5e, 0x96, 0x2b, 0xa5, 0x3e, 0xa2, 0xd5, 0x30, 0xec, 0xbc, 0xdb, 0x3d,
+  0x98, 0x5d, 0x31, 0x98, 0x5e, 0xc9, 0x07, 0xae, 0x97, 0x35, 0xda, 0xe9, 0xd8, 0x26, 0x15, 0xcb,
+  0x62, 0xf5, 0xac, 0x48, 0x3e, 0xfd, 0xc2, 0xf5, 0x9f, 0xf4, 0x21, 0xee, 0xfd, 0x0f, 0x48, 0x56,
+  0xd7, 0x1e, 0x23, 0xd7, 0x42, 0x35, 0x93, 0x61, 0xe0, 0xb9, 0x40, 0x3d, 0xbc, 0xe4, 0x29, 0x26,
+  0xcd, 0x1d, 0x9e, 0xb1, 0x3b, 0x8c, 0xd9, 0xe8, 0x5e, 0xda, 0xfc, 0x0b, 0x14, 0x89, 0x43, 0x7d,
+  0x6c, 0xa0, 0x29, 0x97, 0x22, 0xbc, 0xf4, 0x24, 0x59, 0xd3, 0x2c, 0xf6, 0x97, 0x64, 0x63, 0xc4,
+  0x56, 0x9f, 0x8a, 0x60, 0x7e, 0xb8, 0xb5, 0x02, 0x81, 0x80, 0x2f, 0x9b, 0x57, 0x98, 0x36, 0x09,
+  0xdf, 0x36, 0x5d, 0xbe, 0x0c, 0xa1, 0x31, 0xb1, 0x58, 0x14, 0x74, 0x3f, 0x93, 0xa1, 0x31, 0x4d,
+  0x8f, 0x81, 0x50, 0x31, 0x59, 0x13, 0x61, 0x08, 0xc3, 0xd9, 0xad, 0xa6, 0xfc, 0x3e, 0x4b, 0x82,
+  0xb9, 0x40, 0xc7, 0x7c, 0x1b, 0x8c, 0x7a, 0x06, 0xe9, 0x4f, 0xcb, 0x15, 0x8e, 0xb9, 0x1f, 0x5f,
+  0x9b, 0xe1, 0x80, 0x4d, 0x89, 0xca, 0x2c, 0x08, 0x46, 0x8b, 0x42, 0x8c, 0xa6, 0xd6, 0xb8, 0xeb,
+  0x09, 0x9b, 0x51, 0x6b, 0x9a, 0x8f, 0x0b, 0x7b, 0xc9, 0xc3, 0x1f, 0x15, 0x6d, 0x39, 0xcd, 0x4d,
+  0x99, 0xc5, 0xbd, 0xca, 0xd4, 0x75, 0xa7, 0xca, 0x16, 0xc9, 0xa4, 0x28, 0x9a, 0x4e, 0xb3, 0x35,
+  0x15, 0x7b, 0xeb, 0xf8, 0x6d, 0xbe, 0xc3, 0x0c, 0x11, 0x2d, 0xa3, 0x11, 0xd7, 0x5d, 0x92, 0xc8,
+  0x91, 0xde, 0x0e, 0x46, 0x43, 0x6c, 0xd4, 0xb4, 0x83, 0x31, 0x02, 0x81, 0x80, 0x7e, 0x9a, 0xb7,
+  0x57, 0xed, 0x1a, 0x23, 0x96, 0x46, 0x76, 0x22, 0xdd, 0xae, 0x7e, 0xf0, 0xe4, 0x8a, 0x5c, 0xac,
+  0xee, 0x49, 0x2e, 0xa2, 0x94, 0xb0, 0xfd, 0x98, 0x98, 0x21, 0x38, 0x8e, 0xdf, 0xd2, 0xc1, 0x3b,
+  0x91, 0x3b, 0x44, 0x6e, 0xf7, 0xde, 0x55, 0x1b, 0xa2, 0x6f, 0x60, 0x78, 0xc0, 0x0a, 0x7d, 0xcb,
+  0x15, 0x2a, 0xc3, 0xb1, 0x29, 0x69, 0x61, 0x53, 0xc3, 0x99, 0x1d, 0x68, 0xe6, 0x37, 0xf7, 0x6d,
+  0x46, 0xa4, 0x41, 0xd5, 0x46, 0x57, 0xd0, 0xca, 0x41, 0x4b, 0x98, 0x12, 0xde, 0xa6, 0x0a, 0xf6,
+  0x18, 0x52, 0xdc, 0x38, 0xb5, 0x7b, 0xed, 0xde, 0x31, 0x98, 0x61, 0x9b, 0x78, 0x08, 0x58, 0x0a,
+  0x62, 0x8d, 0x80, 0x60, 0xd4, 0xf3, 0x38, 0xb3, 0x12, 0x1b, 0xe6, 0x2d, 0x40, 0xd4, 0x3e, 0x1e,
+  0x0e, 0x0c, 0xc5, 0xb4, 0x47, 0x9c, 0xe5, 0xb1, 0x6b, 0x1a, 0x33, 0x79, 0x89, 0x02, 0x81, 0x80,
+  0x2a, 0x03, 0x61, 0x55, 0x3c, 0xb0, 0x03, 0x22, 0xcd, 0xcd, 0xf9, 0x60, 0x58, 0xb2, 0xe5, 0xf0,
+  0x6e, 0x3a, 0x6c, 0x8d, 0x60, 0x8c, 0xf4, 0xee, 0x4f, 0x5c, 0x9c, 0x8a, 0xa0, 0x85, 0x42, 0x5c,
+  0x8d, 0x48, 0xed, 0xea, 0x48, 0xe7, 0x67, 0x4c, 0x51, 0xb2, 0xa9, 0xc5, 0xe4, 0xfb, 0x1a, 0xe5,
+  0x38, 0xbe, 0x20, 0x6d, 0xab, 0x7e, 0xf1, 0xf3, 0x74, 0x9f, 0x61, 0xd6, 0xf8, 0x3d, 0xf2, 0xba,
+  0xf9, 0x46, 0xa6, 0x23, 0xbe, 0xd0, 0x69, 0x93, 0x4e, 0x97, 0x91, 0x7b, 0x85, 0xfd, 0x01, 0x9b,
+  0x29, 0xed, 0xf9, 0x41, 0xbf, 0x8e, 0xe6, 0x94, 0xba, 0xb0, 0x1a, 0x82, 0x00, 0xc7, 0xf3, 0x5b,
+  0x3e, 0xa6, 0x0b, 0x6d, 0x01, 0x5b, 0x86, 0x94, 0x3f, 0x98, 0x85, 0x9d, 0xda, 0xb6, 0x85, 0x28,
+  0x2d, 0xb6, 0xfd, 0x83, 0xeb, 0xc9, 0xf8, 0x69, 0xa2, 0x8a, 0x28, 0x77, 0x31, 0x0c, 0xf1, 0x79,
+};
+
+static const uint8_t EC_CA_DER[] = {
+  0x30, 0x82, 0x01, 0xc0, 0x30, 0x82, 0x01, 0x47, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x03,
+  0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x03, 0x30, 0x18, 0x31, 0x16,
+  0x30, 0x14, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0d, 0x54, 0x65, 0x73, 0x74, 0x20, 0x45, 0x43,
+  0x44, 0x53, 0x41, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39,
+  0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39, 0x32,
+  0x35, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x30, 0x18, 0x31, 0x16, 0x30, 0x14, 0x06, 0x03,
+  0x55, 0x04, 0x03, 0x0c, 0x0d, 0x54, 0x65, 0x73, 0x74, 0x20, 0x45, 0x43, 0x44, 0x53, 0x41, 0x20,
+  0x43, 0x41, 0x30, 0x76, 0x30, 0x10, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06,
+  0x05, 0x2b, 0x81, 0x04, 0x00, 0x22, 0x03, 0x62, 0x00, 0x04, 0x49, 0x97, 0xf2, 0x74, 0xad, 0x1f,
+  0x4a, 0xb8, 0xfa, 0x0d, 0xe5, 0xc9, 0x3b, 0x21, 0xac, 0xf3, 0x9f, 0x4c, 0x6c, 0x77, 0xa2, 0x35,
+  0x4f, 0x1f, 0x7c, 0x76, 0xbd, 0xf3, 0x3c, 0xb3, 0x3f, 0x27, 0x73, 0xb1, 0x23, 0xb3, 0xaa, 0xeb,
+  0x11, 0xaa, 0x50, 0x93, 0xda, 0x20, 0xbf, 0x8f, 0x39, 0x45, 0x94, 0x56, 0x92, 0x3d, 0xd4, 0x73,
+  0x05, 0xe0, 0x7e, 0xcb, 0x7f, 0x91, 0x05, 0xee, 0xeb, 0x4c, 0x0a, 0xbc, 0xa7, 0x6f, 0x19, 0xef,
+  0xab, 0xc7, 0x76, 0x25, 0xfd, 0x95, 0x99, 0x71, 0x19, 0x2e, 0x1d, 0xaa, 0x25, 0x0b, 0x71, 0xcb,
+  0x3c, 0x13, 0x04, 0x24, 0x70, 0x83, 0x57, 0x16, 0xc2, 0xf0, 0xa3, 0x63, 0x30, 0x61, 0x30, 0x1d,
+  0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04, 0x16, 0x04, 0x14, 0x3c, 0x4f, 0x87, 0x30, 0x33, 0x0a, 0x17,
+  0x10, 0xb8, 0x7b, 0x4a, 0x9e, 0x2c, 0x28, 0x76, 0x11, 0x70, 0x03, 0x7b, 0xc6, 0x30, 0x1f, 0x06,
+  0x03, 0x55, 0x1d, 0x23, 0x04, 0x18, 0x30, 0x16, 0x80, 0x14, 0x3c, 0x4f, 0x87, 0x30, 0x33, 0x0a,
+  0x17, 0x10, 0xb8, 0x7b, 0x4a, 0x9e, 0x2c, 0x28, 0x76, 0x11, 0x70, 0x03, 0x7b, 0xc6, 0x30, 0x0f,
+  0x06, 0x03, 0x55, 0x1d, 0x13, 0x01, 0x01, 0xff, 0x04, 0x05, 0x30, 0x03, 0x01, 0x01, 0xff, 0x30,
+  0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03, 0x02, 0x02, 0x04, 0x30,
+  0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x03, 0x03, 0x67, 0x00, 0x30, 0x64,
+  0x02, 0x30, 0x20, 0x1f, 0x96, 0xb5, 0x9d, 0x73, 0xd7, 0x1d, 0x87, 0x01, 0x8b, 0x5e, 0xde, 0xaf,
+  0xf4, 0x7e, 0x35, 0x14, 0x2c, 0x54, 0x7d, 0x3b, 0xb3, 0x4b, 0xdc, 0xc6, 0x94, 0x4d, 0xb4, 0x54,
+  0xce, 0x43, 0xae, 0x5c, 0xf8, 0x4d, 0xe5, 0xe0, 0x74, 0xf6, 0xb1, 0x10, 0xff, 0xbf, 0xc3, 0x58,
+  0xb6, 0x49, 0x02, 0x30, 0x76, 0x71, 0x17, 0xaa, 0x03, 0xdd, 0x81, 0xdf, 0x74, 0x9a, 0x1c, 0x61,
+  0xac, 0xec, 0x6d, 0xea, 0x67, 0xcd, 0xbb, 0xc6, 0x13, 0x59, 0xf3, 0xe4, 0x14, 0xeb, 0x7e, 0xca,
+  0x10, 0x9f, 0xa0, 0x9f, 0x03, 0x34, 0xf5, 0x10, 0xc6, 0xf2, 0x55, 0xde, 0x48, 0xcc, 0xe1, 0x5d,
+  0xb1, 0x95, 0x6e, 0xc5,
+};
+
+static const uint8_t EC_CERT_DER[] = {
+  0x30, 0x82, 0x01, 0xbb, 0x30, 0x82, 0x01, 0x40, 0xa0, 0x03, 0x02, 0x01, 0x02, 0x02, 0x01, 0x04,
+  0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x04, 0x03, 0x03, 0x30, 0x18, 0x31, 0x16,
+  0x30, 0x14, 0x06, 0x03, 0x55, 0x04, 0x03, 0x0c, 0x0d, 0x54, 0x65, 0x73, 0x74, 0x20, 0x45, 0x43,
+  0x44, 0x53, 0x41, 0x20, 0x43, 0x41, 0x30, 0x20, 0x17, 0x0d, 0x32, 0x36, 0x31, 0x30, 0x31, 0x39,
+  0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x18, 0x0f, 0x32, 0x31, 0x32, 0x36, 0x30, 0x39, 0x32,
+  0x35, 0x31, 0x33, 0x32, 0x38, 0x30, 0x37, 0x5a, 0x30, 0x14, 0x31, 0x12, 0x30, 0x10, 0x06, 0x03,
+  0x55, 0x04, 0x03, 0x0c, 0x09, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68, 0x6f, 0x73, 0x74, 0x30, 0x59,
+  0x30, 0x13, 0x06, 0x07, 0x2a, 0x86, 0x48, 0xce, 0x3d, 0x02, 0x01, 0x06, 0x08, 0x2a, 0x86, 0x48,
+  0xce, 0x3d, 0x03, 0x01, 0x07, 0x03, 0x42, 0x00, 0x04, 0x4c, 0xd3, 0xd5, 0xca, 0xa2, 0xb2, 0x4f,
+  0x5d, 0xae, 0x12, 0x90, 0x88, 0x95, 0xc9, 0x12, 0x58, 0x5a, 0x9a, 0x05, 0x7d, 0x33, 0x5f, 0x31,
+  0xec, 0xe1, 0x9c, 0xf4, 0x8f, 0x12, 0x5a, 0xda, 0x65, 0x6a, 0x32, 0xdc, 0x15, 0x06, 0x7c, 0xee,
+  0x07, 0xe6, 0x85, 0xd8, 0xe3, 0x42, 0x96, 0xde, 0xd7, 0x1e, 0x42, 0x7a, 0x1c, 0x30, 0x83, 0xed,
+  0x40, 0x1b, 0xbd, 0x11, 0xea, 0x1e, 0xea, 0x35, 0x6e, 0xa3, 0x7d, 0x30, 0x7b, 0x30, 0x14, 0x06,
+  0x03, 0x55, 0x1d, 0x11, 0x04, 0x0d, 0x30, 0x0b, 0x82, 0x09, 0x6c, 0x6f, 0x63, 0x61, 0x6c, 0x68,
+  0x6f, 0x73, 0x74, 0x30, 0x0e, 0x06, 0x03, 0x55, 0x1d, 0x0f, 0x01, 0x01, 0xff, 0x04, 0x04, 0x03,
+  0x02, 0x07, 0x80, 0x30, 0x13, 0x06, 0x03, 0x55, 0x1d, 0x25, 0x04, 0x0c, 0x30, 0x0a, 0x06, 0x08,
+  0x2b, 0x06, 0x01, 0x05, 0x05, 0x07, 0x03, 0x01, 0x30, 0x1d, 0x06, 0x03, 0x55, 0x1d, 0x0e, 0x04,
+  0x16, 0x04, 0x14, 0x56, 0xd5, 0x73, 0x01, 0x7f, 0xc9, 0xca, 0x49, 0x85, 0xf2, 0x37, 0xe7, 0x28,
+  0x6a, 0xc5, 0x5a, 0x8c, 0x5f, 0xb2, 0xc2, 0x30, 0x1f, 0x06, 0x03, 0x55, 0x1d, 0x23, 0x04, 0x18,
+  0x30, 0x16, 0x80, 0x14, 0x3c, 0x4f, 0x87, 0x30, 0x33, 0x0a, 0x17, 0x10, 0xb8, 0x7b, 0x4a, 0x9e,
+  0x2c, 0x28, 0x76, 0x11, 0x70, 0x03, 0x7b, 0xc6, 0x30, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce,
+  0x3d, 0x04, 0x03, 0x03, 0x03, 0x69, 0x00, 0x30, 0x66, 0x02, 0x31, 0x00, 0xef, 0xc5, 0x8e, 0x9c,
+  0x91, 0xf7, 0x1b, 0x39, 0x10, 0x6d, 0x9f, 0x53, 0xfa, 0xa7, 0x5c, 0x76, 0x27, 0xe9, 0x0a, 0x95,
+  0xb2, 0xd2, 0xc7, 0x4a, 0x29, 0xf2, 0x64, 0x8a, 0xfb, 0xb9, 0x5d, 0x9f, 0x00, 0x5d, 0x5f, 0x5c,
+  0x68, 0x7c, 0x56, 0xa4, 0xfd, 0x45, 0xb5, 0xeb, 0xba, 0x02, 0x4d, 0x73, 0x02, 0x31, 0x00, 0xbf,
+  0x48, 0xa7, 0x9c, 0xcd, 0x7f, 0x7a, 0x12, 0x5a, 0xb8, 0x62, 0x2d, 0xac, 0x0b, 0x3d, 0xf0, 0x82,
+  0x00, 0x08, 0xae, 0x09, 0x93, 0xee, 0x66, 0xe8, 0xac, 0x1f, 0xba, 0x4b, 0xc8, 0x96, 0xda, 0x06,
+  0xdc, 0xb9, 0x58, 0xd4, 0x06, 0xd4, 0xe6, 0xd3, 0xba, 0xa1, 0x28, 0x58, 0x31, 0x75, 0x79,
+};
+
+static const uint8_t EC_KEY_DER[] = {
+  0x30, 0x77, 0x02, 0x01, 0x01, 0x04, 0x20, 0x5c, 0x99, 0x9b, 0x26, 0x15, 0xdb, 0x10, 0x29, 0x0f,
+  0x7a, 0x47, 0xe2, 0x6b, 0x22, 0x4c, 0xe5, 0x25, 0xdc, 0xc9, 0x77, 0xca, 0xd9, 0x90, 0x41, 0x02,
+  0xd6, 0x05, 0xf7, 0xe5, 0xe0, 0x34, 0x52, 0xa0, 0x0a, 0x06, 0x08, 0x2a, 0x86, 0x48, 0xce, 0x3d,
+  0x03, 0x01, 0x07, 0xa1, 0x44, 0x03, 0x42, 0x00, 0x04, 0x4c, 0xd3, 0xd5, 0xca, 0xa2, 0xb2, 0x4f,
+  0x5d, 0xae, 0x12, 0x90, 0x88, 0x95, 0xc9, 0x12, 0x58, 0x5a, 0x9a, 0x05, 0x7d, 0x33, 0x5f, 0x31,
+  0xec, 0xe1, 0x9c, 0xf4, 0x8f, 0x12, 0x5a, 0xda, 0x65, 0x6a, 0x32, 0xdc, 0x15, 0x06, 0x7c, 0xee,
+  0x07, 0xe6, 0x85, 0xd8, 0xe3, 0x42, 0x96, 0xde, 0xd7, 0x1e, 0x42, 0x7a, 0x1c, 0x30, 0x83, 0xed,
+  0x40, 0x1b, 0xbd, 0x11, 0xea, 0x1e, 0xea, 0x35, 0x6e,
+};
+
+#endif // TEST_CERTS_H
@@ -0,0 +1,415 @@
+//=====================================================================================================//
+// TLS HANDSHAKE: profiles against a local server
+// The mail client's SSL client (ESP_SSLClient, the BearSSL in lib/) runs full handshakes against
+// a BearSSL server thread on 127.0.0.1. That server holds an RSA or an ECDSA chain (test_certs.h),
+// or both, and then answers with the ECDSA one whenever the client offers an ECDHE-ECDSA suite, as
+// the large mail providers do. Each tls_profile.h profile must reach the suite it promises on the
+// RSA server. COMPAT must also reach the ECDSA server, which RSA must refuse instead of falling
+// back, and the RSA profile must get the RSA chain from the server with both.
+//
+// The benchmark runs each profile's handshakes on a thread of its own. It reports, per handshake,
+// that thread's CPU time, its peak heap (the SSL context and record buffers included) and its
+// peak stack. native_mail builds BearSSL without the 64-bit and x86 engines, so COMPAT gets the
+// engines it gets on the board. Host figures: compare profiles with each other, not with the board.
+//
+//   pio test -e native_mail -f test_tls_handshake
+//=====================================================================================================//
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <arpa/inet.h>
+#include <atomic>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <new>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <thread>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+#include "native_hal.h"
+#include "test_certs.h"
+#include "tls_profile.h"
+
+#define HANDSHAKES        10
+#define SMTP_FRAGMENT     1024
+#define BENCH_STACK_BYTES (256 * 1024)
+#define STACK_PAINT       0xA5
+#define VALIDATION_TIME   1893456000   // 2030-01-01, inside the test certificates' validity
+
+/* glibc's own entry points, under the malloc family defined below */
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *p, size_t size);
+extern "C" void __libc_free(void *p);
+
+/* Bytes live on this thread since countHeap(true), and their high-water mark */
+static thread_local bool counting;
+static thread_local long heapLive;
+static thread_local long heapPeak;
+
+static void countHeap(bool on) {
+  if (on) heapLive = heapPeak = 0;
+  counting = on;
+}
+
+static void *counted(void *p) {
+  if (counting && p) {
+    heapLive += malloc_usable_size(p);
+    if (heapLive > heapPeak) heapPeak = heapLive;
+  }
+  return p;
+}
+
+static void uncount(void *p) {
+  if (counting && p) heapLive -= malloc_usable_size(p);
+}
+
+extern "C" void *malloc(size_t size) { return counted(__libc_malloc(size)); }
+extern "C" void *calloc(size_t n, size_t size) { return counted(__libc_calloc(n, size)); }
+
+extern "C" void *realloc(void *p, size_t size) {
+  uncount(p);
+  return counted(__libc_realloc(p, size));
+}
+
+extern "C" void free(void *p) {
+  uncount(p);
+  __libc_free(p);
+}
+
+void *operator new(size_t size) {
+  void *p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+//==================================== The server ====================================//
+
+struct Chain {
+  const uint8_t *cert;
+  size_t certLen;
+  const uint8_t *key;
+  size_t keyLen;
+  bool ec;
+};
+
+static const Chain RSA_CHAIN = {RSA_CERT_DER, sizeof(RSA_CERT_DER), RSA_KEY_DER, sizeof(RSA_KEY_DER), false};
+static const Chain EC_CHAIN = {EC_CERT_DER, sizeof(EC_CERT_DER), EC_KEY_DER, sizeof(EC_KEY_DER), true};
+
+/* The suites of the server with both chains: every client the tests run has one of them */
+static const uint16_t dualSuites[] = {
+  BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256,
+  BR_TLS_ECDHE_ECDSA_WITH_AES_128_GCM_SHA256,
+  BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256,
+  BR_TLS_ECDHE_RSA_WITH_AES_128_GCM_SHA256,
+};
+
+/* BearSSL's single-chain policies, the ECDSA one asked first */
+struct DualPolicy {
+  const br_ssl_server_policy_class *vtable;
+  br_ssl_server_policy_ec_context ec;
+  br_ssl_server_policy_rsa_context rsa;
+  const br_ssl_server_policy_class **chosen;
+};
+
+static int dualChoose(const br_ssl_server_policy_class **pctx, const br_ssl_server_context *cc,
+                      br_ssl_server_choices *choices) {
+  DualPolicy *dual = reinterpret_cast<DualPolicy *>(pctx);
+  for (const br_ssl_server_policy_class **p : {&dual->ec.vtable, &dual->rsa.vtable}) {
+    if ((*p)->choose(p, cc, choices)) {
+      dual->chosen = p;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+static uint32_t dualKeyx(const br_ssl_server_policy_class **pctx, unsigned char *data, size_t *len) {
+  DualPolicy *dual = reinterpret_cast<DualPolicy *>(pctx);
+  return (*dual->chosen)->do_keyx(dual->chosen, data, len);
+}
+
+static size_t dualSign(const br_ssl_server_policy_class **pctx, unsigned algo, unsigned char *data, size_t hvLen,
+                       size_t len) {
+  DualPolicy *dual = reinterpret_cast<DualPolicy *>(pctx);
+  return (*dual->chosen)->do_sign(dual->chosen, algo, data, hvLen, len);
+}
+
+static const br_ssl_server_policy_class dualPolicyClass = {sizeof(DualPolicy), dualChoose, dualKeyx, dualSign};
+
+static int sockRead(void *ctx, unsigned char *buf, size_t len) {
+  ssize_t n = recv(*static_cast<int *>(ctx), buf, len, 0);
+  return n > 0 ? (int)n : -1;
+}
+
+static int sockWrite(void *ctx, const unsigned char *buf, size_t len) {
+  ssize_t n = send(*static_cast<int *>(ctx), buf, len, MSG_NOSIGNAL);
+  return n > 0 ? (int)n : -1;
+}
+
+/* Answers "ping" with "pong" on each connection, one at a time, with `chain`, or with `chain` and
+ * `rsa` when given, `chain` being the ECDSA one */
+class LocalServer {
+public:
+  explicit LocalServer(const Chain &chain, const Chain *rsa = nullptr)
+      : _chain(chain), _rsa(rsa), _lastSuite(0), _served(0) {
+    _fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(_fd, (sockaddr *)&addr, sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(_fd, (sockaddr *)&addr, &len);
+    _port = ntohs(addr.sin_port);
+    listen(_fd, 4);
+    _thread = std::thread(&LocalServer::run, this);
+  }
+
+  ~LocalServer() {
+    shutdown(_fd, SHUT_RDWR);
+    _thread.join();
+    close(_fd);
+  }
+
+  uint16_t port() const { return _port; }
+  uint16_t lastSuite() const { return _lastSuite; }
+  uint32_t served() const { return _served; }
+
+private:
+  void run() {
+    for (;;) {
+      int conn = accept(_fd, nullptr, nullptr);
+      if (conn < 0) return;
+      serve(conn);
+      close(conn);
+    }
+  }
+
+  void serve(int conn) {
+    static unsigned char buf[BR_SSL_BUFSIZE_BIDI];
+    br_ssl_server_context sc;
+    br_x509_certificate cert = {const_cast<unsigned char *>(_chain.cert), _chain.certLen};
+    br_skey_decoder_context key;
+    br_skey_decoder_init(&key);
+    br_skey_decoder_push(&key, _chain.key, _chain.keyLen);
+    if (_chain.ec) {
+      br_ssl_server_init_full_ec(&sc, &cert, 1, BR_KEYTYPE_EC, br_skey_decoder_get_ec(&key));
+    } else {
+      br_ssl_server_init_full_rsa(&sc, &cert, 1, br_skey_decoder_get_rsa(&key));
+    }
+    br_x509_certificate rsaCert;
+    br_skey_decoder_context rsaKey;
+    DualPolicy dual;
+    if (_rsa) {
+      dual.vtable = &dualPolicyClass;
+      dual.ec = sc.chain_handler.single_ec;
+      rsaCert = {const_cast<unsigned char *>(_rsa->cert), _rsa->certLen};
+      br_skey_decoder_init(&rsaKey);
+      br_skey_decoder_push(&rsaKey, _rsa->key, _rsa->keyLen);
+      br_ssl_server_set_single_rsa(&sc, &rsaCert, 1, br_skey_decoder_get_rsa(&rsaKey),
+                                   BR_KEYTYPE_KEYX | BR_KEYTYPE_SIGN, br_rsa_private_get_default(),
+                                   br_rsa_pkcs1_sign_get_default());
+      dual.rsa = sc.chain_handler.single_rsa;
+      br_ssl_engine_set_suites(&sc.eng, dualSuites, sizeof(dualSuites) / sizeof(dualSuites[0]));
+      br_ssl_server_set_policy(&sc, &dual.vtable);
+    }
+    br_ssl_engine_set_buffer(&sc.eng, buf, sizeof(buf), 1);
+    br_ssl_server_reset(&sc);
+
+    br_sslio_context io;
+    br_sslio_init(&io, &sc.eng, sockRead, &conn, sockWrite, &conn);
+    unsigned char ping[4];
+    if (br_sslio_read_all(&io, ping, sizeof(ping)) == 0) {
+      br_ssl_session_parameters params;
+      br_ssl_engine_get_session_parameters(&sc.eng, &params);
+      _lastSuite = params.cipher_suite;
+      _served++;   // before the answer: the client may count as soon as it has it
+      br_sslio_write_all(&io, "pong", 4);
+      br_sslio_flush(&io);
+    }
+    br_sslio_close(&io);
+  }
+
+  const Chain &_chain;
+  const Chain *_rsa;
+  int _fd;
+  uint16_t _port;
+  std::thread _thread;
+  std::atomic<uint16_t> _lastSuite;
+  std::atomic<uint32_t> _served;
+};
+
+//==================================== The client ====================================//
+
+static bssl::X509List *anchors;
+
+/* One connection with `profile`: handshake, "ping", "pong" */
+static bool handshake(TlsProfile profile, uint16_t port) {
+  WiFiClient tcp;
+  ESP_SSLClient ssl;
+  ssl.setClient(&tcp);
+  ssl.setTrustAnchors(anchors);
+  ssl.setX509Time(VALIDATION_TIME);
+  ssl.setProfile(tlsProfile(profile));
+  TlsBuffers buffers = tlsFullBuffers(SMTP_FRAGMENT);
+  ssl.setBufferSizes(buffers.rx, buffers.tx);
+
+  /* The test port is not one the client knows as TLS: connect, then upgrade, as after STARTTLS */
+  bool ok = ssl.connect("localhost", port) && ssl.connectSSL();
+  if (ok) {
+    ssl.write((const uint8_t *)"ping", 4);
+    char pong[5] = {};
+    for (uint32_t waited = 0; ssl.available() < 4 && waited < 2000; waited++) delay(1);
+    ok = ssl.read((uint8_t *)pong, 4) == 4 && strcmp(pong, "pong") == 0;
+  }
+  ssl.stop();
+  return ok;
+}
+
+/* The figures of HANDSHAKES handshakes on a thread of their own */
+struct HandshakeRun {
+  TlsProfile profile;
+  uint16_t port;
+  uint32_t succeeded;
+  double cpuUs;         // per handshake
+  long heapPeak;        // bytes, the largest of the runs
+  size_t stackPeak;     // bytes
+};
+
+static double threadCpuUs() {
+  timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+static void *handshakes(void *arg) {
+  HandshakeRun *run = static_cast<HandshakeRun *>(arg);
+  for (uint32_t i = 0; i < HANDSHAKES; i++) {
+    countHeap(true);
+    double start = threadCpuUs();
+    run->succeeded += handshake(run->profile, run->port);
+    run->cpuUs += threadCpuUs() - start;
+    countHeap(false);
+    if (heapPeak > run->heapPeak) run->heapPeak = heapPeak;
+  }
+  run->cpuUs /= HANDSHAKES;
+  return nullptr;
+}
+
+static void *idle(void *arg) { return arg; }
+
+/* Deepest the painted stack was written, for `fn` run on a fresh thread */
+static size_t stackUsed(void *(*fn)(void *), void *arg) {
+  static uint8_t stack[BENCH_STACK_BYTES] __attribute__((aligned(64)));
+  memset(stack, STACK_PAINT, sizeof(stack));
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, sizeof(stack));
+  pthread_t thread;
+  pthread_create(&thread, &attr, fn, arg);
+  pthread_join(thread, nullptr);
+  pthread_attr_destroy(&attr);
+
+  size_t untouched = 0;
+  while (untouched < sizeof(stack) && stack[untouched] == STACK_PAINT) untouched++;
+  return sizeof(stack) - untouched;
+}
+
+static HandshakeRun measure(TlsProfile profile, const LocalServer &server) {
+  HandshakeRun run = {};
+  run.profile = profile;
+  run.port = server.port();
+  size_t used = stackUsed(handshakes, &run);
+  size_t base = stackUsed(idle, nullptr);   // thread start-up and TLS, not the handshake
+  run.stackPeak = used > base ? used - base : 0;
+  return run;
+}
+
+void setUp() {}
+void tearDown() {}
+
+static void test_profiles_reach_their_suites() {
+  LocalServer server(RSA_CHAIN);
+  TEST_ASSERT_TRUE(handshake(TLS_PROFILE_COMPAT, server.port()));
+  TEST_ASSERT_TRUE(handshake(TLS_PROFILE_RSA, server.port()));
+  TEST_ASSERT_EQUAL_HEX16(BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, server.lastSuite());
+  TEST_ASSERT_EQUAL(2, server.served());
+}
+
+static void test_rsa_profile_gets_the_rsa_chain_from_a_server_with_both() {
+  LocalServer server(EC_CHAIN, &RSA_CHAIN);
+  TEST_ASSERT_TRUE(handshake(TLS_PROFILE_COMPAT, server.port()));
+  TEST_ASSERT_EQUAL_HEX16(BR_TLS_ECDHE_ECDSA_WITH_CHACHA20_POLY1305_SHA256, server.lastSuite());
+  TEST_ASSERT_TRUE(handshake(TLS_PROFILE_RSA, server.port()));
+  TEST_ASSERT_EQUAL_HEX16(BR_TLS_ECDHE_RSA_WITH_CHACHA20_POLY1305_SHA256, server.lastSuite());
+  TEST_ASSERT_EQUAL(2, server.served());
+}
+
+static void test_rsa_profile_refuses_an_ecdsa_server() {
+  LocalServer server(EC_CHAIN);
+  TEST_ASSERT_TRUE(handshake(TLS_PROFILE_COMPAT, server.port()));
+  TEST_ASSERT_FALSE(handshake(TLS_PROFILE_RSA, server.port()));
+  TEST_ASSERT_EQUAL(1, server.served());
+}
+
+static void test_untrusted_server_is_refused() {
+  bssl::X509List *trusted = anchors;
+  bssl::X509List rsaOnly(RSA_CA_DER, sizeof(RSA_CA_DER));
+  anchors = &rsaOnly;
+  LocalServer server(EC_CHAIN);
+  bool ok = handshake(TLS_PROFILE_COMPAT, server.port());
+  anchors = trusted;
+  TEST_ASSERT_FALSE(ok);
+  TEST_ASSERT_EQUAL(0, server.served());
+}
+
+static void test_handshake_benchmark() {
+  nativeSerialEcho(true);
+  struct {
+    const char *name;
+    const Chain &chain;
+    const Chain *rsa;
+  } servers[] = {{"RSA", RSA_CHAIN, nullptr}, {"ECDSA", EC_CHAIN, nullptr}, {"ECDSA+RSA", EC_CHAIN, &RSA_CHAIN}};
+  for (const auto &s : servers) {
+    LocalServer server(s.chain, s.rsa);
+    for (TlsProfile profile : {TLS_PROFILE_COMPAT, TLS_PROFILE_RSA}) {
+      HandshakeRun run = measure(profile, server);
+      if (run.succeeded) {
+        Serial.printf("TLS handshake, %s server, %s: %.0f us CPU, %ld B heap peak, %u B stack peak\n", s.name,
+                      tlsProfileName(profile), run.cpuUs, run.heapPeak, (unsigned)run.stackPeak);
+      } else {
+        Serial.printf("TLS handshake, %s server, %s: refused\n", s.name, tlsProfileName(profile));
+      }
+      bool expected = !s.chain.ec || s.rsa || profile == TLS_PROFILE_COMPAT;
+      TEST_ASSERT_EQUAL(expected ? HANDSHAKES : 0, run.succeeded);
+    }
+  }
+  nativeSerialEcho(false);
+}
+
+int main(int argc, char **argv) {
+  (void)argc;
+  (void)argv;
+  nativeSerialEcho(false);
+  anchors = new bssl::X509List(RSA_CA_DER, sizeof(RSA_CA_DER));
+  anchors->append(EC_CA_DER, sizeof(EC_CA_DER));
+  UNITY_BEGIN();
+  RUN_TEST(test_profiles_reach_their_suites);
+  RUN_TEST(test_rsa_profile_gets_the_rsa_chain_from_a_server_with_both);
+  RUN_TEST(test_rsa_profile_refuses_an_ecdsa_server);
+  RUN_TEST(test_untrusted_server_is_refused);
+  RUN_TEST(test_handshake_benchmark);
+  int failures = UNITY_END();
+  delete anchors;
+  return failures;
+}
@@ -0,0 +1,196 @@
+"""Converts PEM certificates into BearSSL trust anchors compiled into flash.
+
+Every certs/*.pem becomes a br_x509_trust_anchor in include/trust_anchors.h, so the SMTP client
+verifies the server without parsing a PEM (and allocating the decoded certificate) at run time.
+Root CAs keep their CA flag. A file named *.pin.pem pins that exact certificate instead: it is
+emitted without the CA flag, so only a server presenting that certificate (name and key) passes.
+
+Runs as a PlatformIO pre-script (extra_scripts = pre:tools/trust_anchors.py) and regenerates the
+header when a certificate changes, or by hand:
+
+    python tools/trust_anchors.py [-o include/trust_anchors.h] [cert.pem ...]
+
+Only the standard library is used: the DER walk below reads just the fields BearSSL needs
+(subject DN, public key, basicConstraints).
+"""
+
+import base64
+import glob
+import os
+import re
+import sys
+
+OID_RSA = "1.2.840.113549.1.1.1"
+OID_EC = "1.2.840.10045.2.1"
+OID_BASIC_CONSTRAINTS = "2.5.29.19"
+CURVES = {
+    "1.2.840.10045.3.1.7": "BR_EC_secp256r1",
+    "1.3.132.0.34": "BR_EC_secp384r1",
+    "1.3.132.0.35": "BR_EC_secp521r1",
+}
+
+
+def der_item(data, pos):
+    """Returns (tag, start of content, end of content) of the DER item at pos."""
+    tag = data[pos]
+    length = data[pos + 1]
+    pos += 2
+    if length & 0x80:
+        count = length & 0x7F
+        length = int.from_bytes(data[pos:pos + count], "big")
+        pos += count
+    return tag, pos, pos + length
+
+
+def der_children(data, start, end):
+    items = []
+    while start < end:
+        tag, cstart, cend = der_item(data, start)
+        items.append((tag, start, cstart, cend))
+        start = cend
+    return items
+
+
+def der_oid(raw):
+    first = raw[0]
+    parts = [first // 40, first % 40]
+    value = 0
+    for byte in raw[1:]:
+        value = (value << 7) | (byte & 0x7F)
+        if not byte & 0x80:
+            parts.append(value)
+            value = 0
+    return ".".join(str(p) for p in parts)
+
+
+def parse_certificate(der):
+    _, start, end = der_item(der, 0)
+    tbs = der_children(der, start, end)[0]
+    fields = der_children(der, tbs[2], tbs[3])
+    if fields[0][0] == 0xA0:  # explicit version
+        fields = fields[1:]
+    # serial, signature, issuer, validity, subject, subjectPublicKeyInfo, extensions...
+    subject = fields[4]
+    dn = der[subject[1]:subject[3]]
+
+    spki = der_children(der, fields[5][2], fields[5][3])
+    algorithm = der_children(der, spki[0][2], spki[0][3])
+    key_oid = der_oid(der[algorithm[0][2]:algorithm[0][3]])
+    bits = der[spki[1][2] + 1:spki[1][3]]  # skip the unused-bits byte
+
+    if key_oid == OID_RSA:
+        _, start, end = der_item(bits, 0)
+        n, e = der_children(bits, start, end)[:2]
+        key = ("rsa", bits[n[2]:n[3]].lstrip(b"\x00"), bits[e[2]:e[3]].lstrip(b"\x00"))
+    elif key_oid == OID_EC:
+        curve_oid = der_oid(der[algorithm[1][2]:algorithm[1][3]])
+        if curve_oid not in CURVES:
+            raise ValueError("unsupported curve " + curve_oid)
+        key = ("ec", CURVES[curve_oid], bits)
+    else:
+        raise ValueError("unsupported key type " + key_oid)
+
+    is_ca = False
+    for tag, _, cstart, cend in fields[6:]:
+        if tag != 0xA3:
+            continue
+        _, start, end = der_item(der, cstart)
+        for ext in der_children(der, start, end):
+            parts = der_children(der, ext[2], ext[3])
+            if der_oid(der[parts[0][2]:parts[0][3]]) != OID_BASIC_CONSTRAINTS:
+                continue
+            value = parts[-1]
+            _, start, end = der_item(der, value[2])
+            constraints = der_children(der, start, end)
+            is_ca = bool(constraints) and constraints[0][0] == 0x01 and der[constraints[0][2]] != 0
+    return dn, key, is_ca
+
+
+def read_pem(path):
+    with open(path) as f:
+        text = f.read()
+    blocks = re.findall(r"-----BEGIN CERTIFICATE-----(.*?)-----END CERTIFICATE-----", text, re.S)
+    return [base64.b64decode("".join(b.split())) for b in blocks]
+
+
+def c_array(name, data):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append("  " + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    return "static const unsigned char %s[] = {\n%s\n};\n" % (name, "\n".join(lines))
+
+
+def subject_name(path, index):
+    name = os.path.basename(path)
+    for suffix in (".pin.pem", ".pem"):
+        if name.endswith(suffix):
+            name = name[:-len(suffix)]
+    return name if index == 0 else "%s #%d" % (name, index + 1)
+
+
+def generate(paths):
+    arrays = []
+    anchors = []
+    for path in sorted(paths):
+        pinned = path.endswith(".pin.pem")
+        for index, der in enumerate(read_pem(path)):
+            dn, key, is_ca = parse_certificate(der)
+            n = len(anchors)
+            arrays.append("/* %s */\n" % subject_name(path, index))
+            arrays.append(c_array("TA%d_DN" % n, dn))
+            flags = "BR_X509_TA_CA" if is_ca and not pinned else "0"
+            if key[0] == "rsa":
+                arrays.append(c_array("TA%d_RSA_N" % n, key[1]))
+                arrays.append(c_array("TA%d_RSA_E" % n, key[2]))
+                pkey = ("{BR_KEYTYPE_RSA, {.rsa = {(unsigned char *)TA%d_RSA_N, sizeof TA%d_RSA_N, "
+                        "(unsigned char *)TA%d_RSA_E, sizeof TA%d_RSA_E}}}" % (n, n, n, n))
+            else:
+                arrays.append(c_array("TA%d_EC_Q" % n, key[2]))
+                pkey = ("{BR_KEYTYPE_EC, {.ec = {%s, (unsigned char *)TA%d_EC_Q, sizeof TA%d_EC_Q}}}"
+                        % (key[1], n, n))
+            anchors.append("  {{(unsigned char *)TA%d_DN, sizeof TA%d_DN}, %s, %s}," % (n, n, flags, pkey))
+            arrays.append("\n")
+
+    sources = ", ".join(os.path.basename(p) for p in sorted(paths)) or "none"
+    out = []
+    out.append("//" + "=" * 101 + "//\n")
+    out.append("// SMTP TRUST ANCHORS\n")
+    out.append("// Generated by tools/trust_anchors.py; do not edit, change the certificates in certs/ instead.\n")
+    out.append("// Sources: %s\n" % sources)
+    out.append("// The anchors live in flash and are handed to the SSL client as they are, so verification costs\n")
+    out.append("// no PEM parsing and no heap at connect time.\n")
+    out.append("//" + "=" * 101 + "//\n\n")
+    out.append("#ifndef TRUST_ANCHORS_H\n#define TRUST_ANCHORS_H\n\n")
+    out.append("#include <ESP_Mail_Client.h>  // BearSSL types from the mail client's SSL engine\n\n")
+    out.extend(arrays)
+    out.append("static const br_x509_trust_anchor SMTP_TRUST_ANCHORS[] = {\n%s\n};\n\n" % "\n".join(anchors))
+    out.append("#define SMTP_TRUST_ANCHOR_COUNT (sizeof(SMTP_TRUST_ANCHORS) / sizeof(SMTP_TRUST_ANCHORS[0]))\n\n")
+    out.append("#endif // TRUST_ANCHORS_H\n")
+    return "".join(out)
+
+
+def update(project_dir, output=None, paths=None):
+    output = output or os.path.join(project_dir, "include", "trust_anchors.h")
+    paths = paths or glob.glob(os.path.join(project_dir, "certs", "*.pem"))
+    if os.path.exists(output) and all(os.path.getmtime(p) <= os.path.getmtime(output) for p in paths) \
+            and os.path.getmtime(__file__ if "__file__" in globals() else output) <= os.path.getmtime(output):
+        return
+    if not paths:
+        raise SystemExit("trust_anchors: no certificates in certs/")
+    text = generate(paths)
+    with open(output, "w", newline="\n") as f:
+        f.write(text)
+    print("trust_anchors: wrote %s (%d certificate files)" % (os.path.relpath(output, project_dir), len(paths)))
+
+
+try:
+    Import("env")  # noqa: F821 - defined when PlatformIO runs this as an extra script
+    update(env.subst("$PROJECT_DIR"))  # noqa: F821
+except NameError:
+    if __name__ == "__main__":
+        args = sys.argv[1:]
+        out = None
+        if len(args) >= 2 and args[0] == "-o":
+            out, args = args[1], args[2:]
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        update(root, out, args or None)